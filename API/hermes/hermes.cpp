@@ -18,6 +18,7 @@
 #define HERMESJSI_ON_STACK
 #endif
 
+#include "hermes/BCGen/HBC/BytecodeCache.h"
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
 #include "hermes/DebuggerAPI.h"
@@ -43,7 +44,6 @@
 #include "hermes/VM/StringView.h"
 #include "hermes/VM/TimeLimitMonitor.h"
 
-#include "llvm/Support/ConvertUTF.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/SHA1.h"
@@ -285,6 +285,12 @@ class HermesRuntimeImpl final : public HermesRuntime,
 #ifdef HERMES_ENABLE_DEBUGGER
     compileFlags_.debug = true;
 #endif
+#ifndef HERMESVM_LEAN
+    if (!runtimeConfig.getBytecodeCacheDirectory().empty()) {
+      bytecodeCache_ = std::make_unique<hbc::BytecodeCache>(
+          runtimeConfig.getBytecodeCacheDirectory());
+    }
+#endif
 
 #ifndef HERMESJSI_ON_STACK
     // Register the memory for the runtime if it isn't stored on the stack.
@@ -984,6 +990,12 @@ class HermesRuntimeImpl final : public HermesRuntime,
 
   /// Compilation flags used by prepareJavaScript().
   ::hermes::hbc::CompileFlags compileFlags_{};
+
+#ifndef HERMESVM_LEAN
+  /// Bytecode compiled by prepareJavaScript() in this or earlier processes,
+  /// if enabled.
+  std::unique_ptr<::hermes::hbc::BytecodeCache> bytecodeCache_;
+#endif
 };
 
 namespace {
@@ -1166,9 +1178,11 @@ size_t HermesRuntime::rootsListLength() const {
 
 namespace {
 
-/// An implementation of PreparedJavaScript that wraps a BytecodeProvider.
+/// An implementation of PreparedJavaScript that wraps a CompiledModule. It
+/// can be evaluated by any number of runtimes, which then share the bytecode,
+/// the tables derived from it, and its lazily compiled functions.
 class HermesPreparedJavaScript final : public jsi::PreparedJavaScript {
-  std::shared_ptr<hbc::BCProvider> bcProvider_;
+  std::shared_ptr<vm::CompiledModule> compiledModule_;
   vm::RuntimeModuleFlags runtimeFlags_;
   std::string sourceURL_;
 
@@ -1177,12 +1191,12 @@ class HermesPreparedJavaScript final : public jsi::PreparedJavaScript {
       std::unique_ptr<hbc::BCProvider> bcProvider,
       vm::RuntimeModuleFlags runtimeFlags,
       std::string sourceURL)
-      : bcProvider_(std::move(bcProvider)),
+      : compiledModule_(vm::CompiledModule::create(std::move(bcProvider))),
         runtimeFlags_(runtimeFlags),
         sourceURL_(std::move(sourceURL)) {}
 
-  std::shared_ptr<hbc::BCProvider> bytecodeProvider() const {
-    return bcProvider_;
+  std::shared_ptr<vm::CompiledModule> compiledModule() const {
+    return compiledModule_;
   }
 
   vm::RuntimeModuleFlags runtimeFlags() const {
@@ -1220,8 +1234,13 @@ HermesRuntimeImpl::prepareJavaScript(
 #if defined(HERMESVM_LEAN)
     bcErr.second = "prepareJavaScript source compilation not supported";
 #else
-    bcErr = hbc::BCProviderFromSrc::createBCProviderFromSrc(
-        std::move(buffer), sourceURL, compileFlags_);
+    if (bytecodeCache_) {
+      bcErr = bytecodeCache_->getOrCompile(
+          std::move(buffer), sourceURL, compileFlags_);
+    } else {
+      bcErr = hbc::BCProviderFromSrc::createBCProviderFromSrc(
+          std::move(buffer), sourceURL, compileFlags_);
+    }
 #endif
   }
   if (!bcErr.first) {
@@ -1245,7 +1264,7 @@ jsi::Value HermesRuntimeImpl::evaluatePreparedJavaScript(
         static_cast<const HermesPreparedJavaScript *>(js.get());
     vm::GCScope gcScope(&runtime_);
     auto res = runtime_.runBytecode(
-        hermesPrep->bytecodeProvider(),
+        hermesPrep->compiledModule(),
         hermesPrep->runtimeFlags(),
         hermesPrep->sourceURL(),
         vm::Runtime::makeNullHandle<vm::Environment>());
@@ -1346,17 +1365,29 @@ jsi::PropNameID HermesRuntimeImpl::createPropNameIDFromString(
   });
 }
 
-std::string HermesRuntimeImpl::utf8(const jsi::PropNameID &sym) {
-  vm::GCScope gcScope(&runtime_);
-  vm::SymbolID id = phv(sym).getSymbol();
-  auto view = runtime_.getIdentifierTable().getStringView(&runtime_, id);
-  vm::SmallU16String<32> allocator;
+namespace {
+
+/// \return the UTF-8 encoding of the string in \p view. ASCII strings are
+/// copied directly, without widening them to UTF-16 first.
+std::string viewToStdString(const vm::StringView &view) {
+  if (view.isASCII()) {
+    return std::string(view.castToCharPtr(), view.length());
+  }
   std::string ret;
   ::hermes::convertUTF16ToUTF8WithReplacements(
-      ret, view.getUTF16Ref(allocator));
+      ret, vm::UTF16Ref(view.castToChar16Ptr(), view.length()));
   return ret;
 }
 
+} // namespace
+
+std::string HermesRuntimeImpl::utf8(const jsi::PropNameID &sym) {
+  vm::GCScope gcScope(&runtime_);
+  vm::SymbolID id = phv(sym).getSymbol();
+  return viewToStdString(
+      runtime_.getIdentifierTable().getStringView(&runtime_, id));
+}
+
 bool HermesRuntimeImpl::compare(
     const jsi::PropNameID &a,
     const jsi::PropNameID &b) {
@@ -1368,12 +1399,8 @@ namespace {
 std::string toStdString(
     vm::Runtime *runtime,
     vm::Handle<vm::StringPrimitive> handle) {
-  auto view = vm::StringPrimitive::createStringView(runtime, handle);
-  vm::SmallU16String<32> allocator;
-  std::string ret;
-  ::hermes::convertUTF16ToUTF8WithReplacements(
-      ret, view.getUTF16Ref(allocator));
-  return ret;
+  return viewToStdString(
+      vm::StringPrimitive::createStringView(runtime, handle));
 }
 
 } // namespace
@@ -1425,23 +1452,8 @@ std::string HermesRuntimeImpl::utf8(const jsi::String &str) {
 static void
 convertUtf8ToUtf16(const uint8_t *utf8, size_t length, std::u16string &out) {
   // length is the number of input bytes
-  out.resize(length);
-  const llvm::UTF8 *sourceStart = (const llvm::UTF8 *)utf8;
-  const llvm::UTF8 *sourceEnd = sourceStart + length;
-  llvm::UTF16 *targetStart = (llvm::UTF16 *)&out[0];
-  llvm::UTF16 *targetEnd = targetStart + out.size();
-  llvm::ConversionResult cRes;
-  cRes = ConvertUTF8toUTF16(
-      &sourceStart,
-      sourceEnd,
-      &targetStart,
-      targetEnd,
-      llvm::lenientConversion);
-  (void)cRes;
-  assert(
-      cRes != llvm::ConversionResult::targetExhausted &&
-      "not enough space allocated for UTF16 conversion");
-  out.resize((char16_t *)targetStart - &out[0]);
+  ::hermes::convertUTF8ToUTF16WithReplacements(
+      out, llvm::ArrayRef<uint8_t>(utf8, length));
 }
 
 jsi::Value HermesRuntimeImpl::createValueFromJsonUtf8(
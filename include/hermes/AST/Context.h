@@ -13,6 +13,8 @@
 #include "hermes/Support/SourceErrorManager.h"
 #include "hermes/Support/StringTable.h"
 
+#include <mutex>
+
 namespace hermes {
 
 namespace hbc {
@@ -190,6 +192,10 @@ class Context {
   /// on its destructor.
   std::shared_ptr<hbc::BackendContext> hbcBackendContext_{};
 
+  /// Held while lazy functions are compiled in this context, or their source
+  /// locations are looked up, since that may happen on different threads.
+  std::mutex lazyCompilationMutex_{};
+
  public:
   explicit Context(
       SourceErrorManager &sm,
@@ -334,6 +340,10 @@ class Context {
       std::shared_ptr<hbc::BackendContext> hbcBackendContext) {
     hbcBackendContext_ = std::move(hbcBackendContext);
   }
+
+  std::mutex &getLazyCompilationMutex() {
+    return lazyCompilationMutex_;
+  }
 };
 
 }; // namespace hermes
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_HBC_BYTECODECACHE_H
+#define HERMES_BCGEN_HBC_BYTECODECACHE_H
+
+#ifndef HERMESVM_LEAN
+
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+
+#include <string>
+
+namespace hermes {
+namespace hbc {
+
+/// An on-disk cache of bytecode compiled from source, so that loading the
+/// same source again does not have to compile it again.
+///
+/// Each entry is a bytecode file named after the SHA1 of the source, its URL,
+/// the bytecode version and the flags which affect the generated bytecode.
+/// Entries are written to a temporary file which is then renamed, so that
+/// concurrent readers and writers never see a partial entry, and they are
+/// checked before they are used. The cache is best effort: any failure to
+/// read or write it just means that the source is compiled.
+///
+/// Lazy functions cannot be written to a bytecode file, so sources which
+/// would be compiled lazily are compiled eagerly when they are not in the
+/// cache.
+class BytecodeCache {
+ public:
+  /// \param directory where the entries are kept. It is created if needed.
+  explicit BytecodeCache(std::string directory);
+
+  /// Return a provider for the source in \p buffer compiled with
+  /// \p compileFlags, read from the cache if possible, and otherwise
+  /// compiled and written to the cache.
+  /// \return the provider, or nullptr and an error message if the source
+  ///   failed to compile.
+  std::pair<std::unique_ptr<BCProviderBase>, std::string> getOrCompile(
+      std::unique_ptr<Buffer> buffer,
+      llvm::StringRef sourceURL,
+      const CompileFlags &compileFlags);
+
+  /// \return the path of the entry for a source with hash \p sourceHash
+  /// loaded from \p sourceURL and compiled with \p compileFlags.
+  std::string getEntryPath(
+      const SHA1 &sourceHash,
+      llvm::StringRef sourceURL,
+      const CompileFlags &compileFlags) const;
+
+ private:
+  /// \return the entry at \p path, or nullptr if it doesn't exist or is not
+  /// valid bytecode for a source with hash \p sourceHash.
+  std::unique_ptr<BCProviderBase> read(
+      const std::string &path,
+      const SHA1 &sourceHash);
+
+  /// Write \p module, compiled from a source with hash \p sourceHash with
+  /// \p compileFlags, to the entry at \p path.
+  void write(
+      const std::string &path,
+      BytecodeModule &module,
+      const SHA1 &sourceHash,
+      const CompileFlags &compileFlags);
+
+  std::string directory_;
+};
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMESVM_LEAN
+
+#endif // HERMES_BCGEN_HBC_BYTECODECACHE_H
@@ -18,9 +18,13 @@
 #include "hermes/Support/StringTableEntry.h"
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #ifdef HERMESVM_SERIALIZE
 namespace hermes {
@@ -46,6 +50,31 @@ using BCProvider = BCProviderBase;
 
 using StringID = uint32_t;
 
+/// How the pages of a bytecode buffer are brought into memory and released.
+/// Only buffers forward this to the OS.
+struct BytecodeResidencyPolicy {
+  /// Prefetch the string table and the global function body on load.
+  bool prefetchStartup{false};
+
+  /// Read ahead this many bytes from the start of the function bodies on
+  /// load. The bodies of functions which run at startup are laid out there
+  /// when the bytecode is compiled with a function order.
+  uint32_t startupReadaheadBytes{0};
+
+  /// Advise the OS that the rest of the buffer is accessed randomly, so that
+  /// it doesn't read ahead around every fault.
+  bool randomAccessRest{false};
+
+  /// Let the OS reclaim the pages of function bodies which have not been
+  /// used when TTI is reached.
+  bool releaseColdFunctionsAtTTI{false};
+};
+
+/// Align \p *ptr down to the start of the page it is pointing in to, and
+/// simultaneously adjust \p *byteLen up by the amount the ptr was shifted down
+/// by.
+void pageAlignDown(uint8_t **ptr, size_t *byteLen);
+
 /// Runtime reference to a function header. Values of this class should
 /// be used in the VM to reference (not own) function headers.
 class RuntimeFunctionHeader {
@@ -142,6 +171,10 @@ class BCProviderBase {
   /// when first needed. Most likely we should never need to use it.
   const hbc::DebugInfo *debugInfo_{};
 
+  /// Guards the lazy creation of debugInfo_, since a provider may be shared
+  /// by runtimes on different threads.
+  mutable std::mutex debugInfoMutex_{};
+
   /// Error message when there is an error parsing the bytecode.
   /// We can use this to throw an exception to JSI.
   std::string errstr_{};
@@ -210,6 +243,7 @@ class BCProviderBase {
 
   /// Get the global debug info, lazily create it.
   const hbc::DebugInfo *getDebugInfo() const {
+    std::lock_guard<std::mutex> lock{debugInfoMutex_};
     if (!debugInfo_) {
       const_cast<BCProviderBase *>(this)->createDebugInfo();
     }
@@ -277,6 +311,29 @@ class BCProviderBase {
   /// Only forwards this information to the OS for buffers.
   virtual void dontNeedIdentifierTranslations() {}
 
+  /// Apply the parts of \p policy which take effect when the bytecode is
+  /// loaded. Only forwards this advice to the OS for buffers.
+  virtual void applyResidencyPolicy(const BytecodeResidencyPolicy &policy) {}
+
+  /// Let the OS reclaim the pages which only contain bodies of functions for
+  /// which \p isFunctionUsed returns false. Only implemented for buffers.
+  /// \return the number of pages released.
+  virtual size_t releaseUnusedFunctionPages(
+      llvm::function_ref<bool(uint32_t)> isFunctionUsed) {
+    return 0;
+  }
+
+  /// Record which pages are resident, so that getPagesLoadedSinceSnapshot()
+  /// can count the pages brought in later, mostly by page faults. Only
+  /// implemented for buffers.
+  virtual void snapshotResidentPages() {}
+
+  /// \return the number of pages which are resident now but were not when
+  /// snapshotResidentPages() was called, or -1 if unknown.
+  virtual int getPagesLoadedSinceSnapshot() const {
+    return -1;
+  }
+
   /// Start tracking I/O (only implemented for buffers). Any access before this
   /// call (e.g. reading header to construct the provider) will not be recorded.
   virtual void startPageAccessTracker() {}
@@ -335,6 +392,21 @@ class BCProviderFromBuffer final : public BCProviderBase {
   /// Offset of the location to find debug info.
   uint32_t debugInfoOffset_{};
 
+  /// If the bytecode is compressed, the chunks of function bodies and their
+  /// compressed data.
+  llvm::ArrayRef<CompressedChunk> compressedChunks_{};
+  llvm::ArrayRef<uint8_t> compressedBodies_{};
+
+  /// The function bodies of each chunk, once it has been decompressed.
+  mutable std::vector<std::unique_ptr<uint8_t[]>> decompressedChunks_{};
+
+  /// Guards decompressedChunks_.
+  mutable std::mutex decompressMutex_{};
+
+  /// If the bytecode is compressed, the debug info once it has been
+  /// decompressed.
+  std::unique_ptr<uint8_t[]> debugInfoStorage_{};
+
   /// If \p startWarmup has been called, this is the thread doing the warmup.
   llvm::Optional<std::thread> warmupThread_;
 
@@ -343,6 +415,12 @@ class BCProviderFromBuffer final : public BCProviderBase {
 
   std::unique_ptr<volatile PageAccessTracker> tracker_;
 
+  /// The start of the function bodies, or of the compressed bodies.
+  const uint8_t *functionBodies_{};
+
+  /// Which pages were resident when snapshotResidentPages() was called.
+  std::vector<bool> residentAtSnapshot_{};
+
   /// Tells any running warmup thread to abort and then joins that thread.
   void stopWarmup();
 
@@ -350,6 +428,11 @@ class BCProviderFromBuffer final : public BCProviderBase {
 
   void createDebugInfo() override;
 
+  /// Decompress the chunk containing \p offset in the uncompressed function
+  /// bodies, unless it has already been decompressed.
+  /// \return a pointer to the decompressed byte at \p offset.
+  const uint8_t *getDecompressedBytecode(uint32_t offset) const;
+
   /// Helper function to fetch the exception table data given \p functionID.
   /// \returns the ArrayRef to the exception table data, along with a pointer
   /// to the DebugOffsets (or nullptr if there is none).
@@ -445,7 +528,22 @@ class BCProviderFromBuffer final : public BCProviderBase {
   }
 
   const uint8_t *getBytecode(uint32_t functionID) const override {
-    return bufferPtr_ + getFunctionHeader(functionID).offset();
+    uint32_t offset = getFunctionHeader(functionID).offset();
+    if (LLVM_UNLIKELY(options_.compressed)) {
+      return getDecompressedBytecode(offset);
+    }
+    return bufferPtr_ + offset;
+  }
+
+  /// Returns the chunks of compressed function bodies, which are empty unless
+  /// the bytecode is compressed.
+  llvm::ArrayRef<CompressedChunk> getCompressedChunks() const {
+    return compressedChunks_;
+  }
+
+  /// Returns the compressed data of all chunks.
+  llvm::ArrayRef<uint8_t> getCompressedBodies() const {
+    return compressedBodies_;
   }
 
   llvm::ArrayRef<hbc::HBCExceptionHandlerInfo> getExceptionTable(
@@ -468,6 +566,12 @@ class BCProviderFromBuffer final : public BCProviderBase {
   void willNeedStringTable() override;
   void dontNeedIdentifierTranslations() override;
 
+  void applyResidencyPolicy(const BytecodeResidencyPolicy &policy) override;
+  size_t releaseUnusedFunctionPages(
+      llvm::function_ref<bool(uint32_t)> isFunctionUsed) override;
+  void snapshotResidentPages() override;
+  int getPagesLoadedSinceSnapshot() const override;
+
   void startPageAccessTracker() override;
 
   volatile PageAccessTracker *getPageAccessTracker() override {
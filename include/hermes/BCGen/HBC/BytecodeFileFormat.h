@@ -29,8 +29,8 @@ const static uint64_t MAGIC = 0x1F1903C103BC1FC6;
 const static uint64_t DELTA_MAGIC = ~MAGIC;
 
 // Bytecode version generated by this version of the compiler.
-// Updated: Oct 11, 2019
-const static uint32_t BYTECODE_VERSION = 70;
+// Updated: Oct 18, 2026
+const static uint32_t BYTECODE_VERSION = 74;
 
 /// Property cache index which indicates no caching.
 static constexpr uint8_t PROPERTY_CACHING_DISABLED = 0;
@@ -53,6 +53,9 @@ union BytecodeOptions {
   struct {
     bool staticBuiltins : 1;
     bool cjsModulesStaticallyResolved : 1;
+    /// Function bodies and debug info are compressed, see
+    /// CompressedBodiesHeader and CompressedDebugInfoHeader.
+    bool compressed : 1;
   };
   uint8_t _flags;
 
@@ -372,6 +375,38 @@ struct DebugFileRegion {
   uint32_t sourceMappingUrlId;
 };
 
+/// In compressed bytecode, the function bodies are replaced by this header,
+/// followed by chunkCount CompressedChunk entries and then by the compressed
+/// data of all chunks. The offset of a function body in its header is then
+/// the offset in the uncompressed bodies of all chunks laid end to end.
+struct CompressedBodiesHeader {
+  uint32_t chunkCount;
+  // Bytes of compressed data following the chunk table.
+  uint32_t dataSize;
+};
+
+/// A run of whole function bodies compressed as one block, which can be
+/// decompressed independently of the other chunks.
+struct CompressedChunk {
+  // Offset of the first body in the uncompressed bodies.
+  uint32_t offset;
+  // Size of the uncompressed bodies.
+  uint32_t size;
+  // Offset of the block in the compressed data.
+  uint32_t dataOffset;
+  // Size of the block.
+  uint32_t dataSize;
+};
+
+/// In compressed bytecode, the debug info section is this header followed by
+/// the compressed debug info.
+struct CompressedDebugInfoHeader {
+  // Size of the uncompressed debug info.
+  uint32_t size;
+  // Size of the compressed data following this header.
+  uint32_t dataSize;
+};
+
 LLVM_PACKED_END
 
 /// Visit each segment in a bytecode file in order.
@@ -450,6 +485,16 @@ struct BytecodeFileFields {
   /// List of resolved CJS modules.
   Array<uint32_t> cjsModuleTableStatic;
 
+  /// The start of the function bodies, or of the compressed function bodies,
+  /// which follow the segments above.
+  Pointer<uint8_t> functionBodies{nullptr};
+
+  /// If the bytecode is compressed, the chunks of function bodies.
+  Array<CompressedChunk> compressedChunks;
+
+  /// If the bytecode is compressed, the compressed data of all chunks.
+  Array<uint8_t> compressedBodies;
+
   /// Populate bytecode file fields from a buffer. The fields will point
   /// directly into the buffer and it is the caller's responsibility to ensure
   /// the result does not outlive the buffer.
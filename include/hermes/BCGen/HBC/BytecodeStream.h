@@ -52,6 +52,18 @@ class BytecodeSerializer {
   uint32_t debugInfoOffset_{0};
   /// Count of overflow string entries, computed during layout phase.
   uint32_t overflowStringEntryCount_{0};
+  /// If compressing, the chunks of function bodies and their compressed data,
+  /// computed during layout phase.
+  std::vector<CompressedChunk> compressedChunks_{};
+  std::vector<uint8_t> compressedBodies_{};
+  /// If compressing, the size of the debug info and its compressed data,
+  /// computed during layout phase.
+  uint32_t debugInfoSize_{0};
+  std::vector<uint8_t> compressedDebugInfo_{};
+
+  /// The uncompressed size of function bodies above which a chunk of
+  /// compressed bodies is ended.
+  static constexpr uint32_t COMPRESSED_CHUNK_SIZE = 16 * 1024;
 
   /// Each subsection of a function's `info' section is aligned thusly.
   static constexpr uint32_t INFO_ALIGNMENT = 4;
@@ -98,9 +110,21 @@ class BytecodeSerializer {
 
   void serializeDebugOffsets(BytecodeFunction &BF);
 
+  /// \return the functions of \p BM in the order their bodies are laid out:
+  /// first those listed in the functionOrder option, then the rest by ID.
+  std::vector<BytecodeFunction *> getFunctionLayoutOrder(BytecodeModule &BM);
+
   void serializeFunctionsBytecode(BytecodeModule &BM);
   void serializeFunctionInfo(BytecodeFunction &BF);
 
+  /// Lay out the function bodies of \p BM from offset zero, and split them
+  /// into compressedChunks_ and compressedBodies_.
+  void compressFunctionsBytecode(BytecodeModule &BM);
+  void serializeCompressedFunctionsBytecode(BytecodeModule &BM);
+
+  /// Write the debug info of \p BM into compressedDebugInfo_.
+  void compressDebugInfo(BytecodeModule &BM);
+
   void finishLayout(BytecodeModule &BM);
 
   void visitFunctionHeaders();
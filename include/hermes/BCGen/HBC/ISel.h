@@ -102,6 +102,14 @@ class HBCISel {
   /// Saved identifier of "__proto__" for fast comparisons.
   Identifier protoIdent_{};
 
+  /// Whether to fuse common sequences of instructions, to reduce the size of
+  /// the bytecode.
+  bool fuseInstructions_;
+
+  /// Calls of a method which are emitted with the LoadPropertyInst loading
+  /// the method, as a single instruction at the call.
+  llvm::DenseMap<HBCCallNInst *, LoadPropertyInst *> fusedLoads_{};
+
   /// Encode a value into a param_t type.
   unsigned encodeValue(Value *);
 
@@ -146,6 +154,10 @@ class HBCISel {
   /// In debug mode, assert that parameters have been correctly allocated.
   void verifyCall(CallInst *Inst);
 
+  /// \return the call which can be emitted together with the load of its
+  /// method by \p Inst as a GetByIdCallN instruction, or nullptr.
+  HBCCallNInst *getFusibleCall(LoadPropertyInst *Inst);
+
   /// The last emitted property cache index.
   uint8_t lastPropertyReadCacheIndex_{0};
   uint8_t lastPropertyWriteCacheIndex_{0};
@@ -172,12 +184,18 @@ class HBCISel {
   /// C'tor.
   /// \p F is the function that we are constructing.
   /// \p OS is the output stream.
+  /// \p fuseInstructions enables fusing common sequences of instructions.
   HBCISel(
       Function *F,
       BytecodeFunctionGenerator *BCFGen,
       HVMRegisterAllocator &RA,
-      FunctionScopeAnalysis &scopeAnalysis)
-      : F_(F), BCFGen_(BCFGen), RA_(RA), scopeAnalysis_(scopeAnalysis) {
+      FunctionScopeAnalysis &scopeAnalysis,
+      bool fuseInstructions = false)
+      : F_(F),
+        BCFGen_(BCFGen),
+        RA_(RA),
+        scopeAnalysis_(scopeAnalysis),
+        fuseInstructions_(fuseInstructions) {
     protoIdent_ = F->getContext().getIdentifier("__proto__");
   }
 
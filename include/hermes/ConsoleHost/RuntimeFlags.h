@@ -150,6 +150,35 @@ static opt<bool> TrackBytecodeIO(
     desc(
         "Track bytecode I/O when executing bytecode. Only works with bytecode mode"));
 
+static opt<bool> BytecodePrefetchStartup(
+    "bytecode-prefetch",
+    init(false),
+    desc("Prefetch the parts of the bytecode needed at startup"));
+
+static opt<unsigned> BytecodeStartupReadahead(
+    "bytecode-readahead",
+    init(0),
+    desc("Read this many bytes of function bodies sequentially ahead at "
+         "startup. Only works with bytecode mode"));
+
+static opt<bool> BytecodeRandomAccess(
+    "bytecode-random-access",
+    init(false),
+    desc("Disable readahead for the function bodies after the startup "
+         "region. Only works with bytecode mode"));
+
+static opt<bool> BytecodeReleaseColdAtTTI(
+    "bytecode-release-cold",
+    init(false),
+    desc("Release the pages of functions which have not run when TTI is "
+         "reached. Only works with bytecode mode"));
+
+static opt<bool> PrewarmLazyFunctions(
+    "prewarm-lazy",
+    init(false),
+    desc("Compile lazy functions on a background thread before they are "
+         "first called"));
+
 static opt<bool> StableInstructionCount(
     "stable-instruction-count",
     init(false),
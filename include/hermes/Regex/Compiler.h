@@ -30,6 +30,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <bitset>
 #include <initializer_list>
 #include <limits>
 #include <string>
@@ -99,6 +100,9 @@ enum MatchFlagType {
 
   /// Do not search for a match past the search start location.
   matchOnlyAtStart = 1 << 3,
+
+  /// Use the linear-time executor immediately, if the regex supports it.
+  matchLinearTime = 1 << 4,
 };
 
 inline constexpr MatchFlagType operator~(MatchFlagType x) {
@@ -227,6 +231,35 @@ inline bool isASCII(uint32_t c) {
   return c <= 127;
 }
 
+/// A set of ASCII characters, indexed by character value.
+using ASCIICharSet = std::bitset<128>;
+
+/// Describes what a node reports about the first character of its matches.
+/// This lets the executor skip input positions which cannot begin a match.
+enum class FirstCharResult : uint8_t {
+  /// Every match of the node consumes a character, which is in the reported
+  /// set.
+  Consumes,
+
+  /// The node may match without consuming a character, in which case the first
+  /// character is consumed by a following node.
+  MayBeEmpty,
+
+  /// The first character cannot be determined, or may not be ASCII.
+  Unknown,
+};
+
+/// Add the ASCII character \p c to \p chars. If \p icase is set, also add its
+/// other case. Note that in non-Unicode regexps, canonicalize() never maps a
+/// non-ASCII character to an ASCII one, so these are the only matches for \p c.
+inline void addFirstChar(ASCIICharSet *chars, uint32_t c, bool icase) {
+  assert(isASCII(c) && "Character should be ASCII");
+  chars->set(c);
+  if (icase && ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')) {
+    chars->set(c ^ 0x20);
+  }
+}
+
 // Type wrapping up a character class, like \d or \S.
 struct CharacterClass {
   enum Type : uint8_t {
@@ -283,6 +316,21 @@ class Node {
     return result;
   }
 
+  /// Add to \p chars the characters which may begin a match of the list of
+  /// nodes \p nodes. \return Consumes if every match of the list consumes a
+  /// character, MayBeEmpty if the list may match without consuming anything, or
+  /// Unknown if the first character cannot be determined.
+  static FirstCharResult firstCharsForList(
+      const NodeList &nodes,
+      ASCIICharSet *chars) {
+    for (const auto &node : nodes) {
+      FirstCharResult result = node->firstChars(chars);
+      if (result != FirstCharResult::MayBeEmpty)
+        return result;
+    }
+    return FirstCharResult::MayBeEmpty;
+  }
+
   /// Reverse the order of the node list \p nodes, and recursively ask each node
   /// to reverse the order of its children.
   inline static void reverseNodeList(NodeList &nodes);
@@ -316,6 +364,13 @@ class Node {
     return 0;
   }
 
+  /// Add to \p chars the characters which may be the first character consumed
+  /// by this node, and \return what is known about it. The default is suitable
+  /// for assertions and other nodes which never consume a character.
+  virtual FirstCharResult firstChars(ASCIICharSet *chars) const {
+    return FirstCharResult::MayBeEmpty;
+  }
+
   /// \return whether this is a goal node.
   virtual bool isGoal() const {
     return false;
@@ -343,6 +398,11 @@ class GoalNode final : public Node {
   bool isGoal() const override {
     return true;
   }
+
+  /// Reaching the goal means the match may be empty.
+  FirstCharResult firstChars(ASCIICharSet *chars) const override {
+    return FirstCharResult::Unknown;
+  }
 };
 
 class LoopNode final : public Node {
@@ -409,6 +469,16 @@ class LoopNode final : public Node {
     return result | Super::matchConstraints();
   }
 
+  /// An optional loop may be skipped, leaving the following node to consume
+  /// the first character.
+  virtual FirstCharResult firstChars(ASCIICharSet *chars) const override {
+    FirstCharResult result = firstCharsForList(loopee_, chars);
+    if (min_ == 0 && result == FirstCharResult::Consumes) {
+      result = FirstCharResult::MayBeEmpty;
+    }
+    return result;
+  }
+
   virtual void optimizeNodeContents(constants::SyntaxFlags flags) override {
     optimizeNodeList(loopee_, flags);
   }
@@ -515,6 +585,21 @@ class AlternationNode final : public Node {
     return result | Super::matchConstraints();
   }
 
+  /// A match may begin with the first character of either branch.
+  virtual FirstCharResult firstChars(ASCIICharSet *chars) const override {
+    FirstCharResult first = firstCharsForList(first_, chars);
+    FirstCharResult second = firstCharsForList(second_, chars);
+    if (first == FirstCharResult::Unknown ||
+        second == FirstCharResult::Unknown) {
+      return FirstCharResult::Unknown;
+    }
+    if (first == FirstCharResult::Consumes &&
+        second == FirstCharResult::Consumes) {
+      return FirstCharResult::Consumes;
+    }
+    return FirstCharResult::MayBeEmpty;
+  }
+
   virtual void optimizeNodeContents(constants::SyntaxFlags flags) override {
     optimizeNodeList(first_, flags);
     optimizeNodeList(second_, flags);
@@ -580,6 +665,10 @@ class MarkedSubexpressionNode final : public Node {
   virtual MatchConstraintSet matchConstraints() const override {
     return contentsConstraints_ | Super::matchConstraints();
   }
+
+  virtual FirstCharResult firstChars(ASCIICharSet *chars) const override {
+    return firstCharsForList(contents_, chars);
+  }
 };
 
 /// BackRefNode represents a backreference node.
@@ -595,6 +684,11 @@ class BackRefNode final : public Node {
     assert(static_cast<uint16_t>(mexp_) == mexp_ && "Subexpression too large");
     bcs.emit<BackRefInsn>()->mexp = static_cast<uint16_t>(mexp_);
   }
+
+  /// A backreference may match any captured text.
+  virtual FirstCharResult firstChars(ASCIICharSet *chars) const override {
+    return FirstCharResult::Unknown;
+  }
 };
 
 /// WordBoundaryNode represents a \b or \B assertion in a regex.
@@ -661,6 +755,10 @@ class MatchAnyButNewlineNode final : public Node {
     return MatchConstraintNonEmpty | Super::matchConstraints();
   }
 
+  virtual FirstCharResult firstChars(ASCIICharSet *chars) const override {
+    return FirstCharResult::Unknown;
+  }
+
   void emit(RegexBytecodeStream &bcs) const override {
     if (unicode_) {
       bcs.emit<U16MatchAnyButNewlineInsn>();
@@ -706,6 +804,16 @@ class MatchCharNode final : public Node {
     return result | Super::matchConstraints();
   }
 
+  virtual FirstCharResult firstChars(ASCIICharSet *chars) const override {
+    // Unicode case folding maps some non-ASCII characters to ASCII ones, such
+    // as U+212A KELVIN SIGN to 'k', so give up in that case.
+    CodePoint c = chars_.front();
+    if (!isASCII(c) || (icase_ && unicode_))
+      return FirstCharResult::Unknown;
+    addFirstChar(chars, c, icase_);
+    return FirstCharResult::Consumes;
+  }
+
   void emit(RegexBytecodeStream &bcs) const override {
     llvm::ArrayRef<CodePoint> remaining{chars_};
     while (!remaining.empty()) {
@@ -935,6 +1043,34 @@ class BracketNode : public Node {
     return result | Super::matchConstraints();
   }
 
+  virtual FirstCharResult firstChars(ASCIICharSet *chars) const override {
+    // Only handle brackets which match ASCII characters exclusively. As in
+    // MatchCharNode, Unicode case folding defeats this.
+    if (negate_ || (icase_ && unicode_))
+      return FirstCharResult::Unknown;
+    for (CharacterClass cc : classes_) {
+      if (cc.inverted_ || cc.type_ == CharacterClass::Spaces)
+        return FirstCharResult::Unknown;
+    }
+    for (const CodePointRange &range : codePointSet_.ranges()) {
+      if (!isASCII(range.first + range.length - 1))
+        return FirstCharResult::Unknown;
+    }
+
+    for (CharacterClass cc : classes_) {
+      for (uint32_t c = 0; c < 128; c++) {
+        if (traits_.characterHasType(c, cc.type_))
+          chars->set(c);
+      }
+    }
+    for (const CodePointRange &range : codePointSet_.ranges()) {
+      for (uint32_t c = range.first; c < range.first + range.length; c++) {
+        addFirstChar(chars, c, icase_);
+      }
+    }
+    return FirstCharResult::Consumes;
+  }
+
   virtual void emit(RegexBytecodeStream &bcs) const override {
     if (unicode_) {
       populateInstruction(bcs, bcs.emit<U16BracketInsn>());
@@ -983,6 +1119,10 @@ class Regex {
   // Constraints on the type of strings that can match this regex.
   MatchConstraintSet matchConstraints_ = 0;
 
+  // Whether the regex contains backreferences or lookarounds, which only the
+  // backtracking executor supports.
+  bool requiresBacktracking_ = false;
+
   /// Implementation of make_unique(). Construct a unique_ptr to a new Node from
   /// the given args \p args.
   /// \return the unique_ptr
@@ -1050,7 +1190,19 @@ class Regex {
     RegexBytecodeHeader header = {static_cast<uint16_t>(markedCount_),
                                   static_cast<uint16_t>(loopCount_),
                                   flags_,
-                                  matchConstraints_};
+                                  matchConstraints_,
+                                  {},
+                                  !requiresBacktracking_};
+    // Record the characters which may begin a match, so the executor can skip
+    // over positions which cannot.
+    ASCIICharSet firstChars;
+    if (Node::firstCharsForList(nodes_, &firstChars) ==
+        FirstCharResult::Consumes) {
+      for (uint32_t c = 0; c < firstChars.size(); c++) {
+        if (firstChars[c])
+          header.firstChars[c >> 3] |= 1u << (c & 7);
+      }
+    }
     RegexBytecodeStream bcs(header);
     Node::compile(nodes_, bcs);
     return bcs.acquireBytecode();
@@ -1266,6 +1418,7 @@ constants::ErrorType Regex<Traits>::parseWithBackRefLimit(
     uint32_t *outMaxBackRef) {
   // Initialize our node list with a single no-op node (it must never be empty.)
   nodes_.clear();
+  requiresBacktracking_ = false;
   nodes_.push_back(make_unique<Node>());
   auto result =
       parseRegex(first, last, this, flags_, backRefLimit, outMaxBackRef);
@@ -1341,6 +1494,7 @@ void Regex<Traits>::pushWordBoundary(bool invert) {
 
 template <class Traits>
 void Regex<Traits>::pushBackRef(uint32_t i) {
+  requiresBacktracking_ = true;
   appendNode<BackRefNode>(i);
 }
 
@@ -1361,6 +1515,7 @@ void Regex<Traits>::pushLookaround(
     uint16_t mexpEnd,
     bool invert,
     bool forwards) {
+  requiresBacktracking_ = true;
   if (!forwards) {
     Node::reverseNodeList(exp);
   }
@@ -34,6 +34,14 @@ constexpr uint32_t kNotMatched = UINT32_MAX;
 /// The maximum number of times we will backtrack.
 constexpr uint32_t kBacktrackLimit = 1u << 30;
 
+/// For regexes supported by the linear-time executor, the backtracking executor
+/// gives up in favor of it after this many steps, plus
+/// kLinearFallbackStepsPerCodeUnit for each code unit of input. A step is an
+/// executed instruction or a code unit consumed by a loop, so the time spent
+/// before giving up is linear in the input too.
+constexpr uint32_t kLinearFallbackSteps = 1u << 16;
+constexpr uint32_t kLinearFallbackStepsPerCodeUnit = 256;
+
 /// A CapturedRange represents a range of the input string captured by a capture
 /// group. A CaptureGroup may also not have matched, in which case its start is
 /// set to kNotMatched. Note that an unmatched capture group is different than a
@@ -76,6 +84,54 @@ MatchRuntimeResult searchWithBytecode(
     std::vector<CapturedRange> *captures,
     constants::MatchFlagType matchFlags);
 
+/// A regex compiled to native code, for one kind of input string. The function
+/// attempts a match of the regex only at \p pos, in the string [first, last).
+/// On success it \returns one past the end of the match and stores the start
+/// and end pointers of each capture group i (counting from 0) in captures[2*i]
+/// and captures[2*i+1]; capture groups which did not participate in the match
+/// are left null. On failure it \returns null. Each backtrack and each code
+/// unit consumed by a loop decrements *budget; if it reaches zero the function
+/// gives up, and the match must be redone by the interpreter. Since the native
+/// code has no other backward jumps, the time it spends is linear in the
+/// budget and the input.
+template <typename CharT>
+using NativeMatchFn = const CharT *(*)(
+    const CharT *pos,
+    const CharT *first,
+    const CharT *last,
+    const CharT **captures,
+    uint64_t *budget);
+
+/// The native code for a regex, with one entry point for ASCII input and one
+/// for UTF-16 input.
+struct NativeMatcher {
+  NativeMatchFn<char> ascii;
+  NativeMatchFn<char16_t> utf16;
+};
+
+/// Like searchWithBytecode(), but run the native code \p matcher compiled from
+/// \p bytecode. The bytecode is used instead if the native code gives up or
+/// does not support \p matchFlags.
+/// This is the char16_t overload.
+MatchRuntimeResult searchWithNativeMatcher(
+    llvm::ArrayRef<uint8_t> bytecode,
+    const NativeMatcher &matcher,
+    const char16_t *first,
+    uint32_t start,
+    uint32_t length,
+    std::vector<CapturedRange> *captures,
+    constants::MatchFlagType matchFlags);
+
+/// This is the ASCII overload.
+MatchRuntimeResult searchWithNativeMatcher(
+    llvm::ArrayRef<uint8_t> bytecode,
+    const NativeMatcher &matcher,
+    const char *first,
+    uint32_t start,
+    uint32_t length,
+    std::vector<CapturedRange> *captures,
+    constants::MatchFlagType matchFlags);
+
 } // namespace regex
 } // namespace hermes
 
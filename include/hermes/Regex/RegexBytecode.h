@@ -267,6 +267,28 @@ struct RegexBytecodeHeader {
 
   /// Constraints on what strings can match this regex.
   MatchConstraintSet constraints;
+
+  /// Bitmap of the ASCII characters which may begin a match, indexed by
+  /// character value. If no bit is set, a match may begin with any character.
+  uint8_t firstChars[16];
+
+  /// Whether the regex may be run by the linear-time executor, which does not
+  /// support backreferences or lookarounds.
+  uint8_t linearExecutable;
+
+  /// \return whether every match must begin with a character in firstChars.
+  bool hasFirstChars() const {
+    for (uint8_t bits : firstChars) {
+      if (bits)
+        return true;
+    }
+    return false;
+  }
+
+  /// \return whether the character \p c is in firstChars.
+  bool isFirstChar(uint32_t c) const {
+    return c < 128 && (firstChars[c >> 3] & (1u << (c & 7)));
+  }
 };
 
 LLVM_PACKED_END;
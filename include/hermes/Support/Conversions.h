@@ -154,6 +154,17 @@ const size_t NUMBER_TO_STRING_BUF_SIZE = 32;
 /// \return the length of the generated string (excluding the terminating zero).
 size_t numberToString(double m, char *dest, size_t destSize);
 
+/// Convert the decimal number in [\p first, \p last) to the nearest double,
+/// without the slower general algorithm of hermes_g_strtod(). The whole
+/// range must have the form [+-]?digits[.digits][(e|E)[+-]?digits], where
+/// the integer or the fractional digits (but not both) may be empty.
+/// \return the number, or llvm::None if the range does not have that form,
+///   has more than 19 significant digits, or is too close to halfway between
+///   two doubles to be rounded quickly. The caller must then fall back to
+///   hermes_g_strtod().
+OptValue<double> parseDecimalFast(const char *first, const char *last);
+OptValue<double> parseDecimalFast(const char16_t *first, const char16_t *last);
+
 /// Takes a letter (a-z or A-Z) and makes it lowercase.
 inline char charLetterToLower(char ch) {
   return ch | 32;
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// A small LZ77 block compressor in the style of LZ4, tuned for fast
+/// decompression rather than for ratio.
+///
+/// A compressed block is a sequence of sequences. Each sequence starts with a
+/// token byte, whose high nibble is the number of literals and whose low
+/// nibble is the length of the match minus kMinMatch. A nibble of 15 is
+/// followed by extension bytes which are added to it, up to and including the
+/// first byte which is not 255. Then come the literals, the 16-bit little
+/// endian distance back to the start of the match, and the match length
+/// extension bytes. The last sequence has only literals and ends the block.
+//===----------------------------------------------------------------------===//
+
+#ifndef HERMES_SUPPORT_LZCOMPRESSION_H
+#define HERMES_SUPPORT_LZCOMPRESSION_H
+
+#include "llvm/ADT/ArrayRef.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace hermes {
+namespace lz {
+
+/// The length of the shortest match which is encoded as a match.
+constexpr size_t kMinMatch = 4;
+
+/// The farthest a match may be from the data that refers to it.
+constexpr size_t kMaxDistance = 0xffff;
+
+/// Compress \p input as a single block and append it to \p out.
+void compress(llvm::ArrayRef<uint8_t> input, std::vector<uint8_t> &out);
+
+/// Decompress the block \p input into \p out, which must be exactly as large
+/// as the uncompressed data.
+/// \return false if the block is malformed or does not decompress to exactly
+///   out.size() bytes. The contents of \p out are then unspecified.
+bool decompress(
+    llvm::ArrayRef<uint8_t> input,
+    llvm::MutableArrayRef<uint8_t> out);
+
+} // namespace lz
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_LZCOMPRESSION_H
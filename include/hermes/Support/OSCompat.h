@@ -101,9 +101,11 @@ enum class ProtectMode { ReadWrite, None };
 /// false on error.
 bool vm_protect(void *p, size_t sz, ProtectMode mode);
 
-/// Issue an madvise() call.
+/// Issue an madvise() call. Cold means that the pages are not expected to be
+/// used soon, and may be reclaimed without losing their contents. It is only
+/// supported by newer kernels.
 /// \return true on success, false on error.
-enum class MAdvice { Random, Sequential };
+enum class MAdvice { Random, Sequential, Cold };
 bool vm_madvise(void *p, size_t sz, MAdvice advice);
 
 /// Return the number of pages in the given region that are currently in RAM.
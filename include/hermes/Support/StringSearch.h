@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// Substring search over 8-bit and 16-bit code unit strings.
+///
+/// Single code units are found with memchr or SSE2. Longer needles are found
+/// by scanning for their first code unit and comparing the rest. If the first
+/// code unit of a long needle turns out to be frequent, we switch to
+/// Boyer-Moore-Horspool with a shift table indexed by the low byte of each
+/// code unit, which only makes shifts more conservative for 16-bit strings.
+//===----------------------------------------------------------------------===//
+
+#ifndef HERMES_SUPPORT_STRINGSEARCH_H
+#define HERMES_SUPPORT_STRINGSEARCH_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace hermes {
+
+/// Returned by the search functions when there is no match.
+constexpr size_t kSubstringNotFound = ~(size_t)0;
+
+namespace stringsearch {
+
+/// Needles at least this long are searched with Boyer-Moore-Horspool, if the
+/// haystack is long enough to amortize building its shift table.
+constexpr size_t kBMHMinNeedle = 8;
+constexpr size_t kBMHMinHaystack = 256;
+/// The number of false matches of the first code unit of a long needle after
+/// which we switch to Boyer-Moore-Horspool.
+constexpr size_t kMaxScanMisses = 16;
+
+/// \return the index of the first occurrence of \p c in [\p first, \p last),
+/// or \p last if there is none.
+inline const char *findUnit(const char *first, const char *last, char c) {
+  const void *res = std::memchr(first, c, last - first);
+  return res ? static_cast<const char *>(res) : last;
+}
+
+inline const char16_t *
+findUnit(const char16_t *first, const char16_t *last, char16_t c) {
+#ifdef __SSE2__
+  const __m128i needle = _mm_set1_epi16((short)c);
+  for (; last - first >= 8; first += 8) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi16(chunk, needle));
+    if (mask)
+      return first + llvm::countTrailingZeros(mask) / 2;
+  }
+#endif
+  for (; first != last; ++first) {
+    if (*first == c)
+      return first;
+  }
+  return last;
+}
+
+/// \return whether the \p n code units at \p a and \p b are equal.
+template <typename T>
+inline bool unitsEqual(const T *a, const T *b, size_t n) {
+  return std::memcmp(a, b, n * sizeof(T)) == 0;
+}
+
+/// Find \p needle in \p haystack, starting at \p from, for needles of at least
+/// two code units, by scanning for the first code unit of the needle.
+/// \param maxMisses if the first code unit matches without the rest of the
+///     needle matching this many times, give up.
+/// \param[out] resume if we gave up, the position from which the search
+///     must continue.
+template <typename T>
+size_t findScan(
+    llvm::ArrayRef<T> haystack,
+    llvm::ArrayRef<T> needle,
+    size_t from,
+    size_t maxMisses,
+    size_t &resume) {
+  const T *first = haystack.data() + from;
+  // The last position where the needle may start, plus one.
+  const T *lastStart = haystack.end() - needle.size() + 1;
+  const T head = needle[0];
+  while ((first = findUnit(first, lastStart, head)) != lastStart) {
+    if (unitsEqual(first + 1, needle.data() + 1, needle.size() - 1))
+      return first - haystack.data();
+    ++first;
+    if (--maxMisses == 0) {
+      resume = first - haystack.data();
+      return kSubstringNotFound;
+    }
+  }
+  resume = haystack.size();
+  return kSubstringNotFound;
+}
+
+/// Find \p needle in \p haystack, starting at \p from, with
+/// Boyer-Moore-Horspool.
+template <typename T>
+size_t
+findBMH(llvm::ArrayRef<T> haystack, llvm::ArrayRef<T> needle, size_t from) {
+  const size_t n = needle.size();
+  // shift[b] is how far we can move the needle when the haystack unit under
+  // its last unit has low byte b.
+  uint32_t shift[256];
+  std::fill(std::begin(shift), std::end(shift), n);
+  for (size_t i = 0; i + 1 < n; ++i)
+    shift[(uint8_t)needle[i]] = n - 1 - i;
+
+  const T tail = needle[n - 1];
+  for (size_t pos = from; pos + n <= haystack.size();) {
+    T last = haystack[pos + n - 1];
+    if (last == tail && unitsEqual(haystack.data() + pos, needle.data(), n - 1))
+      return pos;
+    pos += shift[(uint8_t)last];
+  }
+  return kSubstringNotFound;
+}
+
+/// Implementation of searchSubstring() for code units of the same type.
+template <typename T>
+size_t
+find(llvm::ArrayRef<T> haystack, llvm::ArrayRef<T> needle, size_t from) {
+  if (from > haystack.size() || needle.size() > haystack.size() - from)
+    return kSubstringNotFound;
+  if (needle.empty())
+    return from;
+  if (needle.size() == 1) {
+    const T *res = findUnit(haystack.data() + from, haystack.end(), needle[0]);
+    return res == haystack.end() ? kSubstringNotFound : res - haystack.data();
+  }
+  // Scanning for the first code unit is fastest unless it is frequent in the
+  // haystack, in which case long needles switch to Boyer-Moore-Horspool.
+  bool mayUseBMH = needle.size() >= kBMHMinNeedle &&
+      haystack.size() - from >= kBMHMinHaystack;
+  size_t resume;
+  size_t res = findScan(
+      haystack, needle, from, mayUseBMH ? kMaxScanMisses : SIZE_MAX, resume);
+  if (res != kSubstringNotFound || resume == haystack.size())
+    return res;
+  return findBMH(haystack, needle, resume);
+}
+
+/// Implementation of searchSubstringReverse() for code units of the same
+/// type.
+template <typename T>
+size_t
+findLast(llvm::ArrayRef<T> haystack, llvm::ArrayRef<T> needle, size_t before) {
+  if (needle.size() > haystack.size())
+    return kSubstringNotFound;
+  size_t pos = std::min(before, haystack.size() - needle.size());
+  if (needle.empty())
+    return pos;
+  const T head = needle[0];
+  for (const T *p = haystack.data() + pos;; --p) {
+    if (*p == head && unitsEqual(p + 1, needle.data() + 1, needle.size() - 1))
+      return p - haystack.data();
+    if (p == haystack.data())
+      return kSubstringNotFound;
+  }
+}
+
+/// Convert \p needle to code units of type \p T in \p storage.
+/// \return false if some code unit does not fit in \p T, so that the needle
+///     cannot occur in a string of \p T.
+template <typename T, typename U>
+bool convertNeedle(
+    llvm::ArrayRef<U> needle,
+    llvm::SmallVectorImpl<T> &storage) {
+  storage.reserve(needle.size());
+  for (U c : needle) {
+    auto unit = (typename std::make_unsigned<U>::type)c;
+    if (unit > (typename std::make_unsigned<T>::type)~0u)
+      return false;
+    storage.push_back((T)unit);
+  }
+  return true;
+}
+
+} // namespace stringsearch
+
+/// \return the index of the first occurrence of \p needle in \p haystack that
+///     starts at or after \p from, or kSubstringNotFound. An empty needle is
+///     found at \p from if it is not past the end of \p haystack.
+template <typename T>
+size_t searchSubstring(
+    llvm::ArrayRef<T> haystack,
+    llvm::ArrayRef<T> needle,
+    size_t from = 0) {
+  return stringsearch::find(haystack, needle, from);
+}
+
+/// Overload for a needle whose code units have a different width than those
+/// of the haystack.
+template <typename T, typename U>
+size_t searchSubstring(
+    llvm::ArrayRef<T> haystack,
+    llvm::ArrayRef<U> needle,
+    size_t from = 0) {
+  llvm::SmallVector<T, 32> converted;
+  if (!stringsearch::convertNeedle(needle, converted))
+    return kSubstringNotFound;
+  return stringsearch::find(haystack, llvm::makeArrayRef(converted), from);
+}
+
+/// \return the index of the last occurrence of \p needle in \p haystack that
+///     starts at or before \p before, or kSubstringNotFound.
+template <typename T>
+size_t searchSubstringReverse(
+    llvm::ArrayRef<T> haystack,
+    llvm::ArrayRef<T> needle,
+    size_t before) {
+  return stringsearch::findLast(haystack, needle, before);
+}
+
+/// Overload for a needle whose code units have a different width than those
+/// of the haystack.
+template <typename T, typename U>
+size_t searchSubstringReverse(
+    llvm::ArrayRef<T> haystack,
+    llvm::ArrayRef<U> needle,
+    size_t before) {
+  llvm::SmallVector<T, 32> converted;
+  if (!stringsearch::convertNeedle(needle, converted))
+    return kSubstringNotFound;
+  return stringsearch::findLast(
+      haystack, llvm::makeArrayRef(converted), before);
+}
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_STRINGSEARCH_H
@@ -14,6 +14,7 @@
 #include "llvm/Support/Compiler.h"
 
 #include <cstddef>
+#include <string>
 
 namespace hermes {
 
@@ -58,6 +59,23 @@ inline bool isAllASCII(const char *start, const char *end) {
   return isAllASCII((const uint8_t *)start, (const uint8_t *)end);
 }
 
+/// Overload for UTF-16 code units.
+bool isAllASCII(const char16_t *start, const char16_t *end);
+
+/// \return the number of leading ASCII characters in [\p start, \p end).
+/// These and the functions below process many characters at a time with SSE2
+/// or AVX2 when available, so they should be preferred to loops over single
+/// characters for bulk conversions.
+size_t countASCIIPrefix(const uint8_t *start, const uint8_t *end);
+size_t countASCIIPrefix(const char16_t *start, const char16_t *end);
+
+/// Widen the \p length ASCII characters at \p src to UTF-16 at \p dst.
+void convertASCIIToUTF16(char16_t *dst, const char *src, size_t length);
+
+/// Narrow the \p length UTF-16 code units at \p src, which must all be
+/// ASCII, to \p dst.
+void convertUTF16ToASCII(char *dst, const char16_t *src, size_t length);
+
 /// Decode a sequence of UTF8 encoded bytes when it is known that the first byte
 /// is a start of an UTF8 sequence.
 /// \param allowSurrogates when false, values in the surrogate range are
@@ -206,10 +224,16 @@ inline OutIt convertUTF8WithSurrogatesToUTF16(
     OutIt dest,
     const char *begin8,
     const char *end8) {
-  while (begin8 < end8)
+  while (begin8 < end8) {
+    // Most strings are mostly ASCII, which needs no decoding.
+    if (LLVM_LIKELY((unsigned char)*begin8 < 0x80)) {
+      *dest++ = (unsigned char)*begin8++;
+      continue;
+    }
     encodeUTF16(dest, decodeUTF8<true>(begin8, [](const llvm::Twine &) {
                   llvm_unreachable("invalid UTF-8");
                 }));
+  }
   return dest;
 }
 
@@ -223,6 +247,15 @@ void convertUTF16ToUTF8WithSingleSurrogates(
     std::string &dest,
     llvm::ArrayRef<char16_t> input);
 
+/// Convert a UTF-8 encoded string \p input to UTF-16 stored in \p dest,
+/// replacing each maximal invalid subsequence (as defined by the Unicode
+/// standard and the WHATWG Encoding spec) with the Unicode replacement
+/// character. Encoded surrogates are invalid.
+/// \return true if \p input was valid UTF-8.
+bool convertUTF8ToUTF16WithReplacements(
+    std::u16string &dest,
+    llvm::ArrayRef<uint8_t> input);
+
 /// Convert a UTF-16 encoded string \p input to UTF-8 stored in \p dest,
 /// replacing unpaired surrogates halves with the Unicode replacement character.
 /// \param maxCharacters If non-zero, the maximum number of characters to
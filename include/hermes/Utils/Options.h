@@ -8,6 +8,9 @@
 #ifndef HERMES_UTILS_OPTIONS_H
 #define HERMES_UTILS_OPTIONS_H
 
+#include <cstdint>
+#include <vector>
+
 namespace hermes {
 
 enum OutputFormatKind {
@@ -54,6 +57,19 @@ struct BytecodeGenerationOptions {
   /// Add this much garbage after each function body (relative to its size).
   unsigned padFunctionBodiesPercent = 0;
 
+  /// IDs of the functions whose bodies should be laid out first in the
+  /// bytecode file, in this order. The other functions follow in ID order.
+  std::vector<uint32_t> functionOrder{};
+
+  /// Compress function bodies and debug info, which are then decompressed
+  /// when first used.
+  bool compressBytecode = false;
+
+  /// Fuse common sequences of instructions, like loading a method and calling
+  /// it, into single instructions to reduce the size of the bytecode. This
+  /// only applies to calls lowered when optimizing.
+  bool fuseInstructions = false;
+
   /* implicit */ BytecodeGenerationOptions(OutputFormatKind format)
       : format(format) {}
 
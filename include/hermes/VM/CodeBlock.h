@@ -387,10 +387,10 @@ class CodeBlock final
 };
 
 #ifndef HERMESVM_LEAN
-/// Compiles a lazy Function into a separate BytecodeModule. The module will
-/// in turn generate other lazy functions.
+/// Compiles a lazy function into a separate BytecodeModule. The module will
+/// in turn generate other lazy functions. May be called on any thread.
 std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
-    Function *lazyFunction);
+    hbc::LazyCompilationData *lazyData);
 #endif
 
 } // namespace vm
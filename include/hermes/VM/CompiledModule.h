@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_COMPILEDMODULE_H
+#define HERMES_VM_COMPILEDMODULE_H
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/Support/OptValue.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+class BytecodeFunction;
+class BytecodeModule;
+} // namespace hbc
+
+namespace vm {
+
+using StringID = uint32_t;
+
+/// The parts of a loaded bytecode module which don't depend on the runtime
+/// running it: the bytecode itself, the tables derived from it, and the
+/// modules compiled from its lazy functions.
+///
+/// A CompiledModule can be created once and run by any number of runtimes,
+/// on any thread. Each runtime then only keeps the mutable parts in its
+/// RuntimeModule: the SymbolIDs of the strings, and the CodeBlocks with
+/// their inline caches.
+class CompiledModule {
+ public:
+  /// Create a module for \p bytecode, which must not be lazy.
+  static std::shared_ptr<CompiledModule> create(
+      std::shared_ptr<hbc::BCProvider> bytecode);
+
+#ifndef HERMESVM_LEAN
+  /// Create a lazy module for the function \p functionID of \p parent,
+  /// which is compiled on first use by compileLazy().
+  static std::shared_ptr<CompiledModule> createLazy(
+      std::shared_ptr<CompiledModule> parent,
+      uint32_t functionID);
+
+  /// A function which compiles a lazy function to a new bytecode module.
+  using LazyCompiler = llvm::function_ref<std::unique_ptr<hbc::BytecodeModule>(
+      hbc::BytecodeFunction *)>;
+
+  /// \return the module compiled from the function of this lazy module. It
+  /// is compiled with \p compile unless a runtime has compiled it already,
+  /// so that each lazy function is compiled once for all runtimes.
+  std::shared_ptr<CompiledModule> compileLazy(LazyCompiler compile);
+
+  /// \return whether the lazy function \p functionID of this module has been
+  /// compiled by compileLazy().
+  bool isLazyFunctionCompiled(uint32_t functionID);
+#endif
+
+  hbc::BCProvider *getBytecode() const {
+    return bcProvider_.get();
+  }
+
+  const std::shared_ptr<hbc::BCProvider> &getBytecodeSharedPtr() const {
+    return bcProvider_;
+  }
+
+  /// \return the precomputed hash of the identifier \p stringID, or None if
+  ///   it is not an identifier.
+  OptValue<uint32_t> getIdentifierHash(StringID stringID) const;
+
+  /// Called by every runtime which loads this module.
+  /// \return true for the first call only, which should apply any advice
+  ///   about the pages of the bytecode, since they are shared.
+  bool markLoaded() {
+    return !loaded_.exchange(true);
+  }
+
+ private:
+  explicit CompiledModule(std::shared_ptr<hbc::BCProvider> bytecode);
+
+  /// Populate \c identifierRuns_ from the string kinds of the bytecode.
+  void initializeIdentifierRuns();
+
+  /// A run of consecutive identifiers in the string table.
+  struct IdentifierRun {
+    /// The string ID of the first identifier in the run.
+    StringID firstStringID;
+    /// The number of identifiers in the run.
+    uint32_t count;
+    /// The index of the precomputed hash of the first identifier in the
+    /// identifier translations of the bytecode.
+    uint32_t firstTranslation;
+  };
+
+  /// The bytecode of the module.
+  std::shared_ptr<hbc::BCProvider> bcProvider_;
+
+  /// The runs of identifiers in the string table, ordered by string ID. They
+  /// are used to find the precomputed hash of an identifier which is
+  /// interned lazily.
+  std::vector<IdentifierRun> identifierRuns_{};
+
+  /// Whether a runtime has loaded this module.
+  std::atomic<bool> loaded_{false};
+
+#ifndef HERMESVM_LEAN
+  /// For lazy modules, the module containing the function, and its ID there.
+  std::shared_ptr<CompiledModule> lazyParent_{};
+  uint32_t lazyFunctionID_{0};
+
+  /// Protects lazyFunctions_, and is held while one of them is compiled.
+  std::mutex lazyFunctionsMutex_{};
+
+  /// The modules compiled from the lazy functions of this module, by
+  /// function ID.
+  llvm::DenseMap<uint32_t, std::shared_ptr<CompiledModule>> lazyFunctions_{};
+#endif
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_COMPILEDMODULE_H
@@ -156,6 +156,12 @@ class Deserializer {
     lookupRelocation(hv, relo_id, RelocationKind::HermesValue);
   }
 
+  /// \return the number of forward references waiting to be updated by
+  /// flushRelocationQueue().
+  size_t getNumForwardReferences() const {
+    return relocationQueue_.size();
+  }
+
   /// Called at the end of deserialization. Because every entity has been
   /// deserialized at this point, we should be able to update prior forward
   /// references that we were not able to update before.
@@ -288,7 +294,7 @@ class Deserializer {
   Runtime *runtime_;
 
   /// A queue to remember forward references we see during deserialization.
-  std::deque<RelocationEntry> relocationQueue_;
+  std::vector<RelocationEntry> relocationQueue_;
 
   /// A MemoryBuffer that holds the serialized data and where we read from.
   std::shared_ptr<const llvm::MemoryBuffer> buffer_;
@@ -413,9 +413,13 @@ class IdentifierTable {
   template <typename T>
   SymbolID registerLazyIdentifierImpl(llvm::ArrayRef<T> str, uint32_t hash);
 
-  /// Allocate a new SymbolID, and set it to \p str. Update the hash table
-  /// location \p hashTableIndex with the ID. \return the new ID.
-  uint32_t allocIDAndInsert(uint32_t hashTableIndex, StringPrimitive *str);
+  /// Allocate a new SymbolID, and set it to \p str, whose hash is \p hash.
+  /// Update the hash table location \p hashTableIndex with the ID.
+  /// \return the new ID.
+  uint32_t allocIDAndInsert(
+      uint32_t hashTableIndex,
+      StringPrimitive *str,
+      uint32_t hash);
 
   /// Free the symbol with the specified index \p index.
   /// The specified symbol must be a valid one (not previously freed).
@@ -25,11 +25,18 @@ using x86_64::JITContext;
 #include "hermes/VM/CodeBlock.h"
 
 namespace hermes {
+namespace regex {
+struct NativeMatcher;
+} // namespace regex
+
 namespace vm {
 
 /// All state related to JIT compilation.
 class JITContext {
  public:
+  /// The number of searches with a regex after which we compile it.
+  static constexpr uint32_t REGEX_COMPILE_THRESHOLD = 100;
+
   /// Construct a JIT context. No executable memory is allocated before it is
   /// needed.
   /// \param enable whether JIT is enabled.
@@ -52,6 +59,12 @@ class JITContext {
     return codeBlock->getJITCompiled();
   }
 
+  /// Compile the regex \p bytecode to native code.
+  /// \return the native matcher, or nullptr if the regex cannot be compiled.
+  const regex::NativeMatcher *compileRegex(llvm::ArrayRef<uint8_t> bytecode) {
+    return nullptr;
+  }
+
   /// \return true if JIT compilation is enabled.
   bool isEnabled() const {
     return false;
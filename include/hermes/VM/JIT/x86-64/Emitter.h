@@ -618,6 +618,28 @@ class Emitter {
         out, srcBase, srcIndex, srcOffset, ord(dst));
   }
 
+  /// Load a byte (\p s == S::B) or word (\p s == S::W) and zero extend it to
+  /// the 32-bit register \p dst.
+  template <S s, unsigned scale = 0>
+  void movzxRMToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
+    static_assert(s == S::B || s == S::W, "only S::B and S::W supported");
+    emitREX<S::L>(out, srcBase, srcIndex, ord(dst));
+    *out++ = 0x0F;
+    *out++ = s == S::B ? 0xB6 : 0xB7;
+    EmitModRM<S::L, 0, scale>::emitModRM(
+        out, srcBase, srcIndex, srcOffset, ord(dst));
+  }
+
+  template <S s>
+  void cmpRegToReg(Reg src, Reg dst) {
+    _opRegToRM<s, ScaleRegAccess, 0x38>(src, dst, Reg::NoIndex, 0);
+  }
+
+  template <S s>
+  void subRegFromReg(Reg src, Reg dst) {
+    _opRegToRM<s, ScaleRegAccess, 0x28>(src, dst, Reg::NoIndex, 0);
+  }
+
   template <S s, unsigned scale = 0>
   void cmpImmToRM(
       typename OperandType<s>::type imm,
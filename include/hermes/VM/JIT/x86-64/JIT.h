@@ -8,10 +8,13 @@
 #ifndef HERMES_VM_JIT_X86_64_JIT_H
 #define HERMES_VM_JIT_X86_64_JIT_H
 
+#include "hermes/Regex/Executor.h"
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/JIT/ExecHeap.h"
 #include "hermes/VM/JIT/NativeDisassembler.h"
 
+#include "llvm/ADT/StringMap.h"
+
 namespace hermes {
 namespace vm {
 namespace x86_64 {
@@ -19,6 +22,9 @@ namespace x86_64 {
 /// All state related to JIT compilation.
 class JITContext {
  public:
+  /// The number of searches with a regex after which we compile it.
+  static constexpr uint32_t REGEX_COMPILE_THRESHOLD = 100;
+
   /// Construct a JIT context. No executable memory is allocated before it is
   /// needed.
   /// \param enable whether JIT is enabled.
@@ -37,6 +43,11 @@ class JITContext {
   /// be compiled, return nullptr.
   inline JITCompiledFunctionPtr compile(Runtime *runtime, CodeBlock *codeBlock);
 
+  /// Compile the regex \p bytecode to native code. Regexes with identical
+  /// bytecode share their native code, which lives as long as this context.
+  /// \return the native matcher, or nullptr if the regex cannot be compiled.
+  const regex::NativeMatcher *compileRegex(llvm::ArrayRef<uint8_t> bytecode);
+
   /// \return true if JIT compilation is enabled.
   bool isEnabled() const {
     return enabled_;
@@ -96,6 +107,10 @@ class JITContext {
   std::unique_ptr<NativeDisassembler> dis_ =
       NativeDisassembler::create(NativeDisassembler::x86_64_unknown_linux_gnu);
 
+  /// Native code of compiled regexes keyed by their bytecode. Regexes which
+  /// cannot be compiled map to a null matcher.
+  llvm::StringMap<regex::NativeMatcher> regexCache_{};
+
   /// The JIT compile threshold for function execution count
   static constexpr uint32_t COMPILE_THRESHOLD = 0;
 };
@@ -15,6 +15,22 @@
 namespace hermes {
 namespace vm {
 
+/// Describes the elements in the indexed storage of an ArrayImpl, ordered from
+/// the most to the least specific kind. The packed kinds guarantee that there
+/// are no holes (empty values) in the storage. The kind of the values only
+/// becomes less specific as values are stored, but an array becomes packed
+/// again as soon as all of its holes have been filled.
+enum class ElementsKind : uint8_t {
+  /// No holes, and every element is a number with an int32 value (not -0).
+  PackedInt,
+  /// No holes, and every element is a number.
+  PackedDouble,
+  /// No holes.
+  PackedAny,
+  /// There may be holes.
+  Holey,
+};
+
 /// A common implementation of "Array-like" objects.
 class ArrayImpl : public JSObject {
   using Super = JSObject;
@@ -81,9 +97,10 @@ class ArrayImpl : public JSObject {
     assert(
         index >= self->beginIndex_ && index < self->endIndex_ &&
         "array index out of range");
-    self->indexedStorage_.getNonNull(runtime)
-        ->at(index - self->beginIndex_)
-        .set(value, &runtime->getHeap());
+    auto &elem = self->indexedStorage_.getNonNull(runtime)->at(
+        index - self->beginIndex_);
+    self->updateElementsKind(elem, value);
+    elem.set(value, &runtime->getHeap());
   }
 
   /// Set the element at index \p index to empty. This does not affect the
@@ -106,6 +123,12 @@ class ArrayImpl : public JSObject {
     return endIndex_;
   }
 
+  /// \return the kind of the elements in the storage range
+  /// [getBeginIndex(), getEndIndex()).
+  ElementsKind getElementsKind() const {
+    return numHoles_ ? ElementsKind::Holey : valuesKind_;
+  }
+
   /// Return the value at index \p index, or \c empty if the index is not
   /// contained in the storage.
   const HermesValue at(Runtime *runtime, size_type index) const {
@@ -230,9 +253,44 @@ class ArrayImpl : public JSObject {
   uint32_t beginIndex_{0};
   /// One past the last index contained in the storage.
   uint32_t endIndex_{0};
+  /// The number of empty values in the storage.
+  uint32_t numHoles_{0};
+  /// The most specific packed kind describing every non-empty value that was
+  /// stored since the storage was last empty.
+  ElementsKind valuesKind_{ElementsKind::PackedInt};
   /// The indexed property storage. It can be nullptr, if both its capacity and
   /// size are 0.
   GCPointer<StorageType> indexedStorage_;
+
+  /// Update the elements kind before \p value replaces \p old in the storage.
+  void updateElementsKind(HermesValue old, HermesValue value) {
+    if (LLVM_UNLIKELY(value.isEmpty())) {
+      if (!old.isEmpty())
+        ++numHoles_;
+      return;
+    }
+    if (old.isEmpty()) {
+      assert(numHoles_ && "storing into a hole that was not counted");
+      --numHoles_;
+    }
+    if (LLVM_LIKELY(valuesKind_ == ElementsKind::PackedAny))
+      return;
+    if (!value.isNumber()) {
+      valuesKind_ = ElementsKind::PackedAny;
+    } else if (valuesKind_ == ElementsKind::PackedInt) {
+      double d = value.getNumber();
+      if (truncateToInt32(d) != d || (d == 0 && std::signbit(d)))
+        valuesKind_ = ElementsKind::PackedDouble;
+    }
+  }
+
+  /// Update the elements kind when the storage is resized from \p oldSize to
+  /// \p newSize elements. Must be called before shrinking the storage, so the
+  /// holes being removed can be counted.
+  void updateElementsKindForResize(
+      Runtime *runtime,
+      uint32_t oldSize,
+      uint32_t newSize);
 };
 
 class Arguments final : public ArrayImpl {
@@ -302,6 +360,15 @@ class JSArray final : public ArrayImpl {
     return self->shadowLength_;
   }
 
+  /// \return true if all elements [0, length) of the array are present in its
+  /// indexed storage, so they can be read without checking for holes or
+  /// walking the prototype chain.
+  static bool isPacked(const JSArray *self) {
+    return self->hasFastIndexProperties() &&
+        self->getElementsKind() != ElementsKind::Holey &&
+        self->getBeginIndex() == 0 && self->getEndIndex() == getLength(self);
+  }
+
   /// Create an instance of Array, with [[Prototype]] initialized with
   /// \p prototypeHandle, with capacity for \p capacity elements and actual size
   /// \p length.
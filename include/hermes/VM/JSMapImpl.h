@@ -61,19 +61,20 @@ class JSMapImpl final : public JSObject {
     return static_cast<bool>(storage_);
   }
 
-  /// Advance iterator and return the next.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry) {
-    return storage_.get(runtime)->iteratorNext(runtime, entry);
+  /// Advance the iteration cursor (\p table, \p index) to the next entry.
+  /// See OrderedHashMap::iteratorNext.
+  bool iteratorNext(Runtime *runtime, SegmentedArray *&table, uint32_t &index) {
+    return storage_.get(runtime)->iteratorNext(runtime, table, index);
   }
 
   /// Add a value.
-  static void addValue(
+  static ExecutionStatus addValue(
       Handle<JSMapImpl> self,
       Runtime *runtime,
       Handle<> key,
       Handle<> value) {
     self->assertInitialized();
-    OrderedHashMap::insert(
+    return OrderedHashMap::insert(
         runtime->makeHandle<OrderedHashMap>(self->storage_),
         runtime,
         key,
@@ -109,9 +110,10 @@ class JSMapImpl final : public JSObject {
   }
 
   /// Clear all elements from the storage.
-  static void clear(Handle<JSMapImpl> self, Runtime *runtime) {
+  static ExecutionStatus clear(Handle<JSMapImpl> self, Runtime *runtime) {
     self->assertInitialized();
-    self->storage_.get(runtime)->clear(runtime);
+    return OrderedHashMap::clear(
+        runtime->makeHandle<OrderedHashMap>(self->storage_), runtime);
   }
 
   /// Call \p callbackfn for each entry, with \p thisArg as this.
@@ -121,12 +123,19 @@ class JSMapImpl final : public JSObject {
       Handle<Callable> callbackfn,
       Handle<> thisArg) {
     self->assertInitialized();
-    MutableHandle<HashMapEntry> entry{runtime};
-    for (entry = self->storage_.get(runtime)->iteratorNext(runtime); entry;
-         entry =
-             self->storage_.get(runtime)->iteratorNext(runtime, entry.get())) {
-      HermesValue key = entry->key;
-      HermesValue value = entry->value;
+    // The table is kept in a handle since the callback may mutate the map
+    // and trigger GC. iteratorNext follows any rehash of the table.
+    MutableHandle<SegmentedArray> table{runtime};
+    uint32_t index = 0;
+    while (true) {
+      SegmentedArray *rawTable = table.get();
+      if (!self->iteratorNext(runtime, rawTable, index)) {
+        break;
+      }
+      table = rawTable;
+      HermesValue key = OrderedHashMap::getKey(rawTable, index);
+      HermesValue value = OrderedHashMap::getValue(rawTable, index);
+      ++index;
       assert(!key.isEmpty() && "Invalid key encountered");
       assert(!value.isEmpty() && "Invalid value encountered");
       if (LLVM_UNLIKELY(
@@ -215,18 +224,17 @@ class JSMapIteratorImpl final : public JSObject {
       // Iteration has not yet reached the end previously.
       assert(self->data_ && "Storage uninitialized");
       // Advance the iterator.
-      self->itr_.set(
-          runtime,
-          self->data_.get(runtime)->iteratorNext(
-              runtime, self->itr_.get(runtime)),
-          &runtime->getHeap());
-      if (self->itr_) {
+      SegmentedArray *table = self->table_.get(runtime);
+      uint32_t index = self->index_;
+      if (self->data_.get(runtime)->iteratorNext(runtime, table, index)) {
+        self->table_.set(runtime, table, &runtime->getHeap());
+        self->index_ = index + 1;
         switch (self->iterationKind_) {
           case IterationKind::Key:
-            value = self->itr_.get(runtime)->key;
+            value = OrderedHashMap::getKey(table, index);
             break;
           case IterationKind::Value:
-            value = self->itr_.get(runtime)->value;
+            value = OrderedHashMap::getValue(table, index);
             break;
           case IterationKind::Entry: {
             // If we are iterating both key and value, we need to create an
@@ -236,9 +244,12 @@ class JSMapIteratorImpl final : public JSObject {
               return ExecutionStatus::EXCEPTION;
             }
             auto arrHandle = toHandle(runtime, std::move(*arrRes));
-            value = self->itr_.get(runtime)->key;
+            // Reload the table, the allocation may have moved it.
+            table = self->table_.get(runtime);
+            value = OrderedHashMap::getKey(table, index);
             JSArray::setElementAt(arrHandle, runtime, 0, value);
-            value = self->itr_.get(runtime)->value;
+            table = self->table_.get(runtime);
+            value = OrderedHashMap::getValue(table, index);
             JSArray::setElementAt(arrHandle, runtime, 1, value);
             value = arrHandle.getHermesValue();
             break;
@@ -252,6 +263,7 @@ class JSMapIteratorImpl final : public JSObject {
         // reached the end.
         self->iterationFinished_ = true;
         self->data_ = nullptr;
+        self->table_ = nullptr;
       }
     }
     return createIterResultObject(runtime, value, self->iterationFinished_)
@@ -281,8 +293,12 @@ class JSMapIteratorImpl final : public JSObject {
   /// initialized or the iteration has ended.
   GCPointer<JSMapImpl<JSMapTypeTraits<C>::ContainerKind>> data_{nullptr};
 
-  /// Iteration pointer to the element storage in the Map.
-  GCPointer<HashMapEntry> itr_{nullptr};
+  /// The table of the Map storage that the iteration cursor refers to, or
+  /// nullptr if the iteration has not started.
+  GCPointer<SegmentedArray> table_{nullptr};
+
+  /// Index of the next entry to visit in table_.
+  uint32_t index_{0};
 
   IterationKind iterationKind_;
 
@@ -327,6 +327,10 @@ class JSObject : public GCCell {
   /// Number of property slots allocated directly inside the object.
   static const PropStorage::size_type DIRECT_PROPERTY_SLOTS = 6;
 
+  /// Largest number of property slots allocated directly inside a plain
+  /// object, see JSObjectWithSlots.
+  static const PropStorage::size_type MAX_DIRECT_PROPERTY_SLOTS = 24;
+
   static bool classof(const GCCell *cell) {
     return kindInRange(
         cell->getKind(), CellKind::ObjectKind_first, CellKind::ObjectKind_last);
@@ -338,6 +342,14 @@ class JSObject : public GCCell {
       Runtime *runtime,
       Handle<JSObject> parentHandle);
 
+  /// Attempts to allocate a JSObject with the given prototype and room for at
+  /// least \p directSlots properties inside the object itself.
+  /// If allocation fails, the GC declares an OOM.
+  static PseudoHandle<JSObject> create(
+      Runtime *runtime,
+      Handle<JSObject> parentHandle,
+      PropStorage::size_type directSlots);
+
   /// Attempts to allocate a JSObject with the standard Object prototype.
   /// If allocation fails, the GC declares an OOM.
   static PseudoHandle<JSObject> create(Runtime *runtime);
@@ -402,6 +414,24 @@ class JSObject : public GCCell {
     return flags_.hostObject;
   }
 
+  /// \return true if all indexed properties of this object are stored in its
+  /// indexed storage, so that they can be accessed directly.
+  bool hasFastIndexProperties() const {
+    return flags_.fastIndexProperties;
+  }
+
+  /// \return the number of property slots allocated directly inside this
+  /// object. Slots past this number live in the separate property storage.
+  PropStorage::size_type getNumDirectSlots() const {
+    return numDirectSlots_;
+  }
+
+  /// \return the number of property slots to allocate directly inside new
+  /// objects constructed with this object as their prototype.
+  PropStorage::size_type getInstanceSlotsHint() const {
+    return instanceSlotsHint_;
+  }
+
   /// \return the `__proto__` internal property, which may be nullptr.
   JSObject *getParent(Runtime *runtime) const {
     return parent_.get(runtime);
@@ -1031,6 +1061,29 @@ class JSObject : public GCCell {
     return reinterpret_cast<const ObjectVTable *>(GCCell::getVT());
   }
 
+  /// \return the direct property slot \p index, which must be less than
+  /// \c numDirectSlots_.
+  GCHermesValue &directSlotRef(SlotIndex index) {
+    assert(index < numDirectSlots_ && "Not a direct property slot");
+    if (LLVM_LIKELY(index < DIRECT_PROPERTY_SLOTS))
+      return directProps_[index];
+    return extraDirectSlots()[index - DIRECT_PROPERTY_SLOTS];
+  }
+
+  /// \return the direct property slots after the first
+  /// DIRECT_PROPERTY_SLOTS, which are declared by the size class of the
+  /// object. It must be a JSObjectWithSlots.
+  inline GCHermesValue *extraDirectSlots();
+
+  /// Allocate a plain object of the smallest size class with room for
+  /// \p directSlots properties inside the object. If allocation fails, the GC
+  /// declares an OOM.
+  static JSObject *allocatePlainObject(
+      Runtime *runtime,
+      JSObject *parent,
+      HiddenClass *clazz,
+      PropStorage::size_type directSlots);
+
   /// Allocate storage for a new slot after the slot index itself has been
   /// allocated by the hidden class.
   /// Note that slot storage is never truly released once allocated. Released
@@ -1152,6 +1205,19 @@ class JSObject : public GCCell {
   /// Flags affecting the entire object.
   ObjectFlags flags_{};
 
+  /// Number of property slots stored directly inside the object. It is
+  /// DIRECT_PROPERTY_SLOTS for everything except the larger plain object size
+  /// classes, which store the slots past those in \c directProps_ in their
+  /// own fields.
+  uint8_t numDirectSlots_{DIRECT_PROPERTY_SLOTS};
+
+  /// The largest number of property slots observed on a plain object having
+  /// this object as its prototype, capped at MAX_DIRECT_PROPERTY_SLOTS. It is
+  /// used to size objects created by [[Construct]], so that once a
+  /// constructor's instances are known to outgrow the default inline slots,
+  /// later instances are allocated large enough to hold all their properties.
+  uint8_t instanceSlotsHint_{0};
+
   /// The prototype of this object.
   GCPointer<JSObject> parent_;
 
@@ -1162,10 +1228,80 @@ class JSObject : public GCCell {
   /// Storage for property values.
   GCPointer<PropStorage> propStorage_{};
 
-  /// Storage for direct property slots.
+  /// Storage for the first DIRECT_PROPERTY_SLOTS direct property slots.
   GCHermesValue directProps_[DIRECT_PROPERTY_SLOTS];
 };
 
+/// A plain object with room for \p N properties inside the object itself,
+/// instead of the usual JSObject::DIRECT_PROPERTY_SLOTS. Objects whose number
+/// of properties is known or predicted when they are created, like object
+/// literals and instances of constructors, are allocated using the smallest
+/// size class that fits, so that all their properties are stored in a single
+/// allocation. Apart from that, they behave exactly like a JSObject.
+template <PropStorage::size_type N, CellKind C>
+class JSObjectWithSlots final : public JSObject {
+  static_assert(
+      N > DIRECT_PROPERTY_SLOTS && N <= MAX_DIRECT_PROPERTY_SLOTS,
+      "size class must be larger than JSObject");
+
+ public:
+#ifdef HERMESVM_SERIALIZE
+  /// A constructor used by deserialization which performs no GC allocation.
+  explicit JSObjectWithSlots(Deserializer &d);
+
+  static void serializeExtraSlots(Serializer &s, const GCCell *cell);
+#endif
+
+  static ObjectVTable vt;
+
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == C;
+  }
+
+  /// Allocate an object of this size class. If allocation fails, the GC
+  /// declares an OOM.
+  static JSObjectWithSlots *
+  create(Runtime *runtime, JSObject *parent, HiddenClass *clazz);
+
+  /// Add the extra direct property slots of \p cell to \p mb.
+  static void buildExtraSlotsMeta(const GCCell *cell, Metadata::Builder &mb);
+
+  /// \return the direct property slots following JSObject::directProps_.
+  GCHermesValue *getExtraSlots() {
+    return extraProps_;
+  }
+
+ private:
+  JSObjectWithSlots(Runtime *runtime, JSObject *parent, HiddenClass *clazz)
+      : JSObject(
+            runtime,
+            &vt.base,
+            parent,
+            clazz,
+            GCPointerBase::NoBarriers()) {
+    numDirectSlots_ = N;
+  }
+
+  /// The direct property slots following JSObject::directProps_.
+  GCHermesValue extraProps_[N - DIRECT_PROPERTY_SLOTS];
+};
+
+#define OBJECT_SIZE_CLASS(slots)                                   \
+  using JSObjectWith##slots##Slots =                               \
+      JSObjectWithSlots<slots, CellKind::ObjectWith##slots##Slots##Kind>;
+#include "hermes/VM/ObjectSizeClasses.def"
+
+inline GCHermesValue *JSObject::extraDirectSlots() {
+  switch (getKind()) {
+#define OBJECT_SIZE_CLASS(slots)                 \
+  case CellKind::ObjectWith##slots##Slots##Kind: \
+    return static_cast<JSObjectWith##slots##Slots *>(this)->getExtraSlots();
+#include "hermes/VM/ObjectSizeClasses.def"
+    default:
+      llvm_unreachable("Only larger size classes have extra direct slots");
+  }
+}
+
 /// \return an array that contains all enumerable properties of obj (including
 /// those of its prototype etc.) at the indices [beginIndex, endIndex) (any
 /// other part of the array is implementation-defined).
@@ -1235,11 +1371,11 @@ inline ExecutionStatus JSObject::allocatePropStorage(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
     PropStorage::size_type size) {
-  if (LLVM_LIKELY(size <= DIRECT_PROPERTY_SLOTS))
+  const PropStorage::size_type numDirect = selfHandle->numDirectSlots_;
+  if (LLVM_LIKELY(size <= numDirect))
     return ExecutionStatus::RETURNED;
 
-  auto res = PropStorage::create(
-      runtime, size - DIRECT_PROPERTY_SLOTS, size - DIRECT_PROPERTY_SLOTS);
+  auto res = PropStorage::create(runtime, size - numDirect, size - numDirect);
   if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
 
@@ -1252,7 +1388,7 @@ inline CallResult<PseudoHandle<JSObject>> JSObject::allocatePropStorage(
     PseudoHandle<JSObject> self,
     Runtime *runtime,
     PropStorage::size_type size) {
-  if (LLVM_LIKELY(size <= DIRECT_PROPERTY_SLOTS))
+  if (LLVM_LIKELY(size <= self->numDirectSlots_))
     return self;
 
   auto selfHandle = toHandle(runtime, std::move(self));
@@ -1276,11 +1412,11 @@ inline T *JSObject::allocateSmallPropStorage(T *self) {
 template <PropStorage::Inline inl>
 inline GCHermesValue &
 JSObject::namedSlotRef(JSObject *self, PointerBase *runtime, SlotIndex index) {
-  if (LLVM_LIKELY(index < DIRECT_PROPERTY_SLOTS))
-    return self->directProps_[index];
+  if (LLVM_LIKELY(index < self->numDirectSlots_))
+    return self->directSlotRef(index);
 
   return self->propStorage_.getNonNull(runtime)->at<inl>(
-      index - DIRECT_PROPERTY_SLOTS);
+      index - self->numDirectSlots_);
 }
 
 template <PropStorage::Inline inl>
@@ -1292,11 +1428,11 @@ inline void JSObject::setNamedSlotValue(
   // NOTE: even though it is tempting to implement this in terms of assignment
   // to namedSlotRef(), it is a slight performance regression, which is not
   // entirely unexpected.
-  if (LLVM_LIKELY(index < DIRECT_PROPERTY_SLOTS))
-    return self->directProps_[index].set(value, &runtime->getHeap());
+  if (LLVM_LIKELY(index < self->numDirectSlots_))
+    return self->directSlotRef(index).set(value, &runtime->getHeap());
 
   self->propStorage_.get(runtime)
-      ->at<inl>(index - DIRECT_PROPERTY_SLOTS)
+      ->at<inl>(index - self->numDirectSlots_)
       .set(value, &runtime->getHeap());
 }
 
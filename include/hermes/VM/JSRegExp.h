@@ -8,8 +8,8 @@
 #ifndef HERMES_VM_JSREGEXP_H
 #define HERMES_VM_JSREGEXP_H
 
-#include "hermes/VM/CopyableVector.h"
 #include "hermes/VM/JSObject.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/SmallXString.h"
 
@@ -17,6 +17,10 @@
 #include "llvm/ADT/SmallString.h"
 
 namespace hermes {
+namespace regex {
+struct NativeMatcher;
+} // namespace regex
+
 namespace vm {
 
 class JSRegExp final : public JSObject {
@@ -123,10 +127,27 @@ class JSRegExp final : public JSObject {
   JSRegExp(Runtime *runtime, JSObject *parent, HiddenClass *clazz)
       : JSObject(runtime, &vt.base, parent, clazz) {}
 
-  CopyableVector<uint8_t> bytecode_;
+  /// The compiled regex, which may be shared with the RegExpCache and other
+  /// RegExps with the same source. Null until the RegExp is initialized.
+  RegExpCache::Bytecode bytecode_;
+
+  /// \return whether this RegExp is the only owner of its bytecode. Shared
+  /// bytecode is accounted for by the RegExpCache instead, so that it is
+  /// counted once.
+  bool ownsBytecode() const {
+    return bytecode_ && bytecode_.use_count() == 1;
+  }
 
   FlagBits flagBits_ = {};
 
+  /// The number of searches with this regex, counted until it is compiled to
+  /// native code.
+  uint32_t searchCount_ = 0;
+
+  /// The native code of the bytecode, owned by the JIT, or null if it has not
+  /// been compiled.
+  const regex::NativeMatcher *nativeMatcher_ = nullptr;
+
   // Finalizer to clean up stored native regex
   static void _finalizeImpl(GCCell *cell, GC *gc);
   static size_t _mallocSizeImpl(GCCell *cell);
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_LAZYFUNCTIONPREWARMER_H
+#define HERMES_VM_LAZYFUNCTIONPREWARMER_H
+
+#ifndef HERMESVM_LEAN
+
+#include "hermes/BCGen/HBC/Bytecode.h"
+#include "hermes/VM/CompiledModule.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace hermes {
+namespace vm {
+
+/// Compiles lazy functions on a background thread, in source order, before
+/// they are first called. The first call then only has to install the
+/// compiled module instead of compiling it.
+///
+/// At most a fixed number of compiled modules are kept waiting for their
+/// first call, so that prewarming a large bundle doesn't end up compiling
+/// all of it. The background thread stops at that number, and resumes once
+/// a module is taken. Modules which are never taken, and the bytecode
+/// modules they came from, are kept until the prewarmer is destroyed.
+///
+/// Functions which another runtime sharing their CompiledModule has already
+/// compiled are skipped, and discard() drops those compiled in the meantime.
+class LazyFunctionPrewarmer {
+ public:
+  /// The default maximum number of compiled modules which have not been
+  /// taken by compile() yet.
+  static constexpr size_t kDefaultMaxUntaken = 64;
+
+  explicit LazyFunctionPrewarmer(size_t maxUntaken = kDefaultMaxUntaken);
+  ~LazyFunctionPrewarmer();
+
+  LazyFunctionPrewarmer(const LazyFunctionPrewarmer &) = delete;
+  void operator=(const LazyFunctionPrewarmer &) = delete;
+
+  /// Queue the lazy functions of \p module which have not been compiled yet
+  /// to be compiled in the background. Modules without lazy functions are
+  /// ignored.
+  void enqueue(const std::shared_ptr<CompiledModule> &module);
+
+  /// \return the module compiled for the lazy function \p func, taking it
+  /// from the background thread if it has been or is being compiled there,
+  /// and compiling it on this thread otherwise.
+  std::unique_ptr<hbc::BytecodeModule> compile(hbc::BytecodeFunction *func);
+
+  /// Drop the lazy function \p func, which was compiled without calling
+  /// compile(), for instance by another runtime sharing its module. It is not
+  /// compiled in the background anymore, and its compiled module is freed.
+  void discard(hbc::BytecodeFunction *func);
+
+  /// Wait until the background thread has compiled all the queued functions,
+  /// or as many as it may keep. Used by tests.
+  void waitUntilIdle();
+
+  /// \return the number of calls to compile() which found the function
+  /// already compiled.
+  uint64_t getNumPrewarmed() const {
+    return numPrewarmed_;
+  }
+
+ private:
+  /// A lazy function, its ID, and the module which owns it and must be kept
+  /// alive until it is compiled.
+  struct Item {
+    std::shared_ptr<CompiledModule> parent;
+    uint32_t functionID;
+    hbc::BytecodeFunction *func;
+  };
+
+  /// A function compiled by the background thread.
+  struct Compiled {
+    std::shared_ptr<CompiledModule> parent;
+    std::unique_ptr<hbc::BytecodeModule> module;
+  };
+
+  /// The body of the background thread.
+  void run();
+
+  /// Stop compiling \p func in the background, wait for it if it is being
+  /// compiled, and \return its compiled module if there is one.
+  std::unique_ptr<hbc::BytecodeModule> take(hbc::BytecodeFunction *func);
+
+  /// \return whether the background thread has nothing to do until more
+  /// functions are queued or compiled modules are taken. The caller must
+  /// hold mutex_.
+  bool isIdle() const {
+    return !inProgress_ && !checking_ &&
+        (queue_.empty() || compiled_.size() >= maxUntaken_);
+  }
+
+  /// The maximum size of compiled_.
+  const size_t maxUntaken_;
+
+  /// Guards all fields below.
+  std::mutex mutex_{};
+
+  /// Signalled when an item is queued, when a function has been compiled or
+  /// taken, when the background thread is about to wait, and when it must
+  /// stop.
+  std::condition_variable cond_{};
+
+  /// Functions waiting to be compiled, in order.
+  std::deque<Item> queue_{};
+
+  /// The functions in queue_ which have not been compiled by a call to
+  /// compile() in the meantime.
+  llvm::DenseSet<hbc::BytecodeFunction *> pending_{};
+
+  /// The function being compiled by the background thread, if any.
+  hbc::BytecodeFunction *inProgress_{nullptr};
+
+  /// Set while the background thread checks whether the function it took
+  /// from the queue has been compiled by another runtime. It must not hold
+  /// mutex_ then, since a thread calling compile() may hold the lock of the
+  /// CompiledModule.
+  bool checking_{false};
+
+  /// Functions compiled by the background thread, and not yet taken.
+  llvm::DenseMap<hbc::BytecodeFunction *, Compiled> compiled_{};
+
+  /// Set to tell the background thread to stop.
+  bool stop_{false};
+
+  /// Only accessed by the thread calling compile().
+  uint64_t numPrewarmed_{0};
+
+  /// The background thread. Started last, since it uses the fields above.
+  std::thread thread_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMESVM_LEAN
+
+#endif // HERMES_VM_LAZYFUNCTIONPREWARMER_H
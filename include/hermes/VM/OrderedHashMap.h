@@ -9,80 +9,46 @@
 #define HERMES_VM_ORDERED_HASHMAP_H
 
 #include "hermes/Support/ErrorHandling.h"
-#include "hermes/VM/ArrayStorage.h"
+#include "hermes/Support/OptValue.h"
 #include "hermes/VM/Runtime.h"
-
-#include <vector>
+#include "hermes/VM/SegmentedArray.h"
 
 namespace hermes {
 namespace vm {
 
-/// HashMapEntry is a gc-managed entry in the OrderedHashMap.
-/// We use HashMapEntry to form two separate linked lists,
-/// one that tracks the insertion order for iteration purpose, one
-/// tracks the list of entries in a hash table bucket for hash operations.
-class HashMapEntry final : public GCCell {
- public:
-  static VTable vt;
-
-  /// The key.
-  GCHermesValue key;
-
-  /// The value.
-  GCHermesValue value;
-
-  /// Previous entry in insertion order.
-  GCPointer<HashMapEntry> prevIterationEntry{nullptr};
-
-  /// Next entry in insertion order.
-  GCPointer<HashMapEntry> nextIterationEntry{nullptr};
-
-  /// Next entry in the hash table bucket.
-  GCPointer<HashMapEntry> nextEntryInBucket{nullptr};
-
-  static bool classof(const GCCell *cell) {
-    return cell->getKind() == CellKind::HashMapEntryKind;
-  }
-
-  static CallResult<HermesValue> create(Runtime *runtime);
-
-  /// Indicates whether this entry has been deleted.
-  bool isDeleted() const {
-    assert(key.isEmpty() == value.isEmpty() && "Inconsistent deleted status");
-    return value.isEmpty();
-  }
-
-  /// Mark this entry as deleted.
-  void markDeleted() {
-    key.setNonPtr(HermesValue::encodeEmptyValue());
-    value.setNonPtr(HermesValue::encodeEmptyValue());
-  }
-
- protected:
-#ifdef HERMESVM_SERIALIZE
-  explicit HashMapEntry(Deserializer &d);
-
-  friend void HashMapEntryDeserialize(Deserializer &d, CellKind kind);
-#endif
-
-  HashMapEntry(Runtime *runtime) : GCCell(&runtime->getHeap(), &vt) {}
-}; // HashMapEntry
-
 /// OrderedHashMap is a gc-managed hash map that maintains insertion order.
-/// The map contains two conceptual parts: a standard chained hash table,
-/// to store and lookup HermesValue; a linked list to maintain the insertion
-/// order.
-/// When an element is added, it's always appended to the end of the linked
-/// list. When an element is deleted, we mark it as deleted and remove it
-/// from the linked list, unless it's the last element.
-/// Iterators are pointers to the entries, which are always linked according
-/// to insertion order.
-/// When the size of the hash table becomes unreasonably large or small
-/// comparing to the number of alive elements, we will rehash the table.
-/// We always make sure that any entry at any moment can successfully find
-/// the next entry according to insertion order, and rely on GC to manage
-/// the "deleted" entries", free them when no more iterators are before
-/// that entry.
+/// It is a deterministic hash table in the style of the "Close table": all
+/// entries are stored inline, in insertion order, in a single SegmentedArray
+/// (the "table"), next to the bucket array. Each bucket holds the index of the
+/// most recently inserted entry that hashes to it, and each entry holds the
+/// index of the next entry in the same bucket, so there are no per-entry GC
+/// cells and a lookup touches only the table.
+///
+/// Layout of a table with B buckets (B a power of 2) and room for
+/// C = B * kLoadFactor entries:
+/// \code
+///   [kNextTableSlot]        next table, or empty if this table is current
+///   [kNumBucketsSlot]       B
+///   [kNumUsedSlot]          number of entry slots used, including deleted
+///   [kNumRemovedSlot]       only in obsolete tables, see below
+///   [kHeaderSize + b]       index of the first entry of bucket b, or empty
+///   [kHeaderSize + B + 3i]  key of entry i, empty if deleted
+///   [ ...          + 1]     value of entry i, empty if deleted
+///   [ ...          + 2]     index of the next entry in the bucket, or empty
+/// \endcode
+///
+/// Erasing an entry leaves a tombstone in place, so the index of every other
+/// entry is stable and iteration is simply a scan over the used entries.
+/// When the entries are full, or the table is sparse enough, the live entries
+/// are copied in order into a new, compacted table. Because compaction
+/// changes indices, the old table records a pointer to its replacement and
+/// the sorted indices of the tombstones it dropped (written over its bucket
+/// and entry area, which are no longer needed). An iterator is a (table,
+/// index) pair; before advancing, it follows the chain of replacements,
+/// subtracting the number of dropped tombstones before its index at each
+/// step. clear() also installs a new table, marking the old one as cleared
+/// so that iterators restart at index 0. Old tables are kept alive only by
+/// the iterators which still reference them.
 class OrderedHashMap final : public GCCell {
   friend void OrderedHashMapBuildMeta(
       const GCCell *cell,
@@ -111,11 +77,6 @@ class OrderedHashMap final : public GCCell {
   static HermesValue
   get(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Lookup \p key in the table and \return the value if exists.
-  /// Otherwise \return nullptr.
-  static HashMapEntry *
-  find(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
-
   /// Insert a key/value pair into the map, if not already existing.
   static ExecutionStatus insert(
       Handle<OrderedHashMap> self,
@@ -127,77 +88,132 @@ class OrderedHashMap final : public GCCell {
   static bool
   erase(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Clear the map.  The \p gc parameter is necessary for write barriers.
-  void clear(Runtime *runtime);
+  /// Clear the map. This installs a new, empty table, so it can fail if the
+  /// allocation fails.
+  static ExecutionStatus clear(Handle<OrderedHashMap> self, Runtime *runtime);
 
   /// \return the size of the map.
   uint32_t size() const {
     return size_;
   }
 
-  /// \return the next element in insertion order.
-  /// If \p entry is nullptr, we are starting the iteration from the first
-  /// entry that is not deleted.
-  /// Otherwise, we look for the next element after \p entry that is not
-  /// deleted.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry = nullptr)
+  /// Advance an iteration cursor to the next live entry.
+  /// The cursor is the pair (\p table, \p index): the table the cursor was
+  /// last used with, and the index of the next entry to consider in it. If
+  /// \p table is nullptr, the iteration starts at the first entry of the
+  /// current table. If the table has been compacted or cleared since it was
+  /// last used, the cursor is first moved to the current table.
+  /// This function never allocates.
+  /// \return true if a live entry was found, in which case \p table and
+  /// \p index designate it and can be passed to getKey() and getValue();
+  /// the caller must increment \p index before advancing again.
+  /// \return false if the iteration is complete.
+  bool iteratorNext(Runtime *runtime, SegmentedArray *&table, uint32_t &index)
       const;
 
+  /// \return the key of the entry at \p index in \p table.
+  static HermesValue getKey(SegmentedArray *table, uint32_t index) {
+    return table->at(entrySlot(table, index) + kKeyOffset);
+  }
+
+  /// \return the value of the entry at \p index in \p table.
+  static HermesValue getValue(SegmentedArray *table, uint32_t index) {
+    return table->at(entrySlot(table, index) + kValueOffset);
+  }
+
  protected:
-  OrderedHashMap(Runtime *runtime, Handle<ArrayStorage> hashTableStorage);
+  OrderedHashMap(Runtime *runtime, Handle<SegmentedArray> table);
 
  private:
-  /// The hashtable, with size always equal to capacity_. The number of
-  /// reachable entries from hashTable_ should be equal to size_.
-  GCPointer<ArrayStorage> hashTable_{nullptr};
+  /// Slots of the table header.
+  static constexpr uint32_t kNextTableSlot = 0;
+  static constexpr uint32_t kNumBucketsSlot = 1;
+  static constexpr uint32_t kNumUsedSlot = 2;
+  static constexpr uint32_t kNumRemovedSlot = 3;
+  static constexpr uint32_t kHeaderSize = 4;
+
+  /// Offsets of the fields of an entry from the first slot of the entry.
+  static constexpr uint32_t kKeyOffset = 0;
+  static constexpr uint32_t kValueOffset = 1;
+  static constexpr uint32_t kChainOffset = 2;
+  static constexpr uint32_t kEntrySize = 3;
+
+  /// Number of entries per bucket.
+  static constexpr uint32_t kLoadFactor = 2;
 
-  /// The first entry ever inserted. We need this entry to begin an iteration.
-  GCPointer<HashMapEntry> firstIterationEntry_{nullptr};
+  /// Value stored in kNumRemovedSlot of a table replaced by clear().
+  static constexpr double kClearedMarker = -1;
 
-  /// The last entry inserted. We need it to add new elements afterwards.
-  GCPointer<HashMapEntry> lastIterationEntry_{nullptr};
+  /// Initial number of buckets of the hash table.
+  static constexpr uint32_t INITIAL_NUM_BUCKETS = 8;
 
-  /// Initial capacity of the hash table.
-  static constexpr uint32_t INITIAL_CAPACITY = 16;
+  /// The current table.
+  GCPointer<SegmentedArray> table_{nullptr};
 
-  /// Maximum capacity cannot exceed the maximum capacity of the underlying
-  /// ArrayStorage.
-  // It needs to be less than 1/4th the max 32-bit integer in order to use an
-  // integer-based load factor check of 0.75.
-  /// TODO(T31421960): Use constexpr std::min.
-  static constexpr uint32_t MAX_CAPACITY =
-      ArrayStorage::maxElements() < UINT32_MAX / 4 ? ArrayStorage::maxElements()
-                                                   : UINT32_MAX / 4;
+  /// Number of buckets of the current table, cached from its header.
+  uint32_t numBuckets_{INITIAL_NUM_BUCKETS};
 
-  /// Capacity of the hash table.
-  uint32_t capacity_{INITIAL_CAPACITY};
+  /// Number of entry slots used in the current table, including deleted
+  /// entries. Kept in sync with the kNumUsedSlot of the table.
+  uint32_t numUsed_{0};
 
   /// Number of alive entries in the storage.
   uint32_t size_{0};
 
-  /// Hash a HermesValue to an index to our hash table.
-  static uint32_t
-  hashToBucket(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key) {
-    auto hash = runtime->gcStableHashHermesValue(key);
+  /// \return the number of slots needed by a table with \p numBuckets
+  /// buckets.
+  static uint64_t tableSize(uint32_t numBuckets) {
+    return kHeaderSize + (uint64_t)numBuckets +
+        (uint64_t)numBuckets * kLoadFactor * kEntrySize;
+  }
+
+  /// \return the number of buckets of \p table.
+  static uint32_t numBucketsOf(SegmentedArray *table) {
+    return table->at(kNumBucketsSlot).getNumberAs<uint32_t>();
+  }
+
+  /// \return the first slot of the entry at \p index in \p table.
+  static uint32_t entrySlot(SegmentedArray *table, uint32_t index) {
+    return kHeaderSize + numBucketsOf(table) + index * kEntrySize;
+  }
+
+  /// \return the first slot of the entry at \p index in the current table.
+  uint32_t entrySlot(uint32_t index) const {
+    return kHeaderSize + numBuckets_ + index * kEntrySize;
+  }
+
+  /// \return the capacity (in entries) of the current table.
+  uint32_t entryCapacity() const {
+    return numBuckets_ * kLoadFactor;
+  }
+
+  /// \return the bucket in the current table that \p hash maps to.
+  uint32_t hashToBucket(uint64_t hash) const {
     assert(
-        (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-        "capacity_ must be power of 2");
-    return hash & (self->capacity_ - 1);
+        (numBuckets_ & (numBuckets_ - 1)) == 0 &&
+        "numBuckets_ must be power of 2");
+    return hash & (numBuckets_ - 1);
   }
 
-  /// Remove a node from the linked list.
-  void removeLinkedListNode(Runtime *runtime, HashMapEntry *entry, GC *gc);
+  /// Lookup an entry with key as \p key in the bucket that \p hash maps to.
+  /// \return the index of the entry, or None if it doesn't exist.
+  OptValue<uint32_t> lookup(Runtime *runtime, uint64_t hash, HermesValue key);
 
-  /// Lookup an entry with key as \p key in a given \p bucket.
-  HashMapEntry *
-  lookupInBucket(Runtime *runtime, uint32_t bucket, HermesValue key);
+  /// Allocate a new table with \p numBuckets buckets and copy the live
+  /// entries of the current table into it, in insertion order. The old table
+  /// is linked to the new one so that iterators can follow.
+  static ExecutionStatus
+  rehash(Handle<OrderedHashMap> self, Runtime *runtime, uint32_t numBuckets);
 
-  /// Adjust the capacity of the hashtable and rehash if necessary.
-  /// We make decisions based on the Load Factor (size / capacity).
-  /// Rehash if load factor is outside of the range of [0.25, 0.75].
-  static ExecutionStatus rehashIfNecessary(
-      Handle<OrderedHashMap> self,
-      Runtime *runtime);
+  /// Allocate a new empty table with \p numBuckets buckets.
+  static CallResult<HermesValue> createTable(
+      Runtime *runtime,
+      uint32_t numBuckets);
+
+  /// Move an iteration cursor in the obsolete table \p table to the current
+  /// table, adjusting \p index to account for the removed entries.
+  static SegmentedArray *
+  transitionCursor(Runtime *runtime, SegmentedArray *table, uint32_t &index);
 }; // OrderedHashMap
 } // namespace vm
 } // namespace hermes
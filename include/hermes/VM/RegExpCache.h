@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_REGEXPCACHE_H
+#define HERMES_VM_REGEXPCACHE_H
+
+#include "hermes/Regex/Compiler.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
+
+#include <list>
+#include <memory>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// A bounded cache of compiled regex bytecode, keyed by the pattern and the
+/// flags which affect compilation. RegExps created from the same source, for
+/// example in a function which is called repeatedly, can then skip parsing
+/// and compiling the pattern. When the cache is full, the least recently used
+/// entry is evicted. The bytecode is shared with the RegExps using it, so it
+/// outlives its entry if one of them is still alive.
+class RegExpCache {
+ public:
+  /// Compiled regex bytecode, shared by the cache and RegExps.
+  using Bytecode = std::shared_ptr<const std::vector<uint8_t>>;
+
+  /// The maximum number of cached regexes.
+  static constexpr size_t kMaxEntries = 64;
+  /// Patterns longer than this are not cached.
+  static constexpr size_t kMaxPatternLength = 1024;
+
+  RegExpCache() = default;
+  RegExpCache(const RegExpCache &) = delete;
+  void operator=(const RegExpCache &) = delete;
+
+  /// Look up the bytecode of \p pattern compiled with \p flags, and make it
+  /// the most recently used entry.
+  /// \return the bytecode, or null if it is not cached.
+  Bytecode lookup(
+      llvm::ArrayRef<char16_t> pattern,
+      regex::constants::SyntaxFlags flags);
+
+  /// Add \p bytecode for \p pattern compiled with \p flags, evicting the least
+  /// recently used entry if the cache is full.
+  void insert(
+      llvm::ArrayRef<char16_t> pattern,
+      regex::constants::SyntaxFlags flags,
+      Bytecode bytecode);
+
+  /// \return the number of lookups which found the bytecode.
+  uint64_t getHits() const {
+    return hits_;
+  }
+
+  /// \return the number of lookups which did not find the bytecode.
+  uint64_t getMisses() const {
+    return misses_;
+  }
+
+  /// \return the number of cached regexes.
+  size_t size() const {
+    return entries_.size();
+  }
+
+  /// \return an estimate of the memory used by the cache, including the
+  /// bytecode it shares with RegExps.
+  size_t getMallocSize() const {
+    return mallocSize_;
+  }
+
+ private:
+  struct Entry {
+    /// The compiled bytecode.
+    Bytecode bytecode;
+    /// The position of this entry in \c lru_.
+    std::list<llvm::StringRef>::iterator lruPos;
+  };
+
+  /// \return the key of \p pattern with \p flags in \c entries_.
+  static std::string makeKey(
+      llvm::ArrayRef<char16_t> pattern,
+      regex::constants::SyntaxFlags flags);
+
+  /// The cached bytecode, by key.
+  llvm::StringMap<Entry> entries_{};
+
+  /// The keys of all entries, which are owned by \c entries_, from the most
+  /// to the least recently used.
+  std::list<llvm::StringRef> lru_{};
+
+  /// The memory used by the keys and bytecode of all entries.
+  size_t mallocSize_{0};
+
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_REGEXPCACHE_H
@@ -25,12 +25,14 @@
 #include "hermes/VM/IdentifierTable.h"
 #include "hermes/VM/InterpreterState.h"
 #include "hermes/VM/JIT/JIT.h"
+#include "hermes/VM/LazyFunctionPrewarmer.h"
 #include "hermes/VM/MockedEnvironment.h"
 #include "hermes/VM/PointerBase.h"
 #include "hermes/VM/Predefined.h"
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/PropertyDescriptor.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/RuntimeStats.h"
@@ -173,8 +175,40 @@ class Runtime : public HandleRootOwner,
       RuntimeModuleFlags runtimeModuleFlags,
       llvm::StringRef sourceURL,
       Handle<Environment> environment,
+      Handle<> thisArg) {
+    return runBytecode(
+        CompiledModule::create(std::move(bytecode)),
+        runtimeModuleFlags,
+        sourceURL,
+        environment,
+        thisArg);
+  }
+
+  /// Runs \p compiledModule, which may be shared with other runtimes, in the
+  /// same way as runBytecode() above.
+  CallResult<HermesValue> runBytecode(
+      std::shared_ptr<CompiledModule> compiledModule,
+      RuntimeModuleFlags runtimeModuleFlags,
+      llvm::StringRef sourceURL,
+      Handle<Environment> environment,
       Handle<> thisArg);
 
+  /// Runs \p compiledModule, which may be shared with other runtimes, with
+  /// global_ as the "this" value initially.
+  CallResult<HermesValue> runBytecode(
+      std::shared_ptr<CompiledModule> compiledModule,
+      RuntimeModuleFlags runtimeModuleFlags,
+      llvm::StringRef sourceURL,
+      Handle<Environment> environment) {
+    heap_.runtimeWillExecute();
+    return runBytecode(
+        std::move(compiledModule),
+        runtimeModuleFlags,
+        sourceURL,
+        environment,
+        Handle<>(&global_));
+  }
+
   /// Runs the given \p bytecode. If \p environment is not null, set it as the
   /// environment associated with the initial JSFunction, which enables local
   /// eval.
@@ -235,6 +269,12 @@ class Runtime : public HandleRootOwner,
   /// but aren't yet.
   void ignoreAllocationFailure(ExecutionStatus status);
 
+  /// \return the number of bytecode pages which the residency policy has
+  /// let the OS reclaim.
+  size_t getBytecodePagesReleased() const {
+    return bytecodePagesReleased_;
+  }
+
   // Inform the VM that TTI has been reached.  (In case, for example, the
   // runtime should change its behavior at that point.)
   void ttiReached();
@@ -309,6 +349,16 @@ class Runtime : public HandleRootOwner,
   /// 256 characters are pre-allocated. The rest are allocated every time.
   Handle<StringPrimitive> getCharacterString(char16_t ch);
 
+  /// The maximum length of the strings in the short string cache.
+  static constexpr uint32_t SHORT_STRING_MAX_LENGTH = 8;
+
+  /// Return a StringPrimitive with the contents of the ASCII string \p str,
+  /// which is at most SHORT_STRING_MAX_LENGTH characters long and may point
+  /// into the GC heap. A recently created string with the same contents is
+  /// returned if it is still in the short string cache, so that code which
+  /// repeatedly extracts the same short tokens does not allocate every time.
+  CallResult<HermesValue> getShortASCIIString(ASCIIRef str);
+
   CodeBlock *getEmptyCodeBlock() const {
     assert(emptyCodeBlock_ && "Invalid empty code block");
     return emptyCodeBlock_;
@@ -455,6 +505,19 @@ class Runtime : public HandleRootOwner,
   JITContext &getJITContext() {
     return jitContext_;
   }
+
+  /// \return the cache of compiled regex bytecode.
+  RegExpCache &getRegExpCache() {
+    return regExpCache_;
+  }
+
+#ifndef HERMESVM_LEAN
+  /// \return the background compiler of lazy functions, or nullptr if lazy
+  /// functions are compiled when they are first called.
+  LazyFunctionPrewarmer *getLazyFunctionPrewarmer() {
+    return lazyFunctionPrewarmer_.get();
+  }
+#endif
   /// Returns trailing data for all runtime modules.
   std::vector<llvm::ArrayRef<uint8_t>> getEpilogues();
 
@@ -635,6 +698,10 @@ class Runtime : public HandleRootOwner,
   /// Track time spent of each opcode in the interpreter, in CPU cycles.
   uint64_t timeSpent[256] = {0};
 
+  /// Track the frequency of each opcode, by the opcode executed before it.
+  /// Frequent pairs are candidates for fused instructions.
+  uint32_t opcodePairFrequency[256][256] = {{0}};
+
   /// Dump opcode stats to a stream.
   void dumpOpcodeStats(llvm::raw_ostream &os) const;
 #endif
@@ -868,6 +935,10 @@ class Runtime : public HandleRootOwner,
   /// those builtins. This will be called at most once.
   void freezeBuiltins();
 
+  /// Let the OS reclaim the pages of persistent bytecode which only contain
+  /// functions that have not been used.
+  void releaseColdBytecode();
+
   /// The slow path for \c getCharacterString(). This function allocates a new
   /// string for the passed character \p ch.
   Handle<StringPrimitive> allocateCharacterString(char16_t ch);
@@ -917,6 +988,14 @@ class Runtime : public HandleRootOwner,
   /// All state related to JIT compilation.
   JITContext jitContext_;
 
+  /// Compiled regex bytecode shared by all RegExps with the same source.
+  RegExpCache regExpCache_{};
+
+#ifndef HERMESVM_LEAN
+  /// Compiles lazy functions in the background, if enabled.
+  std::unique_ptr<LazyFunctionPrewarmer> lazyFunctionPrewarmer_;
+#endif
+
   /// Set to true if we should enable ES6 Symbol.
   const bool hasES6Symbol_;
 
@@ -929,6 +1008,12 @@ class Runtime : public HandleRootOwner,
   // Signal-based I/O tracking. Slows down execution.
   const bool trackIO_;
 
+  /// How the pages of persistent bytecode buffers are loaded and released.
+  const hbc::BytecodeResidencyPolicy bytecodeResidencyPolicy_;
+
+  /// The number of bytecode pages released by the residency policy.
+  size_t bytecodePagesReleased_{0};
+
   /// This value can be passed to the runtime as flags to test experimental
   /// features. Each experimental feature decides how to interpret these
   /// values. Generally each experiment is associated with one or more bits of
@@ -1034,6 +1119,14 @@ class Runtime : public HandleRootOwner,
   /// to be scanned as roots in young-gen collections.
   std::vector<PinnedHermesValue> charStrings_{};
 
+  /// The number of entries in \c shortStrings_. Must be a power of 2.
+  static constexpr size_t SHORT_STRING_CACHE_SIZE = 256;
+
+  /// A direct-mapped cache of recently created short ASCII strings, indexed by
+  /// the low bits of the hash of their contents. Unlike \c charStrings_,
+  /// these may be young objects, so they are marked in every collection.
+  PinnedHermesValue shortStrings_[SHORT_STRING_CACHE_SIZE];
+
   /// Pointers to native implementations of builtins.
   std::vector<NativeFunction *> builtins_{};
 
@@ -1401,8 +1494,9 @@ inline void Runtime::ignoreAllocationFailure(ExecutionStatus status) {
 }
 
 inline void Runtime::ttiReached() {
-  // Currently, only the heap_ behavior can change at TTI.
   heap_.ttiReached();
+  if (bytecodeResidencyPolicy_.releaseColdFunctionsAtTTI)
+    releaseColdBytecode();
 }
 
 template <class T>
@@ -11,6 +11,7 @@
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/Support/HashString.h"
 #include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/CompiledModule.h"
 #include "hermes/VM/IdentifierTable.h"
 #include "hermes/VM/StringRefUtils.h"
 #include "hermes/VM/WeakRef.h"
@@ -51,8 +52,9 @@ union RuntimeModuleFlags {
 };
 
 /// This class is used to store the non-instruction information needed to
-/// execute code. The RuntimeModule owns a BytecodeModule, from which it copies
-/// the string ID map and function map. Every CodeBlock contains a reference to
+/// execute code. The RuntimeModule refers to a CompiledModule, which may be
+/// shared with other runtimes, and keeps the string ID map and function map
+/// which are specific to its runtime. Every CodeBlock contains a reference to
 /// the RuntimeModule that contains its relevant information. Whenever a
 /// JSFunction is created/destroyed, it will update the reference count of the
 /// runtime module following through the code block.
@@ -75,7 +77,8 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   Runtime *runtime_;
 
   /// The table maps from a sequential string id in the bytecode to an
-  /// SymbolID.
+  /// SymbolID. For persistent modules, identifiers are only interned when
+  /// they are first used, so their entries start out empty.
   std::vector<SymbolID> stringIDMap_;
 
   /// Weak pointer to a GC-managed Domain that owns this RuntimeModule.
@@ -90,12 +93,13 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// The table maps from a function index to a CodeBlock.
   std::vector<CodeBlock *> functionMap_{};
 
-  /// The byte-code provider for this RuntimeModule. The RuntimeModule is
-  /// designed to own the provider exclusively, especially because in some
-  /// cases the bytecode can be modified (e.g. for breakpoints). This however
-  /// is a shared_ptr<> instead of unique_ptr<> for a pragmatic reason - when
-  /// we run performance tests, we want to re-use a BCProvider between runtimes
-  /// in order to minimize the noise.
+  /// The runtime independent parts of this module, which may be shared with
+  /// other runtimes.
+  std::shared_ptr<CompiledModule> compiledModule_{};
+
+  /// The byte-code provider for this RuntimeModule, which is owned by
+  /// compiledModule_. Note that sharing it between runtimes means that
+  /// modifying the bytecode (e.g. for breakpoints) affects all of them.
   std::shared_ptr<hbc::BCProvider> bcProvider_{};
 
   /// Flags associated with the module.
@@ -152,6 +156,16 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
       RuntimeModuleFlags flags = {},
       llvm::StringRef sourceURL = {});
 
+  /// Creates a new RuntimeModule under \p runtime for \p compiledModule,
+  /// which may be shared with other runtimes, and imports the CJS module
+  /// table into \p domain.
+  static CallResult<RuntimeModule *> create(
+      Runtime *runtime,
+      Handle<Domain> domain,
+      std::shared_ptr<CompiledModule> compiledModule,
+      RuntimeModuleFlags flags = {},
+      llvm::StringRef sourceURL = {});
+
   /// Creates a new RuntimeModule that is not yet initialized. It may be
   /// initialized later through lazy compilation.
   /// \param runtime the runtime to use for the identifier table.
@@ -188,23 +202,32 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// Otherwise returns false.  Does no JS heap allocation.
   bool getLazyNameString(Runtime *runtime, std::string &res) const;
 
-  /// Initialize lazy modules created with \p createUninitialized.
+  /// Initialize lazy modules created with \p createLazyModule.
   /// Calls `initialize` and does a bit of extra work.
-  /// \param bytecode the bytecode data to initialize it with.
-  void initializeLazyMayAllocate(std::unique_ptr<hbc::BCProvider> bytecode);
+  /// \param compiledModule the module compiled from the lazy function.
+  void initializeLazyMayAllocate(
+      std::shared_ptr<CompiledModule> compiledModule);
 #endif
 
   /// Initialize modules created with \p createUninitialized,
   /// but do not import the CJS module table, allowing us to always succeed.
   /// \param bytecode the bytecode data to initialize it with.
   void initializeWithoutCJSModulesMayAllocate(
-      std::shared_ptr<hbc::BCProvider> &&bytecode);
+      std::shared_ptr<hbc::BCProvider> &&bytecode) {
+    initializeWithoutCJSModulesMayAllocate(
+        CompiledModule::create(std::move(bytecode)));
+  }
+
+  /// Initialize modules created with \p createUninitialized with
+  /// \p compiledModule, but do not import the CJS module table.
+  void initializeWithoutCJSModulesMayAllocate(
+      std::shared_ptr<CompiledModule> compiledModule);
 
   /// Initialize modules created with \p createUninitialized and import the CJS
   /// module table from the provided bytecode file.
-  /// \param bytecode the bytecode data to initialize it with.
+  /// \param compiledModule the module to initialize it with.
   LLVM_NODISCARD ExecutionStatus
-  initializeMayAllocate(std::shared_ptr<hbc::BCProvider> &&bytecode);
+  initializeMayAllocate(std::shared_ptr<CompiledModule> compiledModule);
 
   /// Prepares this RuntimeModule for the systematic destruction of all modules.
   /// Normal destruction is reference counted, but when the Runtime shuts down,
@@ -213,13 +236,14 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
 
   /// For opcodes that use a stringID as identifier explicitly, we know that
   /// the compiler would have marked the stringID as identifier, and hence
-  /// we should have created the symbol during identifier table initialization.
-  /// The symbol must already exist in the map. This is a fast path.
+  /// we either created the symbol during identifier table initialization or,
+  /// for persistent modules, can register it as a lazy identifier now. Either
+  /// way, this does not allocate in the GC heap. This is a fast path.
   SymbolID getSymbolIDMustExist(StringID stringID) {
-    assert(
-        stringIDMap_[stringID].isValid() &&
-        "Symbol must exist for this string ID");
-    return stringIDMap_[stringID];
+    SymbolID id = stringIDMap_[stringID];
+    if (LLVM_UNLIKELY(!id.isValid()))
+      id = registerLazyIdentifier(stringID);
+    return id;
   }
 
   /// \return the \c SymbolID for a string by string index. The symbol may not
@@ -230,7 +254,8 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     if (LLVM_UNLIKELY(!id.isValid())) {
       // Materialize this lazily created symbol.
       auto entry = bcProvider_->getStringTableEntry(stringID);
-      id = createSymbolFromStringIDMayAllocate(stringID, entry, llvm::None);
+      id = createSymbolFromStringIDMayAllocate(
+          stringID, entry, getIdentifierHash(stringID));
     }
     assert(id.isValid() && "Failed to create symbol for stringID");
     return id;
@@ -279,6 +304,11 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     return bcProvider_;
   }
 
+  /// \return the runtime independent parts of this module.
+  const std::shared_ptr<CompiledModule> &getCompiledModule() const {
+    return compiledModule_;
+  }
+
   /// \return true if the RuntimeModule has CJS modules that have not been
   /// statically resolved.
   bool hasCJSModules() const {
@@ -380,6 +410,17 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// Import the string table from the supplied module.
   void importStringIDMapMayAllocate();
 
+  /// \return the precomputed hash of the identifier \p stringID, or None if
+  ///   it is not an identifier.
+  OptValue<uint32_t> getIdentifierHash(StringID stringID) const {
+    return compiledModule_->getIdentifierHash(stringID);
+  }
+
+  /// The slow path of getSymbolIDMustExist(), which registers the identifier
+  /// \p stringID of a persistent module in the identifier table on its first
+  /// use.
+  LLVM_ATTRIBUTE_NOINLINE SymbolID registerLazyIdentifier(StringID stringID);
+
   /// Initialize functionMap_, without actually creating the code blocks.
   /// They will be created lazily when needed.
   void initializeFunctionMap();
@@ -51,6 +51,9 @@ struct RuntimeStats {
   /// Measure of of jsi Function calls (incoming to VM).
   Statistic incomingFunction;
 
+  /// Measure of restoring the VM from a serialized heap.
+  Statistic deserialize;
+
   /// The topmost RAIITimer in the stack.
   RAIITimer *timerStack{nullptr};
 
@@ -20,7 +20,7 @@ enum class RelocationKind { NativePointer, GCPointer, HermesValue };
 
 constexpr uint32_t SD_MAGIC = 0xad082463;
 
-constexpr uint32_t SD_HEADER_VERSION = 1;
+constexpr uint32_t SD_HEADER_VERSION = 6;
 
 /// Bump this version number up whenever NativeFunctions.def is changed.
 constexpr uint32_t NATIVE_FUNCTION_VERSION = 2;
@@ -117,13 +117,25 @@ class StringBuilder {
 
   /// Append the first \p length characters from StringPrimitive \p other.
   void appendStringPrim(Handle<StringPrimitive> other, uint32_t length) {
+    appendSubstring(other, 0, length);
+  }
+
+  /// Append the \p length characters of StringPrimitive \p other starting at
+  /// index \p start.
+  void appendSubstring(
+      Handle<StringPrimitive> other,
+      uint32_t start,
+      uint32_t length) {
     assert(
         index_ + length <= strPrim_->getStringLength() &&
         "StringBuilder append out of bound");
+    assert(
+        start + length <= other->getStringLength() &&
+        "StringBuilder substring out of bound");
     if (other->isASCII()) {
-      appendASCIIRef({other->castToASCIIPointer(), length});
+      appendASCIIRef({other->castToASCIIPointer() + start, length});
     } else if (!strPrim_->isASCII()) {
-      appendUTF16Ref({other->castToUTF16Pointer(), length});
+      appendUTF16Ref({other->castToUTF16Pointer() + start, length});
     } else {
       // strPrim_ is ASCII, while other is UTF16. We have to recreate string.
       auto strRes = runtime_->ignoreAllocationFailure(StringPrimitive::create(
@@ -135,7 +147,7 @@ class StringBuilder {
       index_ = 0;
       // Append original string and other.
       appendASCIIRef(currentPartialString);
-      appendUTF16Ref({other->castToUTF16Pointer(), length});
+      appendUTF16Ref({other->castToUTF16Pointer() + start, length});
     }
   }
 
@@ -77,6 +77,11 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   /// if the string has been uniqued.
   uint32_t const length;
 
+  /// The hash of the string contents as computed by hermes::hashString(), or
+  /// zero if it hasn't been computed yet. The few strings whose hash really
+  /// is zero just recompute it on every request.
+  mutable uint32_t hash_{0};
+
   /// Super constructor to set the length properly.
   explicit StringPrimitive(
       Runtime *runtime,
@@ -112,6 +117,17 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   // too small, because the std::string itself imposes a space overhead.
   static constexpr uint32_t EXTERNAL_STRING_MIN_SIZE = 128;
 
+  // Slices of at least this length are SlicedStringPrimitives, which share
+  // the storage of the string they were taken from. Shorter slices are
+  // copied, since copying them is about as cheap as creating the slice and
+  // they do not keep the whole parent string alive.
+  static constexpr uint32_t SLICED_STRING_MIN_LENGTH = 32;
+
+  // Slices are only SlicedStringPrimitives if the string whose storage they
+  // would share is at most this many times longer than them. Otherwise a
+  // short slice could keep a much larger string alive, so it is copied.
+  static constexpr uint32_t SLICED_STRING_MAX_PARENT_RATIO = 4;
+
   static bool classof(const GCCell *cell) {
     return kindInRange(
         cell->getKind(),
@@ -188,6 +204,16 @@ class StringPrimitive : public VariableSizeRuntimeCell {
     return (length & (1u << 31)) != 0;
   }
 
+  /// \return the hash of the string contents, as computed by
+  /// hermes::hashString(). It is computed on first use and then cached in the
+  /// string, so that repeatedly hashing the same string (as a Map key or to
+  /// look it up in the IdentifierTable) does not rescan its characters.
+  uint32_t getOrComputeHash() const {
+    if (LLVM_LIKELY(hash_ != 0))
+      return hash_;
+    return computeHash();
+  }
+
   /// Compare a part of this string to \p other for equality.
   /// \return true if the section of this string from \p start of length \p
   /// length is equal to the string \p other.
@@ -214,6 +240,8 @@ class StringPrimitive : public VariableSizeRuntimeCell {
       Handle<StringPrimitive> yHandle);
 
   /// Slice the StringPrimitive at \p str, \p length characters at \p start.
+  /// Long slices share the storage of \p str, see SLICED_STRING_MIN_LENGTH and
+  /// SLICED_STRING_MAX_PARENT_RATIO.
   /// \return new StringPrimitive, representing the sliced string.
   static CallResult<HermesValue> slice(
       Runtime *runtime,
@@ -258,6 +286,9 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   /// Whether this is an external string.
   inline bool isExternal() const;
 
+  /// Whether this is a SlicedStringPrimitive.
+  inline bool isSliced() const;
+
   /// Get a StringRef of T. T must be char or char16_t corresponding to whether
   /// this string is ASCII or UTF-16.
   template <typename T>
@@ -273,6 +304,10 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   /// only be called in rare cases carefully.
   void copyUTF16String(char16_t *ptr) const;
 
+  /// Compute the hash of the string contents, cache it in hash_ and return
+  /// it.
+  uint32_t computeHash() const;
+
   /// Get a read-only raw char pointer, assert that this is ASCII string.
   const char *castToASCIIPointer() const;
 
@@ -316,6 +351,13 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   /// This requires and asserts that the string is uniqued.
   SymbolID getUniqueID() const;
 
+  /// Record \p hash as the hash of the string, when it is already known
+  /// (e.g. by the IdentifierTable). It must equal hermes::hashString() of the
+  /// contents.
+  void setHash(uint32_t hash) const {
+    hash_ = hash;
+  }
+
   static std::string _snapshotNameImpl(GCCell *cell, GC *gc);
 };
 
@@ -597,6 +639,89 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   StdString contents_{};
 };
 
+/// An immutable JavaScript primitive string consisting of length and a range
+/// of the characters (either char or char16) of another, parent string. This
+/// is what StringPrimitive::slice() creates for long slices, so that taking
+/// substrings of a large string does not copy them.
+/// The parent is always a DynamicStringPrimitive or ExternalStringPrimitive:
+/// slices of a sliced string share its parent, so that the characters are
+/// always contiguous and one indirection away. Like ExternalStringPrimitive,
+/// this is a fixed-size cell.
+template <typename T>
+class SlicedStringPrimitive final : public StringPrimitive {
+  friend class StringPrimitive;
+
+  friend void SlicedUTF16StringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+  friend void SlicedASCIIStringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+
+  using Ref = llvm::ArrayRef<T>;
+
+  /// \return the cell kind for this string.
+  static constexpr CellKind getCellKind() {
+    return std::is_same<T, char16_t>::value
+        ? CellKind::SlicedUTF16StringPrimitiveKind
+        : CellKind::SlicedASCIIStringPrimitiveKind;
+  }
+
+ public:
+#ifdef HERMESVM_SERIALIZE
+  template <typename>
+  friend void serializeSlicedStringImpl(Serializer &s, const GCCell *cell);
+
+  template <typename>
+  friend void deserializeSlicedStringImpl(Deserializer &d);
+#endif
+
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == SlicedStringPrimitive::getCellKind();
+  }
+
+ private:
+  static const VTable vt;
+
+  /// Construct a slice of \p length characters at \p start of a parent
+  /// string, which must be set by the caller.
+  SlicedStringPrimitive(Runtime *runtime, uint32_t start, uint32_t length)
+      : StringPrimitive(
+            runtime,
+            &vt,
+            sizeof(SlicedStringPrimitive<T>),
+            length,
+            false /* not uniqued */),
+        start_(start) {}
+
+  /// Create a slice of \p length characters at \p start of \p str, whose
+  /// characters must be of type T.
+  static CallResult<HermesValue> create(
+      Runtime *runtime,
+      Handle<StringPrimitive> str,
+      uint32_t start,
+      uint32_t length);
+
+  /// \return the string whose characters this string refers to.
+  const StringPrimitive *getParent() const {
+    return parent_.getString();
+  }
+
+  const T *getRawPointer() const {
+    return getParent()->template getStringRef<T>().data() + start_;
+  }
+
+  Ref getStringRef() const {
+    return Ref(getRawPointer(), getStringLength());
+  }
+
+  /// The parent string, which is never sliced.
+  GCHermesValue parent_{};
+
+  /// The index of the first character of this string in the parent.
+  const uint32_t start_;
+};
+
 template <typename T, bool Uniqued>
 const VTable DynamicStringPrimitive<T, Uniqued>::vt = VTable(
     DynamicStringPrimitive<T, Uniqued>::getCellKind(),
@@ -639,6 +764,24 @@ const VTable ExternalStringPrimitive<T>::vt = VTable(
 using ExternalUTF16StringPrimitive = ExternalStringPrimitive<char16_t>;
 using ExternalASCIIStringPrimitive = ExternalStringPrimitive<char>;
 
+template <typename T>
+const VTable SlicedStringPrimitive<T>::vt = VTable(
+    SlicedStringPrimitive<T>::getCellKind(),
+    sizeof(SlicedStringPrimitive<T>),
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    VTable::HeapSnapshotMetadata{
+        HeapSnapshot::NodeType::String,
+        SlicedStringPrimitive<T>::_snapshotNameImpl,
+        nullptr,
+        nullptr});
+
+using SlicedUTF16StringPrimitive = SlicedStringPrimitive<char16_t>;
+using SlicedASCIIStringPrimitive = SlicedStringPrimitive<char>;
+
 //===----------------------------------------------------------------------===//
 // StringPrimitive inline methods.
 
@@ -751,6 +894,8 @@ inline const char *StringPrimitive::castToASCIIPointer() const {
     return vmcast<ExternalASCIIStringPrimitive>(this)->getRawPointer();
   } else if (isUniqued()) {
     return vmcast<DynamicUniquedASCIIStringPrimitive>(this)->getRawPointer();
+  } else if (isSliced()) {
+    return vmcast<SlicedASCIIStringPrimitive>(this)->getRawPointer();
   } else {
     return vmcast<DynamicASCIIStringPrimitive>(this)->getRawPointer();
   }
@@ -761,6 +906,8 @@ inline const char16_t *StringPrimitive::castToUTF16Pointer() const {
     return vmcast<ExternalUTF16StringPrimitive>(this)->getRawPointer();
   } else if (isUniqued()) {
     return vmcast<DynamicUniquedUTF16StringPrimitive>(this)->getRawPointer();
+  } else if (isSliced()) {
+    return vmcast<SlicedUTF16StringPrimitive>(this)->getRawPointer();
   } else {
     return vmcast<DynamicUTF16StringPrimitive>(this)->getRawPointer();
   }
@@ -810,6 +957,7 @@ inline char16_t StringPrimitive::at(uint32_t index) const {
 inline bool StringPrimitive::isASCII() const {
   // Abstractly, we're doing the following test:
   // return getKind() == CellKind::DynamicASCIIStringPrimitiveKind ||
+  //        getKind() == CellKind::SlicedASCIIStringPrimitiveKind ||
   //        getKind() == CellKind::DynamicUniquedASCIIStringPrimitiveKind ||
   //        getKind() == CellKind::ExternalASCIIStringPrimitiveKind;
   // We speed this up by making the assumption that the string primitive kinds
@@ -819,6 +967,8 @@ inline bool StringPrimitive::isASCII() const {
       cellKindsContiguousAscending(
           CellKind::DynamicUTF16StringPrimitiveKind,
           CellKind::DynamicASCIIStringPrimitiveKind,
+          CellKind::SlicedUTF16StringPrimitiveKind,
+          CellKind::SlicedASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
@@ -836,6 +986,8 @@ inline bool StringPrimitive::isExternal() const {
       cellKindsContiguousAscending(
           CellKind::DynamicUTF16StringPrimitiveKind,
           CellKind::DynamicASCIIStringPrimitiveKind,
+          CellKind::SlicedUTF16StringPrimitiveKind,
+          CellKind::SlicedASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
@@ -844,6 +996,18 @@ inline bool StringPrimitive::isExternal() const {
   return getKind() >= CellKind::ExternalUTF16StringPrimitiveKind;
 }
 
+inline bool StringPrimitive::isSliced() const {
+  static_assert(
+      cellKindsContiguousAscending(
+          CellKind::SlicedUTF16StringPrimitiveKind,
+          CellKind::SlicedASCIIStringPrimitiveKind),
+      "Cell kinds in unexpected order");
+  return kindInRange(
+      getKind(),
+      CellKind::SlicedUTF16StringPrimitiveKind,
+      CellKind::SlicedASCIIStringPrimitiveKind);
+}
+
 template <typename T>
 inline ArrayRef<T> StringPrimitive::getStringRef() const {
   if (isExternal()) {
@@ -851,6 +1015,8 @@ inline ArrayRef<T> StringPrimitive::getStringRef() const {
   } else if (isUniqued()) {
     return vmcast<DynamicStringPrimitive<T, true /* Uniqued */>>(this)
         ->getStringRef();
+  } else if (isSliced()) {
+    return vmcast<SlicedStringPrimitive<T>>(this)->getStringRef();
   } else {
     return vmcast<DynamicStringPrimitive<T, false /* not Uniqued */>>(this)
         ->getStringRef();
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMESVM_LEAN
+
+#include "hermes/BCGen/HBC/BytecodeCache.h"
+
+#include "hermes/BCGen/HBC/BytecodeStream.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/Support/PerfSection.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace hermes {
+namespace hbc {
+
+BytecodeCache::BytecodeCache(std::string directory)
+    : directory_(std::move(directory)) {
+  llvm::sys::fs::create_directories(directory_);
+}
+
+std::string BytecodeCache::getEntryPath(
+    const SHA1 &sourceHash,
+    llvm::StringRef sourceURL,
+    const CompileFlags &compileFlags) const {
+  // The debug info of an entry records the source URL, so the same source
+  // loaded from another URL needs its own entry. A prefix of the hash of the
+  // URL keeps the names short.
+  auto urlHash = llvm::SHA1::hash(llvm::makeArrayRef(
+      reinterpret_cast<const uint8_t *>(sourceURL.data()), sourceURL.size()));
+  // Lazy compilation doesn't affect the entries, since they are always
+  // compiled eagerly.
+  std::string name;
+  llvm::raw_string_ostream OS(name);
+  OS << hashAsString(sourceHash) << '-';
+  for (unsigned i = 0; i < 4; ++i)
+    OS << llvm::format_hex_no_prefix(urlHash[i], 2);
+  OS << "-v" << BYTECODE_VERSION << '-'
+     << (compileFlags.optimize ? 'o' : '_')
+     << (compileFlags.debug ? 'd' : '_')
+     << (compileFlags.strict ? 's' : '_')
+     << (compileFlags.emitAsyncBreakCheck ? 'a' : '_');
+  if (compileFlags.staticBuiltins.hasValue())
+    OS << (*compileFlags.staticBuiltins ? 'B' : 'b');
+  OS << ".hbc";
+  OS.flush();
+
+  llvm::SmallString<128> path{directory_};
+  llvm::sys::path::append(path, name);
+  return std::string(path.str());
+}
+
+std::pair<std::unique_ptr<BCProviderBase>, std::string>
+BytecodeCache::getOrCompile(
+    std::unique_ptr<Buffer> buffer,
+    llvm::StringRef sourceURL,
+    const CompileFlags &compileFlags) {
+  SHA1 sourceHash{};
+  auto rawHash = llvm::SHA1::hash({buffer->data(), buffer->size()});
+  std::copy(rawHash.begin(), rawHash.end(), sourceHash.begin());
+  std::string path = getEntryPath(sourceHash, sourceURL, compileFlags);
+
+  if (auto cached = read(path, sourceHash))
+    return {std::move(cached), std::string{}};
+
+  CompileFlags eagerFlags = compileFlags;
+  eagerFlags.lazy = false;
+  auto res = BCProviderFromSrc::createBCProviderFromSrc(
+      std::move(buffer), sourceURL, eagerFlags);
+  if (!res.first)
+    return {nullptr, std::move(res.second)};
+  write(path, *res.first->getBytecodeModule(), sourceHash, compileFlags);
+  return {std::move(res.first), std::string{}};
+}
+
+std::unique_ptr<BCProviderBase> BytecodeCache::read(
+    const std::string &path,
+    const SHA1 &sourceHash) {
+  PerfSection perf("Read cached bytecode");
+  // Without a null terminator the entry is memory mapped.
+  auto fileOrErr = llvm::MemoryBuffer::getFile(
+      path, /*FileSize*/ -1, /*RequiresNullTerminator*/ false);
+  if (!fileOrErr)
+    return nullptr;
+  llvm::ArrayRef<uint8_t> data{
+      reinterpret_cast<const uint8_t *>((*fileOrErr)->getBufferStart()),
+      (*fileOrErr)->getBufferSize()};
+  // Check the header before it is used to find the rest of the entry, which
+  // might have been truncated, or written by another version of Hermes.
+  if (!BCProviderFromBuffer::bytecodeStreamSanityCheck(data) ||
+      reinterpret_cast<const BytecodeFileHeader *>(data.data())->fileLength !=
+          data.size() ||
+      BCProviderFromBuffer::getSourceHashFromBytecode(data) != sourceHash)
+    return nullptr;
+
+  return BCProviderFromBuffer::createBCProviderFromBuffer(
+             llvm::make_unique<OwnedMemoryBuffer>(std::move(*fileOrErr)))
+      .first;
+}
+
+void BytecodeCache::write(
+    const std::string &path,
+    BytecodeModule &module,
+    const SHA1 &sourceHash,
+    const CompileFlags &compileFlags) {
+  PerfSection perf("Write cached bytecode");
+  int fd;
+  llvm::SmallString<128> tempPath;
+  if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%", fd, tempPath))
+    return;
+  {
+    llvm::raw_fd_ostream OS(fd, /*shouldClose*/ true);
+    BytecodeGenerationOptions opts(EmitBundle);
+    opts.optimizationEnabled = compileFlags.optimize;
+    BytecodeSerializer BS{OS, opts};
+    BS.serialize(module, sourceHash);
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(tempPath);
+      return;
+    }
+  }
+  // Replace the entry in one step, so that it is never seen partially
+  // written.
+  if (llvm::sys::fs::rename(tempPath, path))
+    llvm::sys::fs::remove(tempPath);
+}
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMESVM_LEAN
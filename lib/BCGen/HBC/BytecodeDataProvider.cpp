@@ -8,12 +8,15 @@
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/Support/ErrorHandling.h"
+#include "hermes/Support/LZCompression.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/VM/Deserializer.h"
 #include "hermes/VM/Serializer.h"
 
 #include "llvm/Support/MathExtras.h"
 
+#include <algorithm>
+
 #ifdef HERMESVM_SERIALIZE
 using hermes::vm::Deserializer;
 using hermes::vm::Serializer;
@@ -238,10 +241,23 @@ bool BytecodeFileFields<Mutable>::populateFromBuffer(
             castArrayRef<std::pair<uint32_t, uint32_t>>(buf, h->cjsModuleCount);
       }
     }
+    void visitCompressedBodies() {
+      align(buf);
+      const auto *bodiesHeader = castData<CompressedBodiesHeader>(buf);
+      f.compressedChunks =
+          castArrayRef<CompressedChunk>(buf, bodiesHeader->chunkCount);
+      f.compressedBodies = castArrayRef<uint8_t>(buf, bodiesHeader->dataSize);
+    }
   };
 
   BytecodeFileFieldsPopulator populator{*this, buffer.data()};
   visitBytecodeSegmentsInOrder(populator);
+  functionBodies = populator.buf;
+  // Compressed function bodies take the place of the uncompressed ones, which
+  // are not visited since they are not a structured segment.
+  if (header->options.compressed) {
+    populator.visitCompressedBodies();
+  }
   return true;
 }
 
@@ -336,6 +352,14 @@ void BCProviderFromBuffer::startWarmup(uint8_t percent) {
   }
 }
 
+void pageAlignDown(uint8_t **ptr, size_t *byteLen) {
+  const auto PS = oscompat::page_size();
+
+  auto orig = *ptr;
+  *ptr = reinterpret_cast<uint8_t *>(llvm::alignAddr(*ptr + 1, PS) - PS);
+  *byteLen += orig - *ptr;
+}
+
 namespace {
 
 /// Cast a pointer of any type to a uint8_t pointer.
@@ -344,17 +368,6 @@ constexpr uint8_t *rawptr_cast(T *p) {
   return const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(p));
 }
 
-/// Align \p *ptr down to the start of the page it is pointing in to, and
-/// simultaneously adjust \p *byteLen up by the amount the ptr was shifted down
-/// by.
-inline void pageAlignDown(uint8_t **ptr, size_t *byteLen) {
-  const auto PS = oscompat::page_size();
-
-  auto orig = *ptr;
-  *ptr = reinterpret_cast<uint8_t *>(llvm::alignAddr(*ptr + 1, PS) - PS);
-  byteLen += orig - *ptr;
-}
-
 #ifndef NDEBUG
 
 /// Returns the total size of all array contents in bytes.
@@ -386,6 +399,129 @@ void BCProviderFromBuffer::madvise(oscompat::MAdvice advice) {
 #define ASSERT_TOTAL_ARRAY_LEN(LEN, ...) \
   assert(LEN == totalByteSize(__VA_ARGS__) && "Mismatched length of region")
 
+void BCProviderFromBuffer::applyResidencyPolicy(
+    const BytecodeResidencyPolicy &policy) {
+  const auto PS = oscompat::page_size();
+  auto *bufEnd = rawptr_cast(bufferPtr_) + buffer_->size();
+  auto *startupStart = rawptr_cast(functionBodies_);
+  size_t startupLength = std::min<size_t>(
+      policy.startupReadaheadBytes, bufEnd - startupStart);
+  auto *startupEnd = startupStart + startupLength;
+
+  // prefetch() rounds regions down to the start of their page, which must be
+  // in the buffer.
+  if (policy.prefetchStartup &&
+      reinterpret_cast<uintptr_t>(bufferPtr_) % PS == 0) {
+    prefetch({bufferPtr_, buffer_->size()});
+  }
+
+  if (startupLength) {
+    pageAlignDown(&startupStart, &startupLength);
+    oscompat::vm_madvise(
+        startupStart, startupLength, oscompat::MAdvice::Sequential);
+    oscompat::vm_prefetch(startupStart, startupLength);
+  }
+
+  if (policy.randomAccessRest) {
+    // Round up, so that the startup region keeps its advice.
+    auto *restStart = reinterpret_cast<uint8_t *>(
+        llvm::alignAddr(startupEnd, PS));
+    if (restStart < bufEnd) {
+      oscompat::vm_madvise(
+          restStart, bufEnd - restStart, oscompat::MAdvice::Random);
+    }
+  }
+}
+
+size_t BCProviderFromBuffer::releaseUnusedFunctionPages(
+    llvm::function_ref<bool(uint32_t)> isFunctionUsed) {
+  const auto PS = oscompat::page_size();
+  const uint8_t *bodiesEnd;
+  if (options_.compressed) {
+    // The compressed bodies of used functions have been decompressed, and
+    // the rest are cold, so none of them are needed.
+    bodiesEnd = compressedBodies_.end();
+  } else {
+    bodiesEnd = functionBodies_;
+    for (uint32_t i = 0; i < functionCount_; ++i) {
+      auto header = getFunctionHeader(i);
+      const uint8_t *end =
+          bufferPtr_ + header.offset() + header.bytecodeSizeInBytes();
+      bodiesEnd = std::max(bodiesEnd, end);
+    }
+  }
+
+  // Only release whole pages of function bodies, since the pages at either
+  // end may be shared with other sections.
+  auto first = llvm::alignAddr(functionBodies_, PS);
+  auto last = reinterpret_cast<uintptr_t>(bodiesEnd) / PS * PS;
+  if (last <= first)
+    return 0;
+  std::vector<bool> used((last - first) / PS);
+  if (!options_.compressed) {
+    for (uint32_t i = 0; i < functionCount_; ++i) {
+      if (!isFunctionUsed(i))
+        continue;
+      auto header = getFunctionHeader(i);
+      auto start = reinterpret_cast<uintptr_t>(bufferPtr_ + header.offset());
+      auto end = start + header.bytecodeSizeInBytes();
+      start = std::max(start, first);
+      end = std::min(end, last);
+      for (auto page = start; page < end; page = (page / PS + 1) * PS)
+        used[(page - first) / PS] = true;
+    }
+  }
+
+  size_t released = 0;
+  for (size_t page = 0, e = used.size(); page < e;) {
+    if (used[page]) {
+      ++page;
+      continue;
+    }
+    size_t runStart = page;
+    while (page < e && !used[page])
+      ++page;
+    if (oscompat::vm_madvise(
+            reinterpret_cast<void *>(first + runStart * PS),
+            (page - runStart) * PS,
+            oscompat::MAdvice::Cold)) {
+      released += page - runStart;
+    }
+  }
+  return released;
+}
+
+void BCProviderFromBuffer::snapshotResidentPages() {
+  llvm::SmallVector<int, 64> runs;
+  if (oscompat::pages_in_ram(bufferPtr_, buffer_->size(), &runs) < 0)
+    return;
+  residentAtSnapshot_.clear();
+  // Runs alternate between resident and non-resident pages, starting with
+  // resident ones.
+  bool resident = true;
+  for (int run : runs) {
+    residentAtSnapshot_.insert(residentAtSnapshot_.end(), run, resident);
+    resident = !resident;
+  }
+}
+
+int BCProviderFromBuffer::getPagesLoadedSinceSnapshot() const {
+  llvm::SmallVector<int, 64> runs;
+  if (residentAtSnapshot_.empty() ||
+      oscompat::pages_in_ram(bufferPtr_, buffer_->size(), &runs) < 0)
+    return -1;
+  int loaded = 0;
+  size_t page = 0;
+  bool resident = true;
+  for (int run : runs) {
+    for (int i = 0; i < run; ++i, ++page) {
+      loaded += resident && !residentAtSnapshot_[page];
+    }
+    resident = !resident;
+  }
+  return loaded;
+}
+
 void BCProviderFromBuffer::adviseStringTableSequential() {
   llvm::ArrayRef<SmallStringTableEntry> smallStringTableEntries{
       stringTableEntries_, stringCount_};
@@ -510,6 +646,44 @@ BCProviderFromBuffer::BCProviderFromBuffer(std::unique_ptr<const Buffer> buffer)
   cjsModuleOffset_ = fileHeader->cjsModuleOffset;
   cjsModuleTable_ = fields.cjsModuleTable;
   cjsModuleTableStatic_ = fields.cjsModuleTableStatic;
+  compressedChunks_ = fields.compressedChunks;
+  compressedBodies_ = fields.compressedBodies;
+  functionBodies_ = fields.functionBodies;
+  for (const CompressedChunk &chunk : compressedChunks_) {
+    if (chunk.dataOffset > compressedBodies_.size() ||
+        chunk.dataSize > compressedBodies_.size() - chunk.dataOffset) {
+      errstr_ = "Compressed function bodies out of bounds";
+      return;
+    }
+  }
+  decompressedChunks_.resize(compressedChunks_.size());
+}
+
+const uint8_t *BCProviderFromBuffer::getDecompressedBytecode(
+    uint32_t offset) const {
+  // Find the last chunk starting at or before the offset.
+  auto it = std::upper_bound(
+      compressedChunks_.begin(),
+      compressedChunks_.end(),
+      offset,
+      [](uint32_t value, const CompressedChunk &chunk) {
+        return value < chunk.offset;
+      });
+  assert(it != compressedChunks_.begin() && "No chunk contains the offset");
+  --it;
+  assert(offset - it->offset < it->size && "No chunk contains the offset");
+
+  std::lock_guard<std::mutex> lock{decompressMutex_};
+  auto &storage = decompressedChunks_[it - compressedChunks_.begin()];
+  if (!storage) {
+    storage.reset(new uint8_t[it->size]);
+    if (!lz::decompress(
+            compressedBodies_.slice(it->dataOffset, it->dataSize),
+            {storage.get(), it->size})) {
+      hermes_fatal("Corrupted compressed function bodies");
+    }
+  }
+  return storage.get() + (offset - it->offset);
 }
 
 llvm::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogue() const {
@@ -545,6 +719,16 @@ SHA1 BCProviderFromBuffer::getSourceHashFromBytecode(
 
 void BCProviderFromBuffer::createDebugInfo() {
   const auto *buf = bufferPtr_ + debugInfoOffset_;
+  if (options_.compressed) {
+    const auto *compressed = castData<hbc::CompressedDebugInfoHeader>(buf);
+    debugInfoStorage_.reset(new uint8_t[compressed->size]);
+    if (!lz::decompress(
+            {buf, compressed->dataSize},
+            {debugInfoStorage_.get(), compressed->size})) {
+      hermes_fatal("Corrupted compressed debug info");
+    }
+    buf = debugInfoStorage_.get();
+  }
   const auto *header = castData<hbc::DebugInfoHeader>(buf);
 
   auto filenameTable =
@@ -645,7 +829,18 @@ void BCProviderFromBuffer::prefetch(llvm::ArrayRef<uint8_t> aref) {
       ? RuntimeFunctionHeader(reinterpret_cast<const hbc::FunctionHeader *>(
             aref.data() + globalSmall.getLargeHeaderOffset()))
       : RuntimeFunctionHeader(&globalSmall);
-  prefetchRegion(aref.data() + global.offset(), global.bytecodeSizeInBytes());
+  if (!fileHeader->options.compressed) {
+    prefetchRegion(aref.data() + global.offset(), global.bytecodeSizeInBytes());
+    return;
+  }
+  // The global function will be decompressed from its chunk.
+  for (const CompressedChunk &chunk : fields.compressedChunks) {
+    if (global.offset() - chunk.offset < chunk.size) {
+      prefetchRegion(
+          fields.compressedBodies.data() + chunk.dataOffset, chunk.dataSize);
+      break;
+    }
+  }
 }
 
 bool BCProviderFromBuffer::bytecodeStreamSanityCheck(
@@ -16,6 +16,7 @@
 #include "hermes/Support/SHA1.h"
 #include "hermes/Support/UTF8.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iomanip>
 #include <locale>
@@ -802,7 +803,20 @@ BytecodeSectionWalker::BytecodeSectionWalker(
       bcProvider->getCJSModuleTable().begin(),
       bcProvider->getCJSModuleTable().end());
 
-  auto firstFuncStart = bcProvider->getBytecode(0);
+  // Function bodies may be laid out in any order. Compressed bodies are
+  // decompressed elsewhere, so use the compressed section instead.
+  const uint8_t *firstFuncStart;
+  if (fileHeader->options.compressed) {
+    firstFuncStart = reinterpret_cast<const uint8_t *>(
+                         bcProvider->getCompressedChunks().data()) -
+        sizeof(hbc::CompressedBodiesHeader);
+  } else {
+    firstFuncStart = bcProvider->getBytecode(0);
+    for (uint32_t funcId = 1; funcId < fileHeader->functionCount; ++funcId) {
+      firstFuncStart =
+          std::min(firstFuncStart, bcProvider->getBytecode(funcId));
+    }
+  }
   auto firstFuncHeader = bcProvider->getFunctionHeader(0);
   auto firstFuncInfoStart = bytecodeStart + firstFuncHeader.infoOffset();
   auto debugInfoStart = bytecodeStart + fileHeader->debugInfoOffset;
@@ -208,6 +208,12 @@ bool hermes::hbc::convertBytecodeToForm(
   if (!fields.populateFromBuffer(buffer, outError, sourceForm)) {
     return false;
   }
+  if (fields.header->options.compressed) {
+    if (outError) {
+      *outError = "Compressed bytecode cannot be converted";
+    }
+    return false;
+  }
 
   if (targetForm == BytecodeForm::Delta) {
     BytecodeFormConverter<BytecodeForm::Delta> conv(buffer, fields);
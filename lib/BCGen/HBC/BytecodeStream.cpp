@@ -7,6 +7,10 @@
 
 #include "hermes/BCGen/HBC/BytecodeStream.h"
 
+#include "hermes/Support/LZCompression.h"
+
+#include <algorithm>
+
 using namespace hermes;
 using namespace hbc;
 
@@ -16,6 +20,8 @@ void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
   uint32_t cjsModuleCount = BM.getBytecodeOptions().cjsModulesStaticallyResolved
       ? BM.getCJSModuleTableStatic().size()
       : BM.getCJSModuleTable().size();
+  BytecodeOptions bytecodeOptions = BM.getBytecodeOptions();
+  bytecodeOptions.compressed = options_.compressBytecode;
   BytecodeFileHeader header{MAGIC,
                             BYTECODE_VERSION,
                             sourceHash,
@@ -35,12 +41,16 @@ void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
                             BM.getCJSModuleOffset(),
                             cjsModuleCount,
                             debugInfoOffset_,
-                            BM.getBytecodeOptions()};
+                            bytecodeOptions};
   writeBinary(header);
   // Sizes of file and function headers are tuned for good cache line packing.
   // If you reorder the format, try to avoid headers crossing cache lines.
   visitBytecodeSegmentsInOrder(*this);
-  serializeFunctionsBytecode(BM);
+  if (options_.compressBytecode) {
+    serializeCompressedFunctionsBytecode(BM);
+  } else {
+    serializeFunctionsBytecode(BM);
+  }
 
   for (auto &entry : BM.getFunctionTable()) {
     serializeFunctionInfo(*entry);
@@ -79,6 +89,17 @@ void BytecodeSerializer::serializeDebugInfo(BytecodeModule &BM) {
   const DebugInfo &info = BM.getDebugInfo();
   debugInfoOffset_ = loc_;
 
+  if (options_.compressBytecode) {
+    if (isLayout_) {
+      compressDebugInfo(BM);
+    }
+    CompressedDebugInfoHeader header{
+        debugInfoSize_, (uint32_t)compressedDebugInfo_.size()};
+    writeBinary(header);
+    writeBinaryArray(llvm::makeArrayRef(compressedDebugInfo_));
+    return;
+  }
+
   if (options_.stripDebugInfoSection) {
     const DebugInfoHeader empty = {0, 0, 0, 0, 0};
     writeBinary(empty);
@@ -106,6 +127,23 @@ void BytecodeSerializer::serializeDebugInfo(BytecodeModule &BM) {
   writeBinaryArray(data.getData());
 }
 
+void BytecodeSerializer::compressDebugInfo(BytecodeModule &BM) {
+  std::string debugInfo;
+  llvm::raw_string_ostream OS(debugInfo);
+  BytecodeGenerationOptions uncompressed = options_;
+  uncompressed.compressBytecode = false;
+  BytecodeSerializer debugInfoSerializer{OS, uncompressed};
+  debugInfoSerializer.isLayout_ = false;
+  debugInfoSerializer.serializeDebugInfo(BM);
+  OS.flush();
+
+  debugInfoSize_ = debugInfo.size();
+  compressedDebugInfo_.clear();
+  lz::compress(
+      {reinterpret_cast<const uint8_t *>(debugInfo.data()), debugInfo.size()},
+      compressedDebugInfo_);
+}
+
 // ===================== CommonJS Module Table ======================
 void BytecodeSerializer::serializeCJSModuleTable(BytecodeModule &BM) {
   pad(BYTECODE_ALIGNMENT);
@@ -153,12 +191,35 @@ void BytecodeSerializer::serializeDebugOffsets(BytecodeFunction &BF) {
 }
 
 // ============================ Function ============================
+std::vector<BytecodeFunction *> BytecodeSerializer::getFunctionLayoutOrder(
+    BytecodeModule &BM) {
+  const auto &functions = BM.getFunctionTable();
+  std::vector<BytecodeFunction *> order;
+  order.reserve(functions.size());
+  std::vector<bool> placed(functions.size());
+  for (uint32_t id : options_.functionOrder) {
+    // Ignore IDs which are out of range or listed twice, since the order may
+    // come from a profile of a slightly different build.
+    if (id < functions.size() && !placed[id]) {
+      placed[id] = true;
+      order.push_back(functions[id].get());
+    }
+  }
+  for (uint32_t id = 0, e = functions.size(); id < e; ++id) {
+    if (!placed[id])
+      order.push_back(functions[id].get());
+  }
+  return order;
+}
+
 void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
   // Map from opcodes and jumptables to offsets, used to deduplicate bytecode.
   using DedupKey =
       std::pair<llvm::ArrayRef<opcode_atom_t>, llvm::ArrayRef<uint32_t>>;
   llvm::DenseMap<DedupKey, uint32_t> bcMap;
-  for (auto &entry : BM.getFunctionTable()) {
+  // Both the layout and the writing pass visit the functions in the same
+  // order, so deduplicated bodies always refer to an earlier offset.
+  for (BytecodeFunction *entry : getFunctionLayoutOrder(BM)) {
     if (options_.optimizationEnabled) {
       // If identical bytecode exists, we'll reuse it.
       bool reuse = false;
@@ -172,8 +233,11 @@ void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
           entry->setOffset(pair.first->second);
         }
       } else {
-        // Cheaply determine whether bytecode was deduplicated.
-        assert(entry->getOffset() && "Function lacks offset after layout");
+        // Cheaply determine whether bytecode was deduplicated. Compressed
+        // bodies are laid out from offset zero.
+        assert(
+            (entry->getOffset() || options_.compressBytecode) &&
+            "Function lacks offset after layout");
         assert(entry->getOffset() <= loc_ && "Function has too large offset");
         reuse = entry->getOffset() < loc_;
       }
@@ -205,6 +269,63 @@ void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
   }
 }
 
+void BytecodeSerializer::compressFunctionsBytecode(BytecodeModule &BM) {
+  // Lay out the bodies in their own space, and then write them out.
+  std::string bodies;
+  llvm::raw_string_ostream OS(bodies);
+  BytecodeSerializer bodySerializer{OS, options_};
+  bodySerializer.serializeFunctionsBytecode(BM);
+  bodySerializer.isLayout_ = false;
+  bodySerializer.loc_ = 0;
+  bodySerializer.serializeFunctionsBytecode(BM);
+  OS.flush();
+
+  // Chunks may only end between bodies, so that each function is in one chunk.
+  std::vector<uint32_t> boundaries;
+  for (auto &entry : BM.getFunctionTable()) {
+    boundaries.push_back(entry->getOffset());
+  }
+  boundaries.push_back(bodies.size());
+  std::sort(boundaries.begin(), boundaries.end());
+
+  compressedChunks_.clear();
+  compressedBodies_.clear();
+  uint32_t chunkStart = 0;
+  for (uint32_t boundary : boundaries) {
+    if (boundary - chunkStart < COMPRESSED_CHUNK_SIZE &&
+        boundary != bodies.size()) {
+      continue;
+    }
+    if (boundary == chunkStart) {
+      continue;
+    }
+    CompressedChunk chunk{chunkStart,
+                          boundary - chunkStart,
+                          (uint32_t)compressedBodies_.size(),
+                          0};
+    lz::compress(
+        {reinterpret_cast<const uint8_t *>(bodies.data()) + chunkStart,
+         chunk.size},
+        compressedBodies_);
+    chunk.dataSize = compressedBodies_.size() - chunk.dataOffset;
+    compressedChunks_.push_back(chunk);
+    chunkStart = boundary;
+  }
+}
+
+void BytecodeSerializer::serializeCompressedFunctionsBytecode(
+    BytecodeModule &BM) {
+  pad(BYTECODE_ALIGNMENT);
+  if (isLayout_) {
+    compressFunctionsBytecode(BM);
+  }
+  CompressedBodiesHeader header{(uint32_t)compressedChunks_.size(),
+                                (uint32_t)compressedBodies_.size()};
+  writeBinary(header);
+  writeBinaryArray(llvm::makeArrayRef(compressedChunks_));
+  writeBinaryArray(llvm::makeArrayRef(compressedBodies_));
+}
+
 void BytecodeSerializer::serializeFunctionInfo(BytecodeFunction &BF) {
   // Set the offset of this function's info. Any subsection that is present is
   // aligned to INFO_ALIGNMENT, so we also align the recorded offset to that.
@@ -276,7 +276,8 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
 
       funcGen =
           BytecodeFunctionGenerator::create(BMGen, RA.getMaxRegisterUsage());
-      HBCISel hbciSel(&F, funcGen.get(), RA, scopeAnalysis);
+      HBCISel hbciSel(
+          &F, funcGen.get(), RA, scopeAnalysis, options.fuseInstructions);
       hbciSel.generate(sourceMapGen);
     }
 
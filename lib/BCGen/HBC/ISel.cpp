@@ -36,6 +36,7 @@ STATISTIC(
 STATISTIC(
     NumCacheSlots,
     "Number of cache slots allocated for all put/get property instructions");
+STATISTIC(NumFusedCalls, "Number of method loads fused with their calls");
 
 /// Given a list of basic blocks \p blocks linearized into the order they will
 /// be generated, \return the set of those basic blocks containing backwards
@@ -386,6 +387,50 @@ void HBCISel::verifyCall(CallInst *Inst) {
 #endif
 }
 
+HBCCallNInst *HBCISel::getFusibleCall(LoadPropertyInst *Inst) {
+  // Keep every instruction separate for the debugger. Also note that
+  // TryLoadGlobalPropertyInst is a LoadPropertyInst.
+  if (!fuseInstructions_ ||
+      F_->getContext().getDebugInfoSetting() == DebugInfoSetting::ALL ||
+      Inst->getKind() != ValueKind::LoadPropertyInstKind) {
+    return nullptr;
+  }
+  auto *Lit = dyn_cast<LiteralString>(Inst->getProperty());
+  if (!Lit || BCFGen_->getIdentifierID(Lit) > UINT16_MAX)
+    return nullptr;
+
+  auto methodReg = encodeValue(Inst);
+  auto objReg = encodeValue(Inst->getObject());
+  // The arguments of the call may be constants, parameters or copies loaded
+  // after the method. The load can be moved after them, as long as they
+  // don't use its registers.
+  for (auto it = std::next(Inst->getIterator()), e = Inst->getParent()->end();
+       it != e;
+       ++it) {
+    // Implicit moves don't emit anything.
+    if (isa<ImplicitMovInst>(&*it))
+      continue;
+    if (isa<HBCLoadConstInst>(&*it) || isa<HBCLoadParamInst>(&*it) ||
+        isa<MovInst>(&*it)) {
+      auto reg = encodeValue(&*it);
+      if (reg == methodReg || reg == objReg)
+        return nullptr;
+      if (auto *MI = dyn_cast<MovInst>(&*it)) {
+        if (encodeValue(MI->getSingleOperand()) == methodReg)
+          return nullptr;
+      }
+      continue;
+    }
+    auto *call = dyn_cast<HBCCallNInst>(&*it);
+    if (!call || call->getCallee() != Inst || call->getNumArguments() > 2 ||
+        encodeValue(call->getArgument(0)) != objReg) {
+      return nullptr;
+    }
+    return call;
+  }
+  return nullptr;
+}
+
 void HBCISel::generateLoadStackInst(LoadStackInst *Inst, BasicBlock *next) {
   auto dst = encodeValue(Inst);
   auto src = encodeValue(Inst->getSingleOperand());
@@ -1137,6 +1182,27 @@ void HBCISel::generateHBCCallNInst(HBCCallNInst *Inst, BasicBlock *next) {
   auto function = encodeValue(Inst->getCallee());
   verifyCall(Inst);
 
+  auto fused = fusedLoads_.find(Inst);
+  if (fused != fusedLoads_.end()) {
+    LoadPropertyInst *load = fused->second;
+    auto objReg = encodeValue(load->getObject());
+    auto id =
+        BCFGen_->getIdentifierID(cast<LiteralString>(load->getProperty()));
+    auto cacheIdx = acquirePropertyReadCacheIndex(id);
+    if (Inst->getNumArguments() == 1) {
+      BCFGen_->emitGetByIdCall1(output, function, objReg, cacheIdx, id);
+    } else {
+      BCFGen_->emitGetByIdCall2(
+          output,
+          function,
+          objReg,
+          cacheIdx,
+          id,
+          encodeValue(Inst->getArgument(1)));
+    }
+    return;
+  }
+
   static_assert(
       HBCCallNInst::kMinArgs == 1 && HBCCallNInst::kMaxArgs == 4,
       "Update generateHBCCallNInst to reflect min/max arg range");
@@ -1519,6 +1585,16 @@ void HBCISel::generate(BasicBlock *BB, BasicBlock *next) {
 void HBCISel::generate(Instruction *ii, BasicBlock *next) {
   LLVM_DEBUG(dbgs() << "Generating the instruction " << ii->getName() << "\n");
 
+  // A load of a method which is fused with its call is emitted with the call,
+  // which also provides the debug location.
+  if (auto *LPI = dyn_cast<LoadPropertyInst>(ii)) {
+    if (auto *call = getFusibleCall(LPI)) {
+      ++NumFusedCalls;
+      fusedLoads_[call] = LPI;
+      return;
+    }
+  }
+
   // Generate the debug info.
   switch (F_->getContext().getDebugInfoSetting()) {
     case DebugInfoSetting::THROWING:
@@ -443,6 +443,28 @@ static opt<unsigned> PadFunctionBodiesPercent(
     init(0),
     Hidden);
 
+static opt<std::string> FunctionOrderFile(
+    "function-order-file",
+    desc(
+        "File listing the IDs of functions, one per line, whose bodies should "
+        "be laid out first in the bytecode, such as the output of the hbcdump "
+        "'function-order' command."),
+    init(""));
+
+static opt<bool> CompressBytecode(
+    "compress-bytecode",
+    desc(
+        "Compress function bodies and debug info in the bytecode. They are "
+        "decompressed when first used."),
+    init(false));
+
+static opt<bool> FuseInstructions(
+    "fuse-instructions",
+    desc(
+        "Fuse common sequences of instructions, like loading a method and "
+        "calling it, to reduce the size of the bytecode. Requires -O."),
+    init(false));
+
 } // namespace cl
 
 namespace {
@@ -487,6 +509,33 @@ std::unique_ptr<llvm::MemoryBuffer> memoryBufferFromFile(
   return std::move(*fileBuf);
 }
 
+/// Read the function IDs listed in the file at \p path, one per line, into
+/// \p order. Empty lines and lines starting with '#' are ignored.
+/// Prints error messages to llvm::errs().
+/// \return true on success, false on error.
+bool readFunctionOrder(llvm::StringRef path, std::vector<uint32_t> &order) {
+  auto buffer = memoryBufferFromFile(path);
+  if (!buffer) {
+    return false;
+  }
+  llvm::SmallVector<llvm::StringRef, 0> lines;
+  buffer->getBuffer().split(lines, '\n');
+  for (size_t i = 0, e = lines.size(); i < e; ++i) {
+    llvm::StringRef line = lines[i].trim();
+    if (line.empty() || line.startswith("#")) {
+      continue;
+    }
+    uint32_t id;
+    if (line.getAsInteger(10, id)) {
+      llvm::errs() << "Error! Invalid function ID at " << path << ":" << i + 1
+                   << ": " << line << '\n';
+      return false;
+    }
+    order.push_back(id);
+  }
+  return true;
+}
+
 /// Read a file from \p path relative to the root of the zip file \p zip
 /// into a memory buffer. Print error messages to llvm::errs().
 /// \param zip the zip file to read from (must not be null).
@@ -1602,6 +1651,8 @@ CompileResult processSourceFiles(
   // options parsing and js parsing. Set the bytecode header flag here.
   genOptions.staticBuiltinsEnabled = context->getStaticBuiltinOptimization();
   genOptions.padFunctionBodiesPercent = cl::PadFunctionBodiesPercent;
+  genOptions.compressBytecode = cl::CompressBytecode;
+  genOptions.fuseInstructions = cl::FuseInstructions;
 
   // If the user requests to output a source map, then do not also emit debug
   // info into the bytecode.
@@ -1609,6 +1660,11 @@ CompileResult processSourceFiles(
 
   genOptions.stripFunctionNames = cl::StripFunctionNames;
 
+  if (!cl::FunctionOrderFile.empty() &&
+      !readFunctionOrder(cl::FunctionOrderFile, genOptions.functionOrder)) {
+    return InputFileError;
+  }
+
   // If the dump target is None, return bytecode in an executable form.
   if (cl::DumpTarget == None) {
     assert(
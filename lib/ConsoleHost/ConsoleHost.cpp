@@ -309,7 +309,13 @@ bool executeHBCBytecodeImpl(
   }
 
   if (options.DeserializeFile != "") {
-    auto inputFileOrErr = llvm::MemoryBuffer::getFile(options.DeserializeFile);
+    // The Deserializer does not need a null terminator. Without one, the file
+    // is always memory mapped, so the bytecode and strings it contains are
+    // shared with other processes deserializing the same file.
+    auto inputFileOrErr = llvm::MemoryBuffer::getFile(
+        options.DeserializeFile,
+        /*FileSize*/ -1,
+        /*RequiresNullTerminator*/ false);
     if (!inputFileOrErr) {
       llvm::errs() << "Failed to read Deserialize file: "
                    << options.DeserializeFile << '\n';
@@ -8,9 +8,14 @@
 #include "hermes/Regex/Executor.h"
 #include "hermes/Regex/RegexTraits.h"
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/TrailingObjects.h"
 
+#include <algorithm>
+#include <cstring>
+
 // This file contains the machinery for executing a regexp compiled to bytecode.
 
 namespace hermes {
@@ -27,6 +32,8 @@ enum class MatchRuntimeErrorType {
   /// Reached maximum stack depth while searching for match.
   MaxStackDepth,
 
+  /// Ran out of steps while searching for match.
+  StepLimit,
 };
 
 /// An enum describing Width1 opcodes. This is the set of regex opcodes which
@@ -201,6 +208,151 @@ class Cursor {
   bool forwards_;
 };
 
+/// The linear-time executor simulates all ways of matching the regex at once,
+/// advancing through the input one code unit at a time. Each way is a thread,
+/// stored as a fixed-size array of words: the fields below, then the iteration
+/// count and entry position of each loop, then the start position of the
+/// match, then the start and end of each capture group.
+enum LinearThreadField : uint32_t {
+  /// The instruction pointer.
+  LinearThreadIp,
+
+  /// The number of input positions to skip before the thread resumes. This is
+  /// nonzero after an instruction consumed more than one code unit.
+  LinearThreadWait,
+
+  /// At a Width1Loop instruction, the number of iterations completed. At the
+  /// body of a Width1Loop, one more than that. Otherwise zero.
+  LinearThreadWidth1Count,
+
+  /// The first word of the loop data.
+  LinearThreadLoops,
+};
+
+/// A list of threads at some input position, in order of priority, along with
+/// the set of states already visited at that position. Two threads with the
+/// same state behave identically from then on, so only the first (highest
+/// priority) one is kept. The state of a thread is its instruction pointer,
+/// wait and loop data, except that loop entry positions only matter in
+/// whether they are equal to the current position.
+class LinearThreadSet {
+  /// Number of words in a thread, and in its state.
+  const uint32_t threadSize_;
+  const uint32_t stateSize_;
+
+  /// The threads, flattened.
+  std::vector<uint32_t> threads_;
+
+  /// The visited states, flattened.
+  std::vector<uint32_t> states_;
+
+  /// Open-addressed hash table of visited states. Entries from an older
+  /// generation are empty, which allows clearing the table in constant time.
+  struct Slot {
+    uint32_t generation;
+    uint32_t index;
+  };
+  std::vector<Slot> table_;
+  uint32_t generation_ = 1;
+
+  /// Scratch space for computing a state.
+  std::vector<uint32_t> scratch_;
+
+  /// \return the hash of the state \p state.
+  size_t hashState(const uint32_t *state) const {
+    return llvm::hash_combine_range(state, state + stateSize_);
+  }
+
+  /// Double the size of the hash table, reinserting the visited states.
+  void grow() {
+    std::vector<Slot> table(std::max<size_t>(16, table_.size() * 2));
+    size_t mask = table.size() - 1;
+    size_t count = states_.size() / stateSize_;
+    for (uint32_t index = 0; index < count; index++) {
+      size_t i = hashState(&states_[index * stateSize_]) & mask;
+      while (table[i].generation == generation_)
+        i = (i + 1) & mask;
+      table[i] = {generation_, index};
+    }
+    table_ = std::move(table);
+  }
+
+ public:
+  LinearThreadSet(uint32_t threadSize, uint32_t loopCount)
+      : threadSize_(threadSize),
+        stateSize_(LinearThreadLoops + 2 * loopCount),
+        scratch_(stateSize_) {}
+
+  /// \return the number of threads.
+  size_t size() const {
+    return threads_.size() / threadSize_;
+  }
+
+  /// \return the thread at index \p idx.
+  const uint32_t *at(size_t idx) const {
+    return &threads_[idx * threadSize_];
+  }
+
+  /// Append the thread \p thread, which must not be stored in this set.
+  void push(const uint32_t *thread) {
+    threads_.insert(threads_.end(), thread, thread + threadSize_);
+  }
+
+  /// Record that the state of \p thread was visited at the input position
+  /// \p offset. \return true if it had not been visited before.
+  bool visit(const uint32_t *thread, uint32_t offset) {
+    uint32_t *state = scratch_.data();
+    std::copy(thread, thread + stateSize_, state);
+    for (uint32_t i = LinearThreadLoops + 1; i < stateSize_; i += 2) {
+      state[i] = state[i] == offset;
+    }
+
+    size_t count = states_.size() / stateSize_;
+    if ((count + 1) * 2 > table_.size())
+      grow();
+    size_t mask = table_.size() - 1;
+    for (size_t i = hashState(state) & mask;; i = (i + 1) & mask) {
+      Slot &slot = table_[i];
+      if (slot.generation != generation_) {
+        slot = {generation_, static_cast<uint32_t>(count)};
+        states_.insert(states_.end(), state, state + stateSize_);
+        return true;
+      }
+      const uint32_t *existing = &states_[slot.index * stateSize_];
+      if (std::equal(state, state + stateSize_, existing))
+        return false;
+    }
+  }
+
+  /// Remove all threads and visited states.
+  void clear() {
+    threads_.clear();
+    states_.clear();
+    if (++generation_ == 0) {
+      std::fill(table_.begin(), table_.end(), Slot{0, 0});
+      generation_ = 1;
+    }
+  }
+};
+
+/// Scratch data for a run of the linear-time executor.
+struct LinearExecution {
+  /// Number of words in a thread.
+  uint32_t threadSize;
+
+  /// Index of the match start position in a thread, which is followed by the
+  /// capture groups.
+  uint32_t startIndex;
+
+  /// Threads which remain to be followed by addLinearThreads(), with the
+  /// highest priority one last.
+  std::vector<uint32_t> pending;
+
+  LinearExecution(uint32_t markedCount, uint32_t loopCount)
+      : threadSize(LinearThreadLoops + 2 * loopCount + 1 + 2 * markedCount),
+        startIndex(LinearThreadLoops + 2 * loopCount) {}
+};
+
 /// A Context records global information about a match attempt.
 template <class Traits>
 struct Context {
@@ -355,6 +507,11 @@ struct Context {
   /// This is effectively a timeout on the regexp execution.
   uint32_t backtracksRemaining_ = kBacktrackLimit;
 
+  /// The remaining number of steps the backtracking executor may take. A step
+  /// is an executed instruction, or a character consumed by a Width1Loop.
+  /// Only limited for regexes supported by the linear-time executor.
+  uint64_t stepsRemaining_ = UINT64_MAX;
+
   /// Whether an error occurred during the regex matching.
   MatchRuntimeErrorType error_ = MatchRuntimeErrorType::None;
 
@@ -385,11 +542,18 @@ struct Context {
   /// state->cursor_.currentPointer().
   const CodeUnit *match(State<Traits> *state, bool onlyAtStart);
 
+  /// Equivalent to match(), but using the linear-time executor, which runs in
+  /// time proportional to the length of the input. The regex must not contain
+  /// backreferences or lookarounds. The cursor of \p state must be forwards.
+  const CodeUnit *matchLinear(State<Traits> *state, bool onlyAtStart);
+
   /// Backtrack the given state \p s with the backtrack stack \p bts.
-  /// \return true if we backatracked, false if we exhausted the stack.
+  /// \return true if we backatracked, false if we exhausted the stack or it
+  /// overflowed.
   bool backtrack(BacktrackStack &bts, State<Traits> *s);
 
   /// Set the state's position to the body of a non-greedy loop.
+  /// \return true on success, false if the backtrack stack overflowed.
   bool performEnterNonGreedyLoop(
       State<Traits> *s,
       const BeginLoopInsn *loop,
@@ -411,6 +575,21 @@ struct Context {
     return true;
   }
 
+  /// Match the instruction \p insn, which must consume characters, against
+  /// the cursor \p c. \return true on success, with \p c advanced past the
+  /// consumed characters; false on failure.
+  bool matchConsumingInsn(const Insn *insn, Cursor<Traits> &c);
+
+  /// Follow the instructions from \p thread at the input position \p pos in
+  /// the linear-time executor, until reaching instructions which consume
+  /// characters. Add the resulting threads to \p threads, in order of
+  /// priority. \p thread is clobbered.
+  void addLinearThreads(
+      LinearExecution &exec,
+      LinearThreadSet &threads,
+      uint32_t *thread,
+      const CodeUnit *pos);
+
   /// Run the given Width1Loop \p insn on the given state \p s with the
   /// backtrack stack \p bts.
   /// \return true on success, false if we should backtrack.
@@ -435,11 +614,11 @@ struct Context {
   inline bool matchWidth1(const Insn *insn, CodeUnit c) const;
 
   /// \return true if all chars, stored in contiguous memory after \p insn,
-  /// match the chars in state \p s in the same order, case insensitive. Note
-  /// the count of chars is given in \p insn.
+  /// match the chars under cursor \p c in the same order, case insensitive.
+  /// Note the count of chars is given in \p insn.
   inline bool matchesNCharICase8(
       const MatchNCharICase8Insn *insn,
-      State<Traits> &s);
+      Cursor<Traits> &c);
 
   /// Execute the given Width1 instruction \p loopBody on cursor \p c up to \p
   /// max times. \return the number of matches made, not to exceed \p max.
@@ -519,9 +698,8 @@ bool isLineTerminator(CharT c) {
 }
 
 template <class Traits>
-bool matchesLeftAnchor(Context<Traits> &ctx, State<Traits> &s) {
+bool matchesLeftAnchor(Context<Traits> &ctx, const Cursor<Traits> &c) {
   bool matchesAnchor = false;
-  const Cursor<Traits> &c = s.cursor_;
   if (c.atLeft()) {
     // Beginning of text.
     matchesAnchor = true;
@@ -535,9 +713,8 @@ bool matchesLeftAnchor(Context<Traits> &ctx, State<Traits> &s) {
 }
 
 template <class Traits>
-bool matchesRightAnchor(Context<Traits> &ctx, State<Traits> &s) {
+bool matchesRightAnchor(Context<Traits> &ctx, const Cursor<Traits> &c) {
   bool matchesAnchor = false;
-  const Cursor<Traits> &c = s.cursor_;
   if (c.atRight() && !(ctx.flags_ & constants::matchNotEndOfLine)) {
     matchesAnchor = true;
   } else if (
@@ -548,12 +725,29 @@ bool matchesRightAnchor(Context<Traits> &ctx, State<Traits> &s) {
   return matchesAnchor;
 }
 
+/// \return whether the cursor \p c is at a word boundary.
+template <class Traits>
+bool matchesWordBoundary(Context<Traits> &ctx, const Cursor<Traits> &c) {
+  const auto *charPointer = c.currentPointer();
+
+  bool prevIsWordchar = false;
+  if (!c.atLeft())
+    prevIsWordchar =
+        ctx.traits_.characterHasType(charPointer[-1], CharacterClass::Words);
+
+  bool currentIsWordchar = false;
+  if (!c.atRight())
+    currentIsWordchar =
+        ctx.traits_.characterHasType(charPointer[0], CharacterClass::Words);
+
+  return prevIsWordchar != currentIsWordchar;
+}
+
 /// \return true if all chars, stored in contiguous memory after \p insn,
-/// match the chars in state \p s in the same order. Note the count of chars
-/// is given in \p insn.
+/// match the chars under cursor \p c in the same order. Note the count of
+/// chars is given in \p insn.
 template <class Traits>
-bool matchesNChar8(const MatchNChar8Insn *insn, State<Traits> &s) {
-  Cursor<Traits> &c = s.cursor_;
+bool matchesNChar8(const MatchNChar8Insn *insn, Cursor<Traits> &c) {
   auto insnCharPtr = reinterpret_cast<const char *>(insn + 1);
   auto charCount = insn->charCount;
   for (int idx = 0; idx < charCount; idx++) {
@@ -567,8 +761,7 @@ bool matchesNChar8(const MatchNChar8Insn *insn, State<Traits> &s) {
 template <class Traits>
 bool Context<Traits>::matchesNCharICase8(
     const MatchNCharICase8Insn *insn,
-    State<Traits> &s) {
-  Cursor<Traits> &c = s.cursor_;
+    Cursor<Traits> &c) {
   auto insnCharPtr = reinterpret_cast<const char *>(insn + 1);
   auto charCount = insn->charCount;
   bool unicode = syntaxFlags_ & constants::unicode;
@@ -661,8 +854,7 @@ bool Context<Traits>::performEnterNonGreedyLoop(
   // loop.
   s->ip_ = bodyIp;
   s->cursor_.setCurrentPointer(first_ + loopData.entryPosition);
-  prepareToEnterLoopBody(s, loop, backtrackStack);
-  return true;
+  return prepareToEnterLoopBody(s, loop, backtrackStack);
 }
 
 template <class Traits>
@@ -690,9 +882,8 @@ bool Context<Traits>::backtrack(BacktrackStack &bts, State<Traits> *s) {
       case BacktrackOp::EnterNonGreedyLoop: {
         auto fields = binsn.enterNonGreedyLoop;
         bts.pop_back();
-        performEnterNonGreedyLoop(
+        return performEnterNonGreedyLoop(
             s, fields.loopInsn, fields.bodyIp, fields.loopData, bts);
-        return true;
       }
 
       case BacktrackOp::GreedyWidth1Loop:
@@ -836,6 +1027,10 @@ bool Context<Traits>::matchWidth1Loop(
       break;
   }
 
+  // Charge the consumed characters, since an enclosing construct may make us
+  // consume them again.
+  stepsRemaining_ -= std::min(uint64_t(matched), stepsRemaining_);
+
   // If we iterated less than the minimum, we failed to match.
   if (matched < minMatch) {
     return false;
@@ -901,6 +1096,54 @@ inline size_t Context<Traits>::advanceStringIndex(
   return index + 2;
 }
 
+/// \return the only character in the first character set of \p header, or -1
+/// if the set does not contain exactly one character.
+static int singleFirstChar(const RegexBytecodeHeader &header) {
+  int result = -1;
+  for (size_t i = 0; i < sizeof(header.firstChars); i++) {
+    uint8_t bits = header.firstChars[i];
+    if (!bits)
+      continue;
+    if (result >= 0 || (bits & (bits - 1)))
+      return -1;
+    result = i * 8 + llvm::countTrailingZeros(bits);
+  }
+  return result;
+}
+
+/// \return the index of the first occurrence of \p c in the string \p start,
+/// searching from \p index up to \p length, or \p length if there is none.
+static size_t findChar(const char *start, size_t index, size_t length, char c) {
+  const void *found = std::memchr(start + index, c, length - index);
+  return found ? static_cast<const char *>(found) - start : length;
+}
+
+static size_t
+findChar(const char16_t *start, size_t index, size_t length, char16_t c) {
+  return std::find(start + index, start + length, c) - start;
+}
+
+/// \return the index of the first code unit of the string \p start, searching
+/// from \p index up to \p length, which is in the first character set of
+/// \p header, or \p length if there is none. \p singleChar is the result of
+/// singleFirstChar() for the header.
+template <typename CodeUnit>
+static size_t findFirstChar(
+    const RegexBytecodeHeader &header,
+    int singleChar,
+    const CodeUnit *start,
+    size_t index,
+    size_t length) {
+  if (singleChar >= 0)
+    return findChar(start, index, length, static_cast<CodeUnit>(singleChar));
+  using UnsignedCodeUnit = typename std::make_unsigned<CodeUnit>::type;
+  while (index < length &&
+         !header.isFirstChar(static_cast<UnsignedCodeUnit>(start[index]))) {
+    index++;
+  }
+  return index;
+}
+
 template <class Traits>
 auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
     -> const CodeUnit * {
@@ -929,6 +1172,14 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
       (c.forwards() || locsToCheckCount == 1) &&
       "Can only check one location when cursor is backwards");
 
+  // If every match must begin with one of a set of characters, skip over the
+  // locations which do not start with one. The empty range at the end can then
+  // never match either.
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(bytecodeStream_.data());
+  const bool useFirstChars = !onlyAtStart && header->hasFirstChars();
+  const int singleChar = useFirstChars ? singleFirstChar(*header) : -1;
+
   // Macro used when a state fails to match.
 #define BACKTRACK()                   \
   do {                                \
@@ -939,24 +1190,37 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
   for (size_t locIndex = 0; locIndex < locsToCheckCount;
        locIndex = advanceStringIndex(startLoc, locIndex, locsToCheckCount)) {
+    if (useFirstChars) {
+      // First characters are ASCII, so they are never in the middle of a
+      // surrogate pair.
+      locIndex = findFirstChar(
+          *header, singleChar, startLoc, locIndex, locsToCheckCount - 1);
+      if (locIndex == locsToCheckCount - 1)
+        break;
+    }
     const CodeUnit *potentialMatchLocation = startLoc + locIndex;
     c.setCurrentPointer(potentialMatchLocation);
     s->ip_ = startIp;
   backtrackingSucceeded:
     for (;;) {
+      if (LLVM_UNLIKELY(stepsRemaining_ == 0)) {
+        error_ = MatchRuntimeErrorType::StepLimit;
+        return nullptr;
+      }
+      stepsRemaining_--;
       const Insn *base = reinterpret_cast<const Insn *>(&bytecode[s->ip_]);
       switch (base->opcode) {
         case Opcode::Goal:
           return potentialMatchLocation;
 
         case Opcode::LeftAnchor:
-          if (!matchesLeftAnchor(*this, *s))
+          if (!matchesLeftAnchor(*this, c))
             BACKTRACK();
           s->ip_ += sizeof(LeftAnchorInsn);
           break;
 
         case Opcode::RightAnchor:
-          if (!matchesRightAnchor(*this, *s))
+          if (!matchesRightAnchor(*this, c))
             BACKTRACK();
           s->ip_ += sizeof(RightAnchorInsn);
           break;
@@ -1033,7 +1297,7 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
         case Opcode::MatchNChar8: {
           const auto *insn = llvm::cast<MatchNChar8Insn>(base);
-          if (c.remaining() < insn->charCount || !matchesNChar8(insn, *s))
+          if (c.remaining() < insn->charCount || !matchesNChar8(insn, c))
             BACKTRACK();
           s->ip_ += insn->totalWidth();
           break;
@@ -1041,7 +1305,7 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
         case Opcode::MatchNCharICase8: {
           const auto *insn = llvm::cast<MatchNCharICase8Insn>(base);
-          if (c.remaining() < insn->charCount || !matchesNCharICase8(insn, *s))
+          if (c.remaining() < insn->charCount || !matchesNCharICase8(insn, c))
             BACKTRACK();
           s->ip_ += insn->totalWidth();
           break;
@@ -1102,20 +1366,7 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
         case Opcode::WordBoundary: {
           const WordBoundaryInsn *insn = llvm::cast<WordBoundaryInsn>(base);
-          const auto *charPointer = c.currentPointer();
-
-          bool prevIsWordchar = false;
-          if (!c.atLeft())
-            prevIsWordchar = traits_.characterHasType(
-                charPointer[-1], CharacterClass::Words);
-
-          bool currentIsWordchar = false;
-          if (!c.atRight())
-            currentIsWordchar =
-                traits_.characterHasType(charPointer[0], CharacterClass::Words);
-
-          bool isWordBoundary = (prevIsWordchar != currentIsWordchar);
-          if (isWordBoundary ^ insn->invert)
+          if (matchesWordBoundary(*this, c) ^ insn->invert)
             s->ip_ += sizeof(WordBoundaryInsn);
           else
             BACKTRACK();
@@ -1329,7 +1580,8 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
           if (!doLoopBody && !doNotTaken) {
             BACKTRACK();
           } else if (doLoopBody && !doNotTaken) {
-            prepareToEnterLoopBody(s, loop, backtrackStack);
+            if (!prepareToEnterLoopBody(s, loop, backtrackStack))
+              return nullptr;
             s->ip_ = loopTakenIp;
 
           } else if (doNotTaken && !doLoopBody) {
@@ -1358,7 +1610,8 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
                 error_ = MatchRuntimeErrorType::MaxStackDepth;
                 return nullptr;
               }
-              prepareToEnterLoopBody(s, loop, backtrackStack);
+              if (!prepareToEnterLoopBody(s, loop, backtrackStack))
+                return nullptr;
               s->ip_ = loopTakenIp;
             }
           }
@@ -1410,12 +1663,413 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
     }
   // The search failed at this location.
   backtrackingExhausted:
+    // Running out of backtracking stack ends the search.
+    if (error_ != MatchRuntimeErrorType::None)
+      return nullptr;
     continue;
   }
   // The match failed.
   return nullptr;
 }
 
+/// \return the width of the instruction \p insn, which must consume characters.
+static uint32_t consumingInsnWidth(const Insn *insn) {
+  switch (insn->opcode) {
+    case Opcode::MatchAnyButNewline:
+      return sizeof(MatchAnyButNewlineInsn);
+    case Opcode::U16MatchAnyButNewline:
+      return sizeof(U16MatchAnyButNewlineInsn);
+    case Opcode::MatchChar8:
+      return sizeof(MatchChar8Insn);
+    case Opcode::MatchChar16:
+      return sizeof(MatchChar16Insn);
+    case Opcode::U16MatchChar32:
+      return sizeof(U16MatchChar32Insn);
+    case Opcode::MatchCharICase8:
+      return sizeof(MatchCharICase8Insn);
+    case Opcode::MatchCharICase16:
+      return sizeof(MatchCharICase16Insn);
+    case Opcode::U16MatchCharICase32:
+      return sizeof(U16MatchCharICase32Insn);
+    case Opcode::MatchNChar8:
+      return llvm::cast<MatchNChar8Insn>(insn)->totalWidth();
+    case Opcode::MatchNCharICase8:
+      return llvm::cast<MatchNCharICase8Insn>(insn)->totalWidth();
+    case Opcode::Bracket:
+      return llvm::cast<BracketInsn>(insn)->totalWidth();
+    case Opcode::U16Bracket:
+      return llvm::cast<U16BracketInsn>(insn)->totalWidth();
+    default:
+      llvm_unreachable("Instruction does not consume characters");
+  }
+}
+
+template <class Traits>
+bool Context<Traits>::matchConsumingInsn(const Insn *base, Cursor<Traits> &c) {
+  if (c.atEnd())
+    return false;
+  switch (base->opcode) {
+    case Opcode::MatchAnyButNewline:
+      return matchWidth1<Width1Opcode::MatchAnyButNewline>(base, c.consume());
+    case Opcode::U16MatchAnyButNewline:
+      c.consumeUTF16();
+      return true;
+    case Opcode::MatchChar8:
+      return matchWidth1<Width1Opcode::MatchChar8>(base, c.consume());
+    case Opcode::MatchChar16:
+      return matchWidth1<Width1Opcode::MatchChar16>(base, c.consume());
+    case Opcode::U16MatchChar32:
+      return c.consumeUTF16() ==
+          (CodePoint)llvm::cast<U16MatchChar32Insn>(base)->c;
+    case Opcode::MatchCharICase8:
+      return matchWidth1<Width1Opcode::MatchCharICase8>(base, c.consume());
+    case Opcode::MatchCharICase16:
+      return matchWidth1<Width1Opcode::MatchCharICase16>(base, c.consume());
+    case Opcode::U16MatchCharICase32: {
+      const auto *insn = llvm::cast<U16MatchCharICase32Insn>(base);
+      CodePoint cp = c.consumeUTF16();
+      return cp == (CodePoint)insn->c ||
+          traits_.canonicalize(cp, true) == (CodePoint)insn->c;
+    }
+    case Opcode::MatchNChar8: {
+      const auto *insn = llvm::cast<MatchNChar8Insn>(base);
+      return c.remaining() >= insn->charCount && matchesNChar8(insn, c);
+    }
+    case Opcode::MatchNCharICase8: {
+      const auto *insn = llvm::cast<MatchNCharICase8Insn>(base);
+      return c.remaining() >= insn->charCount && matchesNCharICase8(insn, c);
+    }
+    case Opcode::Bracket:
+      return matchWidth1<Width1Opcode::Bracket>(base, c.consume());
+    case Opcode::U16Bracket: {
+      const U16BracketInsn *insn = llvm::cast<U16BracketInsn>(base);
+      const BracketRange32 *ranges =
+          reinterpret_cast<const BracketRange32 *>(insn + 1);
+      return bracketMatchesChar<Traits>(*this, insn, ranges, c.consumeUTF16());
+    }
+    default:
+      llvm_unreachable("Instruction does not consume characters");
+  }
+}
+
+template <class Traits>
+void Context<Traits>::addLinearThreads(
+    LinearExecution &exec,
+    LinearThreadSet &threads,
+    uint32_t *thread,
+    const CodeUnit *pos) {
+  const uint8_t *const bytecode = &bytecodeStream_[sizeof(RegexBytecodeHeader)];
+  const uint32_t size = exec.threadSize;
+  const uint32_t offset = pos - first_;
+  const Cursor<Traits> c{first_, pos, last_, true /* forwards */};
+  std::vector<uint32_t> &pending = exec.pending;
+
+  // Push a copy of the thread as a lower priority alternative, to be followed
+  // once the thread itself has been. \return the copy.
+  auto pushAlternative = [&]() -> uint32_t * {
+    pending.insert(pending.end(), thread, thread + size);
+    return &pending[pending.size() - size];
+  };
+  auto loopWord = [](uint32_t loopId) {
+    return LinearThreadLoops + 2 * loopId;
+  };
+
+  assert(pending.empty() && "Pending threads left over");
+  pushAlternative();
+  while (!pending.empty()) {
+    std::copy(pending.end() - size, pending.end(), thread);
+    pending.resize(pending.size() - size);
+
+    // Follow the thread until it dies, reaches an instruction consuming
+    // characters, or reaches a state which was already visited.
+    bool alive = true;
+    while (alive && threads.visit(thread, offset)) {
+      uint32_t &ip = thread[LinearThreadIp];
+      const Insn *base = reinterpret_cast<const Insn *>(&bytecode[ip]);
+      switch (base->opcode) {
+        case Opcode::Goal:
+        case Opcode::MatchAnyButNewline:
+        case Opcode::U16MatchAnyButNewline:
+        case Opcode::MatchChar8:
+        case Opcode::MatchChar16:
+        case Opcode::U16MatchChar32:
+        case Opcode::MatchNChar8:
+        case Opcode::MatchNCharICase8:
+        case Opcode::MatchCharICase8:
+        case Opcode::MatchCharICase16:
+        case Opcode::U16MatchCharICase32:
+        case Opcode::Bracket:
+        case Opcode::U16Bracket:
+          threads.push(thread);
+          alive = false;
+          break;
+
+        case Opcode::LeftAnchor:
+          alive = matchesLeftAnchor(*this, c);
+          ip += sizeof(LeftAnchorInsn);
+          break;
+
+        case Opcode::RightAnchor:
+          alive = matchesRightAnchor(*this, c);
+          ip += sizeof(RightAnchorInsn);
+          break;
+
+        case Opcode::WordBoundary: {
+          const WordBoundaryInsn *insn = llvm::cast<WordBoundaryInsn>(base);
+          alive = matchesWordBoundary(*this, c) ^ insn->invert;
+          ip += sizeof(WordBoundaryInsn);
+          break;
+        }
+
+        case Opcode::Alternation: {
+          const AlternationInsn *alt = llvm::cast<AlternationInsn>(base);
+          pushAlternative()[LinearThreadIp] = alt->secondaryBranch;
+          ip += sizeof(AlternationInsn);
+          break;
+        }
+
+        case Opcode::Jump32:
+          ip = llvm::cast<Jump32Insn>(base)->target;
+          break;
+
+        case Opcode::BeginMarkedSubexpression: {
+          const auto *insn = llvm::cast<BeginMarkedSubexpressionInsn>(base);
+          thread[exec.startIndex + 2 * insn->mexp - 1] = offset;
+          ip += sizeof(BeginMarkedSubexpressionInsn);
+          break;
+        }
+
+        case Opcode::EndMarkedSubexpression: {
+          const auto *insn = llvm::cast<EndMarkedSubexpressionInsn>(base);
+          thread[exec.startIndex + 2 * insn->mexp] = offset;
+          ip += sizeof(EndMarkedSubexpressionInsn);
+          break;
+        }
+
+        case Opcode::BeginSimpleLoop: {
+          // Simple loops are greedy, and their body never matches empty.
+          const auto *loop = llvm::cast<BeginSimpleLoopInsn>(base);
+          pushAlternative()[LinearThreadIp] = loop->notTakenTarget;
+          ip += sizeof(BeginSimpleLoopInsn);
+          break;
+        }
+
+        case Opcode::EndSimpleLoop:
+          ip = llvm::cast<EndSimpleLoopInsn>(base)->target;
+          break;
+
+        case Opcode::Width1Loop: {
+          // Either wait at the body for the next character, or exit the loop.
+          const Width1LoopInsn *loop = llvm::cast<Width1LoopInsn>(base);
+          uint32_t iterations = thread[LinearThreadWidth1Count];
+          bool doBody = iterations < loop->max;
+          bool doNotTaken = iterations >= loop->min;
+          uint32_t *body = thread;
+          uint32_t *notTaken = thread;
+          if (doBody && doNotTaken)
+            (loop->greedy ? notTaken : body) = pushAlternative();
+          if (doNotTaken) {
+            notTaken[LinearThreadIp] = loop->notTakenTarget;
+            notTaken[LinearThreadWidth1Count] = 0;
+          }
+          if (doBody) {
+            body[LinearThreadIp] += sizeof(Width1LoopInsn);
+            body[LinearThreadWidth1Count] = iterations + 1;
+          }
+          alive = doBody || doNotTaken;
+          break;
+        }
+
+        case Opcode::BeginLoop:
+          // Entering the loop from outside.
+          thread[loopWord(llvm::cast<BeginLoopInsn>(base)->loopId)] = 0;
+          goto runLoop;
+
+        case Opcode::EndLoop:
+          ip = llvm::cast<EndLoopInsn>(base)->target;
+          base = reinterpret_cast<const Insn *>(&bytecode[ip]);
+          // Note fall through.
+
+        runLoop : {
+          // This follows the backtracking executor; see there for details.
+          const BeginLoopInsn *loop = llvm::cast<BeginLoopInsn>(base);
+          uint32_t word = loopWord(loop->loopId);
+          uint32_t iterations = thread[word];
+          bool doBody = iterations < loop->max;
+          bool doNotTaken = iterations >= loop->min;
+          if (iterations > loop->min && thread[word + 1] == offset) {
+            alive = false;
+            break;
+          }
+          uint32_t *body = thread;
+          uint32_t *notTaken = thread;
+          if (doBody && doNotTaken)
+            (loop->greedy ? notTaken : body) = pushAlternative();
+          if (doNotTaken) {
+            notTaken[LinearThreadIp] = loop->notTakenTarget;
+            notTaken[word] = 0;
+            notTaken[word + 1] = 0;
+          }
+          if (doBody) {
+            // Once an unbounded loop has run more than its minimum number of
+            // iterations, the exact count no longer matters. Saturate it so
+            // that it does not distinguish states.
+            uint32_t maxCount =
+                loop->max == std::numeric_limits<uint32_t>::max()
+                ? loop->min + 1
+                : loop->max;
+            body[LinearThreadIp] += sizeof(BeginLoopInsn);
+            body[word] = std::min(iterations + 1, maxCount);
+            body[word + 1] = offset;
+            for (uint32_t mexp = loop->mexpBegin; mexp != loop->mexpEnd;
+                 mexp++) {
+              body[exec.startIndex + 1 + 2 * mexp] = kNotMatched;
+              body[exec.startIndex + 2 + 2 * mexp] = kNotMatched;
+            }
+          }
+          alive = doBody || doNotTaken;
+          break;
+        }
+
+        case Opcode::BackRef:
+        case Opcode::Lookaround:
+          llvm_unreachable("Not supported by the linear-time executor");
+      }
+    }
+  }
+}
+
+template <class Traits>
+auto Context<Traits>::matchLinear(State<Traits> *s, bool onlyAtStart)
+    -> const CodeUnit * {
+  Cursor<Traits> &c = s->cursor_;
+  assert(c.forwards() && "Linear-time executor only tracks forwards");
+  const uint8_t *const bytecode = &bytecodeStream_[sizeof(RegexBytecodeHeader)];
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(bytecodeStream_.data());
+  assert(header->linearExecutable && "Regex requires backtracking");
+
+  LinearExecution exec{markedCount_, loopCount_};
+  const uint32_t size = exec.threadSize;
+  LinearThreadSet threadSets[2] = {{size, loopCount_}, {size, loopCount_}};
+  LinearThreadSet *current = &threadSets[0];
+  LinearThreadSet *next = &threadSets[1];
+  std::vector<uint32_t> thread(size);
+
+  // The highest priority thread which reached the goal so far, and the end of
+  // its match. Once a thread matches, no new match attempts are started.
+  std::vector<uint32_t> matched;
+  const CodeUnit *matchEnd = nullptr;
+
+  const CodeUnit *const startLoc = c.currentPointer();
+  const size_t locsToCheckCount = 1 + c.remaining();
+  const bool useFirstChars = !onlyAtStart && header->hasFirstChars();
+  const int singleChar = useFirstChars ? singleFirstChar(*header) : -1;
+
+  // The next location at which to start a match attempt.
+  size_t nextStart = 0;
+  for (size_t locIndex = 0;;) {
+    if (matched.empty()) {
+      if (current->size() == 0) {
+        // Nothing is running, so skip to the next match attempt.
+        if (nextStart >= locsToCheckCount)
+          break;
+        locIndex = nextStart;
+        if (useFirstChars) {
+          locIndex = findFirstChar(
+              *header, singleChar, startLoc, locIndex, locsToCheckCount - 1);
+          if (locIndex == locsToCheckCount - 1)
+            break;
+          nextStart = locIndex;
+        }
+        current->clear();
+      }
+      if (locIndex == nextStart) {
+        // Start a match attempt, with lower priority than the running ones.
+        const uint32_t startOffset = startLoc + locIndex - first_;
+        std::fill(thread.begin(), thread.end(), 0);
+        thread[exec.startIndex] = startOffset;
+        std::fill(
+            thread.begin() + exec.startIndex + 1, thread.end(), kNotMatched);
+        addLinearThreads(exec, *current, thread.data(), startLoc + locIndex);
+        nextStart = onlyAtStart
+            ? locsToCheckCount
+            : advanceStringIndex(startLoc, locIndex, locsToCheckCount);
+      }
+    }
+    if (current->size() == 0) {
+      if (!matched.empty())
+        break;
+      continue;
+    }
+
+    // Advance each thread past the character at this location, in order of
+    // priority.
+    const CodeUnit *pos = startLoc + locIndex;
+    const uint32_t nextOffset = pos + 1 - first_;
+    next->clear();
+    for (size_t i = 0, e = current->size(); i < e; i++) {
+      std::copy(current->at(i), current->at(i) + size, thread.begin());
+      uint32_t &ip = thread[LinearThreadIp];
+      if (thread[LinearThreadWait] > 0) {
+        if (--thread[LinearThreadWait] == 0)
+          addLinearThreads(exec, *next, thread.data(), pos + 1);
+        else if (next->visit(thread.data(), nextOffset))
+          next->push(thread.data());
+        continue;
+      }
+
+      const Insn *base = reinterpret_cast<const Insn *>(&bytecode[ip]);
+      if (base->opcode == Opcode::Goal) {
+        // This thread takes precedence over all the following ones.
+        matched = thread;
+        matchEnd = pos;
+        break;
+      }
+      Cursor<Traits> cursor{first_, pos, last_, true /* forwards */};
+      if (!matchConsumingInsn(base, cursor))
+        continue;
+
+      if (uint32_t iterations = thread[LinearThreadWidth1Count]) {
+        // We matched the body of a Width1Loop; return to the loop. As with
+        // other loops, saturate the iteration count of unbounded loops.
+        ip -= sizeof(Width1LoopInsn);
+        const Width1LoopInsn *loop =
+            llvm::cast<Width1LoopInsn>(reinterpret_cast<const Insn *>(
+                &bytecode[ip]));
+        if (loop->max == std::numeric_limits<uint32_t>::max())
+          iterations = std::min(iterations, loop->min);
+        thread[LinearThreadWidth1Count] = iterations;
+      } else {
+        ip += consumingInsnWidth(base);
+      }
+
+      uint32_t consumed = cursor.currentPointer() - pos;
+      if (consumed == 1) {
+        addLinearThreads(exec, *next, thread.data(), pos + 1);
+      } else {
+        thread[LinearThreadWait] = consumed - 1;
+        if (next->visit(thread.data(), nextOffset))
+          next->push(thread.data());
+      }
+    }
+
+    if (locIndex + 1 == locsToCheckCount)
+      break;
+    std::swap(current, next);
+    locIndex++;
+  }
+
+  if (matched.empty())
+    return nullptr;
+  for (uint32_t mexp = 0; mexp < markedCount_; mexp++) {
+    s->getCapturedRange(mexp) = {matched[exec.startIndex + 1 + 2 * mexp],
+                                 matched[exec.startIndex + 2 + 2 * mexp]};
+  }
+  c.setCurrentPointer(matchEnd);
+  return first_ + matched[exec.startIndex];
+}
+
 /// Entry point for searching a string via regex compiled bytecode.
 /// Given the bytecode \p bytecode, search the range starting at \p first up to
 /// (not including) \p last with the flags \p matchFlags. If the search
@@ -1458,8 +2112,30 @@ MatchRuntimeResult searchWithBytecodeImpl(
   bool onlyAtStart = (header->constraints & MatchConstraintAnchoredAtStart) ||
       (matchFlags & constants::matchOnlyAtStart);
 
+  // Regexes supported by the linear-time executor are first run with a limited
+  // number of steps, which is enough for most. If they run out, the regex is
+  // likely backtracking excessively, so switch to the linear-time executor.
+  // The steps taken before that are linear in the input too.
+  const CharT *matchStartLoc = nullptr;
+  if (header->linearExecutable && (matchFlags & constants::matchLinearTime)) {
+    matchStartLoc = ctx.matchLinear(&state, onlyAtStart);
+  } else {
+    if (header->linearExecutable) {
+      ctx.stepsRemaining_ = kLinearFallbackSteps +
+          uint64_t(kLinearFallbackStepsPerCodeUnit) * length;
+    }
+    matchStartLoc = ctx.match(&state, onlyAtStart);
+    if (header->linearExecutable &&
+        (ctx.error_ == MatchRuntimeErrorType::StepLimit ||
+         ctx.error_ == MatchRuntimeErrorType::MaxStackDepth)) {
+      ctx.error_ = MatchRuntimeErrorType::None;
+      state = State<Traits>{cursor, markedCount, loopCount};
+      matchStartLoc = ctx.matchLinear(&state, onlyAtStart);
+    }
+  }
+
   auto result = MatchRuntimeResult::NoMatch;
-  if (const CharT *matchStartLoc = ctx.match(&state, onlyAtStart)) {
+  if (matchStartLoc) {
     // Match succeeded. Return captured ranges. The first range is the total
     // match, followed by any capture groups.
     if (m != nullptr) {
@@ -1481,6 +2157,79 @@ MatchRuntimeResult searchWithBytecodeImpl(
   return result;
 }
 
+/// Search for a match using the native code \p matchFn, which was compiled
+/// from \p bytecode. The parameters are as for searchWithBytecodeImpl().
+template <typename CharT, class Traits>
+MatchRuntimeResult searchWithNativeMatcherImpl(
+    llvm::ArrayRef<uint8_t> bytecode,
+    NativeMatchFn<CharT> matchFn,
+    const CharT *first,
+    uint32_t start,
+    uint32_t length,
+    std::vector<CapturedRange> *m,
+    constants::MatchFlagType matchFlags) {
+  assert(
+      bytecode.size() >= sizeof(RegexBytecodeHeader) && "Bytecode too small");
+  auto header = reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+
+  // The native code does not implement these flags.
+  if (matchFlags & (constants::matchNotEndOfLine | constants::matchLinearTime))
+    return searchWithBytecodeImpl<CharT, Traits>(
+        bytecode, first, start, length, m, matchFlags);
+
+  Cursor<Traits> cursor{
+      first, first + start, first + length, true /* forwards */};
+  if (!cursor.satisfiesConstraints(matchFlags, header->constraints))
+    return MatchRuntimeResult::NoMatch;
+
+  bool onlyAtStart = (header->constraints & MatchConstraintAnchoredAtStart) ||
+      (matchFlags & constants::matchOnlyAtStart);
+  const bool useFirstChars = !onlyAtStart && header->hasFirstChars();
+  const int singleChar = useFirstChars ? singleFirstChar(*header) : -1;
+
+  // Give the native code the same budget as the backtracking executor. If it
+  // runs out, the interpreter takes over the whole search and may switch to
+  // the linear-time executor.
+  uint64_t budget = kLinearFallbackSteps +
+      uint64_t(kLinearFallbackStepsPerCodeUnit) * length;
+  llvm::SmallVector<const CharT *, 16> captures(2 * header->markedCount);
+  const CharT *const last = first + length;
+  for (size_t index = start; index <= length; ++index) {
+    if (useFirstChars) {
+      index = findFirstChar(*header, singleChar, first, index, length);
+      if (index == length)
+        break;
+    }
+    std::fill(captures.begin(), captures.end(), nullptr);
+    const CharT *matchEnd =
+        matchFn(first + index, first, last, captures.data(), &budget);
+    if (budget == 0)
+      return searchWithBytecodeImpl<CharT, Traits>(
+          bytecode, first, start, length, m, matchFlags);
+    if (matchEnd) {
+      if (m != nullptr) {
+        m->clear();
+        m->push_back(CapturedRange{static_cast<uint32_t>(index),
+                                   static_cast<uint32_t>(matchEnd - first)});
+        for (uint32_t i = 0; i < header->markedCount; ++i) {
+          const CharT *captureStart = captures[2 * i];
+          const CharT *captureEnd = captures[2 * i + 1];
+          if (captureStart && captureEnd)
+            m->push_back(
+                CapturedRange{static_cast<uint32_t>(captureStart - first),
+                              static_cast<uint32_t>(captureEnd - first)});
+          else
+            m->push_back(CapturedRange{kNotMatched, kNotMatched});
+        }
+      }
+      return MatchRuntimeResult::Match;
+    }
+    if (onlyAtStart)
+      break;
+  }
+  return MatchRuntimeResult::NoMatch;
+}
+
 MatchRuntimeResult searchWithBytecode(
     llvm::ArrayRef<uint8_t> bytecode,
     const char16_t *first,
@@ -1503,5 +2252,29 @@ MatchRuntimeResult searchWithBytecode(
       bytecode, first, start, length, m, matchFlags);
 }
 
+MatchRuntimeResult searchWithNativeMatcher(
+    llvm::ArrayRef<uint8_t> bytecode,
+    const NativeMatcher &matcher,
+    const char16_t *first,
+    uint32_t start,
+    uint32_t length,
+    std::vector<CapturedRange> *m,
+    constants::MatchFlagType matchFlags) {
+  return searchWithNativeMatcherImpl<char16_t, UTF16RegexTraits>(
+      bytecode, matcher.utf16, first, start, length, m, matchFlags);
+}
+
+MatchRuntimeResult searchWithNativeMatcher(
+    llvm::ArrayRef<uint8_t> bytecode,
+    const NativeMatcher &matcher,
+    const char *first,
+    uint32_t start,
+    uint32_t length,
+    std::vector<CapturedRange> *m,
+    constants::MatchFlagType matchFlags) {
+  return searchWithNativeMatcherImpl<char, ASCIIRegexTraits>(
+      bytecode, matcher.ascii, first, start, length, m, matchFlags);
+}
+
 } // namespace regex
 } // namespace hermes
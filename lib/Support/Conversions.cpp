@@ -6,11 +6,462 @@
  */
 
 #include "hermes/Support/Conversions.h"
+#include <cfloat>
 #include <cmath>
+#include <cstring>
 #include "hermes/dtoa/dtoa.h"
 
 namespace hermes {
 
+namespace {
+
+#include "PowersOfTen.inc"
+
+/// \return floor(log2(10^e)) for e in the range of kPowersOfTen.
+inline int floorLog2Pow10(int e) {
+  return (e * 217706) >> 16;
+}
+
+/// Multiply \p a and \p b, and store the 128-bit result in \p hi and \p lo.
+inline void multiply64(uint64_t a, uint64_t b, uint64_t &hi, uint64_t &lo) {
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 product = (unsigned __int128)a * b;
+  hi = (uint64_t)(product >> 64);
+  lo = (uint64_t)product;
+#else
+  uint64_t aLo = (uint32_t)a, aHi = a >> 32;
+  uint64_t bLo = (uint32_t)b, bHi = b >> 32;
+  uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+  uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+  hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  lo = (mid << 32) | (uint32_t)ll;
+#endif
+}
+
+//===----------------------------------------------------------------------===//
+// Shortest round-trip formatting with Grisu3.
+// See Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+// with Integers", PLDI 2010. Grisu3 produces the shortest correctly rounded
+// digits for about 99.5% of doubles, and detects when it cannot, in which case
+// we fall back to dtoa.
+
+/// A floating point number f * 2^e with a 64-bit significand.
+struct DiyFp {
+  uint64_t f;
+  int e;
+};
+
+/// The range of binary exponents of the scaled numbers that DigitGen works
+/// with, which guarantees that their integral part fits in 32 bits.
+constexpr int kMinTargetExponent = -60;
+constexpr int kMaxTargetExponent = -32;
+
+/// The most digits Grisu3 produces for a double.
+constexpr int kGrisuMaxDigits = 17;
+
+DiyFp normalize(DiyFp x) {
+  int shift = llvm::countLeadingZeros(x.f);
+  return {x.f << shift, x.e - shift};
+}
+
+/// \return x * y, rounded to 64 bits.
+DiyFp times(DiyFp x, DiyFp y) {
+  uint64_t hi, lo;
+  multiply64(x.f, y.f, hi, lo);
+  return {hi + (lo >> 63), x.e + y.e + 64};
+}
+
+/// \return the normalized power of ten 10^k, rounded to 64 bits.
+DiyFp cachedPowerOfTen(int k) {
+  const uint64_t *entry = kPowersOfTen[k - kPowersOfTenMinExp10];
+  return {entry[0] + (entry[1] >> 63), floorLog2Pow10(k) - 63};
+}
+
+/// Remove excess digits from \p buffer of \p length digits, whose last digit
+/// has weight \p tenKappa, to bring it closer to the number being converted,
+/// given the distances to the upper end of the unsafe interval. All
+/// quantities are scaled by the same power of ten.
+/// \return whether the digits are guaranteed to be the shortest and closest.
+bool roundWeed(
+    char *buffer,
+    int length,
+    uint64_t distanceTooHighW,
+    uint64_t unsafeInterval,
+    uint64_t rest,
+    uint64_t tenKappa,
+    uint64_t unit) {
+  uint64_t smallDistance = distanceTooHighW - unit;
+  uint64_t bigDistance = distanceTooHighW + unit;
+  // Move the last digit down while that brings the number closer to w, and
+  // we certainly stay within the safe interval.
+  while (rest < smallDistance && unsafeInterval - rest >= tenKappa &&
+         (rest + tenKappa < smallDistance ||
+          smallDistance - rest >= rest + tenKappa - smallDistance)) {
+    buffer[length - 1]--;
+    rest += tenKappa;
+  }
+  // If the next smaller digit may also be closer to w, we cannot tell which
+  // is correct.
+  if (rest < bigDistance && unsafeInterval - rest >= tenKappa &&
+      (rest + tenKappa < bigDistance ||
+       bigDistance - rest > rest + tenKappa - bigDistance)) {
+    return false;
+  }
+  // The result must be safely inside the unsafe interval.
+  return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+/// Generate the shortest digits of the number between \p low and \p high
+/// closest to \p w, which have the same exponent in the target range.
+/// \param[out] kappa the decimal exponent of the last generated digit.
+bool digitGen(
+    DiyFp low,
+    DiyFp w,
+    DiyFp high,
+    char *buffer,
+    int &length,
+    int &kappa) {
+  assert(low.e == w.e && w.e == high.e && "Exponents must match");
+  assert(
+      w.e >= kMinTargetExponent && w.e <= kMaxTargetExponent &&
+      "Exponent out of range");
+  // low, w and high are imprecise by up to one unit, so widen the interval
+  // by one unit on each side. Digits outside of it are certainly wrong.
+  uint64_t unit = 1;
+  DiyFp tooLow{low.f - unit, low.e};
+  DiyFp tooHigh{high.f + unit, high.e};
+  uint64_t unsafeInterval = tooHigh.f - tooLow.f;
+  const int shift = -w.e;
+  const uint64_t one = uint64_t(1) << shift;
+  uint32_t integrals = (uint32_t)(tooHigh.f >> shift);
+  uint64_t fractionals = tooHigh.f & (one - 1);
+
+  // Find the largest power of ten not greater than the integral part.
+  static const uint32_t kSmallPowersOfTen[] = {0,
+                                               1,
+                                               10,
+                                               100,
+                                               1000,
+                                               10000,
+                                               100000,
+                                               1000000,
+                                               10000000,
+                                               100000000,
+                                               1000000000};
+  kappa = 0;
+  while (kappa < 10 && integrals >= kSmallPowersOfTen[kappa + 1])
+    ++kappa;
+  uint32_t divisor = kSmallPowersOfTen[kappa];
+
+  length = 0;
+  while (kappa > 0) {
+    buffer[length++] = '0' + integrals / divisor;
+    integrals %= divisor;
+    --kappa;
+    uint64_t rest = ((uint64_t)integrals << shift) + fractionals;
+    if (rest < unsafeInterval) {
+      return roundWeed(
+          buffer,
+          length,
+          tooHigh.f - w.f,
+          unsafeInterval,
+          rest,
+          (uint64_t)divisor << shift,
+          unit);
+    }
+    divisor /= 10;
+  }
+
+  // Generate fractional digits until the rest is inside the interval. The
+  // unit grows with each digit, so this always terminates.
+  for (;;) {
+    fractionals *= 10;
+    unit *= 10;
+    unsafeInterval *= 10;
+    buffer[length++] = '0' + (char)(fractionals >> shift);
+    fractionals &= one - 1;
+    --kappa;
+    if (fractionals < unsafeInterval) {
+      return roundWeed(
+          buffer,
+          length,
+          (tooHigh.f - w.f) * unit,
+          unsafeInterval,
+          fractionals,
+          one,
+          unit);
+    }
+  }
+}
+
+/// Compute the shortest digits of the positive finite double \p v which
+/// convert back to \p v, choosing the closest to \p v if there are several.
+/// \param buffer receives the digits, and must hold kGrisuMaxDigits + 1.
+/// \param[out] length the number of digits.
+/// \param[out] decimalExponent the value of v is digits * 10^decimalExponent.
+/// \return false if the digits could not be determined, in which case the
+///   contents of buffer are unspecified.
+bool grisu3(double v, char *buffer, int &length, int &decimalExponent) {
+  uint64_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  const uint64_t kHiddenBit = uint64_t(1) << 52;
+  uint64_t fraction = bits & (kHiddenBit - 1);
+  int biasedExponent = (int)(bits >> 52) & 0x7FF;
+  DiyFp x = biasedExponent
+      ? DiyFp{fraction | kHiddenBit, biasedExponent - 1075}
+      : DiyFp{fraction, -1074};
+
+  // The boundaries are halfway to the neighboring doubles. The lower one is
+  // closer if v is a power of two, except for the smallest normal exponent.
+  DiyFp plus = normalize({(x.f << 1) + 1, x.e - 1});
+  DiyFp minus = fraction == 0 && biasedExponent > 1
+      ? DiyFp{(x.f << 2) - 1, x.e - 2}
+      : DiyFp{(x.f << 1) - 1, x.e - 1};
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+  DiyFp w = normalize(x);
+  assert(w.e == plus.e && "Boundaries must have the exponent of w");
+
+  // Scale everything by a power of ten that brings the exponent into the
+  // target range.
+  int minExponent = kMinTargetExponent - (w.e + 64);
+  int k = (int)std::ceil((minExponent + 63) * 0.30102999566398114);
+  DiyFp tenK = cachedPowerOfTen(k);
+  assert(
+      w.e + tenK.e + 64 >= kMinTargetExponent &&
+      w.e + tenK.e + 64 <= kMaxTargetExponent && "Bad cached power");
+
+  int kappa;
+  bool result = digitGen(
+      times(minus, tenK),
+      times(w, tenK),
+      times(plus, tenK),
+      buffer,
+      length,
+      kappa);
+  decimalExponent = kappa - k;
+  return result;
+}
+
+/// Write the number with the decimal digits \p s of length \p k and decimal
+/// point position \p n to \p dest, following steps 6 to 10 of ES5.1 9.8.1,
+/// and null-terminate it.
+/// \return the length of the result, excluding the terminating zero.
+size_t formatDecimal(char *dest, bool negative, const char *s, int k, int n) {
+  char *destPtr = dest;
+  if (negative)
+    *destPtr++ = '-';
+
+  if (k <= n && n <= 21) {
+    // Step 6 of 9.8.1.
+    for (int i = 0; i < k; ++i) {
+      *destPtr++ = s[i];
+    }
+    for (int i = 0; i < n - k; ++i) {
+      *destPtr++ = '0';
+    }
+  } else if (0 < n && n <= 21) {
+    // Step 7 of 9.8.1.
+    for (int i = 0; i < n; ++i) {
+      *destPtr++ = s[i];
+    }
+    *destPtr++ = '.';
+    for (int i = n; i < k; ++i) {
+      *destPtr++ = s[i];
+    }
+  } else if (-6 < n && n <= 0) {
+    // Step 8 of 9.8.1.
+    *destPtr++ = '0';
+    *destPtr++ = '.';
+    for (int i = 0; i < -n; ++i) {
+      *destPtr++ = '0';
+    }
+    for (int i = 0; i < k; ++i) {
+      *destPtr++ = s[i];
+    }
+  } else if (k == 1) {
+    // Step 9 of 9.8.1.
+    char nBuf[NUMBER_TO_STRING_BUF_SIZE];
+    int nLen = ::snprintf(nBuf, sizeof(nBuf), "%d", ::abs(n - 1));
+
+    *destPtr++ = s[0];
+    *destPtr++ = 'e';
+    *destPtr++ = n - 1 < 0 ? '-' : '+';
+    for (int i = 0; i < nLen; ++i) {
+      *destPtr++ = nBuf[i];
+    }
+  } else {
+    // Step 10 of 9.8.1.
+    char nBuf[NUMBER_TO_STRING_BUF_SIZE];
+    int nLen = ::snprintf(nBuf, sizeof(nBuf), "%d", ::abs(n - 1));
+
+    *destPtr++ = s[0];
+    *destPtr++ = '.';
+    for (int i = 1; i < k; ++i) {
+      *destPtr++ = s[i];
+    }
+    *destPtr++ = 'e';
+    *destPtr++ = n - 1 < 0 ? '-' : '+';
+    for (int i = 0; i < nLen; ++i) {
+      *destPtr++ = nBuf[i];
+    }
+  }
+
+  // Null-terminate
+  *destPtr++ = '\0';
+  assert(static_cast<size_t>(destPtr - dest) < NUMBER_TO_STRING_BUF_SIZE);
+  return destPtr - dest - 1;
+}
+
+//===----------------------------------------------------------------------===//
+// Decimal parsing with the Clinger fast path and the Eisel-Lemire algorithm.
+// See Daniel Lemire, "Number Parsing at a Gigabyte per Second", Software:
+// Practice and Experience 51(8), 2021.
+
+/// Convert \p mantissa * 10^exp10 to the nearest double, if that can be done
+/// exactly with double arithmetic, or with the 128-bit approximation of
+/// 10^exp10 when it is precise enough to decide the rounding.
+OptValue<double> decimalToDouble(uint64_t mantissa, int exp10, bool negative) {
+  if (mantissa == 0)
+    return negative ? -0.0 : 0.0;
+
+#if FLT_EVAL_METHOD == 0
+  // Both the mantissa and the power of ten are exact doubles, so a single
+  // multiplication or division rounds correctly.
+  static const double kExactPowersOfTen[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  if (mantissa <= (uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+    double d = (double)mantissa;
+    if (exp10 < 0)
+      d /= kExactPowersOfTen[-exp10];
+    else
+      d *= kExactPowersOfTen[exp10];
+    return negative ? -d : d;
+  }
+#endif
+
+  if (exp10 < kPowersOfTenMinExp10 || exp10 > kPowersOfTenMaxExp10)
+    return llvm::None;
+
+  // Normalize the mantissa and multiply it by the high half of the power of
+  // ten.
+  int clz = llvm::countLeadingZeros(mantissa);
+  mantissa <<= clz;
+  uint64_t exp2 = (uint64_t)(floorLog2Pow10(exp10) + 64 + 1023 - clz);
+  const uint64_t *power = kPowersOfTen[exp10 - kPowersOfTenMinExp10];
+  uint64_t hi, lo;
+  multiply64(mantissa, power[0], hi, lo);
+
+  // If the bits below the 54 we keep are all ones, the truncated low half of
+  // the power could carry into them, so take it into account.
+  if ((hi & 0x1FF) == 0x1FF && lo + mantissa < mantissa) {
+    uint64_t hi2, lo2;
+    multiply64(mantissa, power[1], hi2, lo2);
+    uint64_t mergedHi = hi, mergedLo = lo + hi2;
+    if (mergedLo < lo)
+      ++mergedHi;
+    if ((mergedHi & 0x1FF) == 0x1FF && mergedLo + 1 == 0 &&
+        lo2 + mantissa < mantissa) {
+      return llvm::None;
+    }
+    hi = mergedHi;
+    lo = mergedLo;
+  }
+
+  // Keep 54 bits, one more than the result, for rounding.
+  uint64_t msb = hi >> 63;
+  uint64_t bits = hi >> (msb + 9);
+  exp2 -= 1 ^ msb;
+
+  // We cannot tell whether the exact product is halfway between two doubles.
+  if (lo == 0 && (hi & 0x1FF) == 0 && (bits & 3) == 1)
+    return llvm::None;
+
+  // Round to nearest, ties to even, and renormalize if that overflowed.
+  bits += bits & 1;
+  bits >>= 1;
+  if (bits >> 53) {
+    bits >>= 1;
+    ++exp2;
+  }
+
+  // Leave subnormals, infinities and overflow to the slow path.
+  if (exp2 - 1 >= 0x7FF - 1)
+    return llvm::None;
+  bits = (exp2 << 52) | (bits & ((uint64_t(1) << 52) - 1));
+  if (negative)
+    bits |= uint64_t(1) << 63;
+  double result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+inline bool isDigit(char16_t c) {
+  return c >= '0' && c <= '9';
+}
+
+template <typename CharT>
+OptValue<double> parseDecimalFastImpl(const CharT *first, const CharT *last) {
+  const CharT *p = first;
+  bool negative = false;
+  if (p != last && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  // Accumulate up to 19 significant digits, which always fit in 64 bits.
+  uint64_t mantissa = 0;
+  int significantDigits = 0;
+  int exp10 = 0;
+  bool sawDigit = false;
+  for (; p != last && isDigit(*p); ++p) {
+    sawDigit = true;
+    if (mantissa == 0 && *p == '0')
+      continue;
+    if (++significantDigits > 19)
+      return llvm::None;
+    mantissa = mantissa * 10 + (*p - '0');
+  }
+  if (p != last && *p == '.') {
+    for (++p; p != last && isDigit(*p); ++p) {
+      sawDigit = true;
+      --exp10;
+      if (mantissa == 0 && *p == '0')
+        continue;
+      if (++significantDigits > 19)
+        return llvm::None;
+      mantissa = mantissa * 10 + (*p - '0');
+    }
+  }
+  if (!sawDigit)
+    return llvm::None;
+
+  if (p != last && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negativeExp = false;
+    if (p != last && (*p == '+' || *p == '-')) {
+      negativeExp = *p == '-';
+      ++p;
+    }
+    if (p == last || !isDigit(*p))
+      return llvm::None;
+    // Saturate huge exponents, which are out of range anyway.
+    int exp = 0;
+    for (; p != last && isDigit(*p); ++p) {
+      if (exp < 100000)
+        exp = exp * 10 + (*p - '0');
+    }
+    exp10 += negativeExp ? -exp : exp;
+  }
+  if (p != last)
+    return llvm::None;
+
+  return decimalToDouble(mantissa, exp10, negative);
+}
+
+} // namespace
+
 /// Convert a double to a 32-bit integer according to ES5.1 section 9.5.
 /// It can also be used for converting to an unsigned integer, which has the
 /// same bit pattern.
@@ -77,12 +528,39 @@ size_t numberToString(double m, char *dest, size_t destSize) {
     return 9;
   }
 
-  // After special cases, run dtoa to convert.
-  // We do this manually because we need all of the output of dtoa.
-  // Note that n, k, s are defined per ES5.1 9.8.1
+  bool negative = m < 0;
+  double magnitude = negative ? -m : m;
 
-  // Iterator for easier population.
-  char *destPtr = dest;
+  // Fast path for integers below 2^53, whose shortest representation is
+  // the integer itself, since neighboring doubles are at most 1 apart.
+  if (magnitude < 9007199254740992.0) {
+    uint64_t integer = (uint64_t)magnitude;
+    if ((double)integer == magnitude) {
+      char buf[NUMBER_TO_STRING_BUF_SIZE];
+      char *p = buf + sizeof(buf);
+      do {
+        *--p = '0' + integer % 10;
+        integer /= 10;
+      } while (integer);
+      char *destPtr = dest;
+      if (negative)
+        *destPtr++ = '-';
+      size_t len = buf + sizeof(buf) - p;
+      std::memcpy(destPtr, p, len);
+      destPtr[len] = '\0';
+      return destPtr + len - dest;
+    }
+  }
+
+  // Try Grisu3, which handles almost all numbers.
+  char digits[kGrisuMaxDigits + 1];
+  int k, decimalExponent;
+  if (grisu3(magnitude, digits, k, decimalExponent)) {
+    return formatDecimal(dest, negative, digits, k, decimalExponent + k);
+  }
+
+  // Otherwise, run dtoa to convert.
+  // Note that n, k, s are defined per ES5.1 9.8.1
 
   // Decimal point index.
   int n;
@@ -94,73 +572,17 @@ size_t numberToString(double m, char *dest, size_t destSize) {
   char *sEnd;
 
   char *s = ::g_dtoa(m, 0, 0, &n, &sign, &sEnd);
+  size_t len = formatDecimal(dest, sign, s, sEnd - s, n);
+  g_freedtoa(s);
+  return len;
+}
 
-  if (sign)
-    *destPtr++ = '-';
-
-  // Length of decimal representation of s.
-  int k = sEnd - s;
-
-  if (k <= n && n <= 21) {
-    // Step 6 of 9.8.1.
-    for (int i = 0; i < k; ++i) {
-      *destPtr++ = s[i];
-    }
-    for (int i = 0; i < n - k; ++i) {
-      *destPtr++ = '0';
-    }
-  } else if (0 < n && n <= 21) {
-    // Step 7 of 9.8.1.
-    for (int i = 0; i < n; ++i) {
-      *destPtr++ = s[i];
-    }
-    *destPtr++ = '.';
-    for (int i = n; i < k; ++i) {
-      *destPtr++ = s[i];
-    }
-  } else if (-6 < n && n <= 0) {
-    // Step 8 of 9.8.1.
-    *destPtr++ = '0';
-    *destPtr++ = '.';
-    for (int i = 0; i < -n; ++i) {
-      *destPtr++ = '0';
-    }
-    for (int i = 0; i < k; ++i) {
-      *destPtr++ = s[i];
-    }
-  } else if (k == 1) {
-    // Step 9 of 9.8.1.
-    char nBuf[NUMBER_TO_STRING_BUF_SIZE];
-    int nLen = ::snprintf(nBuf, sizeof(nBuf), "%d", ::abs(n - 1));
-
-    *destPtr++ = s[0];
-    *destPtr++ = 'e';
-    *destPtr++ = n - 1 < 0 ? '-' : '+';
-    for (int i = 0; i < nLen; ++i) {
-      *destPtr++ = nBuf[i];
-    }
-  } else {
-    // Step 10 of 9.8.1.
-    char nBuf[NUMBER_TO_STRING_BUF_SIZE];
-    int nLen = ::snprintf(nBuf, sizeof(nBuf), "%d", ::abs(n - 1));
-
-    *destPtr++ = s[0];
-    *destPtr++ = '.';
-    for (int i = 1; i < k; ++i) {
-      *destPtr++ = s[i];
-    }
-    *destPtr++ = 'e';
-    *destPtr++ = n - 1 < 0 ? '-' : '+';
-    for (int i = 0; i < nLen; ++i) {
-      *destPtr++ = nBuf[i];
-    }
-  }
-
-  // Null-terminate
-  *destPtr++ = '\0';
-  assert(static_cast<size_t>(destPtr - dest) < NUMBER_TO_STRING_BUF_SIZE);
+OptValue<double> parseDecimalFast(const char *first, const char *last) {
+  return parseDecimalFastImpl(first, last);
+}
 
-  g_freedtoa(s);
-  return destPtr - dest - 1;
+OptValue<double> parseDecimalFast(const char16_t *first, const char16_t *last) {
+  return parseDecimalFastImpl(first, last);
 }
+
 } // namespace hermes
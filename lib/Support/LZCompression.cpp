@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/LZCompression.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace hermes {
+namespace lz {
+
+namespace {
+
+/// The number of bits in the hash of a sequence of kMinMatch bytes.
+constexpr unsigned kHashBits = 12;
+
+/// The largest length which fits in a token nibble without extension bytes.
+constexpr size_t kMaxNibble = 15;
+
+uint32_t read32(const uint8_t *p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint32_t hashSequence(uint32_t seq) {
+  return (seq * 2654435761u) >> (32 - kHashBits);
+}
+
+/// Append the extension bytes of a length whose nibble was kMaxNibble, where
+/// \p rest is the length minus kMaxNibble.
+void appendLength(std::vector<uint8_t> &out, size_t rest) {
+  for (; rest >= 255; rest -= 255)
+    out.push_back(255);
+  out.push_back(rest);
+}
+
+/// Append a sequence of \p numLiterals bytes at \p literals, followed by a
+/// match of \p matchLength bytes starting \p distance bytes back. A
+/// \p matchLength of zero makes this the last sequence of the block.
+void appendSequence(
+    std::vector<uint8_t> &out,
+    const uint8_t *literals,
+    size_t numLiterals,
+    size_t distance,
+    size_t matchLength) {
+  size_t tokenPos = out.size();
+  out.push_back(0);
+  uint8_t token = std::min(numLiterals, kMaxNibble) << 4;
+  if (numLiterals >= kMaxNibble)
+    appendLength(out, numLiterals - kMaxNibble);
+  out.insert(out.end(), literals, literals + numLiterals);
+  if (matchLength) {
+    assert(distance > 0 && distance <= kMaxDistance && "distance out of range");
+    assert(matchLength >= kMinMatch && "match too short");
+    out.push_back(distance & 0xff);
+    out.push_back(distance >> 8);
+    size_t extra = matchLength - kMinMatch;
+    token |= std::min(extra, kMaxNibble);
+    if (extra >= kMaxNibble)
+      appendLength(out, extra - kMaxNibble);
+  }
+  out[tokenPos] = token;
+}
+
+/// Add the extension bytes at \p in to \p length, which was kMaxNibble.
+/// \return false if the input ends first.
+bool readLength(const uint8_t *&in, const uint8_t *end, size_t &length) {
+  uint8_t byte;
+  do {
+    if (in == end)
+      return false;
+    byte = *in++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+} // namespace
+
+void compress(llvm::ArrayRef<uint8_t> input, std::vector<uint8_t> &out) {
+  const uint8_t *base = input.data();
+  const size_t size = input.size();
+  assert(size <= UINT32_MAX && "input too large to compress");
+  // One plus the position of the last sequence seen with each hash, or zero.
+  std::vector<uint32_t> table(1u << kHashBits, 0);
+  // The start of the literals which have not been written yet.
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (pos + kMinMatch <= size) {
+    uint32_t seq = read32(base + pos);
+    uint32_t &slot = table[hashSequence(seq)];
+    size_t candidate = slot;
+    slot = pos + 1;
+    if (candidate == 0 || pos - (candidate - 1) > kMaxDistance ||
+        read32(base + candidate - 1) != seq) {
+      ++pos;
+      continue;
+    }
+
+    size_t matchPos = candidate - 1;
+    size_t length = kMinMatch;
+    while (pos + length < size && base[matchPos + length] == base[pos + length])
+      ++length;
+    appendSequence(out, base + anchor, pos - anchor, pos - matchPos, length);
+    pos += length;
+    anchor = pos;
+    // Remember a position near the end of the match, so that a repetition of
+    // the data which follows it can be found.
+    if (pos + kMinMatch - 2 <= size)
+      table[hashSequence(read32(base + pos - 2))] = pos - 2 + 1;
+  }
+  appendSequence(out, base + anchor, size - anchor, 0, 0);
+}
+
+bool decompress(
+    llvm::ArrayRef<uint8_t> input,
+    llvm::MutableArrayRef<uint8_t> out) {
+  const uint8_t *in = input.begin();
+  const uint8_t *inEnd = input.end();
+  uint8_t *dst = out.begin();
+  uint8_t *dstEnd = out.end();
+  while (in != inEnd) {
+    uint8_t token = *in++;
+
+    size_t numLiterals = token >> 4;
+    if (numLiterals == kMaxNibble && !readLength(in, inEnd, numLiterals))
+      return false;
+    if (numLiterals > (size_t)(inEnd - in) ||
+        numLiterals > (size_t)(dstEnd - dst))
+      return false;
+    std::memcpy(dst, in, numLiterals);
+    in += numLiterals;
+    dst += numLiterals;
+    // The last sequence has no match.
+    if (in == inEnd)
+      return dst == dstEnd;
+
+    if (inEnd - in < 2)
+      return false;
+    size_t distance = in[0] | (in[1] << 8);
+    in += 2;
+    size_t matchLength = token & kMaxNibble;
+    if (matchLength == kMaxNibble && !readLength(in, inEnd, matchLength))
+      return false;
+    matchLength += kMinMatch;
+    if (distance == 0 || distance > (size_t)(dst - out.begin()) ||
+        matchLength > (size_t)(dstEnd - dst))
+      return false;
+    const uint8_t *match = dst - distance;
+    if (distance >= matchLength) {
+      std::memcpy(dst, match, matchLength);
+      dst += matchLength;
+    } else {
+      // The match overlaps the data it produces, e.g. a run of one byte.
+      for (uint8_t *end = dst + matchLength; dst != end;)
+        *dst++ = *match++;
+    }
+  }
+  // Every block ends with a sequence of literals, even if it is empty.
+  return false;
+}
+
+} // namespace lz
+} // namespace hermes
@@ -270,6 +270,18 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
     case MAdvice::Sequential:
       param = MADV_SEQUENTIAL;
       break;
+    case MAdvice::Cold:
+#if defined(MADV_PAGEOUT)
+      param = MADV_PAGEOUT;
+      break;
+#elif defined(MADV_COLD)
+      param = MADV_COLD;
+      break;
+#else
+      // Other ways of releasing pages, like MADV_DONTNEED, discard the
+      // contents of anonymous memory.
+      return false;
+#endif
   }
   return madvise(p, sz, param) == 0;
 }
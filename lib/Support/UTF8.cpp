@@ -7,8 +7,30 @@
 
 #include "hermes/Support/UTF8.h"
 
+#include "llvm/Support/MathExtras.h"
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace hermes {
 
+namespace {
+
+/// \return the 8 bytes at \p p, which need not be aligned.
+inline uint64_t load64(const void *p) {
+  uint64_t val;
+  std::memcpy(&val, p, sizeof(val));
+  return val;
+}
+
+} // namespace
+
 void encodeUTF8(char *&dst, uint32_t cp) {
   char *d = dst;
   if (cp <= 0x7F) {
@@ -79,9 +101,16 @@ bool convertUTF16ToUTF8WithReplacements(
        cur < end && currNumCharacters < maxCharacters;
        ++cur, ++currNumCharacters) {
     char16_t c = cur[0];
-    // ASCII fast-path.
+    // ASCII fast-path: copy the whole run of ASCII characters at once.
     if (LLVM_LIKELY(c <= 0x7F)) {
-      out.push_back(static_cast<char>(c));
+      size_t run = std::min(
+          countASCIIPrefix(cur, end), maxCharacters - currNumCharacters);
+      size_t oldSize = out.size();
+      out.resize(oldSize + run);
+      convertUTF16ToASCII(&out[oldSize], cur, run);
+      // The loop increments account for the last character of the run.
+      cur += run - 1;
+      currNumCharacters += run - 1;
       continue;
     }
 
@@ -117,10 +146,15 @@ void convertUTF16ToUTF8WithSingleSurrogates(
     llvm::ArrayRef<char16_t> input) {
   dest.clear();
   dest.reserve(input.size());
-  for (char16_t c : input) {
-    // ASCII fast-path.
+  for (auto cur = input.begin(), end = input.end(); cur != end; ++cur) {
+    char16_t c = *cur;
+    // ASCII fast-path: copy the whole run of ASCII characters at once.
     if (LLVM_LIKELY(c <= 0x7F)) {
-      dest.push_back(static_cast<char>(c));
+      size_t run = countASCIIPrefix(cur, end);
+      size_t oldSize = dest.size();
+      dest.resize(oldSize + run);
+      convertUTF16ToASCII(&dest[oldSize], cur, run);
+      cur += run - 1;
       continue;
     }
     char32_t c32 = c;
@@ -132,41 +166,179 @@ void convertUTF16ToUTF8WithSingleSurrogates(
 }
 
 bool isAllASCII(const uint8_t *start, const uint8_t *end) {
-  const uint8_t *cursor = start;
-  size_t len = end - start;
-  static_assert(
-      sizeof(uint32_t) == 4 && alignof(uint32_t) <= 4,
-      "uint32_t must be 4 bytes and cannot be more than 4 byte aligned");
-
-  if (len >= 4) {
-    // Step by 1s until aligned for uint32_t.
-    uint8_t mask = 0;
-    while ((uintptr_t)cursor % alignof(uint32_t)) {
-      mask |= *cursor++;
-      len -= 1;
-    }
-    if (mask & 0x80u) {
-      return false;
+  return countASCIIPrefix(start, end) == (size_t)(end - start);
+}
+
+bool isAllASCII(const char16_t *start, const char16_t *end) {
+  return countASCIIPrefix(start, end) == (size_t)(end - start);
+}
+
+size_t countASCIIPrefix(const uint8_t *start, const uint8_t *end) {
+  const uint8_t *cur = start;
+#ifdef __AVX2__
+  for (; end - cur >= 32; cur += 32) {
+    unsigned mask = _mm256_movemask_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cur)));
+    if (mask)
+      return cur - start + llvm::countTrailingZeros(mask);
+  }
+#endif
+#ifdef __SSE2__
+  for (; end - cur >= 16; cur += 16) {
+    unsigned mask = _mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(cur)));
+    if (mask)
+      return cur - start + llvm::countTrailingZeros(mask);
+  }
+#else
+  for (; end - cur >= 8; cur += 8) {
+    if (load64(cur) & 0x8080808080808080ull)
+      break;
+  }
+#endif
+  while (cur != end && *cur < 0x80)
+    ++cur;
+  return cur - start;
+}
+
+size_t countASCIIPrefix(const char16_t *start, const char16_t *end) {
+  const char16_t *cur = start;
+#ifdef __AVX2__
+  const __m256i nonASCII256 = _mm256_set1_epi16((short)0xFF80);
+  for (; end - cur >= 16; cur += 16) {
+    __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cur));
+    if (!_mm256_testz_si256(units, nonASCII256))
+      break;
+  }
+#endif
+#ifdef __SSE2__
+  const __m128i nonASCII = _mm_set1_epi16((short)0xFF80);
+  const __m128i zero = _mm_setzero_si128();
+  for (; end - cur >= 8; cur += 8) {
+    __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cur));
+    __m128i high = _mm_and_si128(units, nonASCII);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF)
+      break;
+  }
+#else
+  for (; end - cur >= 4; cur += 4) {
+    if (load64(cur) & 0xFF80FF80FF80FF80ull)
+      break;
+  }
+#endif
+  while (cur != end && *cur < 0x80)
+    ++cur;
+  return cur - start;
+}
+
+void convertASCIIToUTF16(char16_t *dst, const char *src, size_t length) {
+  size_t i = 0;
+#ifdef __AVX2__
+  for (; length - i >= 16; i += 16) {
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(dst + i), _mm256_cvtepu8_epi16(chars));
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; length - i >= 16; i += 16) {
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi8(chars, zero));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dst + i + 8),
+        _mm_unpackhi_epi8(chars, zero));
+  }
+#endif
+  for (; i < length; ++i) {
+    assert((unsigned char)src[i] < 0x80 && "character is not ASCII");
+    dst[i] = (unsigned char)src[i];
+  }
+}
+
+void convertUTF16ToASCII(char *dst, const char16_t *src, size_t length) {
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; length - i >= 16; i += 16) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+  }
+#endif
+  for (; i < length; ++i) {
+    assert(src[i] < 0x80 && "character is not ASCII");
+    dst[i] = (char)src[i];
+  }
+}
+
+bool convertUTF8ToUTF16WithReplacements(
+    std::u16string &dest,
+    llvm::ArrayRef<uint8_t> input) {
+  // There are never more UTF-16 code units than UTF-8 bytes.
+  dest.resize(input.size());
+  char16_t *out = &dest[0];
+  bool valid = true;
+  for (const uint8_t *cur = input.begin(), *end = input.end(); cur != end;) {
+    size_t run = countASCIIPrefix(cur, end);
+    convertASCIIToUTF16(out, (const char *)cur, run);
+    out += run;
+    cur += run;
+    if (cur == end)
+      break;
+
+    // Decode a multi-byte sequence. The bounds of the second byte exclude
+    // overlong encodings, surrogates and values above U+10FFFF.
+    uint8_t lead = *cur;
+    uint32_t cp;
+    unsigned numTrailing;
+    uint8_t lower = 0x80, upper = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+      numTrailing = 1;
+      cp = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+      numTrailing = 2;
+      cp = lead & 0x0F;
+      if (lead == 0xE0)
+        lower = 0xA0;
+      else if (lead == 0xED)
+        upper = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+      numTrailing = 3;
+      cp = lead & 0x07;
+      if (lead == 0xF0)
+        lower = 0x90;
+      else if (lead == 0xF4)
+        upper = 0x8F;
+    } else {
+      // A continuation byte or a byte which never appears in UTF-8.
+      *out++ = UNICODE_REPLACEMENT_CHARACTER;
+      ++cur;
+      valid = false;
+      continue;
     }
 
-    // Now that we are aligned, step by 4s.
-    while (len >= 4) {
-      uint32_t val = *(const uint32_t *)cursor;
-      if (val & 0x80808080u) {
-        return false;
-      }
-      cursor += 4;
-      len -= 4;
+    const uint8_t *next = cur + 1;
+    unsigned i = 0;
+    for (; i < numTrailing && next != end; ++i, ++next) {
+      if (*next < lower || *next > upper)
+        break;
+      cp = (cp << 6) | (*next & 0x3F);
+      lower = 0x80;
+      upper = 0xBF;
     }
+    cur = next;
+    if (i < numTrailing) {
+      // The byte which ended the sequence early is decoded again.
+      *out++ = UNICODE_REPLACEMENT_CHARACTER;
+      valid = false;
+      continue;
+    }
+    encodeUTF16(out, cp);
   }
-  assert(len < 4 && "Length should now be less than 4");
-  uint8_t mask = 0;
-  while (len--) {
-    mask |= *cursor++;
-  }
-  if (mask & 0x80u)
-    return false;
-  return true;
+  dest.resize(out - dest.data());
+  return valid;
 }
 
 }; // namespace hermes
@@ -97,7 +97,11 @@ CallResult<HermesValue> Callable::_newObjectImpl(
     Handle<Callable> /*selfHandle*/,
     Runtime *runtime,
     Handle<JSObject> parentHandle) {
-  return JSObject::create(runtime, parentHandle).getHermesValue();
+  // Reserve as many direct slots as previous instances with the same
+  // prototype have needed.
+  return JSObject::create(
+             runtime, parentHandle, parentHandle->getInstanceSlotsHint())
+      .getHermesValue();
 }
 
 void Callable::defineLazyProperties(Handle<Callable> fn, Runtime *runtime) {
@@ -16,6 +16,7 @@
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PerfSection.h"
 #include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/LazyFunctionPrewarmer.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/SerializedLiteralParser.h"
@@ -232,6 +233,8 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
   auto *func = ((hbc::BCProviderLazy *)runtimeModule_->getBytecode())
                    ->getBytecodeFunction();
   auto *lazyData = func->getLazyCompilationData();
+  std::lock_guard<std::mutex> lock{
+      lazyData->context->getLazyCompilationMutex()};
   lazyData->context->getSourceErrorManager().findBufferLineAndLoc(
       start ? lazyData->span.Start : lazyData->span.End, coords);
 #endif
@@ -239,13 +242,14 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
 }
 
 #ifndef HERMESVM_LEAN
-namespace {
 std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
     hbc::LazyCompilationData *lazyData) {
   assert(lazyData);
   LLVM_DEBUG(
       llvm::dbgs() << "Compiling lazy function " << lazyData->originalName
                    << "\n");
+  std::lock_guard<std::mutex> lock{
+      lazyData->context->getLazyCompilationMutex()};
 
   Module M{lazyData->context};
   Function *entryPoint = hermes::generateLazyFunctionIR(lazyData, &M);
@@ -255,16 +259,29 @@ std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
 
   return bytecodeModule;
 }
-} // namespace
 
 void CodeBlock::lazyCompileImpl(Runtime *runtime) {
   assert(isLazy() && "Laziness has not been checked");
   PerfSection perf("Lazy function compilation");
-  auto *func = ((hbc::BCProviderLazy *)runtimeModule_->getBytecode())
-                   ->getBytecodeFunction();
-  auto bcMod = compileLazyFunction(func->getLazyCompilationData());
-  runtimeModule_->initializeLazyMayAllocate(
-      hbc::BCProviderFromSrc::createBCProviderFromSrc(std::move(bcMod)));
+  auto *prewarmer = runtime->getLazyFunctionPrewarmer();
+  // Another runtime sharing the module may have compiled the function.
+  bool compiledHere = false;
+  auto compiled = runtimeModule_->getCompiledModule()->compileLazy(
+      [prewarmer, &compiledHere](hbc::BytecodeFunction *func) {
+        compiledHere = true;
+        return prewarmer ? prewarmer->compile(func)
+                         : compileLazyFunction(func->getLazyCompilationData());
+      });
+  if (prewarmer && !compiledHere) {
+    // Don't keep a copy compiled by this runtime's prewarmer.
+    prewarmer->discard(
+        static_cast<hbc::BCProviderLazy *>(runtimeModule_->getBytecode())
+            ->getBytecodeFunction());
+  }
+  runtimeModule_->initializeLazyMayAllocate(std::move(compiled));
+  // The functions nested in this one are lazy too.
+  if (prewarmer)
+    prewarmer->enqueue(runtimeModule_->getCompiledModule());
   // Reset all meta data of the CodeBlock to point to the newly
   // generated bytecode module.
   functionID_ = runtimeModule_->getBytecode()->getGlobalFunctionIndex();
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/CompiledModule.h"
+
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+CompiledModule::CompiledModule(std::shared_ptr<hbc::BCProvider> bytecode)
+    : bcProvider_(std::move(bytecode)) {}
+
+std::shared_ptr<CompiledModule> CompiledModule::create(
+    std::shared_ptr<hbc::BCProvider> bytecode) {
+  assert(!bytecode->isLazy() && "Use createLazy() for lazy modules");
+  std::shared_ptr<CompiledModule> module{
+      new CompiledModule(std::move(bytecode))};
+  module->initializeIdentifierRuns();
+  return module;
+}
+
+#ifndef HERMESVM_LEAN
+std::shared_ptr<CompiledModule> CompiledModule::createLazy(
+    std::shared_ptr<CompiledModule> parent,
+    uint32_t functionID) {
+  assert(!parent->getBytecode()->isLazy() && "Parent must have been compiled");
+  hbc::BytecodeFunction *bcFunction =
+      &static_cast<hbc::BCProviderFromSrc *>(parent->getBytecode())
+           ->getBytecodeModule()
+           ->getFunction(functionID);
+  std::shared_ptr<CompiledModule> module{new CompiledModule(
+      hbc::BCProviderLazy::createBCProviderLazy(bcFunction))};
+  module->lazyParent_ = std::move(parent);
+  module->lazyFunctionID_ = functionID;
+  return module;
+}
+
+std::shared_ptr<CompiledModule> CompiledModule::compileLazy(
+    LazyCompiler compile) {
+  assert(lazyParent_ && "Not a lazy module");
+  // Compiling while holding the lock doesn't serialize more than before,
+  // since all the functions of a source are compiled in the same context,
+  // which is locked while compiling.
+  std::lock_guard<std::mutex> lock{lazyParent_->lazyFunctionsMutex_};
+  auto &compiled = lazyParent_->lazyFunctions_[lazyFunctionID_];
+  if (!compiled) {
+    auto *func = static_cast<hbc::BCProviderLazy *>(getBytecode())
+                     ->getBytecodeFunction();
+    compiled =
+        create(hbc::BCProviderFromSrc::createBCProviderFromSrc(compile(func)));
+  }
+  return compiled;
+}
+
+bool CompiledModule::isLazyFunctionCompiled(uint32_t functionID) {
+  std::lock_guard<std::mutex> lock{lazyFunctionsMutex_};
+  auto it = lazyFunctions_.find(functionID);
+  return it != lazyFunctions_.end() && it->second;
+}
+#endif
+
+void CompiledModule::initializeIdentifierRuns() {
+  identifierRuns_.clear();
+  StringID strID = 0;
+  uint32_t trnID = 0;
+  for (auto entry : bcProvider_->getStringKinds()) {
+    switch (entry.kind()) {
+      case StringKind::String:
+        break;
+      case StringKind::Identifier:
+        identifierRuns_.push_back({strID, entry.count(), trnID});
+        trnID += entry.count();
+        break;
+      case StringKind::Predefined:
+        trnID += entry.count();
+        break;
+    }
+    strID += entry.count();
+  }
+}
+
+OptValue<uint32_t> CompiledModule::getIdentifierHash(StringID stringID) const {
+  // Find the last run which starts at or before stringID.
+  auto it = std::upper_bound(
+      identifierRuns_.begin(),
+      identifierRuns_.end(),
+      stringID,
+      [](StringID id, const IdentifierRun &run) {
+        return id < run.firstStringID;
+      });
+  if (it == identifierRuns_.begin())
+    return llvm::None;
+  --it;
+  uint32_t index = stringID - it->firstStringID;
+  if (index >= it->count)
+    return llvm::None;
+  return bcProvider_->getIdentifierTranslations()[it->firstTranslation + index];
+}
+
+} // namespace vm
+} // namespace hermes
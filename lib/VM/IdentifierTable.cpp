@@ -27,11 +27,9 @@ IdentifierTable::LookupEntry::LookupEntry(
     : strPrim_(str),
       isUTF16_(false),
       isNotUniqued_(isNotUniqued),
-      num_(NON_LAZY_STRING_PRIM_TAG) {
+      num_(NON_LAZY_STRING_PRIM_TAG),
+      hash_(str->getOrComputeHash()) {
   assert(str && "Invalid string primitive pointer");
-  llvm::SmallVector<char16_t, 32> storage{};
-  str->copyUTF16String(storage);
-  hash_ = hermes::hashString(llvm::ArrayRef<char16_t>(storage));
 }
 
 #ifdef HERMESVM_SERIALIZE
@@ -153,9 +151,11 @@ CallResult<Handle<SymbolID>> IdentifierTable::getSymbolHandleFromPrimitive(
   auto handle = toHandle(runtime, std::move(str));
   // Force the string primitive to flatten if it's a rope.
   handle = StringPrimitive::ensureFlat(runtime, handle);
+  // Use the hash cached in the string, if any, rather than rehashing it.
+  uint32_t hash = handle->getOrComputeHash();
   auto cr = handle->isASCII()
-      ? getOrCreateIdentifier(runtime, handle->castToASCIIRef(), handle)
-      : getOrCreateIdentifier(runtime, handle->castToUTF16Ref(), handle);
+      ? getOrCreateIdentifier(runtime, handle->castToASCIIRef(), handle, hash)
+      : getOrCreateIdentifier(runtime, handle->castToUTF16Ref(), handle, hash);
   if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
   return runtime->makeHandle(*cr);
@@ -300,16 +300,18 @@ IdentifierTable::allocateDynamicString(
 
 uint32_t IdentifierTable::allocIDAndInsert(
     uint32_t hashTableIndex,
-    StringPrimitive *strPrim) {
+    StringPrimitive *strPrim,
+    uint32_t hash) {
   uint32_t nextId = allocNextID();
   SymbolID symbolId = SymbolID::unsafeCreate(nextId);
   assert(lookupVector_[nextId].isFreeSlot() && "Allocated a non-free slot");
   strPrim->updateUniqueID(symbolId);
+  strPrim->setHash(hash);
 
   // We must assign strPrim to the lookupVector before inserting to
   // hashTable_, because inserting to hashTable_ could trigger a grow/rehash,
   // which requires accessing the newly inserted string primitive.
-  new (&lookupVector_[nextId]) LookupEntry(strPrim);
+  new (&lookupVector_[nextId]) LookupEntry(strPrim, hash);
 
   hashTable_.insert(hashTableIndex, symbolId);
 
@@ -346,7 +348,7 @@ CallResult<SymbolID> IdentifierTable::getOrCreateIdentifier(
 
   // Allocate the id after we have performed memory allocations because a GC
   // would have freed id.
-  return SymbolID::unsafeCreate(allocIDAndInsert(idx, cr->get()));
+  return SymbolID::unsafeCreate(allocIDAndInsert(idx, cr->get(), hash));
 }
 
 StringPrimitive *IdentifierTable::getExistingStringPrimitiveOrNull(
@@ -402,6 +404,7 @@ StringPrimitive *IdentifierTable::materializeLazyIdentifier(
                                 Runtime::makeNullHandle<StringPrimitive>(),
                                 id));
   LLVM_DEBUG(llvm::dbgs() << "Materializing lazy identifier " << id << "\n");
+  strPrim->setHash(entry.getHash());
   entry.materialize(strPrim.get());
   return strPrim.get();
 }
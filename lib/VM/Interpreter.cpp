@@ -1467,6 +1467,100 @@ tailCall:
         goto doCall;
       }
 
+      // GetByIdCall1 and GetByIdCall2 load the method like GetById, into
+      // the callee register, and then call it like Call1 and Call2. The
+      // arguments are written after loading the method, since a getter would
+      // overwrite them.
+      CASE(GetByIdCall1) {
+        callArgCount = 1;
+        nextIP = NEXTINST(GetByIdCall1);
+        goto getByIdCall;
+      }
+      CASE(GetByIdCall2) {
+        callArgCount = 2;
+        nextIP = NEXTINST(GetByIdCall2);
+      }
+    getByIdCall : {
+#ifdef HERMES_ENABLE_DEBUGGER
+      // Check for an async debugger request before loading the method, since
+      // the instruction is executed again after the break.
+      if (LLVM_UNLIKELY(runtime->testAndClearDebuggerAsyncBreakRequest())) {
+        if (runDebuggerUpdatingState(
+                Debugger::RunReason::AsyncBreak,
+                runtime,
+                curCodeBlock,
+                ip,
+                frameRegs) == ExecutionStatus::EXCEPTION)
+          goto exception;
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        DISPATCH;
+      }
+#endif
+      ++NumGetById;
+      // NOTE: GetByIdCall1 and GetByIdCall2 have the same layout, except for
+      // the second argument.
+      CallResult<HermesValue> propRes{ExecutionStatus::EXCEPTION};
+      if (LLVM_LIKELY(O3REG(GetByIdCall1).isObject())) {
+        auto *obj = vmcast<JSObject>(O3REG(GetByIdCall1));
+        auto cacheIdx = ip->iGetByIdCall1.op4;
+        auto *cacheEntry = curCodeBlock->getReadCacheEntry(cacheIdx);
+        if (LLVM_LIKELY(
+                cacheEntry->clazz == obj->getClassGCPtr().getStorageType())) {
+          ++NumGetByIdCacheHits;
+          O2REG(GetByIdCall1) =
+              JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
+                  obj, runtime, cacheEntry->slot);
+          goto getByIdCallArgs;
+        }
+        // Methods are usually found in the prototype, whose class is cached
+        // when the method is first loaded.
+        auto id = ID(ip->iGetByIdCall1.op5);
+        NamedPropertyDescriptor desc;
+        OptValue<bool> fastPathResult =
+            JSObject::tryGetOwnNamedDescriptorFast(obj, runtime, id, desc);
+        if (fastPathResult.hasValue() && !fastPathResult.getValue() &&
+            LLVM_LIKELY(!obj->isLazy())) {
+          JSObject *parent = obj->getParent(runtime);
+          if (parent &&
+              cacheEntry->clazz == parent->getClassGCPtr().getStorageType()) {
+            ++NumGetByIdProtoHits;
+            O2REG(GetByIdCall1) =
+                JSObject::getNamedSlotValue(parent, runtime, cacheEntry->slot);
+            goto getByIdCallArgs;
+          }
+        }
+        runtime->storeCallerIP(ip);
+        propRes = JSObject::getNamed_RJS(
+            Handle<JSObject>::vmcast(&O3REG(GetByIdCall1)),
+            runtime,
+            id,
+            defaultPropOpFlags,
+            cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cacheEntry : nullptr);
+        runtime->clearCallerIP();
+      } else {
+        ++NumGetByIdTransient;
+        runtime->storeCallerIP(ip);
+        propRes = Interpreter::getByIdTransient_RJS(
+            runtime,
+            Handle<>(&O3REG(GetByIdCall1)),
+            ID(ip->iGetByIdCall1.op5));
+        runtime->clearCallerIP();
+      }
+      if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
+        goto exception;
+      }
+      O2REG(GetByIdCall1) = *propRes;
+      gcScope.flushToSmallCount(KEEP_HANDLES);
+    }
+    getByIdCallArgs : {
+      StackFramePtr fr{runtime->stackPointer_};
+      fr.getArgRefUnsafe(-1) = O3REG(GetByIdCall1);
+      if (callArgCount == 2)
+        fr.getArgRefUnsafe(0) = O6REG(GetByIdCall2);
+      callNewTarget = HermesValue::encodeUndefinedValue().getRaw();
+      goto doCallAfterBreakCheck;
+    }
+
       CASE(Construct) {
         callArgCount = (uint32_t)ip->iConstruct.op3;
         nextIP = NEXTINST(Construct);
@@ -1495,6 +1589,7 @@ tailCall:
         DISPATCH;
       }
 #endif
+    doCallAfterBreakCheck:
       runtime->storeCallerIP(ip);
 
       // Subtract 1 from callArgCount as 'this' is considered an argument in the
@@ -8,6 +8,7 @@
 #include "hermes/VM/JIT/x86-64/JIT.h"
 
 #include "FastJIT.h"
+#include "RegexJIT.h"
 
 namespace hermes {
 namespace vm {
@@ -26,6 +27,26 @@ JITCompiledFunctionPtr JITContext::compileImpl(
   return codeBlock->getJITCompiled();
 }
 
+const regex::NativeMatcher *JITContext::compileRegex(
+    llvm::ArrayRef<uint8_t> bytecode) {
+  // Bound the memory used by the cache. Native code is never freed, so stop
+  // compiling new regexes instead.
+  static constexpr size_t kMaxCachedRegexes = 512;
+
+  llvm::StringRef key{reinterpret_cast<const char *>(bytecode.data()),
+                      bytecode.size()};
+  auto it = regexCache_.find(key);
+  if (it == regexCache_.end()) {
+    if (regexCache_.size() >= kMaxCachedRegexes)
+      return nullptr;
+    // The matcher stays null if compilation fails, so we don't retry.
+    regex::NativeMatcher matcher{};
+    RegexJIT{heap_, bytecode}.compile(matcher);
+    it = regexCache_.try_emplace(key, matcher).first;
+  }
+  return it->second.ascii ? &it->second : nullptr;
+}
+
 } // namespace x86_64
 } // namespace vm
 } // namespace hermes
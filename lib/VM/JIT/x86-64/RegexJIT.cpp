@@ -0,0 +1,845 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "RegexJIT.h"
+
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "regexjit"
+
+namespace hermes {
+namespace vm {
+namespace x86_64 {
+
+using namespace hermes::regex;
+
+namespace {
+
+/// Registers holding the arguments of a regex::NativeMatchFn. The position is
+/// updated as the input is consumed; the others are never modified.
+constexpr Reg kPos = Reg::rdi;
+constexpr Reg kFirst = Reg::rsi;
+constexpr Reg kLast = Reg::rdx;
+constexpr Reg kCaptures = Reg::rcx;
+constexpr Reg kBudgetPtr = Reg::r8;
+
+/// The remaining budget, which is loaded from *kBudgetPtr on entry and stored
+/// back on exit. No other code uses this register.
+constexpr Reg kBudget = Reg::r11;
+
+/// The maximum number of alternations and loops in a compiled regex. Each of
+/// them uses at most 24 bytes of native stack at a time.
+constexpr unsigned kMaxCalls = 256;
+
+/// The maximum minimum iteration count of a compiled loop.
+constexpr uint32_t kMaxLoopMin = 1u << 28;
+
+/// Upper bounds on the size of the native code emitted by the compiler.
+/// kInsnBound covers the fixed part of any instruction; the other bounds are
+/// per character range test, per character of MatchNChar8 and per reset
+/// capture group.
+constexpr size_t kInsnBound = 64;
+constexpr size_t kRangeBound = 20;
+constexpr size_t kNCharBound = 24;
+constexpr size_t kResetCaptureBound = 22;
+/// The size of the entry point and the shared code.
+constexpr size_t kEntryBound = 64;
+/// The size of the fixed part of a loop.
+constexpr size_t kLoopBound = 192;
+
+/// Character classes as ranges, matching UTF16RegexTraits. ASCII input is
+/// 7-bit, so only the ranges below 128 matter for it.
+const BracketRange32 kDigitRanges[] = {{'0', '9'}};
+const BracketRange32 kWordRanges[] = {{'0', '9'},
+                                      {'A', 'Z'},
+                                      {'_', '_'},
+                                      {'a', 'z'}};
+const BracketRange32 kSpaceRanges[] = {{0x09, 0x0D},
+                                       {0x20, 0x20},
+                                       {0xA0, 0xA0},
+                                       {0x1680, 0x1680},
+                                       {0x2000, 0x200A},
+                                       {0x2028, 0x2029},
+                                       {0x202F, 0x202F},
+                                       {0x205F, 0x205F},
+                                       {0x3000, 0x3000},
+                                       {0xFEFF, 0xFEFF}};
+const BracketRange32 kLineTerminatorRanges[] = {{0x0A, 0x0A},
+                                                {0x0D, 0x0D},
+                                                {0x2028, 0x2029}};
+
+/// \return the ranges of the character class \p type.
+llvm::ArrayRef<BracketRange32> classRanges(CharacterClass::Type type) {
+  switch (type) {
+    case CharacterClass::Digits:
+      return kDigitRanges;
+    case CharacterClass::Spaces:
+      return kSpaceRanges;
+    case CharacterClass::Words:
+      return kWordRanges;
+  }
+  llvm_unreachable("Unknown character type");
+}
+
+/// The character classes a bracket may test, in the order we test them.
+const CharacterClass::Type kClassTypes[] = {CharacterClass::Digits,
+                                            CharacterClass::Spaces,
+                                            CharacterClass::Words};
+
+/// \return the width of \p insn including any trailing data, or 0 if the
+/// instruction is not supported.
+uint32_t insnWidth(const Insn *insn) {
+  switch (insn->opcode) {
+    case Opcode::Goal:
+      return sizeof(GoalInsn);
+    case Opcode::LeftAnchor:
+      return sizeof(LeftAnchorInsn);
+    case Opcode::RightAnchor:
+      return sizeof(RightAnchorInsn);
+    case Opcode::MatchAnyButNewline:
+      return sizeof(MatchAnyButNewlineInsn);
+    case Opcode::MatchChar8:
+      return sizeof(MatchChar8Insn);
+    case Opcode::MatchChar16:
+      return sizeof(MatchChar16Insn);
+    case Opcode::MatchCharICase8:
+      return sizeof(MatchCharICase8Insn);
+    case Opcode::MatchNChar8:
+      return llvm::cast<MatchNChar8Insn>(insn)->totalWidth();
+    case Opcode::MatchNCharICase8:
+      return llvm::cast<MatchNCharICase8Insn>(insn)->totalWidth();
+    case Opcode::Alternation:
+      return sizeof(AlternationInsn);
+    case Opcode::Jump32:
+      return sizeof(Jump32Insn);
+    case Opcode::Bracket:
+      return llvm::cast<BracketInsn>(insn)->totalWidth();
+    case Opcode::BeginMarkedSubexpression:
+      return sizeof(BeginMarkedSubexpressionInsn);
+    case Opcode::EndMarkedSubexpression:
+      return sizeof(EndMarkedSubexpressionInsn);
+    case Opcode::WordBoundary:
+      return sizeof(WordBoundaryInsn);
+    case Opcode::Width1Loop:
+      return sizeof(Width1LoopInsn);
+    default:
+      return 0;
+  }
+}
+
+/// \return whether \p c is an uppercase ASCII letter.
+bool isUpperASCII(uint8_t c) {
+  return 'A' <= c && c <= 'Z';
+}
+
+} // namespace
+
+RegexJIT::RegexJIT(ExecHeap &heap, llvm::ArrayRef<uint8_t> bytecode)
+    : heap_(heap),
+      header_(reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data())),
+      insns_(bytecode.drop_front(sizeof(RegexBytecodeHeader))) {
+  assert(
+      bytecode.size() >= sizeof(RegexBytecodeHeader) && "Bytecode too small");
+}
+
+bool RegexJIT::compile(NativeMatcher &matcher) {
+  size_t bound = validate();
+  if (!bound)
+    return false;
+
+  ExecHeap::SizePair sizes{2 * (kEntryBound + bound), 0};
+  auto blocks = heap_.alloc(sizes);
+  // If the allocation failed, add a new pool and retry.
+  if (!blocks) {
+    auto newPool = heap_.addPool();
+    if (!newPool)
+      return false;
+    blocks = newPool->alloc(sizes);
+    if (!blocks)
+      return false;
+  }
+
+  Emitter emit{blocks->first};
+  uint8_t *asciiEntry = emit.current();
+  emit = compileFunction<S::B>(emit);
+  bool resolved = resolveRelocations();
+  uint8_t *utf16Entry = emit.current();
+  emit = compileFunction<S::W>(emit);
+  resolved &= resolveRelocations();
+
+  size_t size = emit.current() - blocks->first;
+  assert(size <= sizes.first && "native regex code overflowed its buffer");
+  if (!resolved) {
+    LLVM_DEBUG(llvm::dbgs() << "RegexJIT: unresolved jump target\n");
+    heap_.free(*blocks);
+    return false;
+  }
+  heap_.freeRemaining(*blocks, {size, 0});
+
+  LLVM_DEBUG(
+      llvm::dbgs() << "RegexJIT: compiled " << insns_.size()
+                   << " bytes of bytecode to " << size << " bytes\n");
+  matcher.ascii = reinterpret_cast<NativeMatchFn<char>>(asciiEntry);
+  matcher.utf16 = reinterpret_cast<NativeMatchFn<char16_t>>(utf16Entry);
+  return true;
+}
+
+size_t RegexJIT::validate() {
+  if (header_->syntaxFlags & constants::unicode)
+    return 0;
+
+  size_t bound = 0;
+  unsigned calls = 0;
+  // Jump targets and alternations, which are checked once all instruction
+  // boundaries are known.
+  llvm::SmallVector<uint32_t, 8> targets;
+  llvm::SmallVector<uint32_t, 8> alternations;
+  std::vector<bool> isInsnStart(insns_.size());
+  captureStarts_.clear();
+
+  uint32_t offset = 0;
+  while (offset < insns_.size()) {
+    const Insn *base = insnAt(offset);
+    uint32_t width = insnWidth(base);
+    if (!width || width > insns_.size() - offset) {
+      LLVM_DEBUG(
+          llvm::dbgs() << "RegexJIT: unsupported opcode "
+                       << (unsigned)base->opcode << "\n");
+      return 0;
+    }
+    isInsnStart[offset] = true;
+
+    switch (base->opcode) {
+      case Opcode::Goal:
+        bound += kInsnBound;
+        break;
+
+      case Opcode::LeftAnchor:
+      case Opcode::RightAnchor:
+        bound += kInsnBound +
+            kRangeBound * llvm::array_lengthof(kLineTerminatorRanges);
+        break;
+
+      case Opcode::WordBoundary:
+        bound +=
+            kInsnBound + 2 * kRangeBound * llvm::array_lengthof(kWordRanges);
+        break;
+
+      case Opcode::BeginMarkedSubexpression: {
+        uint16_t mexp = llvm::cast<BeginMarkedSubexpressionInsn>(base)->mexp;
+        if (mexp == 0 || mexp > header_->markedCount)
+          return 0;
+        captureStarts_.push_back({offset, mexp});
+        bound += kInsnBound;
+        break;
+      }
+
+      case Opcode::EndMarkedSubexpression: {
+        uint16_t mexp = llvm::cast<EndMarkedSubexpressionInsn>(base)->mexp;
+        if (mexp == 0 || mexp > header_->markedCount)
+          return 0;
+        bound += kInsnBound;
+        break;
+      }
+
+      case Opcode::Jump32: {
+        uint32_t target = llvm::cast<Jump32Insn>(base)->target;
+        // Only forward jumps guarantee that the native code terminates.
+        if (target <= offset)
+          return 0;
+        targets.push_back(target);
+        bound += kInsnBound;
+        break;
+      }
+
+      case Opcode::Alternation: {
+        uint32_t secondary = llvm::cast<AlternationInsn>(base)->secondaryBranch;
+        if (secondary < offset + width + sizeof(Jump32Insn))
+          return 0;
+        targets.push_back(secondary);
+        alternations.push_back(offset);
+        ++calls;
+        bound += kInsnBound;
+        break;
+      }
+
+      case Opcode::MatchNChar8:
+      case Opcode::MatchNCharICase8:
+        bound += kInsnBound + kNCharBound * (width - sizeof(MatchNChar8Insn));
+        break;
+
+      case Opcode::Width1Loop: {
+        const auto *loop = llvm::cast<Width1LoopInsn>(base);
+        if (loop->min > loop->max || loop->min > kMaxLoopMin)
+          return 0;
+        uint32_t bodyOffset = offset + width;
+        if (bodyOffset >= insns_.size())
+          return 0;
+        const Insn *body = insnAt(bodyOffset);
+        size_t bodyBound = testBound(body);
+        uint32_t bodyWidth = insnWidth(body);
+        if (!bodyBound || bodyWidth > insns_.size() - bodyOffset ||
+            loop->notTakenTarget != bodyOffset + bodyWidth)
+          return 0;
+        ++calls;
+        bound += kLoopBound + 2 * bodyBound;
+        // The body is compiled as part of the loop.
+        width += bodyWidth;
+        break;
+      }
+
+      default: {
+        size_t testSize = testBound(base);
+        if (!testSize)
+          return 0;
+        bound += kInsnBound + testSize;
+        break;
+      }
+    }
+    offset += width;
+  }
+
+  if (calls > kMaxCalls)
+    return 0;
+  for (uint32_t target : targets) {
+    if (target >= insns_.size() || !isInsnStart[target])
+      return 0;
+  }
+  // The primary branch of an alternation ends with a jump to the end of the
+  // alternation. Each alternation may reset every capture group twice.
+  for (uint32_t alternation : alternations) {
+    uint32_t jump =
+        llvm::cast<AlternationInsn>(insnAt(alternation))->secondaryBranch -
+        sizeof(Jump32Insn);
+    if (!isInsnStart[jump] || insnAt(jump)->opcode != Opcode::Jump32)
+      return 0;
+    bound += 2 * kResetCaptureBound * captureStarts_.size();
+  }
+  return bound;
+}
+
+size_t RegexJIT::testBound(const Insn *insn) {
+  switch (insn->opcode) {
+    case Opcode::MatchChar8:
+    case Opcode::MatchChar16:
+    case Opcode::MatchCharICase8:
+      return kRangeBound;
+    case Opcode::MatchAnyButNewline:
+      return kRangeBound * llvm::array_lengthof(kLineTerminatorRanges);
+    case Opcode::Bracket: {
+      const auto *bracket = llvm::cast<BracketInsn>(insn);
+      size_t bound = kRangeBound * bracket->rangeCount + kInsnBound;
+      for (auto type : kClassTypes) {
+        if ((bracket->positiveCharClasses | bracket->negativeCharClasses) &
+            type)
+          bound += kRangeBound * (classRanges(type).size() + 1);
+      }
+      return bound;
+    }
+    default:
+      return 0;
+  }
+}
+
+RegexJIT::Label RegexJIT::newLabel() {
+  labels_.push_back(nullptr);
+  return labels_.size() - 1;
+}
+
+RegexJIT::Label RegexJIT::labelForOffset(uint32_t offset) {
+  auto it = offsetLabels_.find(offset);
+  if (it != offsetLabels_.end())
+    return it->second;
+  Label label = newLabel();
+  offsetLabels_[offset] = label;
+  return label;
+}
+
+void RegexJIT::bind(Emitter emit, Label label) {
+  assert(!labels_[label] && "label bound twice");
+  labels_[label] = emit.current();
+}
+
+Emitter RegexJIT::jmp(Emitter emit, Label label) {
+  if (const uint8_t *target = labels_[label]) {
+    emit.jmp<OffsetType::Auto>(target);
+  } else {
+    emit.jmp<OffsetType::Int32>(emit.current());
+    relocs_.push_back({emit.current() - 4, label});
+  }
+  return emit;
+}
+
+template <CCode cc>
+Emitter RegexJIT::cjump(Emitter emit, Label label) {
+  if (const uint8_t *target = labels_[label]) {
+    emit.cjump<cc, OffsetType::Auto>(target);
+  } else {
+    emit.cjump<cc, OffsetType::Int32>(emit.current());
+    relocs_.push_back({emit.current() - 4, label});
+  }
+  return emit;
+}
+
+Emitter RegexJIT::call(Emitter emit, Label label) {
+  emit.call(labels_[label] ? labels_[label] : emit.current());
+  if (!labels_[label])
+    relocs_.push_back({emit.current() - 4, label});
+  return emit;
+}
+
+bool RegexJIT::resolveRelocations() {
+  bool resolved = true;
+  for (const Relo &relo : relocs_) {
+    const uint8_t *target = labels_[relo.target];
+    if (!target) {
+      resolved = false;
+      continue;
+    }
+    *reinterpret_cast<int32_t *>(relo.address) =
+        (int32_t)(target - (relo.address + 4));
+  }
+  relocs_.clear();
+  return resolved;
+}
+
+template <S W>
+Emitter RegexJIT::compileFunction(Emitter emit) {
+  labels_.clear();
+  offsetLabels_.clear();
+  fail_ = newLabel();
+  ret_ = newLabel();
+  exhausted_ = newLabel();
+
+  // The entry point loads the budget, calls the first instruction and stores
+  // the budget back.
+  emit.pushqReg(kBudgetPtr);
+  emit.movRMToReg<S::Q>(kBudgetPtr, Reg::NoIndex, 0, kBudget);
+  emit = call(emit, labelForOffset(0));
+  emit.popqReg(kBudgetPtr);
+  emit.movRegToRM<S::Q>(kBudget, kBudgetPtr, Reg::NoIndex, 0);
+  emit.retq();
+
+  bind(emit, fail_);
+  emit.xorRegToReg<S::L>(Reg::eax, Reg::eax);
+  bind(emit, ret_);
+  emit.retq();
+
+  // Return a non-null value so every caller returns immediately, and leave
+  // the budget at zero to tell the entry point's caller that we gave up.
+  bind(emit, exhausted_);
+  emit.xorRegToReg<S::L>(kBudget, kBudget);
+  emit.movImmToReg<S::L>(1, Reg::eax);
+  emit.retq();
+
+  for (uint32_t offset = 0; offset < insns_.size();)
+    emit = compileInsn<W>(emit, offset);
+  return emit;
+}
+
+template <S W>
+Emitter RegexJIT::compileInsn(Emitter emit, uint32_t &offset) {
+  constexpr int32_t w = W == S::B ? 1 : 2;
+  const bool multiline = header_->syntaxFlags & constants::multiline;
+  const Insn *base = insnAt(offset);
+  bind(emit, labelForOffset(offset));
+  uint32_t next = offset + insnWidth(base);
+
+  switch (base->opcode) {
+    case Opcode::Goal:
+      emit.movRegToReg<S::Q>(kPos, Reg::rax);
+      emit.retq();
+      break;
+
+    case Opcode::LeftAnchor: {
+      emit.cmpRegToReg<S::Q>(kFirst, kPos);
+      if (!multiline) {
+        emit = cjump<CCode::NE>(emit, fail_);
+        break;
+      }
+      Label matched = newLabel();
+      emit = cjump<CCode::E>(emit, matched);
+      emit.movzxRMToReg<W>(kPos, Reg::NoIndex, -w, Reg::eax);
+      emit = emitTestRanges<W>(emit, kLineTerminatorRanges, matched);
+      emit = jmp(emit, fail_);
+      bind(emit, matched);
+      break;
+    }
+
+    case Opcode::RightAnchor: {
+      emit.cmpRegToReg<S::Q>(kLast, kPos);
+      if (!multiline) {
+        emit = cjump<CCode::NE>(emit, fail_);
+        break;
+      }
+      Label matched = newLabel();
+      emit = cjump<CCode::E>(emit, matched);
+      emit.movzxRMToReg<W>(kPos, Reg::NoIndex, 0, Reg::eax);
+      emit = emitTestRanges<W>(emit, kLineTerminatorRanges, matched);
+      emit = jmp(emit, fail_);
+      bind(emit, matched);
+      break;
+    }
+
+    case Opcode::WordBoundary: {
+      // Compute in r9d whether exactly one of the characters before and after
+      // the position is a word character.
+      Label prevDone = newLabel(), prevWord = newLabel();
+      Label nextDone = newLabel(), nextWord = newLabel();
+      emit.xorRegToReg<S::L>(Reg::r9d, Reg::r9d);
+      emit.cmpRegToReg<S::Q>(kFirst, kPos);
+      emit = cjump<CCode::E>(emit, prevDone);
+      emit.movzxRMToReg<W>(kPos, Reg::NoIndex, -w, Reg::eax);
+      emit = emitTestRanges<W>(emit, kWordRanges, prevWord);
+      emit = jmp(emit, prevDone);
+      bind(emit, prevWord);
+      emit.movImmToReg<S::L>(1, Reg::r9d);
+      bind(emit, prevDone);
+
+      emit.cmpRegToReg<S::Q>(kLast, kPos);
+      emit = cjump<CCode::E>(emit, nextDone);
+      emit.movzxRMToReg<W>(kPos, Reg::NoIndex, 0, Reg::eax);
+      emit = emitTestRanges<W>(emit, kWordRanges, nextWord);
+      emit = jmp(emit, nextDone);
+      bind(emit, nextWord);
+      emit.xorImmToReg<S::L>(1, Reg::r9d);
+      bind(emit, nextDone);
+
+      emit.testRegToReg<S::L>(Reg::r9d, Reg::r9d);
+      if (llvm::cast<WordBoundaryInsn>(base)->invert)
+        emit = cjump<CCode::NZ>(emit, fail_);
+      else
+        emit = cjump<CCode::Z>(emit, fail_);
+      break;
+    }
+
+    case Opcode::MatchNChar8:
+    case Opcode::MatchNCharICase8: {
+      bool icase = base->opcode == Opcode::MatchNCharICase8;
+      uint8_t count;
+      const uint8_t *chars;
+      if (icase) {
+        const auto *insn = llvm::cast<MatchNCharICase8Insn>(base);
+        count = insn->charCount;
+        chars = reinterpret_cast<const uint8_t *>(insn + 1);
+      } else {
+        const auto *insn = llvm::cast<MatchNChar8Insn>(base);
+        count = insn->charCount;
+        chars = reinterpret_cast<const uint8_t *>(insn + 1);
+      }
+      emit = emitCheckRemaining<W>(emit, count);
+      for (int32_t i = 0; i < count; ++i) {
+        if (icase && isUpperASCII(chars[i])) {
+          emit.movzxRMToReg<W>(kPos, Reg::NoIndex, i * w, Reg::eax);
+          emit = emitTestICase(emit, chars[i], fail_);
+        } else {
+          emit.cmpImmToRM<W>(chars[i], kPos, Reg::NoIndex, i * w);
+          emit = cjump<CCode::NE>(emit, fail_);
+        }
+      }
+      emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, count * w, kPos);
+      break;
+    }
+
+    case Opcode::Jump32:
+      emit = jmp(emit, labelForOffset(llvm::cast<Jump32Insn>(base)->target));
+      break;
+
+    case Opcode::BeginMarkedSubexpression: {
+      uint16_t mexp = llvm::cast<BeginMarkedSubexpressionInsn>(base)->mexp;
+      emit.movRegToRM<S::Q>(
+          kPos, kCaptures, Reg::NoIndex, (mexp - 1) * 2 * sizeof(void *));
+      break;
+    }
+
+    case Opcode::EndMarkedSubexpression: {
+      uint16_t mexp = llvm::cast<EndMarkedSubexpressionInsn>(base)->mexp;
+      emit.movRegToRM<S::Q>(
+          kPos,
+          kCaptures,
+          Reg::NoIndex,
+          ((mexp - 1) * 2 + 1) * sizeof(void *));
+      break;
+    }
+
+    case Opcode::Alternation: {
+      // Try the primary branch, followed by the rest of the regex. If that
+      // fails, continue with the secondary branch. Capture groups inside the
+      // alternation must not keep values from a failed attempt.
+      uint32_t secondary = llvm::cast<AlternationInsn>(base)->secondaryBranch;
+      uint32_t end =
+          llvm::cast<Jump32Insn>(insnAt(secondary - sizeof(Jump32Insn)))
+              ->target;
+      emit = emitResetCaptures(emit, next, end);
+      emit.pushqReg(kPos);
+      emit = call(emit, labelForOffset(next));
+      emit.popqReg(kPos);
+      emit.testRegToReg<S::Q>(Reg::rax, Reg::rax);
+      emit = cjump<CCode::NZ>(emit, ret_);
+      emit = emitBacktrack(emit);
+      emit = emitResetCaptures(emit, next, secondary);
+      emit = jmp(emit, labelForOffset(secondary));
+      break;
+    }
+
+    case Opcode::Width1Loop: {
+      const auto *loop = llvm::cast<Width1LoopInsn>(base);
+      const Insn *body = insnAt(next);
+      Label cont = labelForOffset(loop->notTakenTarget);
+      next = loop->notTakenTarget;
+
+      // Compute in \p limit the end of the longest possible match of the
+      // loop, which is the smaller of the end of the input and the position
+      // after max iterations.
+      auto emitLimit = [&](Emitter emit, Reg limit) {
+        uint64_t maxBytes = uint64_t(loop->max) * w;
+        if (loop->max == UINT32_MAX) {
+          emit.movRegToReg<S::Q>(kLast, limit);
+          return emit;
+        }
+        if (maxBytes <= INT32_MAX) {
+          emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, maxBytes, limit);
+        } else {
+          emit.movqImmToReg(maxBytes, limit);
+          emit.leaRMToReg<S::Q, S::Q, 1>(limit, kPos, 0, limit);
+        }
+        Label inBounds = newLabel();
+        emit.cmpRegToReg<S::Q>(kLast, limit);
+        emit = cjump<CCode::BE>(emit, inBounds);
+        emit.movRegToReg<S::Q>(kLast, limit);
+        bind(emit, inBounds);
+        return emit;
+      };
+      const int32_t minBytes = loop->min * w;
+
+      if (loop->greedy) {
+        // Match as many iterations as possible, then try the rest of the
+        // regex after each iteration count from the largest down to min.
+        // r8 holds the start and then the minimum end, r9 the limit.
+        Label scan = newLabel(), scanned = newLabel(), retry = newLabel();
+        emit.movRegToReg<S::Q>(kPos, Reg::r8);
+        emit = emitLimit(emit, Reg::r9);
+        bind(emit, scan);
+        emit.cmpRegToReg<S::Q>(Reg::r9, kPos);
+        emit = cjump<CCode::AE>(emit, scanned);
+        emit.movzxRMToReg<W>(kPos, Reg::NoIndex, 0, Reg::eax);
+        emit = emitTest<W>(emit, body, scanned);
+        emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, w, kPos);
+        emit = jmp(emit, scan);
+        bind(emit, scanned);
+
+        // Charge the scanned code units to the budget, since we may scan the
+        // same input again whenever an enclosing construct backtracks.
+        emit.movRegToReg<S::Q>(kPos, Reg::rax);
+        emit.subRegFromReg<S::Q>(Reg::r8, Reg::rax);
+        emit.subRegFromReg<S::Q>(Reg::rax, kBudget);
+        emit = cjump<CCode::BE>(emit, exhausted_);
+
+        emit.leaRMToReg<S::Q>(Reg::r8, Reg::NoIndex, minBytes, Reg::r8);
+        emit.cmpRegToReg<S::Q>(Reg::r8, kPos);
+        emit = cjump<CCode::B>(emit, fail_);
+        bind(emit, retry);
+        emit.pushqReg(Reg::r8);
+        emit.pushqReg(kPos);
+        emit = call(emit, cont);
+        emit.popqReg(kPos);
+        emit.popqReg(Reg::r8);
+        emit.testRegToReg<S::Q>(Reg::rax, Reg::rax);
+        emit = cjump<CCode::NZ>(emit, ret_);
+        emit.cmpRegToReg<S::Q>(Reg::r8, kPos);
+        emit = cjump<CCode::E>(emit, fail_);
+        emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, -w, kPos);
+        emit = emitBacktrack(emit);
+        emit = jmp(emit, retry);
+      } else {
+        // Match min iterations, then try the rest of the regex, matching one
+        // more iteration each time it fails.
+        // r8 holds the limit, r9 the minimum end.
+        Label matchMin = newLabel(), retry = newLabel();
+        emit = emitLimit(emit, Reg::r8);
+        emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, minBytes, Reg::r9);
+        emit.cmpRegToReg<S::Q>(Reg::r8, Reg::r9);
+        emit = cjump<CCode::A>(emit, fail_);
+        if (loop->min) {
+          // Charge the minimum iterations to the budget, like the scan of a
+          // greedy loop.
+          emit.movImmToReg<S::L>(loop->min, Reg::eax);
+          emit.subRegFromReg<S::Q>(Reg::rax, kBudget);
+          emit = cjump<CCode::BE>(emit, exhausted_);
+        }
+        bind(emit, matchMin);
+        emit.cmpRegToReg<S::Q>(Reg::r9, kPos);
+        emit = cjump<CCode::AE>(emit, retry);
+        emit.movzxRMToReg<W>(kPos, Reg::NoIndex, 0, Reg::eax);
+        emit = emitTest<W>(emit, body, fail_);
+        emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, w, kPos);
+        emit = jmp(emit, matchMin);
+
+        bind(emit, retry);
+        emit.pushqReg(Reg::r8);
+        emit.pushqReg(kPos);
+        emit = call(emit, cont);
+        emit.popqReg(kPos);
+        emit.popqReg(Reg::r8);
+        emit.testRegToReg<S::Q>(Reg::rax, Reg::rax);
+        emit = cjump<CCode::NZ>(emit, ret_);
+        emit.cmpRegToReg<S::Q>(Reg::r8, kPos);
+        emit = cjump<CCode::AE>(emit, fail_);
+        emit.movzxRMToReg<W>(kPos, Reg::NoIndex, 0, Reg::eax);
+        emit = emitTest<W>(emit, body, fail_);
+        emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, w, kPos);
+        emit = emitBacktrack(emit);
+        emit = jmp(emit, retry);
+      }
+      break;
+    }
+
+    default:
+      // A single character instruction.
+      emit = emitCheckRemaining<W>(emit, 1);
+      emit.movzxRMToReg<W>(kPos, Reg::NoIndex, 0, Reg::eax);
+      emit = emitTest<W>(emit, base, fail_);
+      emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, w, kPos);
+      break;
+  }
+
+  offset = next;
+  return emit;
+}
+
+template <S W>
+Emitter RegexJIT::emitTest(Emitter emit, const Insn *insn, Label onFail) {
+  switch (insn->opcode) {
+    case Opcode::MatchChar8:
+      emit.cmpImmToRM<S::L, ScaleRegAccess>(
+          (uint8_t)llvm::cast<MatchChar8Insn>(insn)->c,
+          Reg::eax,
+          Reg::NoIndex,
+          0);
+      return cjump<CCode::NE>(emit, onFail);
+
+    case Opcode::MatchChar16:
+      emit.cmpImmToRM<S::L, ScaleRegAccess>(
+          llvm::cast<MatchChar16Insn>(insn)->c, Reg::eax, Reg::NoIndex, 0);
+      return cjump<CCode::NE>(emit, onFail);
+
+    case Opcode::MatchCharICase8:
+      return emitTestICase(
+          emit, (uint8_t)llvm::cast<MatchCharICase8Insn>(insn)->c, onFail);
+
+    case Opcode::MatchAnyButNewline:
+      return emitTestRanges<W>(emit, kLineTerminatorRanges, onFail);
+
+    case Opcode::Bracket: {
+      // The bracket contains the character if it is in a positive class, not
+      // in a negative class, or in a range. Negation inverts the result.
+      const auto *bracket = llvm::cast<BracketInsn>(insn);
+      const auto *ranges =
+          reinterpret_cast<const BracketRange32 *>(bracket + 1);
+      Label contained = bracket->negate ? onFail : newLabel();
+      for (auto type : kClassTypes) {
+        if (bracket->positiveCharClasses & type)
+          emit = emitTestRanges<W>(emit, classRanges(type), contained);
+        if (bracket->negativeCharClasses & type) {
+          Label inClass = newLabel();
+          emit = emitTestRanges<W>(emit, classRanges(type), inClass);
+          emit = jmp(emit, contained);
+          bind(emit, inClass);
+        }
+      }
+      emit = emitTestRanges<W>(
+          emit, llvm::makeArrayRef(ranges, bracket->rangeCount), contained);
+      if (!bracket->negate) {
+        emit = jmp(emit, onFail);
+        bind(emit, contained);
+      }
+      return emit;
+    }
+
+    default:
+      llvm_unreachable("not a single character instruction");
+  }
+}
+
+template <S W>
+Emitter RegexJIT::emitTestRanges(
+    Emitter emit,
+    llvm::ArrayRef<BracketRange32> ranges,
+    Label onHit) {
+  // The largest code unit of the input; ASCII input is 7-bit.
+  constexpr uint32_t maxCodeUnit = W == S::B ? 0x7F : 0xFFFF;
+  for (const auto &range : ranges) {
+    if (range.start > maxCodeUnit || range.start > range.end)
+      continue;
+    uint32_t end = std::min(range.end, maxCodeUnit);
+    if (range.start == end) {
+      emit.cmpImmToRM<S::L, ScaleRegAccess>(
+          range.start, Reg::eax, Reg::NoIndex, 0);
+      emit = cjump<CCode::E>(emit, onHit);
+    } else if (range.start == 0) {
+      emit.cmpImmToRM<S::L, ScaleRegAccess>(end, Reg::eax, Reg::NoIndex, 0);
+      emit = cjump<CCode::BE>(emit, onHit);
+    } else {
+      // eax is in [start, end] iff eax - start <= end - start, unsigned.
+      emit.leaRMToReg<S::L, S::Q>(
+          Reg::rax, Reg::NoIndex, -(int32_t)range.start, Reg::r10d);
+      emit.cmpImmToRM<S::L, ScaleRegAccess>(
+          end - range.start, Reg::r10d, Reg::NoIndex, 0);
+      emit = cjump<CCode::BE>(emit, onHit);
+    }
+  }
+  return emit;
+}
+
+Emitter RegexJIT::emitTestICase(Emitter emit, uint8_t c, Label onFail) {
+  // Characters are canonicalized to uppercase, and a non-ASCII character
+  // never canonicalizes to an ASCII one. So an uppercase letter also matches
+  // its lowercase form, and any other character only matches itself.
+  emit.cmpImmToRM<S::L, ScaleRegAccess>(c, Reg::eax, Reg::NoIndex, 0);
+  if (!isUpperASCII(c))
+    return cjump<CCode::NE>(emit, onFail);
+  Label matched = newLabel();
+  emit = cjump<CCode::E>(emit, matched);
+  emit.cmpImmToRM<S::L, ScaleRegAccess>(c | 0x20, Reg::eax, Reg::NoIndex, 0);
+  emit = cjump<CCode::NE>(emit, onFail);
+  bind(emit, matched);
+  return emit;
+}
+
+template <S W>
+Emitter RegexJIT::emitCheckRemaining(Emitter emit, uint32_t count) {
+  constexpr int32_t w = W == S::B ? 1 : 2;
+  if (count == 1) {
+    emit.cmpRegToReg<S::Q>(kLast, kPos);
+    return cjump<CCode::AE>(emit, fail_);
+  }
+  emit.leaRMToReg<S::Q>(kPos, Reg::NoIndex, count * w, Reg::r10);
+  emit.cmpRegToReg<S::Q>(kLast, Reg::r10);
+  return cjump<CCode::A>(emit, fail_);
+}
+
+Emitter RegexJIT::emitBacktrack(Emitter emit) {
+  emit.leaRMToReg<S::Q>(kBudget, Reg::NoIndex, -1, kBudget);
+  emit.testRegToReg<S::Q>(kBudget, kBudget);
+  return cjump<CCode::Z>(emit, exhausted_);
+}
+
+Emitter RegexJIT::emitResetCaptures(Emitter emit, uint32_t from, uint32_t to) {
+  for (const auto &start : captureStarts_) {
+    if (start.first < from || start.first >= to)
+      continue;
+    int32_t captureOffset = (start.second - 1) * 2 * sizeof(void *);
+    emit.movImmToRM<S::SLQ>(0, kCaptures, Reg::NoIndex, captureOffset);
+    emit.movImmToRM<S::SLQ>(
+        0, kCaptures, Reg::NoIndex, captureOffset + sizeof(void *));
+  }
+  return emit;
+}
+
+} // namespace x86_64
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_X86_64_REGEXJIT_H
+#define HERMES_VM_JIT_X86_64_REGEXJIT_H
+
+#include "hermes/Regex/Executor.h"
+#include "hermes/VM/JIT/ExecHeap.h"
+#include "hermes/VM/JIT/x86-64/Emitter.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+
+#include <vector>
+
+namespace hermes {
+namespace vm {
+namespace x86_64 {
+
+/// An instance of this class is constructed to compile the bytecode of a single
+/// regex to native code, with one entry point for ASCII and one for UTF-16
+/// input. See regex::NativeMatchFn for the calling convention.
+///
+/// Only a subset of the bytecode is supported: regexes without the unicode
+/// flag, made of anchors, word boundaries, characters and brackets, capture
+/// groups, alternations, and loops whose body matches a single character.
+/// Backreferences, lookarounds, general loops and case-insensitive matching of
+/// non-ASCII characters are left to the interpreter.
+///
+/// The generated code backtracks on the native stack: each alternation and
+/// each iteration count of a loop which may have to be revisited calls the
+/// code for the rest of the regex, and tries the next possibility if that
+/// returns null. Since there are no backward jumps, the depth of the native
+/// stack is bounded by the number of such instructions.
+class RegexJIT {
+ public:
+  RegexJIT(ExecHeap &heap, llvm::ArrayRef<uint8_t> bytecode);
+
+  /// Attempt to compile the bytecode.
+  /// \param[out] matcher on success is set to the entry points of the native
+  ///     code, which is owned by the heap.
+  /// \return true on success, false if the regex is not supported or we ran
+  ///     out of executable memory.
+  bool compile(regex::NativeMatcher &matcher);
+
+ private:
+  /// A position in the native code, which may not be known yet. It is an
+  /// index into \c labels_.
+  using Label = unsigned;
+
+  /// A 32-bit relative jump or call to a label which is not yet bound.
+  struct Relo {
+    /// The location of the 32-bit offset in the native code.
+    uint8_t *address;
+    /// The target of the jump.
+    Label target;
+  };
+
+  /// \return an upper bound on the size of the native code for a single input
+  ///     width, or 0 if the bytecode is not supported. Also record the start
+  ///     offsets of the capture groups in \c captureStarts_.
+  size_t validate();
+
+  /// \return an upper bound on the size of the code emitted by emitTest() for
+  ///     \p insn, or 0 if it is not a supported single character instruction.
+  static size_t testBound(const regex::Insn *insn);
+
+  /// \return a new unbound label.
+  Label newLabel();
+
+  /// \return the label of the instruction at bytecode offset \p offset.
+  Label labelForOffset(uint32_t offset);
+
+  /// Set the address of \p label to the current position of \p emit.
+  void bind(Emitter emit, Label label);
+
+  /// Emit a jump, conditional jump or call to \p label, recording a relocation
+  /// if its address is not known yet.
+  Emitter jmp(Emitter emit, Label label);
+  template <CCode cc>
+  Emitter cjump(Emitter emit, Label label);
+  Emitter call(Emitter emit, Label label);
+
+  /// Resolve all recorded relocations and clear the relocation list.
+  /// \return false if some relocation targets a label which was never bound.
+  bool resolveRelocations();
+
+  /// Compile the entry point and all instructions for input code units of
+  /// width \p W (S::B or S::W).
+  template <S W>
+  Emitter compileFunction(Emitter emit);
+
+  /// Compile the instruction at bytecode offset \p offset, which is updated
+  /// to the offset of the next instruction to compile.
+  template <S W>
+  Emitter compileInsn(Emitter emit, uint32_t &offset);
+
+  /// Emit a test of the code unit in eax against the single character
+  /// instruction \p insn. Jump to \p onFail if it does not match, or fall
+  /// through if it does.
+  template <S W>
+  Emitter emitTest(Emitter emit, const regex::Insn *insn, Label onFail);
+
+  /// Emit a jump to \p onHit if the code unit in eax is in any of \p ranges.
+  /// Fall through otherwise.
+  template <S W>
+  Emitter emitTestRanges(
+      Emitter emit,
+      llvm::ArrayRef<regex::BracketRange32> ranges,
+      Label onHit);
+
+  /// Emit a case-insensitive comparison of the code unit in eax against the
+  /// ASCII character \p c. Jump to \p onFail if it does not match.
+  Emitter emitTestICase(Emitter emit, uint8_t c, Label onFail);
+
+  /// Emit a failure if fewer than \p count code units remain in the input.
+  template <S W>
+  Emitter emitCheckRemaining(Emitter emit, uint32_t count);
+
+  /// Emit a decrement of the backtracking budget.
+  Emitter emitBacktrack(Emitter emit);
+
+  /// Emit code resetting the capture groups starting in the bytecode range
+  /// [\p from, \p to).
+  Emitter emitResetCaptures(Emitter emit, uint32_t from, uint32_t to);
+
+  /// \return the instruction at bytecode offset \p offset.
+  const regex::Insn *insnAt(uint32_t offset) const {
+    return reinterpret_cast<const regex::Insn *>(&insns_[offset]);
+  }
+
+  /// The executable memory heap.
+  ExecHeap &heap_;
+  /// The regex bytecode header.
+  const regex::RegexBytecodeHeader *header_;
+  /// The instructions, following the header.
+  llvm::ArrayRef<uint8_t> insns_;
+
+  /// The bytecode offset and index of every BeginMarkedSubexpression.
+  std::vector<std::pair<uint32_t, uint16_t>> captureStarts_{};
+
+  /// The addresses of all labels, or null if not bound yet.
+  std::vector<uint8_t *> labels_{};
+  /// The labels of instructions, by bytecode offset.
+  llvm::DenseMap<uint32_t, Label> offsetLabels_{};
+  /// The relocations which have not been resolved yet.
+  std::vector<Relo> relocs_{};
+
+  /// Code shared by all instructions which returns null (\c fail_), returns
+  /// the value in rax (\c ret_), or gives up because the backtracking budget
+  /// has run out (\c exhausted_).
+  Label fail_{};
+  Label ret_{};
+  Label exhausted_{};
+};
+
+} // namespace x86_64
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_X86_64_REGEXJIT_H
@@ -59,6 +59,8 @@ void ArrayImpl::_snapshotAddEdgesImpl(
 ArrayImpl::ArrayImpl(Deserializer &d, const VTable *vt) : JSObject(d, vt) {
   beginIndex_ = d.readInt<uint32_t>();
   endIndex_ = d.readInt<uint32_t>();
+  numHoles_ = d.readInt<uint32_t>();
+  valuesKind_ = (ElementsKind)d.readInt<uint8_t>();
   d.readRelocation(&indexedStorage_, RelocationKind::GCPointer);
 }
 
@@ -67,6 +69,8 @@ void serializeArrayImpl(Serializer &s, const GCCell *cell) {
   JSObject::serializeObjectImpl(s, cell);
   s.writeInt<uint32_t>(self->beginIndex_);
   s.writeInt<uint32_t>(self->endIndex_);
+  s.writeInt<uint32_t>(self->numHoles_);
+  s.writeInt<uint8_t>((uint8_t)self->valuesKind_);
   s.writeRelocation(self->indexedStorage_.get(s.getRuntime()));
 }
 #endif
@@ -121,6 +125,29 @@ std::pair<uint32_t, uint32_t> ArrayImpl::_getOwnIndexedRangeImpl(
   return {self->beginIndex_, self->endIndex_};
 }
 
+void ArrayImpl::updateElementsKindForResize(
+    Runtime *runtime,
+    uint32_t oldSize,
+    uint32_t newSize) {
+  if (newSize >= oldSize) {
+    // New elements are empty.
+    numHoles_ += newSize - oldSize;
+    return;
+  }
+  if (newSize == 0) {
+    numHoles_ = 0;
+    valuesKind_ = ElementsKind::PackedInt;
+    return;
+  }
+  if (numHoles_) {
+    auto *storage = indexedStorage_.getNonNull(runtime);
+    for (uint32_t i = newSize; i != oldSize; ++i) {
+      if (storage->at(i).isEmpty())
+        --numHoles_;
+    }
+  }
+}
+
 HermesValue ArrayImpl::_getOwnIndexedImpl(
     JSObject *selfObj,
     Runtime *runtime,
@@ -151,6 +178,7 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
         runtime, newStorage.get(), &runtime->getHeap());
     selfHandle->beginIndex_ = 0;
     selfHandle->endIndex_ = newLength;
+    selfHandle->updateElementsKindForResize(runtime, 0, newLength);
     return ExecutionStatus::RETURNED;
   }
 
@@ -160,14 +188,19 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
   auto indexedStorage =
       createPseudoHandle(selfHandle->indexedStorage_.getNonNull(runtime));
 
+  auto oldSize = self->endIndex_ - beginIndex;
+
   if (newLength < beginIndex) {
     // the new length is prior to beginIndex, clearing the storage.
+    selfHandle->updateElementsKindForResize(runtime, oldSize, 0);
     selfHandle->endIndex_ = beginIndex;
     StorageType::resizeWithinCapacity(std::move(indexedStorage), runtime, 0);
     return ExecutionStatus::RETURNED;
   } else if (
       newLength - beginIndex <=
       self->indexedStorage_.getNonNull(runtime)->capacity()) {
+    selfHandle->updateElementsKindForResize(
+        runtime, oldSize, newLength - beginIndex);
     selfHandle->endIndex_ = newLength;
     StorageType::resizeWithinCapacity(
         std::move(indexedStorage), runtime, newLength - beginIndex);
@@ -182,6 +215,10 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
       ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
+  // The storage only had to be reallocated because it grew, so the elements
+  // that were added are all empty.
+  selfHandle->updateElementsKindForResize(
+      runtime, oldSize, newLength - beginIndex);
   selfHandle->endIndex_ = newLength;
   selfHandle->indexedStorage_.set(
       runtime, indexedStorageHandle.get(), &runtime->getHeap());
@@ -202,9 +239,10 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
 
   // Check whether the index is within the storage.
   if (LLVM_LIKELY(index >= beginIndex && index < endIndex)) {
-    self->indexedStorage_.getNonNull(runtime)
-        ->at(index - beginIndex)
-        .set(value.get(), &runtime->getHeap());
+    auto &elem = self->indexedStorage_.getNonNull(runtime)->at(
+        index - beginIndex);
+    self->updateElementsKind(elem, value.get());
+    elem.set(value.get(), &runtime->getHeap());
     return true;
   }
 
@@ -222,6 +260,8 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
     self->indexedStorage_.set(runtime, newStorage.get(), &runtime->getHeap());
     self->beginIndex_ = index;
     self->endIndex_ = index + 1;
+    self->updateElementsKindForResize(runtime, 0, 1);
+    self->updateElementsKind(newStorage->at(0), value.get());
     newStorage->at(0).set(value.get(), &runtime->getHeap());
     return true;
   }
@@ -231,14 +271,17 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
 
   // Can we do it without reallocation for sure?
   if (index >= endIndex && index - beginIndex < indexedStorage->capacity()) {
+    self->updateElementsKindForResize(
+        runtime, endIndex - beginIndex, index - beginIndex + 1);
     self->endIndex_ = index + 1;
     StorageType::resizeWithinCapacity(
         std::move(indexedStorage), runtime, index - beginIndex + 1);
     // Go from selfHandle because the indexedStorage may have changed.
     self = vmcast<ArrayImpl>(selfHandle.get());
-    self->indexedStorage_.getNonNull(runtime)
-        ->at(index - beginIndex)
-        .set(value.get(), &runtime->getHeap());
+    auto &elem = self->indexedStorage_.getNonNull(runtime)->at(
+        index - beginIndex);
+    self->updateElementsKind(elem, value.get());
+    elem.set(value.get(), &runtime->getHeap());
     return true;
   }
 
@@ -257,6 +300,9 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
     self = vmcast<ArrayImpl>(selfHandle.get());
     self->beginIndex_ = index;
     self->endIndex_ = index + 1;
+    self->updateElementsKindForResize(runtime, 0, 1);
+    self->updateElementsKind(
+        HermesValue::encodeEmptyValue(), value.getHermesValue());
   } else if (LLVM_UNLIKELY(
                  (index > endIndex && index - endIndex > shiftLimit) ||
                  (index < beginIndex && beginIndex - index > shiftLimit))) {
@@ -290,6 +336,9 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
       return ExecutionStatus::EXCEPTION;
     }
     self = vmcast<ArrayImpl>(selfHandle.get());
+    self->updateElementsKindForResize(
+        runtime, endIndex - beginIndex, index - beginIndex + 1);
+    self->updateElementsKind(HermesValue::encodeEmptyValue(), value.get());
     self->endIndex_ = index + 1;
     indexedStorageHandle->at(index - beginIndex)
         .set(value.get(), &runtime->getHeap());
@@ -305,6 +354,9 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
       return ExecutionStatus::EXCEPTION;
     }
     self = vmcast<ArrayImpl>(selfHandle.get());
+    self->updateElementsKindForResize(
+        runtime, endIndex - beginIndex, endIndex - index);
+    self->updateElementsKind(HermesValue::encodeEmptyValue(), value.get());
     self->beginIndex_ = index;
     indexedStorageHandle->at(0).set(value.get(), &runtime->getHeap());
   }
@@ -330,6 +382,7 @@ bool ArrayImpl::_deleteOwnIndexedImpl(
       if (!elem.isEmpty())
         return false;
 
+    self->updateElementsKind(elem, HermesValue::encodeEmptyValue());
     elem.setNonPtr(HermesValue::encodeEmptyValue());
   }
 
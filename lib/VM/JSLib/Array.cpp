@@ -457,6 +457,71 @@ class StringCycleChecker {
 
   bool foundCycle_;
 };
+
+/// \return the element at \p index of \p O if it is a packed JSArray which
+/// contains that index. Such an element is known to be present, so it can be
+/// read without a property lookup. Otherwise \return empty, and the caller
+/// must fall back to the generic property lookup.
+inline HermesValue
+getPackedElement(Runtime *runtime, JSObject *O, double index) {
+  auto *arr = dyn_vmcast<JSArray>(O);
+  if (arr && JSArray::isPacked(arr) && index < JSArray::getLength(arr)) {
+    return arr->at(runtime, index);
+  }
+  return HermesValue::encodeEmptyValue();
+}
+
+/// Search the packed array \p arr for \p target, starting at index \p k and
+/// moving towards the end of the range [0, \p len), or towards the start if
+/// \p reverse. \p len must not exceed the length of the array. Elements are
+/// compared with SameValueZero if \p sameValueZero is true, otherwise with
+/// strict equality. Neither can run user code, so the array cannot change.
+/// \return the index of the first match, or -1 if there is none.
+double searchPackedArray(
+    Runtime *runtime,
+    JSArray *arr,
+    HermesValue target,
+    double k,
+    double len,
+    bool reverse,
+    bool sameValueZero) {
+  if (reverse ? k < 0 : k >= len) {
+    return -1;
+  }
+  const int64_t step = reverse ? -1 : 1;
+  const int64_t end = reverse ? -1 : (int64_t)len;
+
+  ElementsKind kind = arr->getElementsKind();
+  if (kind == ElementsKind::PackedInt || kind == ElementsKind::PackedDouble) {
+    // Only numbers can match, and unless we are looking for NaN, they match
+    // when they compare equal.
+    if (!target.isNumber()) {
+      return -1;
+    }
+    double num = target.getNumber();
+    if (kind == ElementsKind::PackedInt && truncateToInt32(num) != num) {
+      // This also excludes NaN, as int elements are never NaN.
+      return -1;
+    }
+    if (!std::isnan(num)) {
+      for (int64_t i = k; i != end; i += step) {
+        if (arr->at(runtime, i).getNumber() == num) {
+          return i;
+        }
+      }
+      return -1;
+    }
+  }
+
+  for (int64_t i = k; i != end; i += step) {
+    HermesValue elem = arr->at(runtime, i);
+    if (sameValueZero ? isSameValueZero(target, elem)
+                      : strictEqualityTest(target, elem)) {
+      return i;
+    }
+  }
+  return -1;
+}
 } // namespace
 
 /// ES5.1 15.4.4.5.
@@ -1255,9 +1320,9 @@ namespace {
 /// handles every time we want to compare different elements.
 /// Usage example:
 ///   StandardSortModel sm{runtime, obj, compareFn};
-///   quickSort(sm, 0, length);
+///   timSort(&sm, 0, length);
 /// Note that this is generic and does nothing different if passed a JSArray.
-class StandardSortModel : public SortModel {
+class StandardSortModel final : public SortModel {
  private:
   /// Runtime to sort in.
   Runtime *runtime_;
@@ -1468,6 +1533,103 @@ class StandardSortModel : public SortModel {
     }
   }
 };
+
+/// \return true if the string representation of the number \p a is less than
+/// that of the number \p b, as the default comparator of Array.prototype.sort
+/// would determine, without allocating any strings.
+bool numberStringLess(double a, double b) {
+  OptValue<uint32_t> aIndex = doubleToArrayIndex(a);
+  OptValue<uint32_t> bIndex = doubleToArrayIndex(b);
+  if (aIndex && bIndex) {
+    // Both are small non-negative integers: compare their decimal digits by
+    // scaling the shorter one to the length of the longer one.
+    uint64_t x = *aIndex;
+    uint64_t y = *bIndex;
+    uint64_t xScale = 1;
+    uint64_t yScale = 1;
+    for (uint64_t t = x; t >= 10; t /= 10)
+      xScale *= 10;
+    for (uint64_t t = y; t >= 10; t /= 10)
+      yScale *= 10;
+    if (xScale < yScale) {
+      // If the scaled x is equal to y, x is a prefix of y, so it is less.
+      return x * (yScale / xScale) <= y;
+    }
+    if (yScale < xScale) {
+      // If the scaled y is equal to x, y is a prefix of x, so it is less.
+      return x < y * (xScale / yScale);
+    }
+    return x < y;
+  }
+
+  char aBuf[NUMBER_TO_STRING_BUF_SIZE];
+  char bBuf[NUMBER_TO_STRING_BUF_SIZE];
+  size_t aLen = numberToString(a, aBuf, sizeof(aBuf));
+  size_t bLen = numberToString(b, bBuf, sizeof(bBuf));
+  return llvm::StringRef(aBuf, aLen) < llvm::StringRef(bBuf, bLen);
+}
+
+/// Sorting model for a JSArray whose elements [0, length) are all present in
+/// its indexed storage and are either all strings or all numbers, sorted with
+/// the default comparator. Comparing such elements can neither run user code
+/// nor allocate, so they are read and written directly in the storage instead
+/// of going through [[Get]], [[Put]] and ToString.
+class DenseArraySortModel final {
+  Runtime *runtime_;
+
+  /// The array being sorted. No allocation happens while sorting, so a raw
+  /// pointer is safe.
+  JSArray *arr_;
+
+  /// Whether all elements are numbers (otherwise they are all strings).
+  bool numbers_;
+
+ public:
+  DenseArraySortModel(Runtime *runtime, JSArray *arr, bool numbers)
+      : runtime_(runtime), arr_(arr), numbers_(numbers) {}
+
+  /// \return true if the elements of \p arr in [0, len) can be sorted with
+  /// this model. \p numbers is set to whether they are all numbers.
+  static bool isApplicable(
+      Runtime *runtime,
+      JSArray *arr,
+      uint64_t len,
+      bool &numbers) {
+    if (!arr->isExtensible() || !arr->hasFastIndexProperties() ||
+        arr->getBeginIndex() != 0 || arr->getEndIndex() != len) {
+      return false;
+    }
+    if (len == 0) {
+      numbers = false;
+      return true;
+    }
+    numbers = arr->at(runtime, 0).isNumber();
+    for (uint32_t i = 0; i != len; ++i) {
+      HermesValue val = arr->at(runtime, i);
+      if (numbers ? !val.isNumber() : !val.isString()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  ExecutionStatus swap(uint32_t a, uint32_t b) {
+    HermesValue aVal = arr_->at(runtime_, a);
+    HermesValue bVal = arr_->at(runtime_, b);
+    JSArray::unsafeSetExistingElementAt(arr_, runtime_, a, bVal);
+    JSArray::unsafeSetExistingElementAt(arr_, runtime_, b, aVal);
+    return ExecutionStatus::RETURNED;
+  }
+
+  CallResult<bool> less(uint32_t a, uint32_t b) {
+    HermesValue aVal = arr_->at(runtime_, a);
+    HermesValue bVal = arr_->at(runtime_, b);
+    if (numbers_) {
+      return numberStringLess(aVal.getNumber(), bVal.getNumber());
+    }
+    return aVal.getString()->compare(bVal.getString()) < 0;
+  }
+};
 } // anonymous namespace
 
 /// ES5.1 15.4.4.11.
@@ -1496,12 +1658,30 @@ arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
   }
   uint64_t len = *intRes;
 
+  // Dense arrays of strings or numbers with the default comparator can be
+  // sorted directly in their storage.
+  if (!compareFn) {
+    if (auto *arr = dyn_vmcast<JSArray>(*O)) {
+      bool numbers;
+      if (DenseArraySortModel::isApplicable(runtime, arr, len, numbers)) {
+        NoAllocScope noAlloc(runtime);
+        DenseArraySortModel sm(runtime, arr, numbers);
+        auto status = timSort(&sm, 0u, len);
+        (void)status;
+        assert(
+            status != ExecutionStatus::EXCEPTION &&
+            "sorting a dense array cannot fail");
+        return O.getHermesValue();
+      }
+    }
+  }
+
   StandardSortModel sm(runtime, O, compareFn);
 
   // Use our custom sort routine. We can't use std::sort because it performs
   // optimizations that allow it to bypass calls to std::swap, but our swap
   // function is special, since it needs to use the internal Object functions.
-  if (LLVM_UNLIKELY(quickSort(&sm, 0u, len) == ExecutionStatus::EXCEPTION))
+  if (LLVM_UNLIKELY(timSort(&sm, 0u, len) == ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
 
   return O.getHermesValue();
@@ -1920,30 +2100,39 @@ arrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
 
   MutableHandle<JSObject> descObjHandle{runtime};
 
+  // Value at index k.
+  MutableHandle<> kValue{runtime};
+
   // Loop through and execute the callback on all existing values.
-  // TODO: Implement a fast path for actual arrays.
   auto marker = gcScope.createMarker();
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    // The callback may modify the array, so check whether it is packed on
+    // every iteration.
+    kValue = getPackedElement(runtime, *O, k->getDouble());
+    if (kValue->isEmpty()) {
+      ComputedPropertyDescriptor desc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, k, descObjHandle, desc);
+      if (descObjHandle) {
+        if ((propRes = JSObject::getComputedPropertyValue(
+                 O, runtime, descObjHandle, desc)) ==
+            ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = propRes.getValue();
+      }
+    }
 
-    if (descObjHandle) {
+    if (!kValue->isEmpty()) {
       // kPresent is true, execute callback.
-      if ((propRes = JSObject::getComputedPropertyValue(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      auto kValue = propRes.getValue();
       if (LLVM_UNLIKELY(
               Callable::executeCall3(
                   callbackFn,
                   runtime,
                   args.getArgHandle(1),
-                  kValue,
+                  kValue.get(),
                   k.get(),
                   O.getHermesValue()) == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
@@ -2008,6 +2197,15 @@ arrayPrototypeIncludes(void *, Runtime *runtime, NativeArgs args) {
     }
   }
 
+  // Packed arrays can be searched directly, without property lookups.
+  if (auto *arr = dyn_vmcast<JSArray>(*O)) {
+    if (JSArray::isPacked(arr) && len <= JSArray::getLength(arr)) {
+      return HermesValue::encodeBoolValue(
+          searchPackedArray(
+              runtime, arr, args.getArg(0), k, len, false, true) >= 0);
+    }
+  }
+
   MutableHandle<> kHandle{runtime};
 
   // 7. Repeat, while k < len
@@ -2519,10 +2717,24 @@ indexOfHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
     }
   }
 
-  MutableHandle<JSObject> descObjHandle{runtime};
-
   // Search for the element.
   auto searchElement = args.getArgHandle(0);
+
+  // Packed arrays can be searched directly, without property lookups.
+  if (auto *arr = dyn_vmcast<JSArray>(*O)) {
+    if (JSArray::isPacked(arr) && len <= JSArray::getLength(arr)) {
+      return HermesValue::encodeNumberValue(searchPackedArray(
+          runtime,
+          arr,
+          searchElement.get(),
+          k->getDouble(),
+          len,
+          reverse,
+          false));
+    }
+  }
+
+  MutableHandle<JSObject> descObjHandle{runtime};
   auto marker = gcScope.createMarker();
   while (true) {
     gcScope.flushToMarker(marker);
@@ -2704,29 +2916,38 @@ arrayPrototypeMap(void *, Runtime *runtime, NativeArgs args) {
 
   MutableHandle<JSObject> descObjHandle{runtime};
 
+  // Value at index k.
+  MutableHandle<> kValue{runtime};
+
   // Main loop to execute callback and store the results in A.
-  // TODO: Implement a fast path for actual arrays.
   auto marker = gcScope.createMarker();
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    // The callback may modify the array, so check whether it is packed on
+    // every iteration.
+    kValue = getPackedElement(runtime, *O, k->getDouble());
+    if (kValue->isEmpty()) {
+      ComputedPropertyDescriptor desc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, k, descObjHandle, desc);
+      if (descObjHandle) {
+        if ((propRes = JSObject::getComputedPropertyValue(
+                 O, runtime, descObjHandle, desc)) ==
+            ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = propRes.getValue();
+      }
+    }
 
-    if (descObjHandle) {
+    if (!kValue->isEmpty()) {
       // kPresent is true, execute callback and store result in A[k].
-      if ((propRes = JSObject::getComputedPropertyValue(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      auto kValue = propRes.getValue();
       auto callRes = Callable::executeCall3(
           callbackFn,
           runtime,
           args.getArgHandle(1),
-          kValue,
+          kValue.get(),
           k.get(),
           O.getHermesValue());
       if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
@@ -2874,6 +3095,20 @@ arrayPrototypeFill(void *, Runtime *runtime, NativeArgs args) {
   // Actual end index.
   double actualEnd = relativeEnd < 0 ? std::max(len + relativeEnd, 0.0)
                                      : std::min(relativeEnd, len);
+
+  // Elements of packed arrays can be overwritten directly: they are all
+  // present, so no setters can be invoked, and they are writable unless the
+  // array is frozen, which implies that it is not extensible.
+  if (auto *arr = dyn_vmcast<JSArray>(*O)) {
+    if (JSArray::isPacked(arr) && arr->isExtensible() &&
+        actualEnd <= JSArray::getLength(arr)) {
+      for (double i = actualStart; i < actualEnd; ++i) {
+        JSArray::unsafeSetExistingElementAt(arr, runtime, i, value.get());
+      }
+      return O.getHermesValue();
+    }
+  }
+
   MutableHandle<> k(runtime, HermesValue::encodeDoubleValue(actualStart));
   auto marker = gcScope.createMarker();
   while (k->getDouble() < actualEnd) {
@@ -2998,6 +3233,9 @@ reduceHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
 
   MutableHandle<> accumulator{runtime};
 
+  // Value at index k.
+  MutableHandle<> kValue{runtime};
+
   auto marker = gcScope.createMarker();
 
   // How much to increment k by each iteration of a loop.
@@ -3053,23 +3291,30 @@ reduceHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
       }
     }
 
-    ComputedPropertyDescriptor kDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, kDescObjHandle, kDesc);
-    if (kDescObjHandle) {
-      // kPresent is true, run the accumulation step.
-      if ((propRes = JSObject::getComputedPropertyValue(
-               O, runtime, kDescObjHandle, kDesc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
+    // The callback may modify the array, so check whether it is packed on
+    // every iteration.
+    kValue = getPackedElement(runtime, *O, k->getDouble());
+    if (kValue->isEmpty()) {
+      ComputedPropertyDescriptor kDesc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, k, kDescObjHandle, kDesc);
+      if (kDescObjHandle) {
+        if ((propRes = JSObject::getComputedPropertyValue(
+                 O, runtime, kDescObjHandle, kDesc)) ==
+            ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        kValue = propRes.getValue();
       }
-      auto kValue = propRes.getValue();
+    }
+    if (!kValue->isEmpty()) {
+      // kPresent is true, run the accumulation step.
       auto callRes = Callable::executeCall4(
           callbackFn,
           runtime,
           Runtime::getUndefinedValue(),
           accumulator.get(),
-          kValue,
+          kValue.get(),
           k.get(),
           O.getHermesValue());
       if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
@@ -237,6 +237,14 @@ hermesInternalGetInstrumentedStats(void *, Runtime *runtime, NativeArgs args) {
     SET_PROP_NEW("js_vaSize", info.va);
   }
 
+  {
+    const RegExpCache &regExpCache = runtime->getRegExpCache();
+    SET_PROP_NEW("js_regExpCacheHits", regExpCache.getHits());
+    SET_PROP_NEW("js_regExpCacheMisses", regExpCache.getMisses());
+    SET_PROP_NEW("js_regExpCacheSize", regExpCache.size());
+    SET_PROP_NEW("js_regExpCacheMallocSize", regExpCache.getMallocSize());
+  }
+
   if (stats.shouldSample) {
     SET_PROP_NEW(
         "js_hermesVolCtxSwitches",
@@ -282,6 +290,9 @@ hermesInternalGetInstrumentedStats(void *, Runtime *runtime, NativeArgs args) {
   if (runtime->getRuntimeStats().shouldSample) {
     size_t bytecodePagesResident = 0;
     size_t bytecodePagesResidentRuns = 0;
+    // Pages brought in by prefetching or page faults since the bytecode was
+    // loaded.
+    size_t bytecodePagesLoaded = 0;
     for (auto &module : runtime->getRuntimeModules()) {
       auto buf = module.getBytecode()->getRawBuffer();
       if (buf.size()) {
@@ -291,10 +302,16 @@ hermesInternalGetInstrumentedStats(void *, Runtime *runtime, NativeArgs args) {
           bytecodePagesResident += pages;
           bytecodePagesResidentRuns += runs.size();
         }
+        int loaded = module.getBytecode()->getPagesLoadedSinceSnapshot();
+        if (loaded >= 0)
+          bytecodePagesLoaded += loaded;
       }
     }
     SET_PROP_NEW("js_bytecodePagesResident", bytecodePagesResident);
     SET_PROP_NEW("js_bytecodePagesResidentRuns", bytecodePagesResidentRuns);
+    SET_PROP_NEW("js_bytecodePagesLoaded", bytecodePagesLoaded);
+    SET_PROP_NEW(
+        "js_bytecodePagesReleased", runtime->getBytecodePagesReleased());
 
     // Stats for the module with most accesses.
     uint32_t bytecodePagesAccessed = 0;
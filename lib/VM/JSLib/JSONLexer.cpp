@@ -7,6 +7,8 @@
 
 #include "JSONLexer.h"
 
+#include "hermes/Support/Conversions.h"
+
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/dtoa/dtoa.h"
 
@@ -111,6 +113,11 @@ ExecutionStatus JSONLexer::scanNumber() {
     return errorWithChar(u"Unexpected token in number: ", *(start + 1));
   }
 
+  if (auto fast = parseDecimalFast(start, curCharPtr_)) {
+    token_.setNumber(*fast);
+    return ExecutionStatus::RETURNED;
+  }
+
   // copy 16 bit chars into 8 bit chars and call hermes_g_strtod.
   llvm::SmallVector<char, 32> str8;
   str8.insert(str8.begin(), start, start + len);
@@ -242,7 +242,10 @@ mapPrototypeClear(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Map.prototype.clear called on incompatible receiver");
   }
-  JSMap::clear(selfHandle, runtime);
+  if (LLVM_UNLIKELY(
+          JSMap::clear(selfHandle, runtime) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return HermesValue::encodeUndefinedValue();
 }
 
@@ -367,8 +370,12 @@ mapPrototypeSet(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Map.prototype.set called on incompatible receiver");
   }
-  JSMap::addValue(
-      selfHandle, runtime, args.getArgHandle(0), args.getArgHandle(1));
+  if (LLVM_UNLIKELY(
+          JSMap::addValue(
+              selfHandle, runtime, args.getArgHandle(0), args.getArgHandle(1)) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return selfHandle.getHermesValue();
 }
 
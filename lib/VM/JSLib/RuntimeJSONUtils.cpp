@@ -7,6 +7,7 @@
 
 #include "hermes/VM/JSLib/RuntimeJSONUtils.h"
 
+#include "hermes/Support/Conversions.h"
 #include "hermes/Support/JSON.h"
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Callable.h"
@@ -811,12 +812,13 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
 
   // Str.9.
   if (operationStrValue_->isNumber()) {
-    if (std::isfinite(operationStrValue_->getNumber())) {
-      auto status = toString_RJS(runtime_, operationStrValue_);
-      assert(
-          status != ExecutionStatus::EXCEPTION &&
-          "toString on a number cannot fail");
-      appendToOutput(status->get());
+    double num = operationStrValue_->getNumber();
+    if (std::isfinite(num)) {
+      // Format the number directly into the output instead of allocating a
+      // string for it.
+      char buf[NUMBER_TO_STRING_BUF_SIZE];
+      size_t len = hermes::numberToString(num, buf, sizeof(buf));
+      output_.append(buf, buf + len);
     } else {
       appendToOutput(Predefined::getSymbolID(Predefined::null));
     }
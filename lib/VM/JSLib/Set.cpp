@@ -217,7 +217,11 @@ setPrototypeAdd(void *, Runtime *runtime, NativeArgs args) {
         "Method Set.prototype.add called on incompatible receiver");
   }
   auto valueHandle = args.getArgHandle(0);
-  JSSet::addValue(selfHandle, runtime, valueHandle, valueHandle);
+  if (LLVM_UNLIKELY(
+          JSSet::addValue(selfHandle, runtime, valueHandle, valueHandle) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return selfHandle.getHermesValue();
 }
 
@@ -232,7 +236,10 @@ setPrototypeClear(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Set.prototype.clear called on incompatible receiver");
   }
-  JSSet::clear(selfHandle, runtime);
+  if (LLVM_UNLIKELY(
+          JSSet::clear(selfHandle, runtime) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return HermesValue::encodeUndefinedValue();
 }
 
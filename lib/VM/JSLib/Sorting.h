@@ -8,6 +8,7 @@
 #ifndef HERMES_VM_JSLIB_SORTING_H
 #define HERMES_VM_JSLIB_SORTING_H
 
+#include <cassert>
 #include <cstdint>
 
 #include "hermes/VM/CallResult.h"
@@ -34,9 +35,458 @@ class SortModel {
   virtual ~SortModel() = 0;
 };
 
-/// QuickSort to sort elements in the range [begin, end). Returns immediately
-/// with ExecutionStatus::EXCEPTION if any compare or swap operations fail.
-ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end);
+namespace sorting_detail {
+
+/// Ranges shorter than this are sorted with a single binary insertion sort.
+constexpr uint32_t kTimSortMinMerge = 32;
+
+/// Maximum number of pending runs. Run lengths on the stack grow at least as
+/// fast as the Fibonacci numbers, so this is plenty for any 32-bit length.
+constexpr unsigned kTimSortMaxPending = 85;
+
+/// The state of a single TimSort invocation over a model of type \p Model,
+/// which must provide the swap() and less() operations of SortModel. The
+/// model is called directly, so a concrete (final) model type avoids virtual
+/// dispatch entirely.
+///
+/// Unlike the classic TimSort, which merges runs through a temporary buffer,
+/// all element movement is expressed as swaps (the only way to move elements
+/// through the [[Get]]/[[Put]] based models), so merging is done in place by
+/// rotation (the SymMerge algorithm). Galloping is used to trim the parts of
+/// two runs which are already in place before merging them.
+template <typename Model>
+class TimSort {
+ public:
+  explicit TimSort(Model *sm) : sm_(sm) {}
+
+  ExecutionStatus sort(uint32_t begin, uint32_t end) {
+    uint32_t remaining = end - begin;
+    if (remaining < 2) {
+      return ExecutionStatus::RETURNED;
+    }
+
+    uint32_t lo = begin;
+    if (remaining < kTimSortMinMerge) {
+      auto runRes = countRunAndMakeAscending(lo, end);
+      if (LLVM_UNLIKELY(runRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      return binaryInsertionSort(lo, end, lo + *runRes);
+    }
+
+    uint32_t minRun = computeMinRun(remaining);
+    do {
+      auto runRes = countRunAndMakeAscending(lo, end);
+      if (LLVM_UNLIKELY(runRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      uint32_t runLen = *runRes;
+
+      // Extend short runs to minRun elements.
+      if (runLen < minRun) {
+        uint32_t force = remaining <= minRun ? remaining : minRun;
+        if (LLVM_UNLIKELY(
+                binaryInsertionSort(lo, lo + force, lo + runLen) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        runLen = force;
+      }
+
+      assert(numPending_ < kTimSortMaxPending && "too many pending runs");
+      pending_[numPending_++] = {lo, runLen};
+      if (LLVM_UNLIKELY(mergeCollapse() == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+
+      lo += runLen;
+      remaining -= runLen;
+    } while (remaining != 0);
+
+    return mergeForceCollapse();
+  }
+
+ private:
+  /// A sorted run of elements [base, base + len).
+  struct Run {
+    uint32_t base;
+    uint32_t len;
+  };
+
+  /// \return the minimum run length for a range of length \p n: n itself if
+  /// it is small, otherwise a number in [kTimSortMinMerge / 2,
+  /// kTimSortMinMerge] such that n / minRun is close to a power of two.
+  static uint32_t computeMinRun(uint32_t n) {
+    uint32_t r = 0;
+    while (n >= kTimSortMinMerge) {
+      r |= n & 1;
+      n >>= 1;
+    }
+    return n + r;
+  }
+
+  /// Find the length of the run starting at \p lo, which is either
+  /// non-descending or strictly descending. A descending run is reversed in
+  /// place (strictness guarantees that this preserves stability).
+  CallResult<uint32_t> countRunAndMakeAscending(uint32_t lo, uint32_t hi) {
+    uint32_t runHi = lo + 1;
+    if (runHi == hi) {
+      return 1u;
+    }
+
+    auto res = sm_->less(runHi, lo);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    ++runHi;
+    if (*res) {
+      for (; runHi < hi; ++runHi) {
+        if (LLVM_UNLIKELY(
+                (res = sm_->less(runHi, runHi - 1)) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        if (!*res) {
+          break;
+        }
+      }
+      if (LLVM_UNLIKELY(
+              reverseRange(lo, runHi) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    } else {
+      for (; runHi < hi; ++runHi) {
+        if (LLVM_UNLIKELY(
+                (res = sm_->less(runHi, runHi - 1)) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        if (*res) {
+          break;
+        }
+      }
+    }
+    return runHi - lo;
+  }
+
+  /// Reverse the elements [lo, hi).
+  ExecutionStatus reverseRange(uint32_t lo, uint32_t hi) {
+    while (hi - lo > 1) {
+      if (LLVM_UNLIKELY(sm_->swap(lo++, --hi) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  /// Sort [lo, hi), given that [lo, start) is already sorted, by inserting
+  /// each remaining element after all elements that are not greater than it.
+  ExecutionStatus
+  binaryInsertionSort(uint32_t lo, uint32_t hi, uint32_t start) {
+    for (uint32_t i = start; i < hi; ++i) {
+      auto posRes = upperBound(i, lo, i);
+      if (LLVM_UNLIKELY(posRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      for (uint32_t j = i; j > *posRes; --j) {
+        if (LLVM_UNLIKELY(sm_->swap(j, j - 1) == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  /// \return the first index in the sorted range [lo, hi) whose element is
+  /// greater than the element at \p key, which must be outside the range.
+  CallResult<uint32_t> upperBound(uint32_t key, uint32_t lo, uint32_t hi) {
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      auto res = sm_->less(key, mid);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return lo;
+  }
+
+  /// \return the first index in the sorted range [lo, hi) whose element is
+  /// not less than the element at \p key, which must be outside the range.
+  CallResult<uint32_t> lowerBound(uint32_t key, uint32_t lo, uint32_t hi) {
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      auto res = sm_->less(mid, key);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /// Same as upperBound(), but searches exponentially from the left end of
+  /// the range first, so it is fast when the result is close to \p lo.
+  CallResult<uint32_t>
+  gallopUpperBound(uint32_t key, uint32_t lo, uint32_t hi) {
+    uint64_t len = hi - lo;
+    // The elements [lo, lo + lastOfs) are known not to be greater than key.
+    uint64_t lastOfs = 0;
+    uint64_t ofs = 1;
+    while (ofs <= len) {
+      auto res = sm_->less(key, lo + ofs - 1);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        break;
+      }
+      lastOfs = ofs;
+      ofs = ofs * 2 + 1;
+    }
+    if (ofs > len) {
+      ofs = len;
+    }
+    return upperBound(key, lo + lastOfs, lo + ofs);
+  }
+
+  /// Same as lowerBound(), but searches exponentially from the right end of
+  /// the range first, so it is fast when the result is close to \p hi.
+  CallResult<uint32_t>
+  gallopLowerBound(uint32_t key, uint32_t lo, uint32_t hi) {
+    uint64_t len = hi - lo;
+    // The elements [hi - lastOfs, hi) are known not to be less than key.
+    uint64_t lastOfs = 0;
+    uint64_t ofs = 1;
+    while (ofs <= len) {
+      auto res = sm_->less(hi - ofs, key);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        break;
+      }
+      lastOfs = ofs;
+      ofs = ofs * 2 + 1;
+    }
+    if (ofs > len) {
+      ofs = len;
+    }
+    return lowerBound(key, hi - ofs, hi - lastOfs);
+  }
+
+  /// Merge adjacent pending runs until the stack invariants hold:
+  ///   len[i - 2] > len[i - 1] + len[i] and len[i - 1] > len[i]
+  /// for the top four runs (checking only the top three is not sufficient).
+  ExecutionStatus mergeCollapse() {
+    while (numPending_ > 1) {
+      unsigned n = numPending_ - 2;
+      if ((n > 0 &&
+           pending_[n - 1].len <= pending_[n].len + pending_[n + 1].len) ||
+          (n > 1 &&
+           pending_[n - 2].len <= pending_[n - 1].len + pending_[n].len)) {
+        if (pending_[n - 1].len < pending_[n + 1].len) {
+          --n;
+        }
+      } else if (pending_[n].len > pending_[n + 1].len) {
+        break;
+      }
+      if (LLVM_UNLIKELY(mergeAt(n) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  /// Merge all pending runs into one.
+  ExecutionStatus mergeForceCollapse() {
+    while (numPending_ > 1) {
+      unsigned n = numPending_ - 2;
+      if (n > 0 && pending_[n - 1].len < pending_[n + 1].len) {
+        --n;
+      }
+      if (LLVM_UNLIKELY(mergeAt(n) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  /// Merge the pending runs at stack indices \p i and \p i + 1.
+  ExecutionStatus mergeAt(unsigned i) {
+    assert(i + 1 < numPending_ && "merging past the top of the stack");
+    uint32_t lo = pending_[i].base;
+    uint32_t mid = pending_[i + 1].base;
+    uint32_t hi = mid + pending_[i + 1].len;
+    pending_[i].len += pending_[i + 1].len;
+    if (i + 3 == numPending_) {
+      pending_[i + 1] = pending_[i + 2];
+    }
+    --numPending_;
+
+    // Elements of the first run which are not greater than the first element
+    // of the second run are already in place.
+    auto res = gallopUpperBound(mid, lo, mid);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    lo = *res;
+    if (lo == mid) {
+      return ExecutionStatus::RETURNED;
+    }
+    // Elements of the second run which are not less than the last element of
+    // the first run are already in place.
+    if (LLVM_UNLIKELY(
+            (res = gallopLowerBound(mid - 1, mid, hi)) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    hi = *res;
+    if (hi == mid) {
+      return ExecutionStatus::RETURNED;
+    }
+    return symMerge(lo, mid, hi);
+  }
+
+  /// Stably merge the sorted ranges [a, m) and [m, b) in place, using the
+  /// SymMerge algorithm by Kim and Kutzner. It needs O(M log(N/M + 1))
+  /// comparisons and O((M + N) log M) swaps, where M <= N are the lengths of
+  /// the two ranges, and its recursion depth is bounded by log(M + N).
+  ExecutionStatus symMerge(uint32_t a, uint32_t m, uint32_t b) {
+    if (m - a == 1) {
+      // Insert the single element at a into [m, b).
+      auto res = lowerBound(a, m, b);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      for (uint32_t k = a; k + 1 < *res; ++k) {
+        if (LLVM_UNLIKELY(sm_->swap(k, k + 1) == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+      }
+      return ExecutionStatus::RETURNED;
+    }
+    if (b - m == 1) {
+      // Insert the single element at m into [a, m).
+      auto res = upperBound(m, a, m);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      for (uint32_t k = m; k > *res; --k) {
+        if (LLVM_UNLIKELY(sm_->swap(k, k - 1) == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+      }
+      return ExecutionStatus::RETURNED;
+    }
+
+    uint32_t mid = a + (b - a) / 2;
+    // Indices symmetric around the center of [a, b) sum up to n.
+    uint64_t n = (uint64_t)mid + m;
+    uint64_t start;
+    uint64_t r;
+    if (m > mid) {
+      start = n - b;
+      r = mid;
+    } else {
+      start = a;
+      r = m;
+    }
+    uint64_t p = n - 1;
+    while (start < r) {
+      uint64_t c = start + (r - start) / 2;
+      auto res = sm_->less(p - c, c);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        r = c;
+      } else {
+        start = c + 1;
+      }
+    }
+    uint32_t end = n - start;
+    if (start < m && m < end) {
+      if (LLVM_UNLIKELY(rotate(start, m, end) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    if (a < start && start < mid) {
+      if (LLVM_UNLIKELY(
+              symMerge(a, start, mid) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    if (mid < end && end < b) {
+      if (LLVM_UNLIKELY(symMerge(mid, end, b) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  /// Rotate [a, b) so that the element at \p m moves to \p a, by swapping
+  /// blocks of equal size.
+  ExecutionStatus rotate(uint32_t a, uint32_t m, uint32_t b) {
+    uint32_t i = m - a;
+    uint32_t j = b - m;
+    while (i != j) {
+      if (i > j) {
+        if (LLVM_UNLIKELY(
+                swapRange(m - i, m, j) == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        i -= j;
+      } else {
+        if (LLVM_UNLIKELY(
+                swapRange(m - i, m + j - i, i) == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        j -= i;
+      }
+    }
+    return swapRange(m - i, m, i);
+  }
+
+  /// Swap the \p count elements starting at \p a with those starting at \p b.
+  ExecutionStatus swapRange(uint32_t a, uint32_t b, uint32_t count) {
+    for (uint32_t k = 0; k != count; ++k) {
+      if (LLVM_UNLIKELY(
+              sm_->swap(a + k, b + k) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  Model *sm_;
+
+  /// Stack of runs waiting to be merged.
+  Run pending_[kTimSortMaxPending];
+  unsigned numPending_{0};
+};
+
+} // namespace sorting_detail
+
+/// Stable TimSort of the elements in the range [begin, end). Runs which are
+/// already sorted (or strictly reverse sorted) are detected and merged, so
+/// presorted input is handled with a linear number of comparisons. Only the
+/// swap and less operations of \p sm are used and no auxiliary storage is
+/// allocated. \p sm is called directly, so passing a final model avoids
+/// virtual dispatch. Returns immediately with ExecutionStatus::EXCEPTION if any
+/// compare or swap operations fail.
+template <typename Model>
+ExecutionStatus timSort(Model *sm, uint32_t begin, uint32_t end) {
+  return sorting_detail::TimSort<Model>(sm).sort(begin, end);
+}
 
 } // namespace vm
 } // namespace hermes
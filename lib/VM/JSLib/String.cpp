@@ -12,6 +12,8 @@
 #include "JSLibInternal.h"
 
 #include "hermes/Platform/Unicode/PlatformUnicode.h"
+#include "hermes/Support/Conversions.h"
+#include "hermes/Support/StringSearch.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/PrimitiveBox.h"
@@ -19,6 +21,8 @@
 #include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringView.h"
 
+#include "llvm/ADT/SmallString.h"
+
 #if defined(__ANDROID__)
 #include "hermes/Platform/Unicode/PlatformUnicode.h"
 #endif
@@ -35,6 +39,47 @@ namespace vm {
 //===----------------------------------------------------------------------===//
 /// String.
 
+/// Helper for searchStringView() once the code unit type of \p haystack is
+/// known.
+template <typename T>
+static size_t searchStringViewIn(
+    llvm::ArrayRef<T> haystack,
+    const StringView &needle,
+    size_t pos,
+    bool reverse) {
+  if (needle.isASCII()) {
+    llvm::ArrayRef<char> units{needle.castToCharPtr(), needle.length()};
+    return reverse ? searchSubstringReverse(haystack, units, pos)
+                   : searchSubstring(haystack, units, pos);
+  }
+  llvm::ArrayRef<char16_t> units{needle.castToChar16Ptr(), needle.length()};
+  return reverse ? searchSubstringReverse(haystack, units, pos)
+                 : searchSubstring(haystack, units, pos);
+}
+
+/// Search for \p needle in \p haystack.
+/// \param reverse if false, find the first occurrence starting at or after
+///     \p pos. If true, find the last occurrence starting at or before \p pos.
+/// \return the index of the occurrence, or kSubstringNotFound.
+static size_t searchStringView(
+    const StringView &haystack,
+    const StringView &needle,
+    size_t pos,
+    bool reverse = false) {
+  if (haystack.isASCII()) {
+    return searchStringViewIn(
+        llvm::makeArrayRef(haystack.castToCharPtr(), haystack.length()),
+        needle,
+        pos,
+        reverse);
+  }
+  return searchStringViewIn(
+      llvm::makeArrayRef(haystack.castToChar16Ptr(), haystack.length()),
+      needle,
+      pos,
+      reverse);
+}
+
 Handle<JSObject> createStringConstructor(Runtime *runtime) {
   auto stringPrototype =
       Handle<PrimitiveBox>::vmcast(&runtime->stringPrototype);
@@ -336,6 +381,14 @@ CallResult<HermesValue>
 stringFromCharCode(void *, Runtime *runtime, NativeArgs args) {
   GCScope gcScope(runtime);
   uint32_t n = args.getArgCount();
+  if (LLVM_LIKELY(n == 1)) {
+    // Single character strings are preallocated.
+    auto res = toUInt16(runtime, args.getArgHandle(0));
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return runtime->getCharacterString(res->getNumber()).getHermesValue();
+  }
   auto builder = StringBuilder::createStringBuilder(runtime, SafeUInt32{n});
   if (builder == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
@@ -680,9 +733,29 @@ stringPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
   }
   auto strings = runtime->makeHandle<ArrayStorage>(*arrRes);
 
+  // Numbers, which are common in template literals, are formatted into
+  // numberChars instead of being converted to strings. They are stored as is
+  // in strings, and the length of each is recorded in numberLengths.
+  llvm::SmallString<32> numberChars;
+  llvm::SmallVector<uint8_t, 4> numberLengths;
+
   // Run toString on the arguments to figure out the final size.
   auto marker = gcScope.createMarker();
   for (uint32_t i = 0; i < argCount; ++i) {
+    HermesValue arg = args.getArg(i);
+    if (arg.isNumber()) {
+      char buf[NUMBER_TO_STRING_BUF_SIZE];
+      size_t len = numberToString(arg.getNumber(), buf, sizeof(buf));
+      numberChars.append(buf, buf + len);
+      numberLengths.push_back(len);
+      strings->at(i).set(arg, &runtime->getHeap());
+      size.add(len);
+      if (LLVM_UNLIKELY(size.isOverflowed())) {
+        return runtime->raiseRangeError(
+            "resulting string length exceeds limit");
+      }
+      continue;
+    }
     auto strRes = toString_RJS(runtime, args.getArgHandle(i));
     if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
@@ -712,7 +785,14 @@ stringPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
   MutableHandle<StringPrimitive> element{runtime};
 
   // Copy the rest of the strings.
+  const char *numberPtr = numberChars.data();
+  const uint8_t *numberLength = numberLengths.data();
   for (uint32_t i = 0; i < argCount; i++) {
+    if (strings->at(i).isNumber()) {
+      builder->appendASCIIRef(ASCIIRef(numberPtr, *numberLength));
+      numberPtr += *numberLength++;
+      continue;
+    }
     element = strings->at(i).getString();
     builder->appendStringPrim(element);
   }
@@ -790,17 +870,73 @@ static CallResult<RegExpMatch> splitMatch(
     return match;
   }
 
-  auto sliced = SStr.slice(q);
-  auto searchResult =
-      std::search(sliced.begin(), sliced.end(), RStr.begin(), RStr.end());
-
-  if (searchResult != sliced.end()) {
-    uint32_t i = q + (searchResult - sliced.begin());
-    match.push_back({{i, RHandle->getStringLength()}});
+  size_t i = searchStringView(SStr, RStr, q);
+  if (i != kSubstringNotFound) {
+    match.push_back({{(uint32_t)i, RHandle->getStringLength()}});
   }
   return match;
 }
 
+/// Split the non-empty string \p S on the string separator \p R into at most
+/// \p lim elements. This is equivalent to the general loop in splitInternal(),
+/// but finds all the separators in a single scan before allocating anything,
+/// so that the result array can be created with its final size and filled
+/// without growing it.
+static CallResult<HermesValue> splitOnString(
+    Runtime *runtime,
+    Handle<StringPrimitive> S,
+    Handle<StringPrimitive> R,
+    uint32_t lim) {
+  uint32_t s = S->getStringLength();
+  uint32_t r = R->getStringLength();
+  assert(s != 0 && lim != 0 && "trivial splits must be handled by the caller");
+
+  // The start of every match, up to the one ending the last element. No
+  // allocation happens while the views are live.
+  std::vector<uint32_t> matches{};
+  if (r != 0) {
+    auto SStr = StringPrimitive::createStringView(runtime, S);
+    auto RStr = StringPrimitive::createStringView(runtime, R);
+    for (size_t q = 0; matches.size() < lim;) {
+      size_t i = searchStringView(SStr, RStr, q);
+      if (i == kSubstringNotFound)
+        break;
+      matches.push_back(i);
+      q = i + r;
+    }
+  }
+
+  // An empty separator splits S into its code units. Otherwise, the elements
+  // are the strings between matches, followed by the rest of S if we did not
+  // reach the limit.
+  uint32_t count =
+      r == 0 ? std::min(s, lim) : std::min<size_t>(matches.size() + 1, lim);
+  auto arrRes = JSArray::create(runtime, count, count);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto A = toHandle(runtime, std::move(*arrRes));
+  if (LLVM_UNLIKELY(
+          JSArray::setStorageEndIndex(A, runtime, count) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  GCScopeMarkerRAII gcMarker{runtime};
+  uint32_t p = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    gcMarker.flush();
+    uint32_t q = r == 0 ? i + 1 : i < matches.size() ? matches[i] : s;
+    auto strRes = StringPrimitive::slice(runtime, S, p, q - p);
+    if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    JSArray::unsafeSetExistingElementAt(*A, runtime, i, *strRes);
+    p = q + r;
+  }
+  return A.getHermesValue();
+}
+
 // TODO: implement this following ES6 21.2.5.11.
 CallResult<HermesValue> splitInternal(
     Runtime *runtime,
@@ -884,6 +1020,10 @@ CallResult<HermesValue> splitInternal(
     return A.getHermesValue();
   }
 
+  if (!vmisa<JSRegExp>(R.get())) {
+    return splitOnString(runtime, S, Handle<StringPrimitive>::vmcast(R), lim);
+  }
+
   // End of the last match.
   uint32_t p = 0;
   // Place to attempt the start of the next match.
@@ -1427,33 +1567,11 @@ stringDirectedIndexOf(Runtime *runtime, NativeArgs args, bool reverse) {
   double len = S->getStringLength();
   uint32_t start = static_cast<uint32_t>(std::min(std::max(pos, 0.), len));
 
-  // TODO: good candidate for Boyer-Moore on large needles/haystacks
-  // TODO: good candidate for memchr on length-1 needles
   auto SView = StringPrimitive::createStringView(runtime, S);
   auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
-  double ret = -1;
-  if (reverse) {
-    uint32_t lastPossibleMatchEnd =
-        std::min(SView.length(), start + searchStrView.length());
-    auto foundIter = std::search(
-        SView.rbegin() + (SView.length() - lastPossibleMatchEnd),
-        SView.rend(),
-        searchStrView.rbegin(),
-        searchStrView.rend());
-    if (foundIter != SView.rend() || searchStrView.empty()) {
-      ret = SView.rend() - foundIter - searchStrView.length();
-    }
-  } else {
-    auto foundIter = std::search(
-        SView.begin() + start,
-        SView.end(),
-        searchStrView.begin(),
-        searchStrView.end());
-    if (foundIter != SView.end() || searchStrView.empty()) {
-      ret = foundIter - SView.begin();
-    }
-  }
-  return HermesValue::encodeDoubleValue(ret);
+  size_t found = searchStringView(SView, searchStrView, start, reverse);
+  return HermesValue::encodeDoubleValue(
+      found == kSubstringNotFound ? -1 : (double)found);
 }
 
 CallResult<HermesValue>
@@ -1788,6 +1906,15 @@ stringPrototypeRepeat(void *, Runtime *runtime, NativeArgs args) {
   return builderRes->getStringPrimitive().getHermesValue();
 }
 
+/// \return whether \p replacement contains a '$', which may start one of the
+/// patterns expanded by GetSubstitution.
+static bool replacementHasDollar(
+    Runtime *runtime,
+    Handle<StringPrimitive> replacement) {
+  auto view = StringPrimitive::createStringView(runtime, replacement);
+  return std::find(view.begin(), view.end(), u'$') != view.end();
+}
+
 CallResult<HermesValue>
 stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
   // 1. Let O be RequireObjectCoercible(this value).
@@ -1862,14 +1989,11 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
   auto strView = StringPrimitive::createStringView(runtime, string);
   if (!strView.empty()) {
     auto searchView = StringPrimitive::createStringView(runtime, searchString);
-    auto searchResult = std::search(
-        strView.begin(), strView.end(), searchView.begin(), searchView.end());
-
-    if (searchResult != strView.end()) {
-      pos = searchResult - strView.begin();
-    } else {
+    size_t found = searchStringView(strView, searchView, 0);
+    if (found == kSubstringNotFound) {
       return string.getHermesValue();
     }
+    pos = found;
   } else if (searchString->getStringLength() != 0) {
     // If string is empty and search is not empty, there is no match.
     return string.getHermesValue();
@@ -1897,6 +2021,9 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
       return ExecutionStatus::EXCEPTION;
     }
     replStr = replStrRes->get();
+  } else if (!replacementHasDollar(runtime, replaceValueStr)) {
+    // Without '$' patterns, GetSubstitution would return replaceValue as is.
+    replStr = replaceValueStr.get();
   } else {
     // 12. Else,
     // a. Let captures be an empty List.
@@ -1916,13 +2043,21 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
   // units of string, replStr, and the trailing substring of string starting at
   // index tailPos. If pos is 0, the first element of the concatenation will be
   // the empty String.
-  SmallU16String<32> newString{};
-  strView.slice(0, pos).copyUTF16String(newString);
-  StringPrimitive::createStringView(runtime, replStr)
-      .copyUTF16String(newString);
-  strView.slice(tailPos).copyUTF16String(newString);
+  // The result is built in place with its exact length, as ASCII if possible.
+  uint32_t tailLength = string->getStringLength() - tailPos;
+  SafeUInt32 newLength{pos};
+  newLength.add(replStr->getStringLength());
+  newLength.add(tailLength);
+  auto builder = StringBuilder::createStringBuilder(
+      runtime, newLength, string->isASCII() && replStr->isASCII());
+  if (LLVM_UNLIKELY(builder == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  builder->appendSubstring(string, 0, pos);
+  builder->appendStringPrim(replStr);
+  builder->appendSubstring(string, tailPos, tailLength);
   // 15. Return newString.
-  return StringPrimitive::create(runtime, newString);
+  return builder->getStringPrimitive().getHermesValue();
 }
 
 CallResult<HermesValue>
@@ -2135,12 +2270,10 @@ CallResult<HermesValue> stringPrototypeIncludesOrStartsWith(
   // than searchLen, the code unit at index k+j of S is the same as the code
   // unit at index j of searchStr, return true; but if there is no such integer
   // k, return false.
-  for (double k = start; k + searchLength <= len; ++k) {
-    if (S->sliceEquals(k, searchLength, *searchStr)) {
-      return HermesValue::encodeBoolValue(true);
-    }
-  }
-  return HermesValue::encodeBoolValue(false);
+  auto SView = StringPrimitive::createStringView(runtime, S);
+  auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
+  return HermesValue::encodeBoolValue(
+      searchStringView(SView, searchStrView, start) != kSubstringNotFound);
 }
 
 CallResult<HermesValue>
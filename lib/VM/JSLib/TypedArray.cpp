@@ -17,6 +17,9 @@
 #include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringView.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace hermes {
 namespace vm {
 
@@ -264,11 +267,10 @@ CallResult<HermesValue> mapFilterLoop(
   return HermesValue::encodeNumberValue(insert);
 }
 
-/// This is the sort model for use with TypedArray.prototype.sort.
-/// template param \p WithCompareFn should be true if the compare function is
-/// a valid callback to call, and false if it is null or undefined.
-template <bool WithCompareFn>
-class TypedArraySortModel : public SortModel {
+/// This is the sort model for use with TypedArray.prototype.sort with a
+/// user-supplied compare function. Without one, the raw elements are sorted
+/// directly by sortTypedArrayElements().
+class TypedArraySortModel final : public SortModel {
  protected:
   /// Runtime to sort in.
   Runtime *runtime_;
@@ -277,7 +279,6 @@ class TypedArraySortModel : public SortModel {
   GCScope gcScope_;
 
   /// JS comparison function, return -1 for less, 0 for equal, 1 for greater.
-  /// If null, then use the built in < operator.
   Handle<Callable> compareFn_;
 
   /// Object to sort.
@@ -323,17 +324,7 @@ class TypedArraySortModel : public SortModel {
     GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
     HermesValue aVal = JSObject::getOwnIndexed(*self_, runtime_, a);
     HermesValue bVal = JSObject::getOwnIndexed(*self_, runtime_, b);
-    if (!WithCompareFn) {
-      double a = aVal.getNumber();
-      double b = bVal.getNumber();
-      if (LLVM_UNLIKELY(a == 0) && LLVM_UNLIKELY(b == 0) &&
-          LLVM_UNLIKELY(std::signbit(a)) && LLVM_UNLIKELY(!std::signbit(b))) {
-        // -0 < +0, according to the spec.
-        return true;
-      }
-      return a < b;
-    }
-    assert(compareFn_ && "Cannot use this version if the compareFn is null");
+    assert(compareFn_ && "Cannot use this model if the compareFn is null");
     // ES7 22.2.3.26 2a.
     // Let v be toNumber_RJS(Call(comparefn, undefined, x, y)).
     auto callRes = Callable::executeCall2(
@@ -354,6 +345,67 @@ class TypedArraySortModel : public SortModel {
   }
 };
 
+/// Sort the elements [first, last) of a typed array in ascending numeric
+/// order, as the default comparator of TypedArray.prototype.sort would.
+/// Equal integers are indistinguishable, so the sort need not be stable.
+template <typename T>
+void sortTypedArrayElements(T *first, T *last) {
+  if (std::is_sorted(first, last)) {
+    return;
+  }
+  std::sort(first, last);
+}
+
+/// Single byte elements are sorted by counting them.
+template <typename T>
+void countingSortBytes(T *first, T *last) {
+  static_assert(sizeof(T) == 1, "Can only count bytes");
+  uint32_t counts[256] = {};
+  for (T *it = first; it != last; ++it) {
+    ++counts[static_cast<uint8_t>(*it)];
+  }
+  // Signed values start at the bit pattern of the minimum value.
+  const unsigned start = std::is_signed<T>::value ? 0x80 : 0;
+  for (unsigned i = 0; i != 256; ++i) {
+    uint8_t byte = (start + i) & 0xff;
+    first = std::fill_n(first, counts[byte], static_cast<T>(byte));
+  }
+}
+
+template <>
+void sortTypedArrayElements(uint8_t *first, uint8_t *last) {
+  countingSortBytes(first, last);
+}
+
+template <>
+void sortTypedArrayElements(int8_t *first, int8_t *last) {
+  countingSortBytes(first, last);
+}
+
+/// Floating point elements are ordered with -0 before +0 and all NaNs last
+/// (ES7 22.2.3.26 2c-2g).
+template <typename T>
+void sortFloatingPointElements(T *first, T *last) {
+  last = std::partition(first, last, [](T x) { return !std::isnan(x); });
+  auto less = [](T x, T y) {
+    return x < y || (x == y && std::signbit(x) && !std::signbit(y));
+  };
+  if (std::is_sorted(first, last, less)) {
+    return;
+  }
+  std::sort(first, last, less);
+}
+
+template <>
+void sortTypedArrayElements(float *first, float *last) {
+  sortFloatingPointElements(first, last);
+}
+
+template <>
+void sortTypedArrayElements(double *first, double *last) {
+  sortFloatingPointElements(first, last);
+}
+
 // ES7 22.2.3.23.1
 CallResult<HermesValue> typedArrayPrototypeSetObject(
     Runtime *runtime,
@@ -1312,17 +1364,28 @@ typedArrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError("TypedArray sort argument must be callable");
   }
 
-  // Use our custom sort routine. We can't use std::sort because it performs
-  // optimizations that allow it to bypass calls to std::swap, but our swap
-  // function is special, since it needs to use the internal Object functions.
   if (compareFn) {
-    TypedArraySortModel<true> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
-  } else {
-    TypedArraySortModel<false> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
+    // Use our custom sort routine. We can't use std::sort because the compare
+    // function may observe the array while it is being sorted, or detach it.
+    TypedArraySortModel sm(runtime, self, compareFn);
+    if (LLVM_UNLIKELY(timSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
+    return self.getHermesValue();
+  }
+
+  // Without a compare function nothing can observe the sort, so the elements
+  // are sorted directly in the buffer.
+#define TYPED_ARRAY(name, type)                                              \
+  case CellKind::name##ArrayKind: {                                          \
+    auto *arr = vmcast<JSTypedArray<type, CellKind::name##ArrayKind>>(*self); \
+    sortTypedArrayElements(arr->begin(runtime), arr->end(runtime));          \
+    break;                                                                   \
+  }
+
+  switch (self->getKind()) {
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
   }
   return self.getHermesValue();
 }
@@ -112,7 +112,7 @@ void JSMapIteratorImpl<C>::MapOrSetIteratorBuildMeta(
   ObjectBuildMeta(cell, mb);
   const auto *self = static_cast<const JSMapIteratorImpl<C> *>(cell);
   mb.addField("data", &self->data_);
-  mb.addField("itr", &self->itr_);
+  mb.addField("table", &self->table_);
 }
 
 void MapIteratorBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
@@ -131,7 +131,8 @@ void serializeMapOrSetIteratorImpl(Serializer &s, const GCCell *cell) {
   auto *self = vmcast<const JSMapIteratorImpl<C>>(cell);
   JSObject::serializeObjectImpl(s, cell);
   s.writeRelocation(self->data_.get(s.getRuntime()));
-  s.writeRelocation(self->itr_.get(s.getRuntime()));
+  s.writeRelocation(self->table_.get(s.getRuntime()));
+  s.writeInt<uint32_t>(self->index_);
   s.writeInt<uint8_t>((uint8_t)self->iterationKind_);
   s.writeInt<uint8_t>(self->iterationFinished_);
 }
@@ -140,7 +141,8 @@ template <CellKind C>
 JSMapIteratorImpl<C>::JSMapIteratorImpl(Deserializer &d)
     : JSObject(d, &vt.base) {
   d.readRelocation(&data_, RelocationKind::GCPointer);
-  d.readRelocation(&itr_, RelocationKind::GCPointer);
+  d.readRelocation(&table_, RelocationKind::GCPointer);
+  index_ = d.readInt<uint32_t>();
   iterationKind_ = (IterationKind)d.readInt<uint8_t>();
   iterationFinished_ = d.readInt<uint8_t>();
 }
@@ -48,31 +48,36 @@ ObjectVTable JSObject::vt{
 namespace {
 
 /// Add \p N fields to the metadata builder \p mb starting from offset
-/// \p props and using the name "directPropX".
-template <int N>
-void addDirectPropertyFields(
-    const GCHermesValue *props,
-    Metadata::Builder &mb) {
-  // Make sure the property number fits in a single ASCII digit.
-  static_assert(N <= 10, "only up to 10 direct properties are supported");
-  static const char propName[] = {'d',
-                                  'i',
-                                  'r',
-                                  'e',
-                                  'c',
-                                  't',
-                                  'P',
-                                  'r',
-                                  'o',
-                                  'p',
-                                  (char)(N - 1 + '0'),
-                                  '\0'};
-  addDirectPropertyFields<N - 1>(props, mb);
-  mb.addField(propName, props + N - 1);
-}
-
-template <>
-void addDirectPropertyFields<0>(const GCHermesValue *, Metadata::Builder &) {}
+/// \p props and using the names "directPropX" for X in [First, First + N).
+template <int First, int N>
+struct DirectPropertyFields {
+  // Make sure the property number fits in two ASCII digits.
+  static_assert(First + N <= 100, "only up to 100 direct properties");
+
+  static void add(const GCHermesValue *props, Metadata::Builder &mb) {
+    constexpr int I = First + N - 1;
+    static const char propName[] = {'d',
+                                    'i',
+                                    'r',
+                                    'e',
+                                    'c',
+                                    't',
+                                    'P',
+                                    'r',
+                                    'o',
+                                    'p',
+                                    (char)(I < 10 ? I + '0' : I / 10 + '0'),
+                                    (char)(I < 10 ? '\0' : I % 10 + '0'),
+                                    '\0'};
+    DirectPropertyFields<First, N - 1>::add(props, mb);
+    mb.addField(propName, props + N - 1);
+  }
+};
+
+template <int First>
+struct DirectPropertyFields<First, 0> {
+  static void add(const GCHermesValue *, Metadata::Builder &) {}
+};
 
 } // anonymous namespace.
 
@@ -83,7 +88,7 @@ void ObjectBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   mb.addField("propStorage", &self->propStorage_);
 
   // Declare the direct properties.
-  addDirectPropertyFields<JSObject::DIRECT_PROPERTY_SLOTS>(
+  DirectPropertyFields<0, JSObject::DIRECT_PROPERTY_SLOTS>::add(
       self->directProps_, mb);
 }
 
@@ -102,6 +107,7 @@ void JSObject::serializeObjectImpl(Serializer &s, const GCCell *cell) {
         s, self->propStorage_.get(s.getRuntime()));
   }
 
+  s.writeInt<uint8_t>(self->instanceSlotsHint_);
   for (size_t i = 0; i < JSObject::DIRECT_PROPERTY_SLOTS; i++) {
     s.writeHermesValue(self->directProps_[i]);
   }
@@ -132,12 +138,106 @@ JSObject::JSObject(Deserializer &d, const VTable *vtp)
         &d.getRuntime()->getHeap());
   }
 
+  instanceSlotsHint_ = d.readInt<uint8_t>();
   for (size_t i = 0; i < JSObject::DIRECT_PROPERTY_SLOTS; i++) {
     d.readHermesValue(&directProps_[i]);
   }
 }
+
+template <PropStorage::size_type N, CellKind C>
+JSObjectWithSlots<N, C>::JSObjectWithSlots(Deserializer &d)
+    : JSObject(d, &vt.base) {
+  numDirectSlots_ = N;
+  for (size_t i = 0; i < N - DIRECT_PROPERTY_SLOTS; i++) {
+    d.readHermesValue(&extraProps_[i]);
+  }
+}
+
+template <PropStorage::size_type N, CellKind C>
+void JSObjectWithSlots<N, C>::serializeExtraSlots(
+    Serializer &s,
+    const GCCell *cell) {
+  auto *self = vmcast<const JSObjectWithSlots>(cell);
+  for (size_t i = 0; i < N - DIRECT_PROPERTY_SLOTS; i++) {
+    s.writeHermesValue(self->extraProps_[i]);
+  }
+}
 #endif
 
+template <PropStorage::size_type N, CellKind C>
+ObjectVTable JSObjectWithSlots<N, C>::vt{
+    VTable(
+        C,
+        sizeof(JSObjectWithSlots<N, C>),
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        VTable::HeapSnapshotMetadata{HeapSnapshot::NodeType::Object,
+                                     JSObject::_snapshotNameImpl,
+                                     JSObject::_snapshotAddEdgesImpl,
+                                     nullptr}),
+    JSObject::_getOwnIndexedRangeImpl,
+    JSObject::_haveOwnIndexedImpl,
+    JSObject::_getOwnIndexedPropertyFlagsImpl,
+    JSObject::_getOwnIndexedImpl,
+    JSObject::_setOwnIndexedImpl,
+    JSObject::_deleteOwnIndexedImpl,
+    JSObject::_checkAllOwnIndexedImpl,
+};
+
+template <PropStorage::size_type N, CellKind C>
+JSObjectWithSlots<N, C> *JSObjectWithSlots<N, C>::create(
+    Runtime *runtime,
+    JSObject *parent,
+    HiddenClass *clazz) {
+  void *mem = runtime->alloc</*fixedSize*/ true>(sizeof(JSObjectWithSlots));
+  return new (mem) JSObjectWithSlots(runtime, parent, clazz);
+}
+
+template <PropStorage::size_type N, CellKind C>
+void JSObjectWithSlots<N, C>::buildExtraSlotsMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const JSObjectWithSlots *>(cell);
+  DirectPropertyFields<DIRECT_PROPERTY_SLOTS, N - DIRECT_PROPERTY_SLOTS>::add(
+      self->extraProps_, mb);
+}
+
+#define OBJECT_SIZE_CLASS(slots) \
+  template class JSObjectWithSlots<     \
+      slots,                            \
+      CellKind::ObjectWith##slots##SlotsKind>;
+#include "hermes/VM/ObjectSizeClasses.def"
+
+#ifdef HERMESVM_SERIALIZE
+#define OBJECT_SIZE_CLASS(slots)                                            \
+  void ObjectWith##slots##SlotsBuildMeta(                                   \
+      const GCCell *cell, Metadata::Builder &mb) {                          \
+    ObjectBuildMeta(cell, mb);                                              \
+    JSObjectWith##slots##Slots::buildExtraSlotsMeta(cell, mb);              \
+  }                                                                         \
+  void ObjectWith##slots##SlotsSerialize(Serializer &s, const GCCell *cell) { \
+    JSObject::serializeObjectImpl(s, cell);                                 \
+    JSObjectWith##slots##Slots::serializeExtraSlots(s, cell);               \
+    s.endObject(cell);                                                      \
+  }                                                                         \
+  void ObjectWith##slots##SlotsDeserialize(Deserializer &d, CellKind kind) { \
+    void *mem = d.getRuntime()->alloc</*fixedSize*/ true>(                  \
+        sizeof(JSObjectWith##slots##Slots));                                \
+    d.endObject(new (mem) JSObjectWith##slots##Slots(d));                   \
+  }
+#else
+#define OBJECT_SIZE_CLASS(slots)                                \
+  void ObjectWith##slots##SlotsBuildMeta(                       \
+      const GCCell *cell, Metadata::Builder &mb) {              \
+    ObjectBuildMeta(cell, mb);                                  \
+    JSObjectWith##slots##Slots::buildExtraSlotsMeta(cell, mb);  \
+  }
+#endif // HERMESVM_SERIALIZE
+#include "hermes/VM/ObjectSizeClasses.def"
+
 PseudoHandle<JSObject> JSObject::create(
     Runtime *runtime,
     Handle<JSObject> parentHandle) {
@@ -150,6 +250,17 @@ PseudoHandle<JSObject> JSObject::create(
       GCPointerBase::NoBarriers()));
 }
 
+PseudoHandle<JSObject> JSObject::create(
+    Runtime *runtime,
+    Handle<JSObject> parentHandle,
+    PropStorage::size_type directSlots) {
+  return createPseudoHandle(allocatePlainObject(
+      runtime,
+      *parentHandle,
+      runtime->getHiddenClassForPrototypeRaw(*parentHandle),
+      directSlots));
+}
+
 PseudoHandle<JSObject> JSObject::create(Runtime *runtime) {
   void *mem = runtime->alloc</*fixedSize*/ true>(sizeof(JSObject));
   JSObject *objProto = runtime->objectPrototypeRawPtr;
@@ -164,15 +275,13 @@ PseudoHandle<JSObject> JSObject::create(Runtime *runtime) {
 PseudoHandle<JSObject> JSObject::create(
     Runtime *runtime,
     unsigned propertyCount) {
-  void *mem = runtime->alloc</*fixedSize*/ true>(sizeof(JSObject));
   JSObject *objProto = runtime->objectPrototypeRawPtr;
   return runtime->ignoreAllocationFailure(JSObject::allocatePropStorage(
-      createPseudoHandle(new (mem) JSObject(
+      createPseudoHandle(allocatePlainObject(
           runtime,
-          &vt.base,
           objProto,
           runtime->getHiddenClassForPrototypeRaw(objProto),
-          GCPointerBase::NoBarriers())),
+          propertyCount)),
       runtime,
       propertyCount));
 }
@@ -189,6 +298,27 @@ PseudoHandle<JSObject> JSObject::create(
   return obj;
 }
 
+JSObject *JSObject::allocatePlainObject(
+    Runtime *runtime,
+    JSObject *parent,
+    HiddenClass *clazz,
+    PropStorage::size_type directSlots) {
+  if (LLVM_LIKELY(directSlots <= DIRECT_PROPERTY_SLOTS)) {
+    void *mem = runtime->alloc</*fixedSize*/ true>(sizeof(JSObject));
+    return new (mem)
+        JSObject(runtime, &vt.base, parent, clazz, GCPointerBase::NoBarriers());
+  }
+  // Objects with even more properties use the largest size class and keep the
+  // rest in the property storage.
+  if (directSlots > MAX_DIRECT_PROPERTY_SLOTS)
+    directSlots = MAX_DIRECT_PROPERTY_SLOTS;
+#define OBJECT_SIZE_CLASS(slots) \
+  if (directSlots <= slots)      \
+    return JSObjectWith##slots##Slots::create(runtime, parent, clazz);
+#include "hermes/VM/ObjectSizeClasses.def"
+  llvm_unreachable("MAX_DIRECT_PROPERTY_SLOTS must be the largest size class");
+}
+
 CallResult<HermesValue> JSObject::createWithException(
     Runtime *runtime,
     Handle<JSObject> parentHandle) {
@@ -246,14 +376,33 @@ void JSObject::allocateNewSlotStorage(
     SlotIndex newSlotIndex,
     Handle<> valueHandle) {
   // If it is a direct property, just store the value and we are done.
-  if (LLVM_LIKELY(newSlotIndex < DIRECT_PROPERTY_SLOTS)) {
-    selfHandle->directProps_[newSlotIndex].set(
+  const PropStorage::size_type numDirect = selfHandle->numDirectSlots_;
+  if (LLVM_LIKELY(newSlotIndex < numDirect)) {
+    selfHandle->directSlotRef(newSlotIndex).set(
         *valueHandle, &runtime->getHeap());
     return;
   }
 
+  // The object has outgrown its direct slots. If it is a plain object with a
+  // prototype, remember how many slots it needs so that its siblings created
+  // by the same constructor can be allocated with enough of them.
+  if (numDirect < MAX_DIRECT_PROPERTY_SLOTS &&
+      kindInRange(
+          selfHandle->getKind(),
+          CellKind::PlainObjectKind_first,
+          CellKind::PlainObjectKind_last) &&
+      !selfHandle->clazz_.get(runtime)->isDictionary()) {
+    if (JSObject *parent = selfHandle->parent_.get(runtime)) {
+      if (newSlotIndex >= parent->instanceSlotsHint_) {
+        parent->instanceSlotsHint_ = newSlotIndex < MAX_DIRECT_PROPERTY_SLOTS
+            ? newSlotIndex + 1
+            : MAX_DIRECT_PROPERTY_SLOTS;
+      }
+    }
+  }
+
   // Make the slot index relative to the indirect storage.
-  newSlotIndex -= DIRECT_PROPERTY_SLOTS;
+  newSlotIndex -= numDirect;
 
   // Allocate a new property storage if not already allocated.
   if (LLVM_UNLIKELY(!selfHandle->propStorage_)) {
@@ -333,7 +482,7 @@ void JSObject::addInternalProperties(
       selfHandle->clazz_.get(runtime)->getNumProperties() == 0 &&
       "Internal properties must be added first");
   assert(
-      count <= DIRECT_PROPERTY_SLOTS &&
+      count <= selfHandle->numDirectSlots_ &&
       "We shouldn't add internal properties to indirect storage");
 
   for (unsigned i = 0; i != count; ++i) {
@@ -1894,7 +2043,13 @@ std::string JSObject::getHeuristicTypeName(GC *gc) {
     }
   }
 
-  std::string name = cellKindStr(getKind());
+  // Plain objects are named the same regardless of their size class.
+  const bool isPlainObject = kindInRange(
+      getKind(),
+      CellKind::PlainObjectKind_first,
+      CellKind::PlainObjectKind_last);
+  std::string name =
+      cellKindStr(isPlainObject ? CellKind::ObjectKind : getKind());
   // A constructor's name was not found, check if the object is in dictionary
   // mode.
   if (getClass(base)->isDictionary()) {
@@ -1902,7 +2057,7 @@ std::string JSObject::getHeuristicTypeName(GC *gc) {
   }
 
   // If it's not an Object, the CellKind is most likely good enough on its own
-  if (getKind() != CellKind::ObjectKind) {
+  if (!isPlainObject) {
     return name;
   }
 
@@ -54,10 +54,17 @@ void RegExpBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
 #ifdef HERMESVM_SERIALIZE
 JSRegExp::JSRegExp(Deserializer &d) : JSObject(d, &vt.base) {
   size_t size = d.readInt<size_t>();
-  bytecode_ = d.readArrayRef<uint8_t>(size);
-  // bytecode_.begin() is tracked by IDTracker for heapsnapshot. We should do
+  uint8_t *data = nullptr;
+  if (size) {
+    auto stored = d.readArrayRef<uint8_t>(size);
+    auto bytecode =
+        std::make_shared<std::vector<uint8_t>>(stored.begin(), stored.end());
+    data = bytecode->data();
+    bytecode_ = std::move(bytecode);
+  }
+  // bytecode_->data() is tracked by IDTracker for heapsnapshot. We should do
   // relocation for it.
-  d.endObject(bytecode_.begin());
+  d.endObject(data);
 
   d.readData(&flagBits_, sizeof(flagBits_));
 }
@@ -65,11 +72,17 @@ JSRegExp::JSRegExp(Deserializer &d) : JSObject(d, &vt.base) {
 void RegExpSerialize(Serializer &s, const GCCell *cell) {
   auto *self = vmcast<const JSRegExp>(cell);
   JSObject::serializeObjectImpl(s, cell);
-  s.writeInt<size_t>(self->bytecode_.size());
-  s.writeData(self->bytecode_.begin(), self->bytecode_.size());
-  // bytecode_.begin() is tracked by IDTracker for heapsnapshot. We should do
+  const uint8_t *bytecode = nullptr;
+  size_t size = 0;
+  if (self->bytecode_) {
+    bytecode = self->bytecode_->data();
+    size = self->bytecode_->size();
+  }
+  s.writeInt<size_t>(size);
+  s.writeData(bytecode, size);
+  // bytecode_->data() is tracked by IDTracker for heapsnapshot. We should do
   // relocation for it.
-  s.endObject(self->bytecode_.begin());
+  s.endObject(bytecode);
 
   s.writeData(&self->flagBits_, sizeof(self->flagBits_));
 
@@ -151,8 +164,11 @@ ExecutionStatus JSRegExp::initialize(
       res != ExecutionStatus::EXCEPTION && *res &&
       "defineOwnProperty() failed");
 
+  selfHandle->searchCount_ = 0;
+  selfHandle->nativeMatcher_ = nullptr;
   if (bytecode) {
-    selfHandle->bytecode_ = *bytecode;
+    selfHandle->bytecode_ = std::make_shared<std::vector<uint8_t>>(
+        bytecode->begin(), bytecode->end());
   } else {
     regex::constants::SyntaxFlags nativeFlags = {};
     if (fbits->ignoreCase)
@@ -166,6 +182,13 @@ ExecutionStatus JSRegExp::initialize(
     llvm::SmallVector<char16_t, 16> patternText16;
     patternText.copyUTF16String(patternText16);
 
+    // Reuse the bytecode of a previous RegExp with the same source.
+    RegExpCache &cache = runtime->getRegExpCache();
+    if (auto cached = cache.lookup(patternText16, nativeFlags)) {
+      selfHandle->bytecode_ = std::move(cached);
+      return ExecutionStatus::RETURNED;
+    }
+
     // Build the regex.
     regex::Regex<regex::UTF16RegexTraits> regex(
         patternText16.begin(), patternText16.end(), nativeFlags);
@@ -177,7 +200,9 @@ ExecutionStatus JSRegExp::initialize(
       return ExecutionStatus::EXCEPTION;
     }
     // The regex is valid. Compile and store its bytecode.
-    selfHandle->bytecode_ = llvm::makeArrayRef(regex.compile());
+    selfHandle->bytecode_ =
+        std::make_shared<std::vector<uint8_t>>(regex.compile());
+    cache.insert(patternText16, nativeFlags, selfHandle->bytecode_);
   }
 
   return ExecutionStatus::RETURNED;
@@ -233,18 +258,28 @@ template <typename CharT, typename Traits>
 CallResult<RegExpMatch> performSearch(
     Runtime *runtime,
     llvm::ArrayRef<uint8_t> bytecode,
+    const regex::NativeMatcher *nativeMatcher,
     const CharT *start,
     uint32_t stringLength,
     uint32_t searchStartOffset,
     regex::constants::MatchFlagType matchFlags) {
   std::vector<regex::CapturedRange> nativeMatchRanges;
-  auto matchResult = regex::searchWithBytecode(
-      bytecode,
-      start,
-      searchStartOffset,
-      stringLength,
-      &nativeMatchRanges,
-      matchFlags);
+  auto matchResult = nativeMatcher
+      ? regex::searchWithNativeMatcher(
+            bytecode,
+            *nativeMatcher,
+            start,
+            searchStartOffset,
+            stringLength,
+            &nativeMatchRanges,
+            matchFlags)
+      : regex::searchWithBytecode(
+            bytecode,
+            start,
+            searchStartOffset,
+            stringLength,
+            &nativeMatchRanges,
+            matchFlags);
   if (matchResult == regex::MatchRuntimeResult::StackOverflow) {
     runtime->raiseRangeError("Maximum regex stack depth reached");
     return ExecutionStatus::EXCEPTION;
@@ -275,7 +310,7 @@ CallResult<RegExpMatch> JSRegExp::search(
     Runtime *runtime,
     Handle<StringPrimitive> strHandle,
     uint32_t searchStartOffset) {
-  assert(!selfHandle->bytecode_.empty() && "Missing bytecode");
+  assert(selfHandle->bytecode_ && "Missing bytecode");
   auto input = StringPrimitive::createStringView(runtime, strHandle);
 
   // Note we may still have a match if searchStartOffset == str.size(),
@@ -292,12 +327,21 @@ CallResult<RegExpMatch> JSRegExp::search(
     matchFlags |= regex::constants::matchOnlyAtStart;
   }
 
+  // Compile regexes which are searched often to native code. Regexes which
+  // cannot be compiled keep using the interpreter.
+  auto &jit = runtime->getJITContext();
+  if (jit.isEnabled() && !selfHandle->nativeMatcher_ &&
+      ++selfHandle->searchCount_ == JITContext::REGEX_COMPILE_THRESHOLD) {
+    selfHandle->nativeMatcher_ = jit.compileRegex(*selfHandle->bytecode_);
+  }
+
   CallResult<RegExpMatch> matchResult = RegExpMatch{};
   if (input.isASCII()) {
     matchFlags |= regex::constants::matchInputAllAscii;
     matchResult = performSearch<char, regex::ASCIIRegexTraits>(
         runtime,
-        selfHandle->bytecode_,
+        *selfHandle->bytecode_,
+        selfHandle->nativeMatcher_,
         input.castToCharPtr(),
         input.length(),
         searchStartOffset,
@@ -305,7 +349,8 @@ CallResult<RegExpMatch> JSRegExp::search(
   } else {
     matchResult = performSearch<char16_t, regex::UTF16RegexTraits>(
         runtime,
-        selfHandle->bytecode_,
+        *selfHandle->bytecode_,
+        selfHandle->nativeMatcher_,
         input.castToChar16Ptr(),
         input.length(),
         searchStartOffset,
@@ -330,7 +375,7 @@ void JSRegExp::_finalizeImpl(GCCell *cell, GC *) {
 
 size_t JSRegExp::_mallocSizeImpl(GCCell *cell) {
   auto *self = vmcast<JSRegExp>(cell);
-  return self->bytecode_.capacity_in_bytes();
+  return self->ownsBytecode() ? self->bytecode_->capacity() : 0;
 }
 
 std::string JSRegExp::_snapshotNameImpl(GCCell *cell, GC *gc) {
@@ -342,26 +387,25 @@ void JSRegExp::_snapshotAddEdgesImpl(GCCell *cell, GC *gc, HeapSnapshot &snap) {
   auto *const self = vmcast<JSRegExp>(cell);
   // Call the super type to add any other custom edges.
   JSObject::_snapshotAddEdgesImpl(self, gc, snap);
-  if (!self->bytecode_.empty()) {
+  if (self->ownsBytecode()) {
     snap.addNamedEdge(
         HeapSnapshot::EdgeType::Internal,
         "bytecode",
-        gc->getNativeID(self->bytecode_.begin()));
+        gc->getNativeID(self->bytecode_->data()));
   }
 }
 
 void JSRegExp::_snapshotAddNodesImpl(GCCell *cell, GC *gc, HeapSnapshot &snap) {
   auto *const self = vmcast<JSRegExp>(cell);
-  if (!self->bytecode_.empty()) {
+  if (self->ownsBytecode()) {
     // Add a native node for regex bytecode, to account for native size directly
     // owned by the regex.
     snap.beginNode();
     snap.endNode(
         HeapSnapshot::NodeType::Native,
         "RegExpBytecode",
-        // begin is the internal pointer stored by CopyableVector.
-        gc->getNativeID(self->bytecode_.begin()),
-        self->bytecode_.capacity() * sizeof(uint8_t));
+        gc->getNativeID(self->bytecode_->data()),
+        self->bytecode_->capacity() * sizeof(uint8_t));
   }
 }
 
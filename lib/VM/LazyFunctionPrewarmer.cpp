@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMESVM_LEAN
+
+#include "hermes/VM/LazyFunctionPrewarmer.h"
+
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/IRGen/IRGen.h"
+#include "hermes/VM/CodeBlock.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+LazyFunctionPrewarmer::LazyFunctionPrewarmer(size_t maxUntaken)
+    : maxUntaken_(maxUntaken), thread_([this]() { run(); }) {}
+
+LazyFunctionPrewarmer::~LazyFunctionPrewarmer() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_ = true;
+  }
+  cond_.notify_all();
+  thread_.join();
+}
+
+void LazyFunctionPrewarmer::enqueue(
+    const std::shared_ptr<CompiledModule> &module) {
+  auto *provider = module->getBytecode();
+  std::vector<Item> items;
+  for (uint32_t i = 0, e = provider->getFunctionCount(); i < e; ++i) {
+    // Another runtime sharing the module may have compiled the function.
+    if (!provider->isFunctionLazy(i) || module->isLazyFunctionCompiled(i))
+      continue;
+    // Only providers compiled from source contain lazy functions.
+    auto *bcModule =
+        static_cast<hbc::BCProviderFromSrc *>(provider)->getBytecodeModule();
+    items.push_back(Item{module, i, &bcModule->getFunction(i)});
+  }
+  if (items.empty())
+    return;
+
+  // Functions which appear earlier in the source tend to be called earlier.
+  std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+    return a.func->getLazyCompilationData()->span.Start.getPointer() <
+        b.func->getLazyCompilationData()->span.Start.getPointer();
+  });
+
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (auto &item : items) {
+      if (pending_.insert(item.func).second)
+        queue_.push_back(std::move(item));
+    }
+  }
+  cond_.notify_all();
+}
+
+std::unique_ptr<hbc::BytecodeModule> LazyFunctionPrewarmer::compile(
+    hbc::BytecodeFunction *func) {
+  if (auto module = take(func)) {
+    ++numPrewarmed_;
+    return module;
+  }
+  return compileLazyFunction(func->getLazyCompilationData());
+}
+
+void LazyFunctionPrewarmer::discard(hbc::BytecodeFunction *func) {
+  take(func);
+}
+
+std::unique_ptr<hbc::BytecodeModule> LazyFunctionPrewarmer::take(
+    hbc::BytecodeFunction *func) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  // Don't compile the function in the background anymore if it hasn't been
+  // started yet.
+  pending_.erase(func);
+  cond_.wait(lock, [this, func]() { return inProgress_ != func; });
+  auto it = compiled_.find(func);
+  if (it == compiled_.end())
+    return nullptr;
+  auto module = std::move(it->second.module);
+  compiled_.erase(it);
+  // The background thread may be waiting for room in compiled_.
+  cond_.notify_all();
+  return module;
+}
+
+void LazyFunctionPrewarmer::waitUntilIdle() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  cond_.wait(lock, [this]() { return stop_ || isIdle(); });
+}
+
+void LazyFunctionPrewarmer::run() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  for (;;) {
+    if (isIdle())
+      cond_.notify_all();
+    cond_.wait(lock, [this]() { return stop_ || !isIdle(); });
+    if (stop_)
+      return;
+
+    Item item = std::move(queue_.front());
+    queue_.pop_front();
+    // The function may have been compiled by its first call in the meantime,
+    // in this runtime or in another one sharing the module.
+    if (!pending_.count(item.func))
+      continue;
+    checking_ = true;
+    lock.unlock();
+    bool compiled = item.parent->isLazyFunctionCompiled(item.functionID);
+    lock.lock();
+    checking_ = false;
+    if (!pending_.erase(item.func) || compiled)
+      continue;
+
+    inProgress_ = item.func;
+    lock.unlock();
+    auto module = compileLazyFunction(item.func->getLazyCompilationData());
+    lock.lock();
+    compiled_[item.func] =
+        Compiled{std::move(item.parent), std::move(module)};
+    inProgress_ = nullptr;
+    cond_.notify_all();
+  }
+}
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMESVM_LEAN
@@ -297,33 +297,11 @@ bool toBoolean(HermesValue value) {
 }
 
 /// ES5.1 9.8.1
-static CallResult<PseudoHandle<StringPrimitive>> numberToString(
-    Runtime *runtime,
-    double m) LLVM_NO_SANITIZE("float-cast-overflow");
-
 static CallResult<PseudoHandle<StringPrimitive>> numberToString(
     Runtime *runtime,
     double m) {
   char buf8[hermes::NUMBER_TO_STRING_BUF_SIZE];
 
-  // Optimization: Fast-case for positive integers < 2^31
-  int32_t n = static_cast<int32_t>(m);
-  if (m == static_cast<double>(n) && n > 0) {
-    // Write base 10 digits in reverse from end of buf8.
-    char *p = buf8 + sizeof(buf8);
-    do {
-      *--p = '0' + (n % 10);
-      n /= 10;
-    } while (n);
-    size_t len = buf8 + sizeof(buf8) - p;
-    // Temporarily stop the propagation of removing.
-    auto result = StringPrimitive::create(runtime, ASCIIRef(p, len));
-    if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    return createPseudoHandle(vmcast<StringPrimitive>(*result));
-  }
-
   auto getPredefined = [runtime](Predefined::Str predefinedID) {
     return createPseudoHandle(runtime->getPredefinedString(predefinedID));
   };
@@ -337,8 +315,12 @@ static CallResult<PseudoHandle<StringPrimitive>> numberToString(
   if (m == -std::numeric_limits<double>::infinity())
     return getPredefined(Predefined::NegativeInfinity);
 
-  // After special cases, run the generic routine to convert.
+  // After special cases, run the generic routine to convert. It has fast
+  // paths for integers and for the shortest representation of most numbers.
   size_t len = hermes::numberToString(m, buf8, sizeof(buf8));
+  if (len == 1) {
+    return createPseudoHandle(runtime->getCharacterString(buf8[0]).get());
+  }
 
   auto result = StringPrimitive::create(runtime, ASCIIRef(buf8, len));
   if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
@@ -437,6 +419,17 @@ static inline double stringToNumber(
   // Trim the string.
   StringView str16 = orig.slice(begin, end);
 
+  // Most numeric strings are plain decimals, which can usually be converted
+  // without copying them.
+  auto fast = str16.isASCII()
+      ? parseDecimalFast(
+            str16.castToCharPtr(), str16.castToCharPtr() + str16.length())
+      : parseDecimalFast(
+            str16.castToChar16Ptr(), str16.castToChar16Ptr() + str16.length());
+  if (fast) {
+    return *fast;
+  }
+
   // Slow check for special values.
   // This should only run if user created a string with extra whitespace,
   // since normal uses would get caught by the initial check.
@@ -10,6 +10,7 @@
 #include "hermes/Support/ErrorHandling.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/HermesValue-inline.h"
 #include "hermes/VM/Operations.h"
 
 #include "llvm/Support/Debug.h"
@@ -17,53 +18,6 @@
 
 namespace hermes {
 namespace vm {
-//===----------------------------------------------------------------------===//
-// class HashMapEntry
-
-VTable HashMapEntry::vt{CellKind::HashMapEntryKind, sizeof(HashMapEntry)};
-
-void HashMapEntryBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
-  const auto *self = static_cast<const HashMapEntry *>(cell);
-  mb.addField("key", &self->key);
-  mb.addField("value", &self->value);
-  mb.addField("prevIterationEntry", &self->prevIterationEntry);
-  mb.addField("nextIterationEntry", &self->nextIterationEntry);
-  mb.addField("nextEntryInBucket", &self->nextEntryInBucket);
-}
-
-#ifdef HERMESVM_SERIALIZE
-HashMapEntry::HashMapEntry(Deserializer &d)
-    : GCCell(&d.getRuntime()->getHeap(), &vt) {
-  d.readHermesValue(&key);
-  d.readHermesValue(&value);
-  d.readRelocation(&prevIterationEntry, RelocationKind::GCPointer);
-  d.readRelocation(&nextIterationEntry, RelocationKind::GCPointer);
-  d.readRelocation(&nextEntryInBucket, RelocationKind::GCPointer);
-}
-
-void HashMapEntrySerialize(Serializer &s, const GCCell *cell) {
-  auto *self = vmcast<const HashMapEntry>(cell);
-  s.writeHermesValue(self->key);
-  s.writeHermesValue(self->value);
-  s.writeRelocation(self->prevIterationEntry.get(s.getRuntime()));
-  s.writeRelocation(self->nextIterationEntry.get(s.getRuntime()));
-  s.writeRelocation(self->nextEntryInBucket.get(s.getRuntime()));
-  s.endObject(cell);
-}
-
-void HashMapEntryDeserialize(Deserializer &d, CellKind kind) {
-  assert(kind == CellKind::HashMapEntryKind && "Expected HashMapEntry");
-  void *mem = d.getRuntime()->alloc(sizeof(HashMapEntry));
-  auto *cell = new (mem) HashMapEntry(d);
-  d.endObject(cell);
-}
-#endif
-
-CallResult<HermesValue> HashMapEntry::create(Runtime *runtime) {
-  void *mem = runtime->alloc(sizeof(HashMapEntry));
-  return HermesValue::encodeObjectValue(new (mem) HashMapEntry(runtime));
-}
-
 //===----------------------------------------------------------------------===//
 // class OrderedHashMap
 
@@ -71,41 +25,23 @@ VTable OrderedHashMap::vt{CellKind::OrderedHashMapKind, sizeof(OrderedHashMap)};
 
 void OrderedHashMapBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   const auto *self = static_cast<const OrderedHashMap *>(cell);
-  mb.addField("hashTable", &self->hashTable_);
-  mb.addField("firstIterationEntry", &self->firstIterationEntry_);
-  mb.addField("lastIterationEntry", &self->lastIterationEntry_);
+  mb.addField("table", &self->table_);
 }
 
 #ifdef HERMESVM_SERIALIZE
 OrderedHashMap::OrderedHashMap(Deserializer &d)
     : GCCell(&d.getRuntime()->getHeap(), &vt) {
-  if (d.readInt<uint8_t>()) {
-    hashTable_.set(
-        d.getRuntime(),
-        ArrayStorage::deserializeArrayStorage(d),
-        &d.getRuntime()->getHeap());
-  }
-
-  d.readRelocation(&firstIterationEntry_, RelocationKind::GCPointer);
-  d.readRelocation(&lastIterationEntry_, RelocationKind::GCPointer);
-  capacity_ = d.readInt<uint32_t>();
+  d.readRelocation(&table_, RelocationKind::GCPointer);
+  numBuckets_ = d.readInt<uint32_t>();
+  numUsed_ = d.readInt<uint32_t>();
   size_ = d.readInt<uint32_t>();
 }
 
 void OrderedHashMapSerialize(Serializer &s, const GCCell *cell) {
   auto *self = vmcast<const OrderedHashMap>(cell);
-  // If we have an ArrayStorage, it doesn't store any native pointers. Serialize
-  // it here.
-  bool hasArray = (bool)self->hashTable_;
-  s.writeInt<uint8_t>(hasArray);
-  if (hasArray) {
-    ArrayStorage::serializeArrayStorage(
-        s, self->hashTable_.get(s.getRuntime()));
-  }
-
-  s.writeRelocation(self->firstIterationEntry_.get(s.getRuntime()));
-  s.writeRelocation(self->lastIterationEntry_.get(s.getRuntime()));
-  s.writeInt<uint32_t>(self->capacity_);
+  s.writeRelocation(self->table_.get(s.getRuntime()));
+  s.writeInt<uint32_t>(self->numBuckets_);
+  s.writeInt<uint32_t>(self->numUsed_);
   s.writeInt<uint32_t>(self->size_);
 
   s.endObject(cell);
@@ -120,166 +56,170 @@ void OrderedHashMapDeserialize(Deserializer &d, CellKind kind) {
 }
 #endif
 
-OrderedHashMap::OrderedHashMap(
-    Runtime *runtime,
-    Handle<ArrayStorage> hashTableStorage)
+OrderedHashMap::OrderedHashMap(Runtime *runtime, Handle<SegmentedArray> table)
     : GCCell(&runtime->getHeap(), &vt),
-      hashTable_(runtime, hashTableStorage.get(), &runtime->getHeap()) {}
+      table_(runtime, table.get(), &runtime->getHeap()) {}
 
 CallResult<HermesValue> OrderedHashMap::create(Runtime *runtime) {
-  auto arrRes =
-      ArrayStorage::create(runtime, INITIAL_CAPACITY, INITIAL_CAPACITY);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+  auto tableRes = createTable(runtime, INITIAL_NUM_BUCKETS);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto hashTableStorage = runtime->makeHandle<ArrayStorage>(*arrRes);
+  auto table = runtime->makeHandle<SegmentedArray>(*tableRes);
 
   void *mem = runtime->alloc(sizeof(OrderedHashMap));
   return HermesValue::encodeObjectValue(
-      new (mem) OrderedHashMap(runtime, hashTableStorage));
+      new (mem) OrderedHashMap(runtime, table));
 }
 
-void OrderedHashMap::removeLinkedListNode(
+CallResult<HermesValue> OrderedHashMap::createTable(
     Runtime *runtime,
-    HashMapEntry *entry,
-    GC *gc) {
+    uint32_t numBuckets) {
   assert(
-      entry != lastIterationEntry_.get(runtime) &&
-      "Cannot remove the last entry");
-  if (entry->prevIterationEntry) {
-    entry->prevIterationEntry.get(runtime)->nextIterationEntry.set(
-        runtime, entry->nextIterationEntry, gc);
+      (numBuckets & (numBuckets - 1)) == 0 &&
+      "numBuckets must be power of 2");
+  uint64_t size = tableSize(numBuckets);
+  if (LLVM_UNLIKELY(size > SegmentedArray::maxElements())) {
+    return runtime->raiseRangeError("Map/Set size exceeds the maximum");
   }
-  if (entry->nextIterationEntry) {
-    entry->nextIterationEntry.get(runtime)->prevIterationEntry.set(
-        runtime, entry->prevIterationEntry, gc);
-  }
-  if (entry == firstIterationEntry_.get(runtime)) {
-    firstIterationEntry_.set(runtime, entry->nextIterationEntry, gc);
+  // All the buckets, entries and the rest of the header start out empty.
+  auto arrRes = SegmentedArray::create(runtime, size, size);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
   }
-  entry->prevIterationEntry = nullptr;
+  auto *table = vmcast<SegmentedArray>(*arrRes);
+  table->at(kNumBucketsSlot).setNonPtr(
+      HermesValue::encodeNumberValue(numBuckets));
+  table->at(kNumUsedSlot).setNonPtr(HermesValue::encodeNumberValue(0));
+  return *arrRes;
 }
 
-HashMapEntry *OrderedHashMap::lookupInBucket(
-    Runtime *runtime,
-    uint32_t bucket,
-    HermesValue key) {
-  assert(
-      hashTable_.get(runtime)->size() == capacity_ && "Inconsistent capacity");
-  auto *entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key)) {
-    entry = entry->nextEntryInBucket.get(runtime);
+OptValue<uint32_t>
+OrderedHashMap::lookup(Runtime *runtime, uint64_t hash, HermesValue key) {
+  SegmentedArray *table = table_.get(runtime);
+  HermesValue head = table->at(kHeaderSize + hashToBucket(hash));
+  if (head.isEmpty()) {
+    return llvm::None;
+  }
+  for (uint32_t index = head.getNumberAs<uint32_t>();;) {
+    uint32_t slot = entrySlot(index);
+    // Deleted entries have an empty key, which never matches.
+    if (isSameValueZero(table->at(slot + kKeyOffset), key)) {
+      return index;
+    }
+    HermesValue next = table->at(slot + kChainOffset);
+    if (next.isEmpty()) {
+      return llvm::None;
+    }
+    index = next.getNumberAs<uint32_t>();
   }
-  return entry;
 }
 
-ExecutionStatus OrderedHashMap::rehashIfNecessary(
+ExecutionStatus OrderedHashMap::rehash(
     Handle<OrderedHashMap> self,
-    Runtime *runtime) {
-  uint32_t newCapacity = self->capacity_;
-  // NOTE: we have ensured that self->capacity_ * 4 never overflows uint32_t by
-  // setting MAX_CAPACITY to the apropriate value. self->size_ is always <=
-  // self->capacity_, so this applies to self->size_ as well.
-  static_assert(
-      MAX_CAPACITY < UINT32_MAX / 4,
-      "Avoid overflow checks on multiplying capacity by 4");
-  if (self->size_ * 4 > self->capacity_ * 3) {
-    // Load factor is more than 0.75, need to increase the capacity.
-    newCapacity = self->capacity_ * 2;
-    if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
-      // We maintain the invariant that the capacity_ is a power of two.
-      // Therefore, if doubling would exceed the max, we revert to the
-      // previous value.  (Assert the invariant to make it clear.)
-      assert(
-          (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-          "capacity_ must be power of 2");
-      newCapacity = self->capacity_;
-    }
-  } else if (
-      self->size_ * 4 < self->capacity_ && self->capacity_ > INITIAL_CAPACITY) {
-    // Load factor is less than 0.25, and we are not at initial cap.
-    newCapacity = self->capacity_ / 2;
-  }
-  if (newCapacity == self->capacity_) {
-    // No need to rehash.
-    return ExecutionStatus::RETURNED;
-  }
+    Runtime *runtime,
+    uint32_t numBuckets) {
   assert(
-      self->size_ && self->firstIterationEntry_ && self->lastIterationEntry_ &&
-      "We should never be rehashing when there are no elements");
-
-  // Set new capacity first to update the hash function.
-  self->capacity_ = newCapacity;
-
-  // Create a new hash table.
-  auto arrRes = ArrayStorage::create(runtime, newCapacity, newCapacity);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      numBuckets * kLoadFactor >= self->size_ &&
+      "New table too small for the live entries");
+  auto tableRes = createTable(runtime, numBuckets);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto newHashTable = runtime->makeHandle<ArrayStorage>(*arrRes);
-
-  // Now re-add all entries to the hash table.
-  MutableHandle<HashMapEntry> entry{runtime};
-  MutableHandle<HashMapEntry> oldNextInBucket{runtime};
+  auto newTable = runtime->makeHandle<SegmentedArray>(*tableRes);
+  auto oldTable = runtime->makeHandle(self->table_.get(runtime));
+  const uint32_t oldNumBuckets = self->numBuckets_;
+  const uint32_t oldNumUsed = self->numUsed_;
+
+  // Copy the live entries in order, and record the indices of the deleted
+  // ones for the iterators still pointing into the old table. The indices are
+  // written over the old buckets and entries, starting right after the
+  // header; since there are never more deleted entries than entries visited
+  // so far, this only overwrites entries which have already been copied.
   MutableHandle<> keyHandle{runtime};
   GCScopeMarkerRAII marker{runtime};
-  for (unsigned i = 0, len = self->hashTable_.get(runtime)->size(); i < len;
-       ++i) {
-    entry = dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(i));
-    while (entry) {
-      marker.flush();
-      keyHandle = entry->key;
-      uint32_t bucket = hashToBucket(self, runtime, keyHandle);
-      oldNextInBucket = entry->nextEntryInBucket.get(runtime);
-      if (newHashTable->at(bucket).isEmpty()) {
-        // Empty bucket.
-        entry->nextEntryInBucket = nullptr;
-      } else {
-        // There are already a bucket head.
-        entry->nextEntryInBucket.set(
-            runtime,
-            vmcast<HashMapEntry>(newHashTable->at(bucket)),
-            &runtime->getHeap());
-      }
-      // Update bucket head to the new entry.
-      newHashTable->at(bucket).set(entry.getHermesValue(), &runtime->getHeap());
-
-      entry = *oldNextInBucket;
+  uint32_t newIndex = 0;
+  uint32_t numRemoved = 0;
+  for (uint32_t i = 0; i < oldNumUsed; ++i) {
+    marker.flush();
+    const uint32_t oldSlot = kHeaderSize + oldNumBuckets + i * kEntrySize;
+    if (oldTable->at(oldSlot + kKeyOffset).isEmpty()) {
+      oldTable->at(kHeaderSize + numRemoved++)
+          .setNonPtr(HermesValue::encodeNumberValue(i));
+      continue;
     }
+    keyHandle = oldTable->at(oldSlot + kKeyOffset);
+    uint64_t hash = runtime->gcStableHashHermesValue(keyHandle);
+    const uint32_t newSlot = kHeaderSize + numBuckets + newIndex * kEntrySize;
+    GCHermesValue &bucket =
+        newTable->at(kHeaderSize + (hash & (numBuckets - 1)));
+    newTable->at(newSlot + kKeyOffset).set(*keyHandle, &runtime->getHeap());
+    newTable->at(newSlot + kValueOffset)
+        .set(oldTable->at(oldSlot + kValueOffset), &runtime->getHeap());
+    newTable->at(newSlot + kChainOffset).setNonPtr(bucket);
+    bucket.setNonPtr(HermesValue::encodeNumberValue(newIndex));
+    ++newIndex;
   }
+  assert(newIndex == self->size_ && "Inconsistent size");
 
-  self->hashTable_.set(runtime, newHashTable.get(), &runtime->getHeap());
-  assert(
-      self->hashTable_.get(runtime)->size() == self->capacity_ &&
-      "Inconsistent capacity");
+  newTable->at(kNumUsedSlot).setNonPtr(HermesValue::encodeNumberValue(newIndex));
+  oldTable->at(kNumRemovedSlot)
+      .setNonPtr(HermesValue::encodeNumberValue(numRemoved));
+  oldTable->at(kNextTableSlot)
+      .set(newTable.getHermesValue(), &runtime->getHeap());
+
+  self->table_.set(runtime, newTable.get(), &runtime->getHeap());
+  self->numBuckets_ = numBuckets;
+  self->numUsed_ = newIndex;
   return ExecutionStatus::RETURNED;
 }
 
-bool OrderedHashMap::has(
-    Handle<OrderedHashMap> self,
+SegmentedArray *OrderedHashMap::transitionCursor(
     Runtime *runtime,
-    Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
+    SegmentedArray *table,
+    uint32_t &index) {
+  while (!table->at(kNextTableSlot).isEmpty()) {
+    HermesValue numRemoved = table->at(kNumRemovedSlot);
+    if (numRemoved.getNumber() == kClearedMarker) {
+      index = 0;
+    } else {
+      // The removed indices are sorted, find how many precede the cursor.
+      uint32_t lo = 0;
+      uint32_t hi = numRemoved.getNumberAs<uint32_t>();
+      while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (table->at(kHeaderSize + mid).getNumberAs<uint32_t>() < index) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      index -= lo;
+    }
+    table = vmcast<SegmentedArray>(table->at(kNextTableSlot));
+  }
+  return table;
 }
 
-HashMapEntry *OrderedHashMap::find(
+bool OrderedHashMap::has(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  uint64_t hash = runtime->gcStableHashHermesValue(key);
+  return self->lookup(runtime, hash, key.get()).hasValue();
 }
 
 HermesValue OrderedHashMap::get(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto *entry = find(self, runtime, key);
-  if (!entry) {
+  uint64_t hash = runtime->gcStableHashHermesValue(key);
+  auto index = self->lookup(runtime, hash, key.get());
+  if (!index) {
     return HermesValue::encodeUndefinedValue();
   }
-  return entry->value;
+  return self->table_.get(runtime)->at(
+      self->entrySlot(*index) + kValueOffset);
 }
 
 ExecutionStatus OrderedHashMap::insert(
@@ -287,158 +227,125 @@ ExecutionStatus OrderedHashMap::insert(
     Runtime *runtime,
     Handle<> key,
     Handle<> value) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  if (auto *entry =
-          self->lookupInBucket(runtime, bucket, key.getHermesValue())) {
+  uint64_t hash = runtime->gcStableHashHermesValue(key);
+  if (auto index = self->lookup(runtime, hash, key.get())) {
     // Element already exists, update value and return.
-    entry->value.set(value.get(), &runtime->getHeap());
+    self->table_.get(runtime)
+        ->at(self->entrySlot(*index) + kValueOffset)
+        .set(value.get(), &runtime->getHeap());
     return ExecutionStatus::RETURNED;
   }
-  // Create a new entry, set the key and value.
-  auto crtRes = HashMapEntry::create(runtime);
-  if (LLVM_UNLIKELY(crtRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto newMapEntry = runtime->makeHandle<HashMapEntry>(*crtRes);
-  newMapEntry->key.set(key.get(), &runtime->getHeap());
-  newMapEntry->value.set(value.get(), &runtime->getHeap());
-  auto *curBucketFront =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  if (curBucketFront) {
-    // If the bucket we are inserting to is not empty, we maintain the
-    // linked list properly.
-    newMapEntry->nextEntryInBucket.set(
-        runtime, curBucketFront, &runtime->getHeap());
-  }
-  // Set the newly inserted entry as the front of this bucket chain.
-  self->hashTable_.get(runtime)->at(bucket).set(
-      newMapEntry.getHermesValue(), &runtime->getHeap());
-
-  if (!self->firstIterationEntry_) {
-    // If we are inserting the first ever element, update
-    // first iteration entry pointer.
-    self->firstIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-  } else {
-    // Connect the new entry with the last entry.
-    self->lastIterationEntry_.get(runtime)->nextIterationEntry.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    newMapEntry->prevIterationEntry.set(
-        runtime, self->lastIterationEntry_, &runtime->getHeap());
-
-    HashMapEntry *previousLastEntry = self->lastIterationEntry_.get(runtime);
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-
-    if (previousLastEntry && previousLastEntry->isDeleted()) {
-      // If the last entry was a deleted entry, we no longer need to keep it.
-      self->removeLinkedListNode(
-          runtime, previousLastEntry, &runtime->getHeap());
+
+  if (self->numUsed_ == self->entryCapacity()) {
+    // Out of entries. Grow if at least half of them are alive, otherwise
+    // compact the table in place to drop the deleted entries.
+    uint32_t numBuckets = self->size_ >= self->entryCapacity() / 2
+        ? self->numBuckets_ * 2
+        : self->numBuckets_;
+    if (LLVM_UNLIKELY(
+            rehash(self, runtime, numBuckets) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
   }
 
+  // Append the new entry and make it the head of its bucket.
+  SegmentedArray *table = self->table_.get(runtime);
+  const uint32_t index = self->numUsed_;
+  const uint32_t slot = self->entrySlot(index);
+  GCHermesValue &bucket = table->at(kHeaderSize + self->hashToBucket(hash));
+  table->at(slot + kKeyOffset).set(key.get(), &runtime->getHeap());
+  table->at(slot + kValueOffset).set(value.get(), &runtime->getHeap());
+  table->at(slot + kChainOffset).setNonPtr(bucket);
+  bucket.setNonPtr(HermesValue::encodeNumberValue(index));
+
+  self->numUsed_ = index + 1;
+  table->at(kNumUsedSlot)
+      .setNonPtr(HermesValue::encodeNumberValue(self->numUsed_));
   self->size_++;
-  return self->rehashIfNecessary(self, runtime);
+  return ExecutionStatus::RETURNED;
 }
 
 bool OrderedHashMap::erase(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  HashMapEntry *prevEntry = nullptr;
-  auto *entry =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key.getHermesValue())) {
-    prevEntry = entry;
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  if (!entry) {
+  uint64_t hash = runtime->gcStableHashHermesValue(key);
+  auto index = self->lookup(runtime, hash, key.get());
+  if (!index) {
     // Element does not exist.
     return false;
   }
 
-  if (prevEntry) {
-    // The entry we are deleting has a previous entry, update the link.
-    prevEntry->nextEntryInBucket.set(
-        runtime, entry->nextEntryInBucket, &runtime->getHeap());
-  } else {
-    // The entry we are erasing is the front entry in the bucket, we need
-    // to update the bucket head to the next entry in the bucket, if not
-    // any, set to empty value.
-    self->hashTable_.get(runtime)->at(bucket).set(
-        entry->nextEntryInBucket ? HermesValue::encodeObjectValue(
-                                       entry->nextEntryInBucket.get(runtime))
-                                 : HermesValue::encodeEmptyValue(),
-        &runtime->getHeap());
-  }
-
-  entry->markDeleted();
+  // Leave a tombstone: the entry stays in its bucket chain and keeps its
+  // index, so that iterators and the other entries are unaffected.
+  SegmentedArray *table = self->table_.get(runtime);
+  const uint32_t slot = self->entrySlot(*index);
+  table->at(slot + kKeyOffset).setNonPtr(HermesValue::encodeEmptyValue());
+  table->at(slot + kValueOffset).setNonPtr(HermesValue::encodeEmptyValue());
   self->size_--;
 
-  // Now delete the entry from the iteration linked list.
-  // If we are deleting the last entry, don't remove it from the list yet.
-  // This will ensure that if any iterator out there is currently pointing to
-  // this entry, it will be able to follow on if we add new entries in the
-  // future.
-  if (entry != self->lastIterationEntry_.get(runtime)) {
-    self->removeLinkedListNode(runtime, entry, &runtime->getHeap());
+  // Shrink the table once less than a quarter of it is alive. Failing to
+  // shrink is harmless, the current table remains valid.
+  if (self->size_ < self->entryCapacity() / 4 &&
+      self->numBuckets_ > INITIAL_NUM_BUCKETS) {
+    if (LLVM_UNLIKELY(
+            rehash(self, runtime, self->numBuckets_ / 2) ==
+            ExecutionStatus::EXCEPTION)) {
+      runtime->clearThrownValue();
+    }
   }
 
-  self->rehashIfNecessary(self, runtime);
-
   return true;
 }
 
-HashMapEntry *OrderedHashMap::iteratorNext(
+bool OrderedHashMap::iteratorNext(
     Runtime *runtime,
-    HashMapEntry *entry) const {
-  if (entry == nullptr) {
+    SegmentedArray *&table,
+    uint32_t &index) const {
+  if (table == nullptr) {
     // Starting a new iteration from the first entry.
-    entry = firstIterationEntry_.get(runtime);
+    table = table_.get(runtime);
+    index = 0;
   } else {
-    // Advance to the next entry.
-    entry = entry->nextIterationEntry.get(runtime);
+    table = transitionCursor(runtime, table, index);
   }
+  assert(table == table_.get(runtime) && "Cursor must reach current table");
 
-  // Make sure the entry we returned (if not nullptr) must not be deleted.
-  while (entry && entry->isDeleted()) {
-    entry = entry->nextIterationEntry.get(runtime);
+  // Skip the deleted entries.
+  for (; index < numUsed_; ++index) {
+    if (!table->at(entrySlot(index) + kKeyOffset).isEmpty()) {
+      return true;
+    }
   }
-  return entry;
+  return false;
 }
 
-void OrderedHashMap::clear(Runtime *runtime) {
-  if (!firstIterationEntry_) {
-    // Empty set.
-    return;
+ExecutionStatus OrderedHashMap::clear(
+    Handle<OrderedHashMap> self,
+    Runtime *runtime) {
+  if (self->numUsed_ == 0) {
+    // Nothing was ever inserted in the current table.
+    return ExecutionStatus::RETURNED;
   }
 
-  // Clear the hash table.
-  for (unsigned i = 0; i < capacity_; ++i) {
-    auto entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(i));
-    // Delete every element reachable from the hash table.
-    while (entry) {
-      entry->markDeleted();
-      entry = entry->nextEntryInBucket.get(runtime);
-    }
-    // Clear every element in the hash table.
-    hashTable_.get(runtime)->at(i).setNonPtr(HermesValue::encodeEmptyValue());
+  auto tableRes = createTable(runtime, INITIAL_NUM_BUCKETS);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
   }
-  // Resize the hash table to the initial size.
-  ArrayStorage::resizeWithinCapacity(
-      createPseudoHandle(hashTable_.get(runtime)), runtime, INITIAL_CAPACITY);
-  capacity_ = INITIAL_CAPACITY;
-
-  // After clearing, we will still keep the last deleted entry
-  // in case there is an iterator out there
-  // pointing to the middle of the iteration chain. We need it to be
-  // able to merge back eventually.
-  firstIterationEntry_.set(runtime, lastIterationEntry_, &runtime->getHeap());
-  firstIterationEntry_.get(runtime)->prevIterationEntry = nullptr;
-  size_ = 0;
+
+  // Any iterator still pointing into the old table will restart from the
+  // beginning of the new one.
+  SegmentedArray *oldTable = self->table_.get(runtime);
+  oldTable->at(kNumRemovedSlot)
+      .setNonPtr(HermesValue::encodeNumberValue(kClearedMarker));
+  oldTable->at(kNextTableSlot).set(*tableRes, &runtime->getHeap());
+
+  self->table_.set(
+      runtime, vmcast<SegmentedArray>(*tableRes), &runtime->getHeap());
+  self->numBuckets_ = INITIAL_NUM_BUCKETS;
+  self->numUsed_ = 0;
+  self->size_ = 0;
+  return ExecutionStatus::RETURNED;
 }
 
 } // namespace vm
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/RegExpCache.h"
+
+namespace hermes {
+namespace vm {
+
+std::string RegExpCache::makeKey(
+    llvm::ArrayRef<char16_t> pattern,
+    regex::constants::SyntaxFlags flags) {
+  std::string key;
+  key.reserve(1 + pattern.size() * sizeof(char16_t));
+  key.push_back((char)flags);
+  key.append(
+      reinterpret_cast<const char *>(pattern.data()),
+      pattern.size() * sizeof(char16_t));
+  return key;
+}
+
+RegExpCache::Bytecode RegExpCache::lookup(
+    llvm::ArrayRef<char16_t> pattern,
+    regex::constants::SyntaxFlags flags) {
+  if (pattern.size() > kMaxPatternLength) {
+    ++misses_;
+    return nullptr;
+  }
+  auto it = entries_.find(makeKey(pattern, flags));
+  if (it == entries_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  Entry &entry = it->second;
+  lru_.splice(lru_.begin(), lru_, entry.lruPos);
+  return entry.bytecode;
+}
+
+void RegExpCache::insert(
+    llvm::ArrayRef<char16_t> pattern,
+    regex::constants::SyntaxFlags flags,
+    Bytecode bytecode) {
+  if (pattern.size() > kMaxPatternLength)
+    return;
+  auto res = entries_.try_emplace(makeKey(pattern, flags));
+  if (!res.second)
+    return;
+
+  if (entries_.size() > kMaxEntries) {
+    auto victim = entries_.find(lru_.back());
+    mallocSize_ -= victim->first().size() + victim->second.bytecode->capacity();
+    entries_.erase(victim);
+    lru_.pop_back();
+  }
+
+  Entry &entry = res.first->second;
+  entry.bytecode = std::move(bytecode);
+  lru_.push_front(res.first->first());
+  entry.lruPos = lru_.begin();
+  mallocSize_ += res.first->first().size() + entry.bytecode->capacity();
+}
+
+} // namespace vm
+} // namespace hermes
@@ -67,6 +67,45 @@ void Runtime::dumpOpcodeStats(llvm::raw_ostream &os) const {
            << inst::getOpCodeString(static_cast<inst::OpCode>(op)).data()
            << std::setw(22) << t[op] << std::setw(11) << f[op] << "\n";
   }
+
+  // The most frequent pairs of consecutive opcodes.
+  constexpr size_t kMaxPairs = 50;
+  std::vector<std::pair<size_t, size_t>> pairs;
+  uint64_t totalDispatches = 0;
+  for (size_t first : idx) {
+    totalDispatches += f[first];
+    for (size_t second : idx) {
+      if (opcodePairFrequency[first][second])
+        pairs.emplace_back(first, second);
+    }
+  }
+  auto pairFreq = [this](const std::pair<size_t, size_t> &p) {
+    return opcodePairFrequency[p.first][p.second];
+  };
+  sort(
+      pairs.begin(),
+      pairs.end(),
+      [&pairFreq](
+          const std::pair<size_t, size_t> &p1,
+          const std::pair<size_t, size_t> &p2) {
+        return pairFreq(p1) > pairFreq(p2);
+      });
+  if (pairs.size() > kMaxPairs)
+    pairs.resize(kMaxPairs);
+
+  stream << "\nOpcode pairs sorted by frequency:\n"
+         << std::left << std::setfill(' ') << std::setw(50)
+         << "==Opcode Pair==" << std::setw(11) << "==Frequency=="
+         << "\n";
+  for (const auto &p : pairs) {
+    std::string pairName =
+        inst::getOpCodeString(static_cast<inst::OpCode>(p.first)).str() +
+        " " + inst::getOpCodeString(static_cast<inst::OpCode>(p.second)).str();
+    stream << std::left << std::setfill(' ') << std::setw(50) << pairName
+           << std::setw(11) << pairFreq(p) << "\n";
+  }
+
+  stream << "\nTotal dispatches: " << totalDispatches << "\n";
   os << stream.str();
 }
 #endif
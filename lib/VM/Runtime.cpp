@@ -23,6 +23,7 @@
 #include "hermes/Platform/Logging.h"
 #include "hermes/Runtime/Libhermes.h"
 #include "hermes/Support/CheckedMalloc.h"
+#include "hermes/Support/HashString.h"
 #include "hermes/Support/MemoryBuffer.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PerfSection.h"
@@ -71,6 +72,17 @@ static constexpr uint32_t kMaxSupportedNumRegisters =
 // Runtime::generateSpecialRuntimeBytecode).
 static constexpr size_t MIN_IO_TRACKING_SIZE = 64 * 1024;
 
+static hbc::BytecodeResidencyPolicy makeBytecodeResidencyPolicy(
+    const RuntimeConfig &runtimeConfig) {
+  hbc::BytecodeResidencyPolicy policy;
+  policy.prefetchStartup = runtimeConfig.getBytecodePrefetchStartup();
+  policy.startupReadaheadBytes = runtimeConfig.getBytecodeStartupReadahead();
+  policy.randomAccessRest = runtimeConfig.getBytecodeRandomAccess();
+  policy.releaseColdFunctionsAtTTI =
+      runtimeConfig.getBytecodeReleaseColdAtTTI();
+  return policy;
+}
+
 static const Predefined::Str fixedPropCacheNames[(size_t)PropCacheID::_COUNT] =
     {
 #define V(id, predef) predef,
@@ -175,6 +187,7 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
       shouldRandomizeMemoryLayout_(runtimeConfig.getRandomizeMemoryLayout()),
       bytecodeWarmupPercent_(runtimeConfig.getBytecodeWarmupPercent()),
       trackIO_(runtimeConfig.getTrackIO()),
+      bytecodeResidencyPolicy_(makeBytecodeResidencyPolicy(runtimeConfig)),
       vmExperimentFlags_(runtimeConfig.getVMExperimentFlags()),
       runtimeStats_(runtimeConfig.getEnableSampledStats()),
       commonStorage_(createRuntimeCommonStorage(
@@ -190,6 +203,10 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
   if (LLVM_UNLIKELY(maxNumRegisters > kMaxSupportedNumRegisters)) {
     hermes_fatal("RuntimeConfig maxNumRegisters too big");
   }
+#ifndef HERMESVM_LEAN
+  if (runtimeConfig.getPrewarmLazyFunctions())
+    lazyFunctionPrewarmer_ = llvm::make_unique<LazyFunctionPrewarmer>();
+#endif
   registerStack_ = runtimeConfig.getRegisterStack();
   if (!registerStack_) {
     // registerStack_ should not be allocated with new, because then
@@ -329,6 +346,10 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
 
 Runtime::~Runtime() {
   samplingProfiler_->unregisterRuntime(this);
+#ifndef HERMESVM_LEAN
+  // Stop compiling in the background before the modules go away.
+  lazyFunctionPrewarmer_.reset();
+#endif
 
   heap_.finalizeAll();
   crashMgr_->unregisterCallback(crashCallbackKey_);
@@ -426,6 +447,8 @@ void Runtime::markRoots(RootAcceptor &acceptor, bool markLongLived) {
       for (auto &hv : charStrings_)
         acceptor.accept(hv);
     }
+    for (auto &hv : shortStrings_)
+      acceptor.accept(hv);
     acceptor.endRootSection();
   }
 
@@ -552,6 +575,15 @@ void Runtime::printHeapStats(llvm::raw_ostream &os) {
   if (shouldStabilizeInstructionCount())
     return;
   getHeap().printAllCollectedStats(os);
+#ifdef HERMESVM_SERIALIZE
+  if (runtimeStats_.deserialize.count) {
+    os << "Deserialize stats:\n"
+       << "wall time: " << runtimeStats_.deserialize.wallDuration * 1000
+       << " ms\n"
+       << "CPU time: " << runtimeStats_.deserialize.cpuDuration * 1000
+       << " ms\n";
+  }
+#endif
   for (auto &module : getRuntimeModules()) {
     auto tracker = module.getBytecode()->getPageAccessTracker();
     if (tracker) {
@@ -581,6 +613,8 @@ size_t Runtime::mallocSize() const {
   for (const RuntimeModule &rtm : runtimeModuleList_) {
     totalSize += sizeof(RuntimeModule) + rtm.additionalMemorySize();
   }
+  // Cached regex bytecode
+  totalSize += regExpCache_.getMallocSize();
   return totalSize;
 }
 
@@ -663,7 +697,7 @@ CallResult<HermesValue> Runtime::run(
 }
 
 CallResult<HermesValue> Runtime::runBytecode(
-    std::shared_ptr<hbc::BCProvider> &&bytecode,
+    std::shared_ptr<CompiledModule> compiledModule,
     RuntimeModuleFlags flags,
     llvm::StringRef sourceURL,
     Handle<Environment> environment,
@@ -689,6 +723,7 @@ CallResult<HermesValue> Runtime::runBytecode(
   }
 #endif
 
+  hbc::BCProvider *bytecode = compiledModule->getBytecode();
   auto globalFunctionIndex = bytecode->getGlobalFunctionIndex();
 
   if (bytecode->getBytecodeOptions().staticBuiltins && !builtinsFrozen_) {
@@ -700,7 +735,14 @@ CallResult<HermesValue> Runtime::runBytecode(
   }
 
   if (flags.persistent) {
-    persistentBCProviders_.push_back(bytecode);
+    persistentBCProviders_.push_back(compiledModule->getBytecodeSharedPtr());
+  }
+  // The pages of the bytecode are shared by every runtime which loads it, so
+  // only the first one advises the OS about them.
+  if (flags.persistent && compiledModule->markLoaded()) {
+    // Count the pages loaded from now on, including by prefetching.
+    if (runtimeStats_.shouldSample)
+      bytecode->snapshotResidentPages();
     if (bytecodeWarmupPercent_ > 0) {
       // Start the warmup thread for this bytecode if it's a buffer.
       bytecode->startWarmup(bytecodeWarmupPercent_);
@@ -710,6 +752,7 @@ CallResult<HermesValue> Runtime::runBytecode(
     } else if (getVMExperimentFlags() & experiments::MAdviseSequential) {
       bytecode->madvise(oscompat::MAdvice::Sequential);
     }
+    bytecode->applyResidencyPolicy(bytecodeResidencyPolicy_);
   }
   // Only track I/O for buffers > 64 kB (which excludes things like
   // Runtime::generateSpecialRuntimeBytecode).
@@ -729,11 +772,15 @@ CallResult<HermesValue> Runtime::runBytecode(
   Handle<Domain> domain = toHandle(this, Domain::create(this));
 
   auto runtimeModuleRes = RuntimeModule::create(
-      this, domain, std::move(bytecode), flags, sourceURL);
+      this, domain, std::move(compiledModule), flags, sourceURL);
   if (LLVM_UNLIKELY(runtimeModuleRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
   auto runtimeModule = *runtimeModuleRes;
+#ifndef HERMESVM_LEAN
+  if (lazyFunctionPrewarmer_)
+    lazyFunctionPrewarmer_->enqueue(runtimeModule->getCompiledModule());
+#endif
   auto globalCode = runtimeModule->getCodeBlockMayAllocate(globalFunctionIndex);
 
 #ifdef HERMES_ENABLE_DEBUGGER
@@ -1218,6 +1265,30 @@ Handle<StringPrimitive> Runtime::getCharacterString(char16_t ch) {
       ignoreAllocationFailure(StringPrimitive::create(this, UTF16Ref(ch))));
 }
 
+CallResult<HermesValue> Runtime::getShortASCIIString(ASCIIRef str) {
+  assert(
+      str.size() <= SHORT_STRING_MAX_LENGTH &&
+      "String is too long for the short string cache");
+  PinnedHermesValue &entry =
+      shortStrings_[hermes::hashString(str) & (SHORT_STRING_CACHE_SIZE - 1)];
+  if (entry.isString() &&
+      StringPrimitive::createStringView(
+          this, Handle<StringPrimitive>::vmcast(&entry))
+          .equals(str)) {
+    return entry;
+  }
+
+  // Copy the characters out of the heap, since allocating may move them.
+  char buf[SHORT_STRING_MAX_LENGTH];
+  std::copy(str.begin(), str.end(), buf);
+  auto res = StringPrimitive::create(this, ASCIIRef(buf, str.size()));
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  entry = *res;
+  return res;
+}
+
 // Store all object and symbol ids in a static table to conserve code size.
 static const struct {
   uint16_t object, method;
@@ -1326,6 +1397,20 @@ ExecutionStatus Runtime::assertBuiltinsUnmodified() {
   });
 }
 
+void Runtime::releaseColdBytecode() {
+  for (auto &module : runtimeModuleList_) {
+    // Lazy modules have no bytecode of their own.
+    if (!module.isInitialized())
+      continue;
+    const auto &functionMap = module.getFunctionMap();
+    bytecodePagesReleased_ +=
+        module.getBytecode()->releaseUnusedFunctionPages(
+            [&functionMap](uint32_t functionID) {
+              return functionMap[functionID] != nullptr;
+            });
+  }
+}
+
 void Runtime::freezeBuiltins() {
   assert(!builtinsFrozen_ && "Builtins are already frozen.");
   GCScope gcScope{this};
@@ -1390,10 +1475,11 @@ uint64_t Runtime::gcStableHashHermesValue(Handle<HermesValue> value) {
       return llvm::hash_value(id);
     }
     case StrTag: {
-      // For strings, we hash the string content.
-      auto strView = StringPrimitive::createStringView(
-          this, Handle<StringPrimitive>::vmcast(value));
-      return llvm::hash_combine_range(strView.begin(), strView.end());
+      // For strings, we hash the string content. The hash is cached in the
+      // string, so each string is only scanned once.
+      return StringPrimitive::ensureFlat(
+                 this, Handle<StringPrimitive>::vmcast(value))
+          ->getOrComputeHash();
     }
     default:
       assert(!value->isPointer() && "Unhandled pointer type");
@@ -1759,6 +1845,9 @@ void Runtime::serializeRuntimeFields(Serializer &s) {
     s.writeHermesValue(str);
   }
 
+  // Field PinnedHermesValue shortStrings_[SHORT_STRING_CACHE_SIZE];
+  // This is only a cache, so it starts out empty after deserialization.
+
   // Field std::vector<NativeFunction *> builtins_{};
   s.writeInt<uint32_t>(builtins_.size());
   for (auto *nativeFunction : builtins_) {
@@ -1874,6 +1963,9 @@ void Runtime::deserializeRuntimeFields(Deserializer &d) {
 }
 
 void Runtime::deserializeImpl(Deserializer &d, bool currentlyInYoung) {
+  const instrumentation::RAIITimer timer{
+      "Deserialize", runtimeStats_, runtimeStats_.deserialize};
+
   if (currentlyInYoung) {
     heap_.deserializeStart();
   }
@@ -1883,23 +1975,34 @@ void Runtime::deserializeImpl(Deserializer &d, bool currentlyInYoung) {
   d.readAndCheckOffset();
   heap_.deserializeWeakRefs(d);
 
-  d.readAndCheckOffset();
-  identifierTable_.deserialize(d);
+  {
+    PerfSection deserializeIdentifiersSystraceRegion("deserializeIdentifiers");
+    d.readAndCheckOffset();
+    identifierTable_.deserialize(d);
 
-  d.readAndCheckOffset();
-  symbolRegistry_.deserialize(d);
+    d.readAndCheckOffset();
+    symbolRegistry_.deserialize(d);
+  }
 
   d.readAndCheckOffset();
   deserializeRuntimeFields(d);
 
-  d.readAndCheckOffset();
-  heap_.deserializeHeap(d);
+  {
+    PerfSection deserializeHeapSystraceRegion("deserializeHeap");
+    d.readAndCheckOffset();
+    heap_.deserializeHeap(d);
+  }
 
   d.readAndCheckOffset();
   heap_.getIDTracker().deserialize(d);
 
-  d.readAndCheckOffset();
-  d.flushRelocationQueue();
+  {
+    PerfSection flushRelocationsSystraceRegion("deserializeFlushRelocations");
+    flushRelocationsSystraceRegion.addArg(
+        "forwardReferences", d.getNumForwardReferences());
+    d.readAndCheckOffset();
+    d.flushRelocationQueue();
+  }
 
   // Now update the runtime pointer to prototypes.
   // JSObject *objectPrototypeRawPtr{};
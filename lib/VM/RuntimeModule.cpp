@@ -17,6 +17,8 @@
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/VM/StringView.h"
 
+#include <algorithm>
+
 namespace hermes {
 namespace vm {
 
@@ -85,27 +87,42 @@ CallResult<RuntimeModule *> RuntimeModule::create(
     std::shared_ptr<hbc::BCProvider> &&bytecode,
     RuntimeModuleFlags flags,
     llvm::StringRef sourceURL) {
+  if (!bytecode)
+    return new RuntimeModule(runtime, domain, flags, sourceURL);
+  return create(
+      runtime,
+      domain,
+      CompiledModule::create(std::move(bytecode)),
+      flags,
+      sourceURL);
+}
+
+CallResult<RuntimeModule *> RuntimeModule::create(
+    Runtime *runtime,
+    Handle<Domain> domain,
+    std::shared_ptr<CompiledModule> compiledModule,
+    RuntimeModuleFlags flags,
+    llvm::StringRef sourceURL) {
   auto *result = new RuntimeModule(runtime, domain, flags, sourceURL);
-  if (bytecode) {
-    if (result->initializeMayAllocate(std::move(bytecode)) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
+  if (result->initializeMayAllocate(std::move(compiledModule)) ==
+      ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
   }
   return result;
 }
 
 void RuntimeModule::initializeWithoutCJSModulesMayAllocate(
-    std::shared_ptr<hbc::BCProvider> &&bytecode) {
+    std::shared_ptr<CompiledModule> compiledModule) {
   assert(!bcProvider_ && "RuntimeModule already initialized");
-  bcProvider_ = std::move(bytecode);
+  compiledModule_ = std::move(compiledModule);
+  bcProvider_ = compiledModule_->getBytecodeSharedPtr();
   importStringIDMapMayAllocate();
   initializeFunctionMap();
 }
 
 ExecutionStatus RuntimeModule::initializeMayAllocate(
-    std::shared_ptr<hbc::BCProvider> &&bytecode) {
-  initializeWithoutCJSModulesMayAllocate(std::move(bytecode));
+    std::shared_ptr<CompiledModule> compiledModule) {
+  initializeWithoutCJSModulesMayAllocate(std::move(compiledModule));
   if (LLVM_UNLIKELY(importCJSModuleTable() == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -139,12 +156,12 @@ RuntimeModule *RuntimeModule::createLazyModule(
   // Set the bcProvider's BytecodeModule to point to the parent's.
   assert(parent->isInitialized() && "Parent module must have been initialized");
 
-  hbc::BytecodeFunction *bcFunction =
-      &((hbc::BCProviderFromSrc *)parent->getBytecode())
-           ->getBytecodeModule()
-           ->getFunction(functionID);
-
-  RM->bcProvider_ = hbc::BCProviderLazy::createBCProviderLazy(bcFunction);
+  RM->compiledModule_ =
+      CompiledModule::createLazy(parent->compiledModule_, functionID);
+  RM->bcProvider_ = RM->compiledModule_->getBytecodeSharedPtr();
+  auto *bcFunction =
+      static_cast<hbc::BCProviderLazy *>(RM->getBytecode())
+          ->getBytecodeFunction();
 
   // We don't know which function index this block will eventually represent,
   // so just add it as 0 to ensure ownership. We'll move it later in
@@ -184,13 +201,13 @@ bool RuntimeModule::getLazyNameString(Runtime *runtime, std::string &res)
 }
 
 void RuntimeModule::initializeLazyMayAllocate(
-    std::unique_ptr<hbc::BCProvider> bytecode) {
+    std::shared_ptr<CompiledModule> compiledModule) {
   // Clear the old data provider first.
   bcProvider_ = nullptr;
 
   // Initialize without CJS module table because this compilation is done
   // separately, and the bytecode will not contain a module table.
-  initializeWithoutCJSModulesMayAllocate(std::move(bytecode));
+  initializeWithoutCJSModulesMayAllocate(std::move(compiledModule));
 
   // createLazyCodeBlock added a single codeblock as functionMap_[0]
   assert(functionMap_[0] && "Missing first entry");
@@ -222,12 +239,22 @@ void RuntimeModule::importStringIDMapMayAllocate() {
   // Populate the string ID map with empty identifiers.
   stringIDMap_.resize(strTableSize, SymbolID::empty());
 
-  if (runtime_->getVMExperimentFlags() &
-      experiments::MAdviseStringsSequential) {
+  // Registering a lazy identifier does not allocate in the GC heap, so the
+  // identifiers of persistent modules can be registered on first use, even
+  // from paths which expect them to exist already. Most identifiers in a large
+  // bundle are not used early, if at all, so this saves both load time and
+  // identifier table memory. Other modules must create every identifier now.
+  const bool lazyIdentifiers = flags_.persistent;
+
+  if (!lazyIdentifiers &&
+      (runtime_->getVMExperimentFlags() &
+       experiments::MAdviseStringsSequential)) {
     bcProvider_->adviseStringTableSequential();
   }
 
-  if (runtime_->getVMExperimentFlags() & experiments::MAdviseStringsWillNeed) {
+  if (!lazyIdentifiers &&
+      (runtime_->getVMExperimentFlags() &
+       experiments::MAdviseStringsWillNeed)) {
     bcProvider_->willNeedStringTable();
   }
 
@@ -242,7 +269,8 @@ void RuntimeModule::importStringIDMapMayAllocate() {
   // Preallocate enough space to store all identifiers to prevent
   // unnecessary allocations. NOTE: If this module is not the first module,
   // then this is an underestimate.
-  runtime_->getIdentifierTable().reserve(translations.size());
+  if (!lazyIdentifiers)
+    runtime_->getIdentifierTable().reserve(translations.size());
   {
     StringID strID = 0;
     uint32_t trnID = 0;
@@ -254,6 +282,11 @@ void RuntimeModule::importStringIDMapMayAllocate() {
           break;
 
         case StringKind::Identifier:
+          if (lazyIdentifiers) {
+            strID += entry.count();
+            trnID += entry.count();
+            break;
+          }
           for (uint32_t i = 0; i < entry.count(); ++i, ++strID, ++trnID) {
             createSymbolFromStringIDMayAllocate(
                 strID,
@@ -293,8 +326,21 @@ void RuntimeModule::importStringIDMapMayAllocate() {
     mapStringMayAllocate(s, 0, hashString(s));
   }
 
-  // Done with translations, so advise them out if possible.
-  bcProvider_->dontNeedIdentifierTranslations();
+  // Done with translations, so advise them out if possible. Lazy
+  // identifiers still need their hashes.
+  if (!lazyIdentifiers)
+    bcProvider_->dontNeedIdentifierTranslations();
+}
+
+SymbolID RuntimeModule::registerLazyIdentifier(StringID stringID) {
+  assert(
+      flags_.persistent &&
+      "Identifiers are only created on first use in persistent modules");
+  assert(getIdentifierHash(stringID) && "String is not an identifier");
+  return createSymbolFromStringIDMayAllocate(
+      stringID,
+      bcProvider_->getStringTableEntry(stringID),
+      getIdentifierHash(stringID));
 }
 
 void RuntimeModule::initializeFunctionMap() {
@@ -485,7 +531,9 @@ RuntimeModule *RuntimeModule::deserialize(Deserializer &d) {
   // We write both BCProviderFromBuffer and BCProviderFromSrc to bytecode
   // file format. Therefore, when we deserialize, always use
   // BCProviderFromBuffer.
-  res->bcProvider_ = hbc::BCProviderFromBuffer::deserialize(d);
+  res->compiledModule_ =
+      CompiledModule::create(hbc::BCProviderFromBuffer::deserialize(d));
+  res->bcProvider_ = res->compiledModule_->getBytecodeSharedPtr();
 
   size = d.readInt<size_t>();
   res->functionMap_.resize(size);
@@ -108,8 +108,10 @@ void SegmentedArraySerialize(Serializer &s, const GCCell *cell) {
   s.writeInt<SegmentedArray::size_type>(self->slotCapacity_);
   s.writeInt<SegmentedArray::size_type>(self->numSlotsUsed_);
 
+  // Write the slots rather than the elements: past kValueToSegmentThreshold,
+  // the slots point to the segments, which are serialized separately.
   for (uint32_t i = 0; i < self->numSlotsUsed_; i++) {
-    s.writeHermesValue(self->at(i));
+    s.writeHermesValue(self->inlineStorage()[i]);
   }
 
   s.endObject(cell);
@@ -125,8 +127,8 @@ void SegmentedArrayDeserialize(Deserializer &d, CellKind kind) {
       SegmentedArray::allocationSizeForSlots(slotCapacity));
   auto *cell =
       new (mem) SegmentedArray(d.getRuntime(), slotCapacity, numSlotsUsed);
-  for (auto it = cell->begin(); it != cell->end(); ++it) {
-    d.readHermesValue(&*it);
+  for (uint32_t i = 0; i < numSlotsUsed; i++) {
+    d.readHermesValue(&cell->inlineStorage()[i]);
   }
   d.endObject(cell);
 }
@@ -8,9 +8,11 @@
 #include "hermes/VM/StringPrimitive.h"
 
 #include "hermes/Support/Algorithms.h"
+#include "hermes/Support/HashString.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/FillerCell.h"
+#include "hermes/VM/HermesValue-inline.h"
 #include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringView.h"
 
@@ -143,7 +145,64 @@ void ExternalUTF16StringPrimitiveBuildMeta(
   symbolStringPrimitiveBuildMeta(cell, mb);
 }
 
+void SlicedUTF16StringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const SlicedUTF16StringPrimitive *>(cell);
+  mb.addField("parent", &self->parent_);
+}
+
+void SlicedASCIIStringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const SlicedASCIIStringPrimitive *>(cell);
+  mb.addField("parent", &self->parent_);
+}
+
 #ifdef HERMESVM_SERIALIZE
+template <typename T>
+void serializeSlicedStringImpl(Serializer &s, const GCCell *cell) {
+  const auto *self = vmcast<const SlicedStringPrimitive<T>>(cell);
+  s.writeInt<uint32_t>(self->getStringLength());
+  s.writeInt<uint32_t>(self->start_);
+  s.writeHermesValue(self->parent_);
+  s.endObject(cell);
+}
+
+template <typename T>
+void deserializeSlicedStringImpl(Deserializer &d) {
+  uint32_t length = d.readInt<uint32_t>();
+  uint32_t start = d.readInt<uint32_t>();
+  void *mem = d.getRuntime()->alloc</*fixedSize*/ true>(
+      sizeof(SlicedStringPrimitive<T>));
+  auto *cell =
+      new (mem) SlicedStringPrimitive<T>(d.getRuntime(), start, length);
+  d.readHermesValue(&cell->parent_);
+  d.endObject(cell);
+}
+
+void SlicedUTF16StringPrimitiveSerialize(Serializer &s, const GCCell *cell) {
+  serializeSlicedStringImpl<char16_t>(s, cell);
+}
+
+void SlicedASCIIStringPrimitiveSerialize(Serializer &s, const GCCell *cell) {
+  serializeSlicedStringImpl<char>(s, cell);
+}
+
+void SlicedUTF16StringPrimitiveDeserialize(Deserializer &d, CellKind kind) {
+  assert(
+      kind == CellKind::SlicedUTF16StringPrimitiveKind &&
+      "Expected SlicedUTF16StringPrimitive");
+  deserializeSlicedStringImpl<char16_t>(d);
+}
+
+void SlicedASCIIStringPrimitiveDeserialize(Deserializer &d, CellKind kind) {
+  assert(
+      kind == CellKind::SlicedASCIIStringPrimitiveKind &&
+      "Expected SlicedASCIIStringPrimitive");
+  deserializeSlicedStringImpl<char>(d);
+}
+
 template <typename T>
 void serializeExternalStringImpl(Serializer &s, const GCCell *cell) {
   const auto *self = vmcast<const ExternalStringPrimitive<T>>(cell);
@@ -304,8 +363,8 @@ CallResult<HermesValue> StringPrimitive::createDynamic(
       return ExecutionStatus::EXCEPTION;
     }
     // Copy directly into the StringPrimitive storage.
-    std::copy(
-        str.begin(), str.end(), res->getString()->castToASCIIPointerForWrite());
+    convertUTF16ToASCII(
+        res->getString()->castToASCIIPointerForWrite(), str.data(), str.size());
     return res;
   } else {
     return DynamicUTF16StringPrimitive::create(runtime, str);
@@ -336,9 +395,21 @@ bool StringPrimitive::equals(const StringPrimitive *other) const {
   if (this == other) {
     return true;
   }
+  // If both hashes have already been computed, they can rule out equality
+  // without looking at the characters.
+  if (hash_ && other->hash_ && hash_ != other->hash_) {
+    return false;
+  }
   return sliceEquals(0, getStringLength(), other);
 }
 
+uint32_t StringPrimitive::computeHash() const {
+  assert(isFlat() && "Can only hash flat strings");
+  hash_ = isASCII() ? hermes::hashString(castToASCIIRef())
+                    : hermes::hashString(castToUTF16Ref());
+  return hash_;
+}
+
 bool StringPrimitive::equals(const StringView &other) const {
   if (isASCII()) {
     return other.equals(castToASCIIRef());
@@ -396,6 +467,40 @@ CallResult<HermesValue> StringPrimitive::slice(
   assert(
       start + length <= str->getStringLength() && "Invalid length for slice");
 
+  if (start == 0 && length == str->getStringLength()) {
+    return str.getHermesValue();
+  }
+  // Empty and single character strings are preallocated, and short ASCII
+  // strings are often the same tokens over and over, so avoid allocating them.
+  if (length == 0) {
+    return HermesValue::encodeStringValue(
+        runtime->getPredefinedString(Predefined::emptyString));
+  }
+  if (length == 1) {
+    return runtime->getCharacterString(str->at(start)).getHermesValue();
+  }
+  if (length <= Runtime::SHORT_STRING_MAX_LENGTH && str->isASCII()) {
+    return runtime->getShortASCIIString(str->castToASCIIRef(start, length));
+  }
+  // The characters of a slice of a slice are stored in the parent of the
+  // latter.
+  uint32_t storageLength = str->getStringLength();
+  if (str->isSliced()) {
+    storageLength = str->isASCII()
+        ? vmcast<SlicedASCIIStringPrimitive>(str.get())
+              ->getParent()
+              ->getStringLength()
+        : vmcast<SlicedUTF16StringPrimitive>(str.get())
+              ->getParent()
+              ->getStringLength();
+  }
+  if (length >= SLICED_STRING_MIN_LENGTH &&
+      storageLength / SLICED_STRING_MAX_PARENT_RATIO <= length) {
+    return str->isASCII()
+        ? SlicedASCIIStringPrimitive::create(runtime, str, start, length)
+        : SlicedUTF16StringPrimitive::create(runtime, str, start, length);
+  }
+
   SafeUInt32 safeLen(length);
 
   auto builder =
@@ -423,8 +528,10 @@ StringView StringPrimitive::createStringView(
 void StringPrimitive::copyUTF16String(
     llvm::SmallVectorImpl<char16_t> &str) const {
   if (isASCII()) {
-    const char *ptr = castToASCIIPointer();
-    str.append(ptr, ptr + getStringLength());
+    size_t existingLen = str.size();
+    str.resize(existingLen + getStringLength());
+    convertASCIIToUTF16(
+        str.data() + existingLen, castToASCIIPointer(), getStringLength());
   } else {
     const char16_t *ptr = castToUTF16Pointer();
     str.append(ptr, ptr + getStringLength());
@@ -433,8 +540,7 @@ void StringPrimitive::copyUTF16String(
 
 void StringPrimitive::copyUTF16String(char16_t *ptr) const {
   if (isASCII()) {
-    const char *src = castToASCIIPointer();
-    std::copy(src, src + getStringLength(), ptr);
+    convertASCIIToUTF16(ptr, castToASCIIPointer(), getStringLength());
   } else {
     const char16_t *src = castToUTF16Pointer();
     std::copy(src, src + getStringLength(), ptr);
@@ -630,5 +736,29 @@ void ExternalStringPrimitive<T>::_snapshotAddNodesImpl(
 template class ExternalStringPrimitive<char16_t>;
 template class ExternalStringPrimitive<char>;
 
+template <typename T>
+CallResult<HermesValue> SlicedStringPrimitive<T>::create(
+    Runtime *runtime,
+    Handle<StringPrimitive> str,
+    uint32_t start,
+    uint32_t length) {
+  void *mem = runtime->alloc</*fixedSize*/ true>(sizeof(SlicedStringPrimitive));
+  // No allocation may happen from here on, as we hold raw pointers.
+  NoAllocScope noAlloc{runtime};
+  StringPrimitive *parent = str.get();
+  if (auto *sliced = dyn_vmcast<SlicedStringPrimitive>(parent)) {
+    start += sliced->start_;
+    parent = sliced->parent_.getString();
+  }
+  assert(!parent->isSliced() && "the parent of a slice cannot be sliced");
+  auto *self = new (mem) SlicedStringPrimitive(runtime, start, length);
+  self->parent_.set(
+      HermesValue::encodeStringValue(parent), &runtime->getHeap());
+  return HermesValue::encodeStringValue(self);
+}
+
+template class SlicedStringPrimitive<char16_t>;
+template class SlicedStringPrimitive<char>;
+
 } // namespace vm
 } // namespace hermes
@@ -7,6 +7,8 @@
 
 #include "hermes/VM/StringView.h"
 
+#include "hermes/Support/UTF8.h"
+
 namespace hermes {
 namespace vm {
 
@@ -15,8 +17,9 @@ UTF16Ref StringView::getUTF16Ref(
     bool alwaysCopy) const {
   uint32_t existingLen = allocator.size();
   if (isASCII()) {
-    const char *ptr = castToCharPtr();
-    allocator.append(ptr, ptr + length());
+    allocator.resize(existingLen + length());
+    convertASCIIToUTF16(
+        allocator.data() + existingLen, castToCharPtr(), length());
     return UTF16Ref(allocator.data() + existingLen, length());
   }
   const char16_t *ptr = castToChar16Ptr();
@@ -34,10 +34,10 @@ void SymbolRegistry::markRoots(SlotAcceptor &acceptor) {
 CallResult<SymbolID> SymbolRegistry::getSymbolForKey(
     Runtime *runtime,
     Handle<StringPrimitive> key) {
-  HashMapEntry *it = OrderedHashMap::find(
+  HermesValue symbolValue = OrderedHashMap::get(
       Handle<OrderedHashMap>::vmcast(&stringMap_), runtime, key);
-  if (it) {
-    return it->value.getSymbol();
+  if (symbolValue.isSymbol()) {
+    return symbolValue.getSymbol();
   }
 
   auto symbolRes =
@@ -107,11 +107,7 @@ template uint32_t IdentifierHashTable::lookupString(
 uint32_t IdentifierHashTable::lookupString(
     const StringPrimitive *str,
     bool mustBeNew) const {
-  if (str->isASCII()) {
-    return lookupString(str->castToASCIIRef(), mustBeNew);
-  } else {
-    return lookupString(str->castToUTF16Ref(), mustBeNew);
-  }
+  return lookupString(str, str->getOrComputeHash(), mustBeNew);
 }
 
 uint32_t IdentifierHashTable::lookupString(
@@ -136,11 +132,7 @@ void IdentifierHashTable::insert(uint32_t idx, SymbolID id) {
 }
 
 void IdentifierHashTable::remove(const StringPrimitive *str) {
-  if (str->isASCII()) {
-    remove(str->castToASCIIRef());
-  } else {
-    remove(str->castToUTF16Ref());
-  }
+  remove(lookupString(str));
 }
 
 void IdentifierHashTable::growAndRehash(uint32_t newCapacity) {
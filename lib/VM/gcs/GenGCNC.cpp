@@ -1549,6 +1549,9 @@ void GenGC::serializeHeap(Serializer &s) {
     }
   };
 
+  // Record how much of the old generation the objects occupy, so the
+  // Deserializer can set up all the segments it needs at once.
+  s.writeInt<uint32_t>(oldGen_.used());
   oldGen_.forAllObjs(serializeObject);
 
   // Write a 255 at the end to signal that we finish serializing heap objects.
@@ -1556,6 +1559,15 @@ void GenGC::serializeHeap(Serializer &s) {
 }
 
 void GenGC::deserializeHeap(Deserializer &d) {
+  // Grow the old generation to fit the serialized objects up front, rather
+  // than materializing segments one at a time as they fill up. If that is
+  // not possible, allocation below grows the heap as usual.
+  const uint32_t serializedBytes = d.readInt<uint32_t>();
+  {
+    AllocContextYieldThenClaim yielder(this);
+    oldGen_.growToFit(serializedBytes);
+  }
+
   uint8_t kind;
   while ((kind = d.readInt<uint8_t>()) != 255) {
     LLVM_DEBUG(
@@ -2219,6 +2231,7 @@ void GenGC::sizeDiagnosticCensus() {
         static_cast<int>(cell->isVariableSize());
 
     if (cell->getKind() == CellKind::DynamicASCIIStringPrimitiveKind ||
+        cell->getKind() == CellKind::SlicedASCIIStringPrimitiveKind ||
         cell->getKind() == CellKind::DynamicUniquedASCIIStringPrimitiveKind ||
         cell->getKind() == CellKind::ExternalASCIIStringPrimitiveKind) {
       acceptor.diagnostic.asciiStr.count++;
@@ -2229,6 +2242,7 @@ void GenGC::sizeDiagnosticCensus() {
       acceptor.diagnostic.asciiStr.totalChars += strprim->getStringLength();
     } else if (
         cell->getKind() == CellKind::DynamicUTF16StringPrimitiveKind ||
+        cell->getKind() == CellKind::SlicedUTF16StringPrimitiveKind ||
         cell->getKind() == CellKind::DynamicUniquedUTF16StringPrimitiveKind ||
         cell->getKind() == CellKind::ExternalUTF16StringPrimitiveKind) {
       acceptor.diagnostic.utf16Str.count++;
@@ -13,6 +13,7 @@
 #include "hermes/Public/GCConfig.h"
 
 #include <memory>
+#include <string>
 
 #ifdef HERMESVM_SERIALIZE
 #include <vector>
@@ -75,6 +76,27 @@ class Deserializer;
   /* all bytecode buffers > 64 kB passed to Hermes must be mmap:ed. */ \
   F(constexpr, bool, TrackIO, false)                                   \
                                                                        \
+  /* Prefetch the string table and global function of bytecode. */     \
+  F(constexpr, bool, BytecodePrefetchStartup, false)                   \
+                                                                       \
+  /* Read ahead this many bytes of function bodies on load, where */   \
+  /* the bodies run at startup are laid out by a function order. */    \
+  F(constexpr, unsigned, BytecodeStartupReadahead, 0)                  \
+                                                                       \
+  /* Advise the OS that the rest of the bytecode is read randomly. */  \
+  F(constexpr, bool, BytecodeRandomAccess, false)                      \
+                                                                       \
+  /* Let the OS reclaim bytecode pages of unused functions at TTI. */  \
+  F(constexpr, bool, BytecodeReleaseColdAtTTI, false)                  \
+                                                                       \
+  /* Compile lazy functions on a background thread before their */     \
+  /* first call. */                                                    \
+  F(constexpr, bool, PrewarmLazyFunctions, false)                      \
+                                                                       \
+  /* If set, a directory where bytecode compiled from source by the */ \
+  /* JSI runtime is cached, and reused by later runtimes. */           \
+  F(HERMES_NON_CONSTEXPR, std::string, BytecodeCacheDirectory, "")     \
+                                                                       \
   /* An interface for managing crashes. */                             \
   F(HERMES_NON_CONSTEXPR,                                              \
     std::shared_ptr<CrashManager>,                                     \
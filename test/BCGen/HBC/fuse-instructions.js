@@ -0,0 +1,57 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -fuse-instructions -dump-bytecode %s | %FileCheck %s
+// RUN: %hermes -O -dump-bytecode %s | %FileCheck --check-prefix=NOFUSE %s
+
+// Loading a method and calling it with up to one argument is emitted as a
+// single instruction.
+
+function call0(o) {
+  return o.m0();
+}
+// CHECK-LABEL: Function<call0>
+// CHECK-NOT: GetByIdShort
+// CHECK: GetByIdCall1 {{ *}}r{{[0-9]+}}, r{{[0-9]+}}, r{{[0-9]+}}, {{[0-9]+}}, "m0"
+// CHECK-NEXT: Ret
+
+// NOFUSE-LABEL: Function<call0>
+// NOFUSE: GetByIdShort {{.*}}, "m0"
+// NOFUSE-NEXT: Call1
+
+// The constant argument is loaded before the method.
+function call1(o) {
+  return o.m1(10);
+}
+// CHECK-LABEL: Function<call1>
+// CHECK: LoadConstUInt8 {{.*}}, 10
+// CHECK-NEXT: GetByIdCall2 {{ *}}r{{[0-9]+}}, r{{[0-9]+}}, r{{[0-9]+}}, {{[0-9]+}}, "m1", r{{[0-9]+}}
+// CHECK-NEXT: Ret
+
+// The parameter is loaded before the method.
+function callParam(o, a) {
+  return o.m4(a);
+}
+// CHECK-LABEL: Function<callParam>
+// CHECK: LoadParam {{.*}}, 2
+// CHECK-NEXT: GetByIdCall2 {{ *}}r{{[0-9]+}}, r{{[0-9]+}}, r{{[0-9]+}}, {{[0-9]+}}, "m4", r{{[0-9]+}}
+// CHECK-NEXT: Ret
+
+// Too many arguments.
+function call2(o, a, b) {
+  return o.m2(a, b);
+}
+// CHECK-LABEL: Function<call2>
+// CHECK: GetByIdShort {{.*}}, "m2"
+// CHECK: Call3
+
+// The method is not called with the object it was loaded from.
+function detached(o, a) {
+  var f = o.m3;
+  return f(a);
+}
+// CHECK-LABEL: Function<detached>
+// CHECK: GetByIdShort {{.*}}, "m3"
+// CHECK: Call2
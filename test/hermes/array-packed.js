@@ -0,0 +1,90 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Builtins take shortcuts on packed arrays, which must not be observable.
+
+print('packed arrays');
+// CHECK-LABEL: packed arrays
+
+var ints = [1, 2, 3, 2, 1];
+print(ints.indexOf(2), ints.lastIndexOf(2), ints.indexOf(2.5), ints.indexOf('2'));
+// CHECK-NEXT: 1 3 -1 -1
+print(ints.indexOf(-0), ints.includes(NaN), ints.indexOf(1, -2));
+// CHECK-NEXT: -1 false 4
+var doubles = [0.5, -0, NaN, 3];
+print(doubles.indexOf(0), doubles.indexOf(NaN), doubles.includes(NaN));
+// CHECK-NEXT: 1 -1 true
+print(doubles.includes(0), doubles.lastIndexOf(3, -2), doubles.indexOf(3, 10));
+// CHECK-NEXT: true -1 -1
+var o = {};
+var any = ['a', o, 1, undefined];
+print(any.indexOf(o), any.indexOf('a'), any.includes(undefined));
+// CHECK-NEXT: 1 0 true
+
+// Holes are looked up on the prototype chain.
+Array.prototype[1] = 'proto';
+var holey = [0, , 2];
+print(holey.indexOf('proto'), holey.includes('proto'));
+// CHECK-NEXT: 1 true
+print(holey.map(function(x) { return x; }));
+// CHECK-NEXT: 0,proto,2
+delete Array.prototype[1];
+
+// The fromIndex conversion may shrink the array.
+var shrink = [1, 2, 3, 4];
+Array.prototype[3] = 4;
+print(shrink.indexOf(4, {valueOf: function() { shrink.length = 2; return 0; }}));
+// CHECK-NEXT: 3
+delete Array.prototype[3];
+
+// Callbacks may modify the array while it is being iterated.
+var a = [1, 2, 3, 4];
+var seen = [];
+a.forEach(function(x, i) {
+  seen.push(x);
+  if (i === 0) a.pop();
+  if (i === 1) a[2] = 30;
+});
+print(seen);
+// CHECK-NEXT: 1,2,30
+a = [1, 2, 3];
+print(a.map(function(x, i) {
+  if (i === 0) delete a[1];
+  return x * 2;
+}));
+// CHECK-NEXT: 2,,6
+a = [1, 2, 3, 4];
+print(a.reduce(function(acc, x, i) {
+  if (i === 1) a.length = 3;
+  return acc + x;
+}));
+// CHECK-NEXT: 6
+
+// fill on packed, frozen and holey arrays.
+a = [1, 2, 3, 4];
+print(a.fill(0, 1, 3), a.fill('x', -1));
+// CHECK-NEXT: 1,0,0,x 1,0,0,x
+var frozen = Object.freeze([1, 2]);
+try {
+  frozen.fill(0);
+} catch (e) {
+  print('caught', e.name);
+}
+// CHECK-NEXT: caught TypeError
+print(frozen);
+// CHECK-NEXT: 1,2
+var called = 0;
+Object.defineProperty(Array.prototype, 1, {
+  set: function(v) { called++; },
+  configurable: true,
+});
+var h = [0, , 2];
+h.fill(7);
+print(h[0], h.hasOwnProperty(1), h[2], called);
+// CHECK-NEXT: 7 false 7 1
+delete Array.prototype[1];
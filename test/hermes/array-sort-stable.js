@@ -0,0 +1,112 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+print('sort stability');
+// CHECK-LABEL: sort stability
+
+function checkStable(n, mod, prep) {
+  var a = [];
+  for (var i = 0; i < n; i++) a.push({key: (i * 7919) % mod, idx: i});
+  if (prep) prep(a);
+  var before = a.slice();
+  a.sort(function(x, y) { return x.key - y.key; });
+  for (var i = 1; i < n; i++) {
+    var x = a[i - 1], y = a[i];
+    if (x.key > y.key) return 'unsorted at ' + i;
+    if (x.key === y.key && before.indexOf(x) > before.indexOf(y))
+      return 'unstable at ' + i;
+  }
+  return 'ok';
+}
+
+print(checkStable(10, 3));
+// CHECK-NEXT: ok
+print(checkStable(1000, 10));
+// CHECK-NEXT: ok
+print(checkStable(1000, 997, function(a) {
+  a.sort(function(x, y) { return x.key - y.key; });
+  a.reverse();
+}));
+// CHECK-NEXT: ok
+print(checkStable(2000, 50, function(a) {
+  a.sort(function(x, y) { return x.key - y.key; });
+  var t = a[5]; a[5] = a[1500]; a[1500] = t;
+}));
+// CHECK-NEXT: ok
+
+(function() {
+  // Presorted input only needs n - 1 comparisons.
+  var a = [];
+  for (var i = 0; i < 1000; i++) a.push(i);
+  var count = 0;
+  a.sort(function(x, y) { count++; return x - y; });
+  print(count);
+// CHECK-NEXT: 999
+  // Strictly descending input is reversed in place.
+  a.reverse();
+  count = 0;
+  a.sort(function(x, y) { count++; return x - y; });
+  print(count, a[0], a[999]);
+// CHECK-NEXT: 999 0 999
+})();
+
+(function() {
+  // An exception from the comparator stops the sort.
+  var a = [];
+  for (var i = 0; i < 100; i++) a.push(100 - i);
+  try {
+    a.sort(function(x, y) {
+      if (x === 50) throw new Error('stop');
+      return x - y;
+    });
+  } catch (e) {
+    print('caught', e.message);
+  }
+// CHECK-NEXT: caught stop
+})();
+
+print('default comparator');
+// CHECK-LABEL: default comparator
+
+print([10, 9, 1, 100, 2, 0, 1000000, 99].sort());
+// CHECK-NEXT: 0,1,10,100,1000000,2,9,99
+print([-1, 1.5, NaN, Infinity, -Infinity, 1e21, 15, 1, -0].sort());
+// CHECK-NEXT: -1,-Infinity,0,1,1.5,15,1e+21,Infinity,NaN
+print([4294967295, 4294967294, 429496729, 42949672950].sort());
+// CHECK-NEXT: 429496729,4294967294,4294967295,42949672950
+print(['b', 'a', 'ab', '', 'B', 'é', 'aa'].sort().join('|'));
+// CHECK-NEXT: |B|a|aa|ab|b|é
+print(['b', 1, 'a', 10, 2].sort());
+// CHECK-NEXT: 1,10,2,a,b
+var holes = ['c', , 'a', undefined, 'b'];
+holes.sort();
+print(holes, holes.length, 1 in holes, 4 in holes);
+// CHECK-NEXT: a,b,c,, 5 true false
+
+print('typed array sort');
+// CHECK-LABEL: typed array sort
+
+print(Array.from(new Int8Array([5, -128, 127, 0, -1, 5]).sort()));
+// CHECK-NEXT: -128,-1,0,5,5,127
+print(Array.from(new Uint8Array([200, 3, 255, 0, 3]).sort()));
+// CHECK-NEXT: 0,3,3,200,255
+print(Array.from(new Uint8ClampedArray([2, 1]).sort()));
+// CHECK-NEXT: 1,2
+print(Array.from(new Int32Array([3, -2147483648, 2147483647, -1]).sort()));
+// CHECK-NEXT: -2147483648,-1,3,2147483647
+print(Array.from(new Uint32Array([4294967295, 0, 7]).sort()));
+// CHECK-NEXT: 0,7,4294967295
+var f = new Float64Array([NaN, 1, -0, 0, -Infinity, NaN, -5, Infinity]).sort();
+print(Array.from(f), 1 / f[2], 1 / f[3]);
+// CHECK-NEXT: -Infinity,-5,0,0,1,Infinity,NaN,NaN -Infinity Infinity
+print(Array.from(new Float32Array([2.5, NaN, -2.5]).sort()));
+// CHECK-NEXT: -2.5,2.5,NaN
+print(Array.from(new Int16Array([3, 2, 1]).sort(function(a, b) {
+  return b - a;
+})));
+// CHECK-NEXT: 3,2,1
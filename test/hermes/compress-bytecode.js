@@ -0,0 +1,47 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -target=HBC -emit-binary -compress-bytecode -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -target=HBC -emit-binary -compress-bytecode -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Function bodies are decompressed when they are first called, and the debug
+// info when it is first needed.
+
+print('start');
+// CHECK: start
+
+function classify(x) {
+  switch (x) {
+    case 0: return 'zero';
+    case 1: return 'one';
+    case 2: return 'two';
+    case 3: return 'three';
+    case 4: return 'four';
+    case 5: return 'five';
+    case 6: return 'six';
+    default: return 'many';
+  }
+}
+var names = [];
+for (var i = 0; i < 8; i++)
+  names.push(classify(i));
+print(names.join());
+// CHECK-NEXT: zero,one,two,three,four,five,six,many
+
+function thrower() {
+  throw new Error('boom');
+}
+try {
+  thrower();
+} catch (e) {
+  print(e.message, /compress-bytecode.js:(\d+)/.exec(e.stack)[1]);
+}
+// CHECK-NEXT: boom 34
+
+var sum = 0;
+for (var i = 0; i < 100; i++)
+  sum += (function(n) { return n * 2; })(i);
+print(sum);
+// CHECK-NEXT: 9900
@@ -0,0 +1,75 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -fuse-instructions %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -fuse-instructions -target=HBC -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Method calls fused with the load of the method behave like a GetById
+// followed by a call.
+
+print('start');
+// CHECK: start
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+Point.prototype.len = function() {
+  return this.x + this.y;
+};
+Point.prototype.scale = function(k) {
+  return new Point(this.x * k, this.y * k);
+};
+
+// Methods found in the prototype, with a warm cache.
+var sum = 0;
+for (var i = 0; i < 100; ++i) {
+  var p = new Point(i, 1);
+  sum += p.scale(2).len();
+}
+print(sum);
+// CHECK-NEXT: 10100
+
+// An own method shadowing the prototype.
+var q = new Point(1, 2);
+q.len = function() {
+  return 'own';
+};
+print(q.len(), new Point(3, 4).len());
+// CHECK-NEXT: own 7
+
+// A getter runs once, before the arguments are passed.
+var count = 0;
+var o = {
+  get m() {
+    ++count;
+    // Calls in the getter use the same stack as the arguments.
+    Math.max(1, 2, 3, 4, 5, 6);
+    return function(a) {
+      return this === o && a;
+    };
+  },
+};
+print(o.m(7), count);
+// CHECK-NEXT: 7 1
+
+// Primitive values.
+print((255).toString(16), 'abc'.charAt(1));
+// CHECK-NEXT: ff b
+
+// Errors.
+try {
+  o.missing(1);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+try {
+  var n = null;
+  n.m();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
@@ -0,0 +1,104 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Iterators of Map and Set must keep their position while the underlying
+// table is mutated, compacted, grown, shrunk or cleared.
+
+print('map iterator mutation');
+// CHECK-LABEL: map iterator mutation
+
+(function() {
+  var m = new Map();
+  for (var i = 0; i < 4; i++) m.set(i, i);
+  var it = m.keys();
+  print(it.next().value);
+// CHECK-NEXT: 0
+  m.delete(0);
+  m.delete(1);
+  print(it.next().value);
+// CHECK-NEXT: 2
+  m.set(4, 4);
+  print(it.next().value, it.next().value, it.next().done);
+// CHECK-NEXT: 3 4 true
+  m.set(5, 5);
+  print(it.next().done);
+// CHECK-NEXT: true
+})();
+
+(function() {
+  // Shrink the table several times, then grow it, while iterating.
+  var m = new Map();
+  for (var i = 0; i < 100; i++) m.set(i, i);
+  var it = m.values();
+  for (var i = 0; i < 10; i++) it.next();
+  for (var i = 0; i < 90; i++) m.delete(i);
+  print(it.next().value);
+// CHECK-NEXT: 90
+  for (var i = 100; i < 1000; i++) m.set(i, i);
+  var count = 1;
+  var last;
+  for (var r = it.next(); !r.done; r = it.next()) {
+    count++;
+    last = r.value;
+  }
+  print(count, last, m.size);
+// CHECK-NEXT: 910 999 910
+})();
+
+(function() {
+  var s = new Set([1, 2, 3]);
+  var it = s.values();
+  print(it.next().value);
+// CHECK-NEXT: 1
+  s.clear();
+  s.add(5);
+  print(it.next().value, it.next().done);
+// CHECK-NEXT: 5 true
+})();
+
+(function() {
+  var s = new Set([1, 2, 3]);
+  var seen = [];
+  s.forEach(function(v) {
+    seen.push(v);
+    if (v === 1) {
+      s.delete(2);
+      s.add(4);
+    }
+  });
+  print(seen);
+// CHECK-NEXT: 1,3,4
+})();
+
+(function() {
+  // Keep a single live entry while cycling through many keys, which
+  // compacts the table without growing it.
+  var m = new Map();
+  for (var i = 0; i < 1000; i++) {
+    m.set('k' + i, i);
+    m.delete('k' + (i - 1));
+  }
+  print(m.size, m.get('k999'), m.has('k998'));
+// CHECK-NEXT: 1 999 false
+  var entries = m.entries().next().value;
+  print(entries[0], entries[1]);
+// CHECK-NEXT: k999 999
+})();
+
+(function() {
+  var m = new Map();
+  m.set(-0, 'zero');
+  m.set(NaN, 'nan');
+  print(m.get(0), m.get(NaN), m.size);
+// CHECK-NEXT: zero nan 2
+  var o = {};
+  m.set(o, 'obj');
+  m.delete(-0);
+  print(m.get(o), m.has(0), Array.from(m.keys()).length);
+// CHECK-NEXT: obj false 2
+})();
@@ -0,0 +1,30 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+print('number conversions');
+// CHECK-LABEL: number conversions
+
+print(String(-42), String(2 ** 53), String(2 ** 60), String(0.1 + 0.2));
+// CHECK-NEXT: -42 9007199254740992 1152921504606847000 0.30000000000000004
+print(String(5e-324), String(1.7976931348623157e308), String(1e21));
+// CHECK-NEXT: 5e-324 1.7976931348623157e+308 1e+21
+
+// Template literals format numbers without converting them to strings first.
+var x = 1.5, n = -7;
+print(`x=${x}, n=${n}, big=${1e300}, ${'s'}${NaN}${-0}`);
+// CHECK-NEXT: x=1.5, n=-7, big=1e+300, sNaN0
+
+print(JSON.stringify([0, -0, 1 / 3, -1e-7, 123456789012, Infinity]));
+// CHECK-NEXT: [0,0,0.3333333333333333,-1e-7,123456789012,null]
+
+print(+'  3.25 ', +'-.5', +'1.', +'1e', +'9007199254740993', +'4.9e-324');
+// CHECK-NEXT: 3.25 -0.5 1 NaN 9007199254740992 5e-324
+print(+'123456789012345678901234', +'1e400', +'0x1F', +'1_0');
+// CHECK-NEXT: 1.2345678901234569e+23 Infinity 31 NaN
+
+print(JSON.parse('[0.1, -2.5e3, 1e-400, 12345678901234567890]').join());
+// CHECK-NEXT: 0.1,-2500,0,12345678901234567000
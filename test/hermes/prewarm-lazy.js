@@ -0,0 +1,58 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -lazy -prewarm-lazy -non-strict %s | %FileCheck --match-full-lines %s
+
+// Lazy functions may be compiled in the background before their first call,
+// or by their first call, in any interleaving.
+
+function outer(n) {
+  function inner(x) {
+    /* Some text to pad out the function so that it won't be eagerly compiled
+     * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+     * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+     */
+    return x * n;
+  }
+  function unused() {
+    /* Some text to pad out the function so that it won't be eagerly compiled
+     * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+     * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+     */
+    print("unused");
+  }
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  return inner(2) + inner(3);
+}
+
+function thrower() {
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  throw new Error("boom");
+}
+
+print("main");
+// CHECK-LABEL: main
+
+var sum = 0;
+for (var i = 0; i < 10; i++)
+  sum += outer(i);
+print(sum);
+// CHECK-NEXT: 225
+
+try {
+  thrower();
+} catch (e) {
+  print(e.message, /prewarm-lazy.js:(\d+)/.exec(e.stack)[1]);
+}
+// CHECK-NEXT: boom 38
+
+print(eval("(function() { return outer(10); })()"));
+// CHECK-NEXT: 50
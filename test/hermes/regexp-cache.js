@@ -0,0 +1,73 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// RegExps created from the same source share compiled bytecode.
+
+print('regexp cache');
+// CHECK-LABEL: regexp cache
+
+function stats() {
+  var s = HermesInternal.getInstrumentedStats();
+  return [s.js_regExpCacheHits, s.js_regExpCacheMisses, s.js_regExpCacheSize];
+}
+
+var before = stats();
+function delta() {
+  var now = stats();
+  return [now[0] - before[0], now[1] - before[1], now[2] - before[2]];
+}
+
+for (var i = 0; i < 10; i++) {
+  var re = new RegExp('a(b+)c', 'g');
+  re.lastIndex = 0;
+  print(re.exec('xabbc')[1], re.lastIndex);
+}
+// CHECK-COUNT-10: bb 5
+print(delta());
+// CHECK-NEXT: 9,1,1
+
+// Flags which affect compilation are part of the key; 'g' and 'y' are not.
+print(new RegExp('a(b+)c', 'i').test('ABC'), new RegExp('a(b+)c').test('ABC'));
+// CHECK-NEXT: true false
+print(new RegExp('a(b+)c', 'y').sticky, new RegExp('a(b+)c', 'm').multiline);
+// CHECK-NEXT: true true
+print(delta());
+// CHECK-NEXT: 11,3,3
+
+// String methods which create a RegExp use the cache too.
+print('xabcx'.search('a(b+)c'), 'xabcx'.match('a(b+)c')[1]);
+// CHECK-NEXT: 1 b
+print(delta());
+// CHECK-NEXT: 13,3,3
+
+// Invalid patterns are not cached.
+for (var i = 0; i < 2; i++) {
+  try {
+    new RegExp('(');
+  } catch (e) {
+    print(e.name);
+  }
+}
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
+print(delta());
+// CHECK-NEXT: 13,5,3
+
+// Many distinct patterns evict the least recently used entries.
+for (var i = 0; i < 100; i++) new RegExp('p' + i);
+print(stats()[2]);
+// CHECK-NEXT: 64
+print(new RegExp('p99').test('p99'), new RegExp('p0').test('p0'));
+// CHECK-NEXT: true true
+
+// A RegExp keeps its bytecode alive after its entry is evicted.
+var kept = new RegExp('kept(\\d+)');
+for (var i = 0; i < 100; i++) new RegExp('q' + i);
+print(kept.exec('kept42')[1]);
+// CHECK-NEXT: 42
+print(HermesInternal.getInstrumentedStats().js_regExpCacheMallocSize > 0);
+// CHECK-NEXT: true
@@ -0,0 +1,42 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+print('sliced strings');
+// CHECK-LABEL: sliced strings
+
+// Long substrings share the storage of the string they are taken from. They
+// must stay valid after the original string is otherwise unreachable.
+function makeSlices() {
+  var text = '';
+  for (var i = 0; i < 2000; ++i)
+    text += 'line ' + i + ': the quick brown fox jumps over the lazy dog\n';
+  return [
+    text.slice(100, 200),
+    text.substring(5000, 5100).substr(10, 50),
+    /line 1999: .*/.exec(text)[0],
+    ('é' + text).slice(1, 60),
+  ];
+}
+var slices = makeSlices();
+gc();
+for (var i = 0; i < slices.length; ++i)
+  print(slices[i].length, JSON.stringify(slices[i].slice(0, 20)));
+// CHECK-NEXT: 100 "dog\nline 2: the quic"
+// CHECK-NEXT: 50 "r the lazy dog\nline "
+// CHECK-NEXT: 54 "line 1999: the quick"
+// CHECK-NEXT: 59 "line 0: the quick br"
+
+// Slices behave like any other string.
+var s = slices[2];
+var o = {};
+o[s] = 1;
+print(o['line 1999: the quick brown fox jumps over the lazy dog'], s + '!');
+// CHECK-NEXT: 1 line 1999: the quick brown fox jumps over the lazy dog!
+print(s === 'line 1999: the quick brown fox jumps over the lazy dog');
+// CHECK-NEXT: true
+print(s.indexOf('fox'), s.split(' ').length, s.toUpperCase().slice(-8));
+// CHECK-NEXT: 27 11 LAZY DOG
@@ -0,0 +1,40 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+print('string search');
+// CHECK-LABEL: string search
+
+// Long haystacks and needles take the Boyer-Moore-Horspool path.
+var hay = 'ab'.repeat(5000) + 'needle in a haystack' + 'ab'.repeat(100);
+var needle = 'needle in a haystack';
+print(hay.indexOf(needle), hay.lastIndexOf(needle), hay.includes(needle));
+// CHECK-NEXT: 10000 10000 true
+print(hay.indexOf(needle, 10001), hay.lastIndexOf(needle, 9999));
+// CHECK-NEXT: -1 -1
+print(hay.indexOf('abababababc'), hay.includes('needle in a haystacks'));
+// CHECK-NEXT: -1 false
+print(hay.split(needle).length, hay.replace(needle, '!').length);
+// CHECK-NEXT: 2 10201
+
+// Two-byte strings, and needles of a different width than the haystack.
+var wide = 'šš'.repeat(300) + 'ša' + 'ɡš'.repeat(300);
+print(wide.indexOf('ša'), wide.indexOf('ššššššššša'), wide.lastIndexOf('š'));
+// CHECK-NEXT: 600 592 1201
+print(wide.indexOf('a'), wide.indexOf('ab'), wide.indexOf('aɡ'));
+// CHECK-NEXT: 601 -1 601
+print('cafe'.indexOf('é'), 'café'.indexOf('e'), 'café'.indexOf('fé'));
+// CHECK-NEXT: -1 -1 2
+print('xšy'.split('š').join(), 'xšy'.split('ɡ').length);
+// CHECK-NEXT: x,y 1
+print('abc'.indexOf('š'), 'abc'.lastIndexOf('š'), 'abc'.includes('š'));
+// CHECK-NEXT: -1 -1 false
+
+// Empty needles match at the start position, clamped to the length.
+print('abc'.indexOf('', 2), 'abc'.indexOf('', 10), 'abc'.lastIndexOf('', 1));
+// CHECK-NEXT: 2 3 1
+print('abc'.lastIndexOf(''), ''.indexOf(''), ''.includes(''));
+// CHECK-NEXT: 3 0 true
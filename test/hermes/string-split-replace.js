@@ -0,0 +1,46 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+print('split and replace with strings');
+// CHECK-LABEL: split and replace with strings
+
+print(JSON.stringify('a,b,,c,'.split(',')));
+// CHECK-NEXT: ["a","b","","c",""]
+print(JSON.stringify(',a,b'.split(',', 2)), ',a,b'.split(',', 0).length);
+// CHECK-NEXT: ["","a"] 0
+print(JSON.stringify('a::b::c'.split('::', 3)));
+// CHECK-NEXT: ["a","b","c"]
+print(JSON.stringify('abc'.split('')), JSON.stringify('abc'.split('', 2)));
+// CHECK-NEXT: ["a","b","c"] ["a","b"]
+print(JSON.stringify('abc'.split('abc')), JSON.stringify('abc'.split('x')));
+// CHECK-NEXT: ["",""] ["abc"]
+print(JSON.stringify('aaa'.split('aa')), JSON.stringify('é,ü'.split(',')));
+// CHECK-NEXT: ["","a"] ["é","ü"]
+print(JSON.stringify('x1y1z'.split(1)), JSON.stringify(''.split(',')));
+// CHECK-NEXT: ["x","y","z"] [""]
+
+// Split a large CSV-like string into lines and fields.
+var lines = [];
+for (var i = 0; i < 10000; ++i)
+  lines.push(i + ',' + (i * 2) + ',name' + i);
+var rows = lines.join('\n').split('\n');
+var sum = 0;
+for (var i = 0; i < rows.length; ++i)
+  sum += +rows[i].split(',')[1];
+print(rows.length, sum, rows[9999]);
+// CHECK-NEXT: 10000 99990000 9999,19998,name9999
+
+print('abcabc'.replace('b', 'X'), 'abc'.replace('', '-'));
+// CHECK-NEXT: aXcabc -abc
+print('abc'.replace('d', 'X'), 'abc'.replace('abc', '').length);
+// CHECK-NEXT: abc 0
+print('abc'.replace('b', 'é'), 'ébc'.replace('b', 'x'));
+// CHECK-NEXT: aéc éxc
+print('abc'.replace('b', '[$&$`$\'$$]'), 'abc'.replace('b', '$'));
+// CHECK-NEXT: a[bac$]c a$c
+print('abc'.replace('b', function(m, pos, s) { return m + pos + s; }));
+// CHECK-NEXT: ab1abcc
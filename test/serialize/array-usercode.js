@@ -39,6 +39,11 @@ a3[5] = 100;
 a4 = [];
 a4[4294967294] = 1;
 
+// Large enough to store its elements in segments.
+a5 = [];
+for (var i = 0; i < 10000; ++i)
+  a5.push(i);
+
 serializeVM(function() {
   print(className(a), a.length);
   //CHECK: [object Array] 0
@@ -86,4 +91,7 @@ serializeVM(function() {
   print(a4.length);
   //CHECK-NEXT: 4294967295
 
+  print(a5.length, a5[0], a5[4999], a5[9999]);
+  //CHECK-NEXT: 10000 0 4999 9999
+
 })
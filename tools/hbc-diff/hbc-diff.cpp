@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <unordered_map>
 
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
@@ -122,6 +123,8 @@ static ExecutionStatus diffFiles(
     uint32_t lastFuncId = 0;
     for (uint32_t funcId = 0; funcId < functionCount; ++funcId) {
       auto funcStart = bytecode->getBytecode(funcId);
+      // Function bodies may be laid out in any order.
+      start = std::min(start, funcStart);
       if (funcStart > lastFuncStart) {
         lastFuncStart = funcStart;
         lastFuncId = funcId;
@@ -11,6 +11,7 @@
 #include "hermes/BCGen/HBC/HBC.h"
 #include "hermes/Parser/JSONParser.h"
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -226,6 +227,17 @@ ProfileData ProfileAnalyzer::deserializeTrace(
       profileData
           .executionInfo[checksum->str()][(uint16_t)profileIndex->getValue()] =
           executionCount->getValue();
+      auto *order = dyn_cast<JSONNumber>(basicBlock->at("order"));
+      checkInvalidTraceObjectAndExit(order, "fail to fetch 'order' field");
+      // Blocks which never ran have order 0.
+      if (order->getValue() > 0) {
+        auto res = profileData.firstExecution.emplace(
+            checksum->str(), (uint64_t)order->getValue());
+        if (!res.second) {
+          res.first->second =
+              std::min(res.first->second, (uint64_t)order->getValue());
+        }
+      }
     }
   }
   return profileData;
@@ -648,10 +660,16 @@ void ProfileAnalyzer::dumpIO() {
   os_ << executionInfo.size() << " functions accessed out of total "
       << funcCount << " functions\n";
 
-  uint32_t funcRegionStartOffset = bcProvider->getFunctionHeader(0).offset();
-  uint32_t funcRegionEndOffset =
-      bcProvider->getFunctionHeader(funcCount - 1).offset() +
-      bcProvider->getFunctionHeader(funcCount - 1).bytecodeSizeInBytes() - 1;
+  // Function bodies may be laid out in any order, so find the extremes.
+  uint32_t funcRegionStartOffset = UINT32_MAX;
+  uint32_t funcRegionEndOffset = 0;
+  for (uint32_t funcId = 0; funcId < funcCount; ++funcId) {
+    hbc::RuntimeFunctionHeader header = bcProvider->getFunctionHeader(funcId);
+    funcRegionStartOffset = std::min(funcRegionStartOffset, header.offset());
+    funcRegionEndOffset = std::max(
+        funcRegionEndOffset,
+        header.offset() + header.bytecodeSizeInBytes() - 1);
+  }
 
   uint32_t funcRegionStartPage = getPageIndexFromOffset(funcRegionStartOffset);
   uint32_t funcRegionEndPage = getPageIndexFromOffset(funcRegionEndOffset);
@@ -696,6 +714,34 @@ void ProfileAnalyzer::dumpIO() {
   os_ << "\n";
 }
 
+void ProfileAnalyzer::dumpFunctionOrder() {
+  if (!profileDataOpt_.hasValue()) {
+    os_ << "This command requires trace profile to run.\n";
+    return;
+  }
+  auto &firstExecution = profileDataOpt_.getValue().firstExecution;
+  // Pairs of <first_execution, function_id>.
+  std::vector<std::pair<uint64_t, unsigned>> order;
+  forEachTracedFunction(
+      [this, &firstExecution, &order](
+          std::shared_ptr<hbc::BCProvider> bcProvider,
+          std::unordered_map<uint16_t, uint64_t> &funcExecInfo,
+          ProfileIndexMap &profileIndexMap,
+          unsigned funcId) {
+        auto it =
+            firstExecution.find(hbcParser_.getFunctionChecksum(funcId).str());
+        if (it != firstExecution.end()) {
+          order.emplace_back(it->second, funcId);
+        }
+      });
+  // Unmatched checksums are not reported, so that the output can be passed to
+  // hermesc as is.
+  std::sort(order.begin(), order.end());
+  for (const auto &entry : order) {
+    os_ << entry.second << "\n";
+  }
+}
+
 void ProfileAnalyzer::dumpEpilogue() {
   llvm::ArrayRef<uint8_t> epilogue = hbcParser_.getBCProvider()->getEpilogue();
   std::string epiStr(
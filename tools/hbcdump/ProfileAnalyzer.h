@@ -31,6 +31,9 @@ struct ProfileData {
   uint32_t pageSize;
   // Function execution information.
   ExecutionInfo executionInfo;
+  // Maps func_checksum to the sequence number of the first of its basic blocks
+  // to execute.
+  std::unordered_map<std::string, uint64_t> firstExecution;
 };
 
 // Function runtime profile statistics.
@@ -134,6 +137,9 @@ class ProfileAnalyzer {
   void dumpFunctionBasicBlockStat(unsigned funcId);
   // Print page I/O access information.
   void dumpIO();
+  // Print the IDs of the executed functions in the order they first ran, one
+  // per line, as expected by the -function-order-file option of hermesc.
+  void dumpFunctionOrder();
   // Print the string corresponding to \p stringID.
   void dumpString(uint32_t stringID) {
     os_ << hbcParser_.getBCProvider()->getStringRefFromID(stringID);
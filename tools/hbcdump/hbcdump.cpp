@@ -135,6 +135,12 @@ static void printHelp(llvm::Optional<llvm::StringRef> command = llvm::None) {
       {"block",
        "Display top hot basic blocks in sorted order.\n\n"
        "USAGE: block\n"},
+      {"function-order",
+       "Print the IDs of the functions in the basic block profile trace "
+       "in the order they first executed, one per line. Pass the output "
+       "to the -function-order-file option of hermesc to lay out their "
+       "bodies first.\n\n"
+       "USAGE: function-order\n"},
       {"at-virtual",
        "Display information about the function at a given virtual offset.\n\n"
        "USAGE: at-virtual <OFFSET> [-json]\n"},
@@ -326,6 +332,8 @@ static bool executeCommand(
     analyzer.dumpSummary();
   } else if (command == "block") {
     analyzer.dumpBasicBlockStats();
+  } else if (command == "function-order") {
+    analyzer.dumpFunctionOrder();
   } else if (command == "at_virtual" || command == "at-virtual") {
     bool json = findAndRemoveOne(commandTokens, "-json");
     std::unique_ptr<StructuredPrinter> printer =
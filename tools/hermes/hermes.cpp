@@ -120,6 +120,11 @@ static int executeHBCBytecodeFromCL(
           .withEnableSampleProfiling(cl::SampleProfiling)
           .withRandomizeMemoryLayout(cl::RandomizeMemoryLayout)
           .withTrackIO(cl::TrackBytecodeIO)
+          .withBytecodePrefetchStartup(cl::BytecodePrefetchStartup)
+          .withBytecodeStartupReadahead(cl::BytecodeStartupReadahead)
+          .withBytecodeRandomAccess(cl::BytecodeRandomAccess)
+          .withBytecodeReleaseColdAtTTI(cl::BytecodeReleaseColdAtTTI)
+          .withPrewarmLazyFunctions(cl::PrewarmLazyFunctions)
           .build();
 
   options.basicBlockProfiling = cl::BasicBlockProfiling;
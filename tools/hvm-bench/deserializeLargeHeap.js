@@ -0,0 +1,48 @@
+// Builds a large heap of objects, arrays, strings and closures, and then
+// serializes it, to measure how long restoring a heap takes compared to
+// rebuilding it. Requires a build with HERMESVM_SERIALIZE:
+//   hermes -O -serializevm-path=heap.sd deserializeLargeHeap.js
+//   hermes -O -gc-init-heap=128M -deserialize-file=heap.sd -gc-print-stats \
+//     deserializeLargeHeap.js
+// The second command prints the time spent deserializing in its stats. The
+// initial heap must be large enough to hold the serialized heap.
+
+var numObjects = 100000;
+
+function makeNode(i) {
+  return {
+    id: i,
+    name: 'node' + i,
+    tags: ['t' + (i % 97), 't' + (i % 89)],
+    value: i * 1.5,
+    next: null,
+    get: function() {
+      return this.value;
+    },
+  };
+}
+
+var nodes = [];
+var prev = null;
+for (var i = 0; i < numObjects; i++) {
+  var node = makeNode(i);
+  if (prev)
+    prev.next = node;
+  prev = node;
+  nodes.push(node);
+}
+
+var byName = new Map();
+for (var i = 0; i < nodes.length; i += 3)
+  byName.set(nodes[i].name, nodes[i]);
+
+var text = [];
+for (var i = 0; i < 1000; i++)
+  text.push('line ' + i + ': ' + JSON.stringify(nodes[i].tags));
+
+serializeVM(function() {
+  var sum = 0;
+  for (var i = 0; i < nodes.length; i += 1000)
+    sum += nodes[i].get() + byName.size + text[i % text.length].length;
+  print('done, sum =', sum);
+});
@@ -0,0 +1,20 @@
+var numIter = 200;
+var len = 5000;
+var numbers = [];
+for (var i = 0; i < len; i++) {
+  numbers.push(i, -i * 37, i / 8, i * 1.1, Math.sqrt(i) * 1e10, 1 / (i + 1));
+}
+
+// The purpose of this variable is so that the results are used, thus the
+// compiler wouldn't optimize out the conversions
+var sum = 0;
+
+for (var i = 0; i < numIter; i++) {
+  for (var j = 0; j < numbers.length; j++) {
+    sum += String(numbers[j]).length;
+    sum += `${numbers[j]}px`.length;
+  }
+  sum += JSON.stringify(numbers).length;
+}
+
+print('done, sum =', sum);
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// This benchmark compares the substring search used by the String builtins
+/// (hermes/Support/StringSearch.h) with the std::search over StringView
+/// iterators which they used before.
+///
+/// Each case searches a haystack of 8-bit or 16-bit code units for a needle
+/// which only occurs at its very end, and reports the best time of several
+/// runs for both searches.
+//===----------------------------------------------------------------------===//
+#include "hermes/Support/StringSearch.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/StringPrimitive.h"
+#include "hermes/VM/StringView.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace hermes;
+using namespace hermes::vm;
+
+namespace {
+
+static llvm::cl::opt<unsigned> HaystackLength{
+    "length",
+    llvm::cl::init(1 << 20),
+    llvm::cl::desc("Number of code units in the haystack")};
+static llvm::cl::opt<unsigned> Repeat{
+    "repeat",
+    llvm::cl::init(20),
+    llvm::cl::desc("Number of runs of each search")};
+
+/// A search case: the haystack is \c filler repeated, followed by \c needle.
+struct Case {
+  const char *name;
+  char filler;
+  std::string needle;
+};
+
+/// \return the best time of \c Repeat runs of \p search, in microseconds.
+/// Checks that each run returns \p expected.
+template <typename F>
+double timeSearch(F search, size_t expected) {
+  double best = 0;
+  for (unsigned i = 0; i < Repeat; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    size_t res = search();
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (res != expected) {
+      llvm::errs() << "wrong result " << res << ", expected " << expected
+                   << "\n";
+      exit(1);
+    }
+    if (i == 0 || elapsed.count() < best)
+      best = elapsed.count();
+  }
+  return best;
+}
+
+/// Run \p c on a haystack of 8-bit code units if \p wide is false, or 16-bit
+/// code units otherwise, and print the times.
+void runCase(Runtime *runtime, const Case &c, bool wide) {
+  GCScope scope(runtime);
+  size_t expected = HaystackLength - c.needle.size();
+  CallResult<HermesValue> hayRes{ExecutionStatus::EXCEPTION};
+  if (wide) {
+    std::u16string units(expected, c.filler);
+    units.append(c.needle.begin(), c.needle.end());
+    // Make it non-ASCII, without affecting where the needle is found.
+    units[0] = u'\u00e9';
+    hayRes = StringPrimitive::createEfficient(runtime, std::move(units));
+  } else {
+    std::string units(expected, c.filler);
+    units += c.needle;
+    hayRes = StringPrimitive::createEfficient(runtime, std::move(units));
+  }
+  if (hayRes == ExecutionStatus::EXCEPTION) {
+    llvm::errs() << "failed to allocate the haystack\n";
+    exit(1);
+  }
+  auto hay = runtime->makeHandle<StringPrimitive>(*hayRes);
+  auto needleRes = StringPrimitive::createEfficient(
+      runtime, createASCIIRef(c.needle.c_str()));
+  if (needleRes == ExecutionStatus::EXCEPTION) {
+    llvm::errs() << "failed to allocate the needle\n";
+    exit(1);
+  }
+  auto needle = runtime->makeHandle<StringPrimitive>(*needleRes);
+  StringView hayView = StringPrimitive::createStringView(runtime, hay);
+  StringView needleView = StringPrimitive::createStringView(runtime, needle);
+  assert(hayView.isASCII() == !wide && "unexpected haystack width");
+
+  // The search used by the String builtins before StringSearch.h.
+  double oldTime = timeSearch(
+      [&]() -> size_t {
+        auto it = std::search(
+            hayView.begin(),
+            hayView.end(),
+            needleView.begin(),
+            needleView.end());
+        return it == hayView.end() ? kSubstringNotFound : it - hayView.begin();
+      },
+      expected);
+
+  llvm::ArrayRef<char> needleUnits{needleView.castToCharPtr(),
+                                   needleView.length()};
+  double newTime = timeSearch(
+      [&]() -> size_t {
+        if (hayView.isASCII()) {
+          return searchSubstring(
+              llvm::makeArrayRef(hayView.castToCharPtr(), hayView.length()),
+              needleUnits);
+        }
+        return searchSubstring(
+            llvm::makeArrayRef(hayView.castToChar16Ptr(), hayView.length()),
+            needleUnits);
+      },
+      expected);
+
+  llvm::outs() << llvm::format(
+      "%-26s %6s %10.0f %10.0f %7.1fx\n",
+      c.name,
+      wide ? "16-bit" : "8-bit",
+      oldTime,
+      newTime,
+      oldTime / newTime);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Print a stack trace if we signal out.
+  llvm::sys::PrintStackTraceOnErrorSignal("Hermes driver");
+  llvm::PrettyStackTraceProgram X(argc, argv);
+  // Call llvm_shutdown() on exit to print stats and free memory.
+  llvm::llvm_shutdown_obj Y;
+  llvm::cl::ParseCommandLineOptions(argc, argv, "String search benchmark\n");
+
+  const Case cases[] = {
+      {"1 unit", 'a', "z"},
+      {"4 units", 'a', "wxyz"},
+      {"32 units, rare head", 'a', "z" + std::string(31, 'a')},
+      {"36 units, frequent head", 'a', std::string(35, 'a') + "z"},
+  };
+
+  auto runtime = Runtime::create(RuntimeConfig::Builder()
+                                     .withGCConfig(GCConfig::Builder()
+                                                       .withMaxHeapSize(1 << 26)
+                                                       .build())
+                                     .build());
+
+  llvm::outs() << "Haystack of " << HaystackLength
+               << " code units, best of " << Repeat << " runs (us)\n";
+  llvm::outs() << "needle                      width std::search       new"
+                  "  speedup\n";
+  for (const Case &c : cases) {
+    runCase(runtime.get(), c, false);
+    runCase(runtime.get(), c, true);
+  }
+  return 0;
+}
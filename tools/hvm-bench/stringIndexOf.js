@@ -0,0 +1,24 @@
+var numIter = 2000;
+var len = 10000;
+var text = 'lorem ipsum dolor sit amet, '.repeat(len / 28);
+var wideText = text.replace(/o/g, 'ö');
+
+// The needles are a single character, a short word and a long phrase, each of
+// which only occurs at the end of the text.
+var needles = ['#', '#end', 'consectetur adipiscing elit #end'];
+text += needles[2];
+wideText += needles[2];
+
+// The purpose of this variable is so that the return value from indexOf
+// is used, thus the compiler wouldn't optimize out the indexOf call
+var sum = 0;
+
+for (var i = 0; i < numIter; i++) {
+  for (var j = 0; j < needles.length; j++) {
+    sum += text.indexOf(needles[j]);
+    sum += wideText.indexOf(needles[j]);
+    sum += text.includes(needles[j]) ? 1 : 0;
+  }
+}
+
+print('done, sum =', sum);
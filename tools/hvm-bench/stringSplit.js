@@ -0,0 +1,21 @@
+var numIter = 200;
+var numLines = 2000;
+var lines = [];
+for (var i = 0; i < numLines; i++) {
+  lines.push(i + ',field' + i + ',' + (i * 7) + ',some longer text field');
+}
+var csv = lines.join('\n');
+
+// The purpose of this variable is so that the results are used, thus the
+// compiler wouldn't optimize out the calls
+var sum = 0;
+
+for (var i = 0; i < numIter; i++) {
+  var rows = csv.split('\n');
+  for (var j = 0; j < rows.length; j += 100) {
+    sum += rows[j].split(',').length;
+  }
+  sum += csv.replace('some longer', 'a').length;
+}
+
+print('done, sum =', sum);
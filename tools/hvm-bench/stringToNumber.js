@@ -0,0 +1,20 @@
+var numIter = 200;
+var len = 5000;
+var strings = [];
+for (var i = 0; i < len; i++) {
+  strings.push(String(i), String(i * 0.25), String(Math.sqrt(i) * 1e10));
+}
+var json = JSON.stringify(strings.map(Number));
+
+// The purpose of this variable is so that the results are used, thus the
+// compiler wouldn't optimize out the conversions
+var sum = 0;
+
+for (var i = 0; i < numIter; i++) {
+  for (var j = 0; j < strings.length; j++) {
+    sum += +strings[j];
+  }
+  sum += JSON.parse(json).length;
+}
+
+print('done, sum =', sum);
@@ -122,6 +122,10 @@ int main(int argc, char **argv) {
                   .build())
           .withES6Symbol(cl::ES6Symbol)
           .withTrackIO(cl::TrackBytecodeIO)
+          .withBytecodePrefetchStartup(cl::BytecodePrefetchStartup)
+          .withBytecodeStartupReadahead(cl::BytecodeStartupReadahead)
+          .withBytecodeRandomAccess(cl::BytecodeRandomAccess)
+          .withBytecodeReleaseColdAtTTI(cl::BytecodeReleaseColdAtTTI)
           .build();
 
   options.stabilizeInstructionCount = cl::StableInstructionCount;
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/BCGen/HBC/BytecodeCache.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes;
+using namespace hermes::hbc;
+
+namespace {
+
+class BytecodeCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("hbc-cache", dir_));
+  }
+
+  void TearDown() override {
+    llvm::sys::fs::remove_directories(dir_);
+  }
+
+  /// Load \p source from \p sourceURL through \p cache.
+  std::pair<std::unique_ptr<BCProviderBase>, std::string> load(
+      BytecodeCache &cache,
+      const std::string &source,
+      const CompileFlags &flags = CompileFlags{},
+      llvm::StringRef sourceURL = "test.js") {
+    // The parser relies on the null terminator of the string.
+    return cache.getOrCompile(
+        llvm::make_unique<Buffer>(
+            reinterpret_cast<const uint8_t *>(source.c_str()), source.size()),
+        sourceURL,
+        flags);
+  }
+
+  llvm::SmallString<128> dir_;
+};
+
+SHA1 hashSource(const std::string &source) {
+  auto rawHash = llvm::SHA1::hash(llvm::makeArrayRef(
+      reinterpret_cast<const uint8_t *>(source.data()), source.size()));
+  SHA1 hash{};
+  std::copy(rawHash.begin(), rawHash.end(), hash.begin());
+  return hash;
+}
+
+TEST_F(BytecodeCacheTest, MissThenHitTest) {
+  const std::string source = "function f(x) { return x + 1; } f(2);";
+  BytecodeCache cache{dir_.str().str()};
+
+  auto compiled = load(cache, source);
+  ASSERT_TRUE(compiled.first) << compiled.second;
+  // Compiled from source, so there is no serialized bytecode.
+  EXPECT_TRUE(compiled.first->getRawBuffer().empty());
+
+  // A new cache in the same directory, as in another process.
+  BytecodeCache other{dir_.str().str()};
+  auto cached = load(other, source);
+  ASSERT_TRUE(cached.first) << cached.second;
+  EXPECT_FALSE(cached.first->getRawBuffer().empty());
+  EXPECT_EQ(
+      compiled.first->getFunctionCount(), cached.first->getFunctionCount());
+  EXPECT_EQ(hashSource(source), cached.first->getSourceHash());
+
+  // A different source is not found.
+  auto changed = load(cache, source + " f(3);");
+  ASSERT_TRUE(changed.first) << changed.second;
+  EXPECT_TRUE(changed.first->getRawBuffer().empty());
+}
+
+TEST_F(BytecodeCacheTest, FlagsTest) {
+  BytecodeCache cache{dir_.str().str()};
+  SHA1 hash{};
+  CompileFlags flags{};
+  auto path = cache.getEntryPath(hash, "test.js", flags);
+
+  // Entries are always compiled eagerly.
+  flags.lazy = true;
+  EXPECT_EQ(path, cache.getEntryPath(hash, "test.js", flags));
+
+  flags.strict = true;
+  EXPECT_NE(path, cache.getEntryPath(hash, "test.js", flags));
+  flags.strict = false;
+  flags.staticBuiltins = false;
+  EXPECT_NE(path, cache.getEntryPath(hash, "test.js", flags));
+  flags.staticBuiltins.reset();
+  EXPECT_NE(path, cache.getEntryPath(hash, "other.js", flags));
+  hash[0] = 1;
+  EXPECT_NE(path, cache.getEntryPath(hash, "test.js", flags));
+}
+
+TEST_F(BytecodeCacheTest, SourceURLTest) {
+  const std::string source = "function f() { throw new Error(); } f();";
+  // Debug info of the entries records the file they were loaded from.
+  auto getFilename = [](const BCProviderBase &provider) {
+    const DebugInfo *info = provider.getDebugInfo();
+    EXPECT_EQ(1u, info->getFilenameTable().size());
+    return info->getFilenameByID(0);
+  };
+
+  BytecodeCache cache{dir_.str().str()};
+  auto first = load(cache, source, CompileFlags{}, "first.js");
+  ASSERT_TRUE(first.first) << first.second;
+  EXPECT_EQ("first.js", getFilename(*first.first));
+
+  // The same source from another URL is compiled again.
+  auto second = load(cache, source, CompileFlags{}, "second.js");
+  ASSERT_TRUE(second.first) << second.second;
+  EXPECT_TRUE(second.first->getRawBuffer().empty());
+  EXPECT_EQ("second.js", getFilename(*second.first));
+
+  // Each URL then has its own entry.
+  for (const char *url : {"first.js", "second.js"}) {
+    auto cached = load(cache, source, CompileFlags{}, url);
+    ASSERT_TRUE(cached.first) << cached.second;
+    EXPECT_FALSE(cached.first->getRawBuffer().empty());
+    EXPECT_EQ(url, getFilename(*cached.first));
+  }
+}
+
+TEST_F(BytecodeCacheTest, InvalidEntryTest) {
+  const std::string source = "var x = 10; x * x;";
+  BytecodeCache cache{dir_.str().str()};
+  auto compiled = load(cache, source);
+  ASSERT_TRUE(compiled.first) << compiled.second;
+
+  auto path =
+      cache.getEntryPath(hashSource(source), "test.js", CompileFlags{});
+  auto entry = llvm::MemoryBuffer::getFile(path);
+  ASSERT_TRUE(bool(entry));
+  // Copy the entry, since it may be mapped.
+  std::string contents = (*entry)->getBuffer().str();
+  entry->reset();
+
+  // A truncated entry is ignored and replaced.
+  {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(path, EC, llvm::sys::fs::F_None);
+    ASSERT_FALSE(EC);
+    OS << contents.substr(0, contents.size() / 2);
+  }
+  auto recompiled = load(cache, source);
+  ASSERT_TRUE(recompiled.first) << recompiled.second;
+  EXPECT_TRUE(recompiled.first->getRawBuffer().empty());
+  auto cached = load(cache, source);
+  ASSERT_TRUE(cached.first) << cached.second;
+  EXPECT_FALSE(cached.first->getRawBuffer().empty());
+}
+
+TEST_F(BytecodeCacheTest, CompileErrorTest) {
+  BytecodeCache cache{dir_.str().str()};
+  auto res = load(cache, "var = ;");
+  EXPECT_FALSE(res.first);
+  EXPECT_FALSE(res.second.empty());
+}
+
+} // anonymous namespace
@@ -18,6 +18,13 @@
 #include "hermes/IR/IRBuilder.h"
 #include "hermes/Public/Buffer.h"
 #include "hermes/SourceMap/SourceMapGenerator.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/Support/OSCompat.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include "TestHelpers.h"
 
@@ -471,4 +478,243 @@ TEST(HBCBytecodeGen, SerializeBytecodeOptions) {
   EXPECT_TRUE(bytecodeStaticBuiltins->getBytecodeOptions().staticBuiltins);
 }
 
+TEST(HBCBytecodeGen, FunctionOrder) {
+  const char *source =
+      "function f() { return 1; }\n"
+      "function g() { return 'g' + f(); }\n"
+      "print(g());";
+  auto getOffsets = [source](TestCompileFlags flags) {
+    auto bytecode = bytecodeForSource(source, flags);
+    std::string error;
+    ConstBytecodeFileFields fields;
+    EXPECT_TRUE(fields.populateFromBuffer(bytecode, &error)) << error;
+    std::vector<uint32_t> offsets;
+    for (const auto &header : fields.functionHeaders)
+      offsets.push_back(header.offset);
+    return offsets;
+  };
+
+  // By default, bodies are laid out in function ID order.
+  auto offsets = getOffsets(TestCompileFlags());
+  ASSERT_EQ(3u, offsets.size());
+  EXPECT_LT(offsets[0], offsets[1]);
+  EXPECT_LT(offsets[1], offsets[2]);
+
+  // Listed functions come first, in the given order. Invalid and repeated
+  // IDs are ignored.
+  TestCompileFlags flags;
+  flags.functionOrder = {2, 7, 1, 2};
+  offsets = getOffsets(flags);
+  ASSERT_EQ(3u, offsets.size());
+  EXPECT_LT(offsets[2], offsets[1]);
+  EXPECT_LT(offsets[1], offsets[0]);
+}
+
+TEST(HBCBytecodeGen, CompressBytecode) {
+  // Enough similar functions to need several chunks.
+  std::string source;
+  for (int i = 0; i < 1000; ++i) {
+    std::string n = std::to_string(i);
+    source += "function f" + n + "(a, b) { if (a > " + n + ") return a.x" + n +
+        "; return [a, b, '" + n + "'].join(); }\n";
+  }
+  auto createProvider = [&source](bool compress) {
+    TestCompileFlags flags;
+    flags.compressBytecode = compress;
+    auto bytecode = bytecodeForSource(source.c_str(), flags);
+    auto ret = BCProviderFromBuffer::createBCProviderFromBuffer(
+        llvm::make_unique<StringBuffer>(
+            std::string(bytecode.begin(), bytecode.end())));
+    EXPECT_TRUE(ret.first) << ret.second;
+    return std::move(ret.first);
+  };
+  auto plain = createProvider(false);
+  auto compressed = createProvider(true);
+  ASSERT_TRUE(plain && compressed);
+  EXPECT_FALSE(plain->getBytecodeOptions().compressed);
+  EXPECT_TRUE(compressed->getBytecodeOptions().compressed);
+  EXPECT_TRUE(plain->getCompressedChunks().empty());
+  EXPECT_GT(compressed->getCompressedChunks().size(), 1u);
+  EXPECT_LT(compressed->getRawBuffer().size(), plain->getRawBuffer().size());
+
+  // Every function decompresses to the same bytecode, in any order.
+  ASSERT_EQ(plain->getFunctionCount(), compressed->getFunctionCount());
+  for (uint32_t i = compressed->getFunctionCount(); i-- > 0;) {
+    uint32_t size = plain->getFunctionHeader(i).bytecodeSizeInBytes();
+    ASSERT_EQ(size, compressed->getFunctionHeader(i).bytecodeSizeInBytes());
+    EXPECT_EQ(
+        llvm::makeArrayRef(plain->getBytecode(i), size),
+        llvm::makeArrayRef(compressed->getBytecode(i), size));
+  }
+
+  // The debug info decompresses to the same tables.
+  const DebugInfo *plainInfo = plain->getDebugInfo();
+  const DebugInfo *compressedInfo = compressed->getDebugInfo();
+  EXPECT_EQ(
+      plainInfo->viewData().getData(), compressedInfo->viewData().getData());
+  ASSERT_EQ(
+      plainInfo->getFilenameTable().size(),
+      compressedInfo->getFilenameTable().size());
+  for (uint32_t i = 0, e = plainInfo->getFilenameTable().size(); i < e; ++i) {
+    EXPECT_EQ(
+        plainInfo->getFilenameByID(i), compressedInfo->getFilenameByID(i));
+  }
+}
+
+TEST(HBCBytecodeGen, PageAlignDown) {
+  const size_t PS = oscompat::page_size();
+  std::vector<uint8_t> storage(3 * PS);
+  auto *page = reinterpret_cast<uint8_t *>(
+      llvm::alignAddr(storage.data(), PS));
+
+  // A pointer into a page moves to its start, and the length grows by as
+  // much.
+  uint8_t *ptr = page + 100;
+  size_t len = 50;
+  pageAlignDown(&ptr, &len);
+  EXPECT_EQ(page, ptr);
+  EXPECT_EQ(150u, len);
+
+  ptr = page + PS - 1;
+  len = 1;
+  pageAlignDown(&ptr, &len);
+  EXPECT_EQ(page, ptr);
+  EXPECT_EQ(PS, len);
+
+  // A pointer to the start of a page doesn't move.
+  ptr = page + PS;
+  len = 10;
+  pageAlignDown(&ptr, &len);
+  EXPECT_EQ(page + PS, ptr);
+  EXPECT_EQ(10u, len);
+}
+
+/// \return the source of \p count functions, each long enough to span a
+/// page of bytecode.
+std::string longFunctionsSource(unsigned count) {
+  std::string source;
+  for (unsigned i = 0; i < count; ++i) {
+    std::string n = std::to_string(i);
+    source += "function f" + n + "(x) {\n";
+    for (unsigned j = 0; j < 300; ++j)
+      source += "  x = x * " + std::to_string(j) + " + " + n + ";\n";
+    source += "  return x;\n}\n";
+  }
+  return source;
+}
+
+/// Write \p bytecode to a file, and \return a provider for a memory mapping
+/// of it.
+std::unique_ptr<BCProviderFromBuffer> mapBytecode(
+    const std::vector<uint8_t> &bytecode) {
+  int fd;
+  llvm::SmallString<128> path;
+  if (llvm::sys::fs::createTemporaryFile("residency", "hbc", fd, path)) {
+    ADD_FAILURE() << "Could not create a temporary file";
+    return nullptr;
+  }
+  {
+    llvm::raw_fd_ostream OS(fd, /* shouldClose */ true);
+    OS.write(reinterpret_cast<const char *>(bytecode.data()), bytecode.size());
+  }
+  // Without a null terminator the file is memory mapped. The mapping stays
+  // valid after the file is removed.
+  auto fileOrErr = llvm::MemoryBuffer::getFile(
+      path, /* FileSize */ -1, /* RequiresNullTerminator */ false);
+  llvm::sys::fs::remove(path);
+  if (!fileOrErr) {
+    ADD_FAILURE() << "Could not map " << path.str().str();
+    return nullptr;
+  }
+  auto ret = BCProviderFromBuffer::createBCProviderFromBuffer(
+      llvm::make_unique<OwnedMemoryBuffer>(std::move(*fileOrErr)));
+  EXPECT_TRUE(ret.first) << ret.second;
+  return std::move(ret.first);
+}
+
+TEST(HBCBytecodeGen, ReleaseUnusedFunctionPages) {
+  const unsigned kNumFunctions = 16;
+  auto source = longFunctionsSource(kNumFunctions);
+  auto bytecode = bytecodeForSource(source.c_str());
+  auto provider = mapBytecode(bytecode);
+  ASSERT_TRUE(provider);
+  ASSERT_EQ(kNumFunctions + 1, provider->getFunctionCount());
+
+  size_t bodiesSize = 0;
+  for (uint32_t i = 0; i < provider->getFunctionCount(); ++i)
+    bodiesSize += provider->getFunctionHeader(i).bytecodeSizeInBytes();
+  const size_t PS = oscompat::page_size();
+  ASSERT_GT(bodiesSize, 4 * PS);
+
+  // Nothing is released while every function is used.
+  EXPECT_EQ(
+      0u, provider->releaseUnusedFunctionPages([](uint32_t) { return true; }));
+
+  size_t all =
+      provider->releaseUnusedFunctionPages([](uint32_t) { return false; });
+  // Without a way to release pages which keeps their contents, like
+  // MADV_PAGEOUT, nothing is released.
+  if (all) {
+    // Every whole page of function bodies is released, which excludes at
+    // most the partial pages at either end.
+    EXPECT_GE(all, bodiesSize / PS - 1);
+
+    // Pages shared by a used and an unused function are kept.
+    size_t someUsed = provider->releaseUnusedFunctionPages(
+        [](uint32_t id) { return id % 2 == 0; });
+    EXPECT_GT(someUsed, 0u);
+    EXPECT_LT(someUsed, all);
+  }
+
+  // Released pages keep their contents.
+  for (uint32_t i = 0; i < provider->getFunctionCount(); ++i) {
+    auto header = provider->getFunctionHeader(i);
+    EXPECT_EQ(
+        llvm::makeArrayRef(
+            bytecode.data() + header.offset(), header.bytecodeSizeInBytes()),
+        llvm::makeArrayRef(
+            provider->getBytecode(i), header.bytecodeSizeInBytes()));
+  }
+}
+
+TEST(HBCBytecodeGen, ResidencyPolicy) {
+  auto source = longFunctionsSource(8);
+  auto bytecode = bytecodeForSource(source.c_str());
+  auto provider = mapBytecode(bytecode);
+  ASSERT_TRUE(provider);
+
+  // The readahead ends in the middle of a page, so that both its start and
+  // its end have to be aligned.
+  BytecodeResidencyPolicy policy;
+  policy.prefetchStartup = true;
+  policy.startupReadaheadBytes = oscompat::page_size() + 100;
+  policy.randomAccessRest = true;
+  provider->applyResidencyPolicy(policy);
+
+  // No pages are counted before the first snapshot.
+  EXPECT_EQ(-1, provider->getPagesLoadedSinceSnapshot());
+  provider->snapshotResidentPages();
+
+  // Read every function body. Pages which were already resident, like
+  // those of a file which was just written, are not counted.
+  unsigned sum = 0;
+  for (uint32_t i = 0; i < provider->getFunctionCount(); ++i) {
+    auto header = provider->getFunctionHeader(i);
+    for (const uint8_t *p = provider->getBytecode(i),
+                       *e = p + header.bytecodeSizeInBytes();
+         p != e;
+         ++p) {
+      sum += *p;
+    }
+  }
+  EXPECT_GT(sum, 0u);
+
+  int loaded = provider->getPagesLoadedSinceSnapshot();
+  EXPECT_GE(loaded, 0);
+  EXPECT_LE(
+      (size_t)loaded,
+      (provider->getRawBuffer().size() + oscompat::page_size() - 1) /
+          oscompat::page_size());
+}
+
 } // end anonymous namespace
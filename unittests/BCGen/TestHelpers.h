@@ -15,6 +15,10 @@ namespace hermes {
 
 struct TestCompileFlags {
   bool staticBuiltins{false};
+  /// IDs of the functions whose bodies should be laid out first.
+  std::vector<uint32_t> functionOrder{};
+  /// Whether to compress function bodies and debug info.
+  bool compressBytecode{false};
 };
 
 /// Compile source code \p source into Hermes bytecode, asserting that it can be
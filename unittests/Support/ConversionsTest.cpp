@@ -6,8 +6,13 @@
  */
 
 #include "hermes/Support/Conversions.h"
+#include "hermes/dtoa/dtoa.h"
 
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <random>
+#include <string>
 
 #include "gtest/gtest.h"
 
@@ -163,6 +168,92 @@ TEST(ConversionsTest, numberToStringTest) {
   DoubleToStringTest("0", 0);
   DoubleToStringTest("12384", 12384);
   DoubleToStringTest("-12384", -12384);
+
+  // Integers up to 2^53 are printed exactly, larger ones with the shortest
+  // digits that round-trip.
+  DoubleToStringTest("9007199254740991", 9007199254740991.0);
+  DoubleToStringTest("-9007199254740992", -9007199254740992.0);
+  DoubleToStringTest("1152921504606847000", 1152921504606846976.0);
+
+  // Shortest round-trip digits, including the extremes.
+  DoubleToStringTest("0.30000000000000004", 0.1 + 0.2);
+  DoubleToStringTest("0.000001", 1e-6);
+  DoubleToStringTest("1e-7", 1e-7);
+  DoubleToStringTest("5e-324", 4.9406564584124654e-324);
+  DoubleToStringTest("2.2250738585072014e-308", 2.2250738585072014e-308);
+  DoubleToStringTest("1.7976931348623157e+308", 1.7976931348623157e308);
+  DoubleToStringTest("9.007199254740993e+35", 9.007199254740993e35);
+}
+
+TEST(ConversionsTest, parseDecimalFastTest) {
+  auto parse = [](const char *str) {
+    return parseDecimalFast(str, str + strlen(str));
+  };
+  auto parse16 = [](const char16_t *str) {
+    const char16_t *end = str;
+    while (*end)
+      ++end;
+    return parseDecimalFast(str, end);
+  };
+
+  EXPECT_EQ(0.0, *parse("0"));
+  EXPECT_TRUE(std::signbit(*parse("-0")));
+  EXPECT_EQ(3.25, *parse("+3.25"));
+  EXPECT_EQ(0.5, *parse(".5"));
+  EXPECT_EQ(1.0, *parse("1."));
+  EXPECT_EQ(1e-30, *parse("0.000000000000000000000000000001"));
+  EXPECT_EQ(-12.5e10, *parse16(u"-12.5E+10"));
+  EXPECT_EQ(1.7976931348623157e308, *parse("1.7976931348623157e308"));
+
+  // Malformed input.
+  EXPECT_FALSE(parse("").hasValue());
+  EXPECT_FALSE(parse("-").hasValue());
+  EXPECT_FALSE(parse(".").hasValue());
+  EXPECT_FALSE(parse("1e").hasValue());
+  EXPECT_FALSE(parse("1e+").hasValue());
+  EXPECT_FALSE(parse("1x").hasValue());
+  EXPECT_FALSE(parse16(u"1\u0661").hasValue());
+
+  // Input which the fast path leaves to hermes_g_strtod: too many digits,
+  // ambiguous rounding, overflow and subnormals.
+  EXPECT_FALSE(parse("12345678901234567890").hasValue());
+  EXPECT_FALSE(parse("9007199254740993").hasValue());
+  EXPECT_FALSE(parse("1e400").hasValue());
+  EXPECT_FALSE(parse("4.9e-324").hasValue());
+}
+
+TEST(ConversionsTest, roundTripTest) {
+  // Formatting and parsing must agree with dtoa for arbitrary doubles.
+  std::mt19937_64 rng(0);
+  char buf[NUMBER_TO_STRING_BUF_SIZE];
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t bits = rng();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (!std::isfinite(value))
+      continue;
+    size_t len = numberToString(value, buf, sizeof(buf));
+
+    int n, sign;
+    char *end;
+    char *digits = g_dtoa(value, 0, 0, &n, &sign, &end);
+    std::string expected(digits, end);
+    g_freedtoa(digits);
+    std::string actual;
+    for (const char *p = buf; p != buf + len && *p != 'e'; ++p) {
+      if (*p >= '0' && *p <= '9' && (!actual.empty() || *p != '0'))
+        actual += *p;
+    }
+    while (actual.size() > expected.size() && actual.back() == '0')
+      actual.pop_back();
+    EXPECT_EQ(expected, actual) << buf;
+
+    double parsed = hermes_g_strtod(buf, &end);
+    EXPECT_EQ(value, parsed) << buf;
+    if (auto fast = parseDecimalFast(buf, buf + len)) {
+      EXPECT_EQ(parsed, *fast) << buf;
+    }
+  }
 }
 
 } // end anonymous namespace
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/LZCompression.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+using namespace hermes;
+
+namespace {
+
+/// Compress \p input, check that it decompresses back to \p input, and
+/// \return the compressed block.
+std::vector<uint8_t> roundTrip(const std::vector<uint8_t> &input) {
+  std::vector<uint8_t> compressed;
+  lz::compress(input, compressed);
+  std::vector<uint8_t> output(input.size());
+  EXPECT_TRUE(lz::decompress(compressed, output));
+  EXPECT_EQ(input, output);
+  return compressed;
+}
+
+TEST(LZCompressionTest, EmptyTest) {
+  auto compressed = roundTrip({});
+  EXPECT_EQ(1u, compressed.size());
+}
+
+TEST(LZCompressionTest, ShortTest) {
+  for (size_t size = 1; size < 40; ++size) {
+    std::vector<uint8_t> input;
+    for (size_t i = 0; i < size; ++i)
+      input.push_back(i % 7);
+    roundTrip(input);
+  }
+}
+
+TEST(LZCompressionTest, RunTest) {
+  // Long runs of one byte are matches which overlap the data they produce,
+  // and need length extension bytes.
+  std::vector<uint8_t> input(100000, 'a');
+  input.push_back('b');
+  auto compressed = roundTrip(input);
+  EXPECT_LT(compressed.size(), 500u);
+}
+
+TEST(LZCompressionTest, RepetitiveTest) {
+  std::vector<uint8_t> input;
+  const char *words[] = {"LoadParam", "GetById", "PutById", "Call", "Ret"};
+  std::mt19937 rng(42);
+  for (size_t i = 0; i < 20000; ++i) {
+    const char *word = words[rng() % 5];
+    input.insert(input.end(), word, word + strlen(word));
+    input.push_back(rng() % 4);
+  }
+  auto compressed = roundTrip(input);
+  EXPECT_LT(compressed.size(), input.size() / 2);
+}
+
+TEST(LZCompressionTest, RandomTest) {
+  // Incompressible data only grows a little.
+  std::mt19937 rng(1);
+  std::vector<uint8_t> input(70000);
+  for (auto &byte : input)
+    byte = rng();
+  auto compressed = roundTrip(input);
+  EXPECT_LT(compressed.size(), input.size() + input.size() / 100);
+}
+
+TEST(LZCompressionTest, MalformedTest) {
+  std::vector<uint8_t> input;
+  for (size_t i = 0; i < 1000; ++i)
+    input.push_back(i % 13);
+  std::vector<uint8_t> compressed;
+  lz::compress(input, compressed);
+
+  // The output size must match exactly.
+  std::vector<uint8_t> shorter(input.size() - 1);
+  EXPECT_FALSE(lz::decompress(compressed, shorter));
+  std::vector<uint8_t> longer(input.size() + 1);
+  EXPECT_FALSE(lz::decompress(compressed, longer));
+
+  // Truncated blocks are rejected.
+  std::vector<uint8_t> output(input.size());
+  for (size_t size = 0; size < compressed.size(); ++size) {
+    EXPECT_FALSE(lz::decompress(
+        llvm::makeArrayRef(compressed.data(), size), output));
+  }
+
+  // A match may not refer to data before the start of the output.
+  const uint8_t badDistance[] = {0x10, 'x', 0x02, 0x00, 0x00};
+  EXPECT_FALSE(lz::decompress(badDistance, output));
+
+  // Corrupted blocks never write out of bounds.
+  std::mt19937 rng(7);
+  for (size_t i = 0; i < 1000; ++i) {
+    auto corrupted = compressed;
+    corrupted[rng() % corrupted.size()] ^= 1 << (rng() % 8);
+    lz::decompress(corrupted, output);
+  }
+}
+
+} // anonymous namespace
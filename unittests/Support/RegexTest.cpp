@@ -788,4 +788,121 @@ TEST(Regex, NonASCII) {
       constants::matchInputAllAscii));
 }
 
+/// \return the characters which may begin a match of \p pattern, as recorded
+/// in its bytecode header.
+static std::string regexFirstChars(
+    const char16_t *pattern,
+    constants::SyntaxFlags flags = {}) {
+  std::vector<uint8_t> bytecode = cregex(pattern, flags).compile();
+  auto header = reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  std::string result;
+  for (uint32_t c = 0; c < 128; c++) {
+    if (header->isFirstChar(c))
+      result += static_cast<char>(c);
+  }
+  return result;
+}
+
+TEST(Regex, FirstChars) {
+  EXPECT_EQ("a", regexFirstChars(u"abc"));
+  EXPECT_EQ("Aa", regexFirstChars(u"abc", constants::icase));
+  EXPECT_EQ("", regexFirstChars(u"abc", constants::icase | constants::unicode));
+  EXPECT_EQ("ab", regexFirstChars(u"a|b"));
+  EXPECT_EQ("bc", regexFirstChars(u"(?:b+|c)d"));
+  EXPECT_EQ("ab", regexFirstChars(u"a*b"));
+  EXPECT_EQ("abc", regexFirstChars(u"(a?(b))*c"));
+  EXPECT_EQ("x", regexFirstChars(u"\\b(?=y)(?<=z)x"));
+  EXPECT_EQ("0123456789_", regexFirstChars(u"[\\d_]"));
+  EXPECT_EQ("DEFdef", regexFirstChars(u"[d-f]", constants::icase));
+  EXPECT_EQ("", regexFirstChars(u"a|"));
+  EXPECT_EQ("", regexFirstChars(u"a*"));
+  EXPECT_EQ("", regexFirstChars(u".a"));
+  EXPECT_EQ("", regexFirstChars(u"[^a]"));
+  EXPECT_EQ("", regexFirstChars(u"[\\sa]"));
+  EXPECT_EQ("", regexFirstChars(u"[a\xFF]"));
+  EXPECT_EQ("", regexFirstChars(u"\u00FFa"));
+  EXPECT_EQ("", regexFirstChars(u"(a)?\\1b"));
+
+  // Searches skip ahead to the candidate characters.
+  cmatch m;
+  EXPECT_TRUE(search(u"xxxxabxxab", m, cregex(u"ab$")));
+  EXPECT_EQ("(8-10)", flatten(m));
+  EXPECT_TRUE(search(u"\xFFxyAb", m, cregex(u"ab", constants::icase)));
+  EXPECT_EQ("(3-5)", flatten(m));
+  EXPECT_TRUE(search(
+      u"\xD83D\xDE00"
+      u"c",
+      m,
+      cregex(u"[a-c]", constants::unicode)));
+  EXPECT_EQ("(2-3)", flatten(m));
+  EXPECT_FALSE(search(u"xxxxxa", m, cregex(u"ab")));
+
+  const char ascii[] = "----a-ab";
+  std::vector<uint8_t> bytecode = cregex(u"a[b-c]").compile();
+  EXPECT_EQ(
+      MatchRuntimeResult::Match,
+      searchWithBytecode(
+          bytecode, ascii, 0, sizeof(ascii) - 1, &m, constants::matchDefault));
+  EXPECT_EQ("(6-8)", flatten(m));
+  EXPECT_EQ(
+      MatchRuntimeResult::NoMatch,
+      searchWithBytecode(
+          bytecode, ascii, 0, sizeof(ascii) - 2, &m, constants::matchDefault));
+}
+
+static bool regexIsLinear(const char16_t *pattern) {
+  std::vector<uint8_t> bytecode = cregex(pattern).compile();
+  return reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data())
+      ->linearExecutable;
+}
+
+TEST(Regex, LinearTime) {
+  EXPECT_TRUE(regexIsLinear(u"(a|b)*c{2,3}?\\b^$"));
+  EXPECT_FALSE(regexIsLinear(u"(a)\\1"));
+  EXPECT_FALSE(regexIsLinear(u"a(?=b)"));
+  EXPECT_FALSE(regexIsLinear(u"(?<!b)a"));
+
+  // The linear-time executor produces the same captures as backtracking.
+  const char16_t *const cases[][2] = {
+      {u"(a|ab)(c|bcd)(d*)", u"xabcd"},
+      {u"((a)|b)+", u"abab"},
+      {u"(z)((a+)?(b+)?(c))*", u"zaacbbbcac"},
+      {u"(a*?)(a*)", u"aaa"},
+      {u"(a*)+?b", u"aab"},
+      {u"(?:a|())*?b", u"ab"},
+      {u"(\\w+)\\s(\\w+)$", u"one two three"},
+      {u"(a{2,3})*?$", u"aaaaa"},
+      {u"\\bo.", u"foo oof"},
+  };
+  for (const auto &c : cases) {
+    cmatch expected, actual;
+    bool matched = search(c[1], expected, cregex(c[0]));
+    EXPECT_EQ(
+        matched,
+        search(c[1], actual, cregex(c[0]), constants::matchLinearTime));
+    EXPECT_EQ(flatten(expected), flatten(actual));
+  }
+  cmatch m;
+  EXPECT_TRUE(search(
+      u"\xD83D\xDE00\xD83D\xDE00x",
+      m,
+      cregex(u"(.)+x", constants::unicode),
+      constants::matchLinearTime));
+  EXPECT_EQ("(0-5) (2-4)", flatten(m));
+
+  // Catastrophic backtracking falls back to the linear-time executor, instead
+  // of running out of stack.
+  const std::u16string as(10000, u'a');
+  EXPECT_FALSE(search(as, m, cregex(u"(a*)*b")));
+  EXPECT_FALSE(search(as, m, cregex(u"(?:a|aa)+$x")));
+  EXPECT_TRUE(search(as + u"b", m, cregex(u"(a|aa)+b")));
+  EXPECT_EQ("(0-10001) (9999-10000)", flatten(m));
+
+  // So does rescanning the input from every start position.
+  EXPECT_TRUE(search(as + u"b", m, cregex(u"[ab]*c|b$")));
+  EXPECT_EQ("(10000-10001)", flatten(m));
+  EXPECT_TRUE(search(as + u"b", m, cregex(u"(?:a|b)*c|b$")));
+  EXPECT_EQ("(10000-10001)", flatten(m));
+}
+
 } // end anonymous namespace
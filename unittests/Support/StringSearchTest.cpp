@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/StringSearch.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include "gtest/gtest.h"
+
+using namespace hermes;
+
+namespace {
+
+/// Reference implementation of searchSubstring().
+template <typename T, typename U>
+size_t naiveSearch(const T &haystack, const U &needle, size_t from) {
+  if (from > haystack.size())
+    return kSubstringNotFound;
+  for (size_t i = from; i + needle.size() <= haystack.size(); ++i) {
+    if (std::equal(needle.begin(), needle.end(), haystack.begin() + i))
+      return i;
+  }
+  return kSubstringNotFound;
+}
+
+/// Reference implementation of searchSubstringReverse().
+template <typename T, typename U>
+size_t naiveSearchReverse(const T &haystack, const U &needle, size_t before) {
+  if (needle.size() > haystack.size())
+    return kSubstringNotFound;
+  for (size_t i = std::min(before, haystack.size() - needle.size()) + 1;
+       i-- > 0;) {
+    if (std::equal(needle.begin(), needle.end(), haystack.begin() + i))
+      return i;
+  }
+  return kSubstringNotFound;
+}
+
+template <typename T, typename U>
+size_t indexOf(const T &haystack, const U &needle, size_t from = 0) {
+  return searchSubstring(
+      llvm::makeArrayRef(haystack.data(), haystack.size()),
+      llvm::makeArrayRef(needle.data(), needle.size()),
+      from);
+}
+
+template <typename T, typename U>
+size_t searchReverse(const T &haystack, const U &needle, size_t before) {
+  return searchSubstringReverse(
+      llvm::makeArrayRef(haystack.data(), haystack.size()),
+      llvm::makeArrayRef(needle.data(), needle.size()),
+      before);
+}
+
+TEST(StringSearchTest, Basic) {
+  std::string s = "hello, world";
+  EXPECT_EQ(0u, indexOf(s, std::string("hello")));
+  EXPECT_EQ(7u, indexOf(s, std::string("world")));
+  EXPECT_EQ(4u, indexOf(s, std::string("o")));
+  EXPECT_EQ(8u, indexOf(s, std::string("o"), 5));
+  EXPECT_EQ(kSubstringNotFound, indexOf(s, std::string("worlds")));
+  EXPECT_EQ(3u, indexOf(s, std::string(""), 3));
+  EXPECT_EQ(12u, indexOf(s, std::string(""), 12));
+  EXPECT_EQ(kSubstringNotFound, indexOf(s, std::string(""), 13));
+
+  EXPECT_EQ(8u, searchReverse(s, std::string("o"), 100));
+  EXPECT_EQ(4u, searchReverse(s, std::string("o"), 7));
+  EXPECT_EQ(kSubstringNotFound, searchReverse(s, std::string("o"), 3));
+  EXPECT_EQ(12u, searchReverse(s, std::string(""), 100));
+}
+
+TEST(StringSearchTest, MixedWidths) {
+  std::u16string s16 = u"café 世界 cafe";
+  EXPECT_EQ(8u, indexOf(s16, std::string("cafe")));
+  EXPECT_EQ(0u, indexOf(s16, std::string("caf")));
+  EXPECT_EQ(8u, searchReverse(s16, std::string("caf"), 100));
+
+  std::string s8 = "cafe \xe9";
+  EXPECT_EQ(5u, indexOf(s8, std::u16string(u"é")));
+  EXPECT_EQ(kSubstringNotFound, indexOf(s8, std::u16string(u"ǩ")));
+  EXPECT_EQ(
+      kSubstringNotFound, searchReverse(s8, std::u16string(u"世"), 100));
+}
+
+TEST(StringSearchTest, LongNeedles) {
+  // A needle whose units share their low byte with other units of the
+  // haystack.
+  std::u16string hay(1000, u'š');
+  std::u16string needle = u"ššššššša";
+  hay[500] = u'a';
+  EXPECT_EQ(493u, indexOf(hay, needle));
+  hay[500] = u'ɡ';
+  EXPECT_EQ(kSubstringNotFound, indexOf(hay, needle));
+
+  std::string text(5000, 'x');
+  std::string pattern = "needle in a haystack";
+  text.replace(4000, pattern.size(), pattern);
+  EXPECT_EQ(4000u, indexOf(text, pattern));
+  EXPECT_EQ(4000u, indexOf(text, pattern, 4000));
+  EXPECT_EQ(kSubstringNotFound, indexOf(text, pattern, 4001));
+}
+
+template <typename T>
+void fuzz(unsigned seed) {
+  std::mt19937 rng(seed);
+  const T alphabet[] = {'a', 'b', 'c', (T)0x161, (T)0x261};
+  const unsigned alphabetSize = sizeof(T) == 1 ? 3 : 5;
+  auto randomString = [&](size_t maxLen) {
+    std::basic_string<T> s(rng() % (maxLen + 1), 'a');
+    for (auto &c : s)
+      c = alphabet[rng() % alphabetSize];
+    return s;
+  };
+  for (unsigned iter = 0; iter < 2000; ++iter) {
+    auto haystack = randomString(iter % 2 ? 600 : 40);
+    auto needle = randomString(iter % 3 ? 4 : 12);
+    size_t from = rng() % (haystack.size() + 2);
+    ASSERT_EQ(
+        naiveSearch(haystack, needle, from), indexOf(haystack, needle, from))
+        << "iteration " << iter;
+    ASSERT_EQ(
+        naiveSearchReverse(haystack, needle, from),
+        searchReverse(haystack, needle, from))
+        << "iteration " << iter;
+  }
+}
+
+TEST(StringSearchTest, Fuzz) {
+  fuzz<char>(1);
+  fuzz<char16_t>(2);
+}
+
+} // namespace
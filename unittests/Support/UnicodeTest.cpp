@@ -143,4 +143,96 @@ TEST(StringTest, IsAllASCIITest) {
   }
 }
 
+TEST(StringTest, ASCIIPrefixTest) {
+  // Place a single non-ASCII character at every position of strings of every
+  // length up to a few vector widths, at every alignment.
+  for (size_t len = 0; len < 80; ++len) {
+    for (size_t offset = 0; offset < 4; ++offset) {
+      std::vector<uint8_t> bytes(len + offset, 'a');
+      std::vector<char16_t> units(len + offset, u'a');
+      const uint8_t *begin8 = bytes.data() + offset;
+      const char16_t *begin16 = units.data() + offset;
+      EXPECT_EQ(len, countASCIIPrefix(begin8, begin8 + len));
+      EXPECT_EQ(len, countASCIIPrefix(begin16, begin16 + len));
+      EXPECT_TRUE(isAllASCII(begin16, begin16 + len));
+      for (size_t pos = 0; pos < len; ++pos) {
+        bytes[offset + pos] = 0x80;
+        units[offset + pos] = 0x100;
+        EXPECT_EQ(pos, countASCIIPrefix(begin8, begin8 + len));
+        EXPECT_EQ(pos, countASCIIPrefix(begin16, begin16 + len));
+        EXPECT_FALSE(isAllASCII(begin16, begin16 + len));
+        units[offset + pos] = 0x80;
+        EXPECT_EQ(pos, countASCIIPrefix(begin16, begin16 + len));
+        bytes[offset + pos] = 0x7F;
+        units[offset + pos] = 0x7F;
+      }
+    }
+  }
+}
+
+TEST(StringTest, ASCIIWidenNarrowTest) {
+  for (size_t len = 0; len < 80; ++len) {
+    std::string ascii;
+    for (size_t i = 0; i < len; ++i)
+      ascii += (char)(i * 7 % 128);
+    std::vector<char16_t> wide(len + 1, u'!');
+    convertASCIIToUTF16(wide.data(), ascii.data(), len);
+    EXPECT_EQ(u'!', wide[len]);
+    std::string narrow(len + 1, '!');
+    convertUTF16ToASCII(&narrow[0], wide.data(), len);
+    EXPECT_EQ(ascii + '!', narrow);
+    for (size_t i = 0; i < len; ++i)
+      EXPECT_EQ((char16_t)ascii[i], wide[i]);
+  }
+}
+
+TEST(StringTest, UTF8ToUTF16WithReplacements) {
+  auto convert = [](std::initializer_list<unsigned char> cs,
+                    bool expectValid) -> std::u16string {
+    std::u16string out;
+    std::vector<uint8_t> bytes(cs);
+    EXPECT_EQ(expectValid, convertUTF8ToUTF16WithReplacements(out, bytes));
+    return out;
+  };
+  EXPECT_EQ(u"", convert({}, true));
+  EXPECT_EQ(u"abc", convert({'a', 'b', 'c'}, true));
+  EXPECT_EQ(u"e\u0301", convert({'e', 0xCC, 0x81}, true));
+  EXPECT_EQ(u"\u2603", convert({0xE2, 0x98, 0x83}, true));
+  EXPECT_EQ(u"\U0001F639", convert({0xF0, 0x9F, 0x98, 0xB9}, true));
+  EXPECT_EQ(u"\U0010FFFF", convert({0xF4, 0x8F, 0xBF, 0xBF}, true));
+
+  // Invalid bytes, overlong encodings, encoded surrogates and values above
+  // U+10FFFF are replaced one maximal subpart at a time.
+  EXPECT_EQ(u"a\uFFFDb", convert({'a', 0x80, 'b'}, false));
+  EXPECT_EQ(u"\uFFFD\uFFFD", convert({0xC0, 0xAF}, false));
+  EXPECT_EQ(u"\uFFFD\uFFFD\uFFFD", convert({0xE0, 0x80, 0xAF}, false));
+  EXPECT_EQ(u"\uFFFD\uFFFD\uFFFD", convert({0xED, 0xA0, 0xBD}, false));
+  EXPECT_EQ(
+      u"\uFFFD\uFFFD\uFFFD\uFFFD", convert({0xF4, 0x90, 0x80, 0x80}, false));
+  EXPECT_EQ(u"\uFFFDa", convert({0xE2, 0x98, 'a'}, false));
+  EXPECT_EQ(u"a\uFFFD", convert({'a', 0xF0, 0x9F, 0x98}, false));
+  EXPECT_EQ(u"\uFFFD\uFFFD", convert({0xFE, 0xFF}, false));
+
+  // Long strings mixing ASCII runs with other characters.
+  std::string utf8;
+  std::u16string expected;
+  for (int i = 0; i < 200; ++i) {
+    utf8 += std::string(i % 37, 'x');
+    expected += std::u16string(i % 37, u'x');
+    utf8 += i % 2 ? "\xC3\xA9" : "\xF0\x9F\x98\xB9";
+    expected += i % 2 ? u"\u00E9" : u"\U0001F639";
+  }
+  std::u16string out;
+  EXPECT_TRUE(convertUTF8ToUTF16WithReplacements(
+      out,
+      llvm::ArrayRef<uint8_t>((const uint8_t *)utf8.data(), utf8.size())));
+  EXPECT_EQ(expected, out);
+
+  // Round trip through UTF-8.
+  std::string back;
+  EXPECT_TRUE(convertUTF16ToUTF8WithReplacements(
+      back, llvm::ArrayRef<char16_t>(out.data(), out.size())));
+  EXPECT_EQ(utf8, back);
+}
+
 } // end anonymous namespace
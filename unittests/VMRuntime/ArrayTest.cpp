@@ -154,4 +154,73 @@ TEST_F(ArrayTest, TestLength) {
   EXPECT_CALLRESULT_DOUBLE(
       5.0, JSObject::getNamed_RJS(array, runtime, lengthID));
 }
+
+TEST_F(ArrayTest, ElementsKindTest) {
+  auto arrayRes = JSArray::create(runtime, 4, 0);
+  ASSERT_EQ(arrayRes.getStatus(), ExecutionStatus::RETURNED);
+  auto array = toHandle(runtime, std::move(*arrayRes));
+  EXPECT_EQ(ElementsKind::PackedInt, array->getElementsKind());
+  EXPECT_TRUE(JSArray::isPacked(array.get()));
+
+  // Appending in order keeps the array packed.
+  JSArray::setElementAt(array, runtime, 0, runtime->makeHandle(1.0_hd));
+  JSArray::setElementAt(array, runtime, 1, runtime->makeHandle(2.0_hd));
+  ASSERT_TRUE(*JSArray::setLengthProperty(array, runtime, 2));
+  EXPECT_EQ(ElementsKind::PackedInt, array->getElementsKind());
+  EXPECT_TRUE(JSArray::isPacked(array.get()));
+
+  // Storing a non-integer widens the kind.
+  JSArray::setElementAt(array, runtime, 1, runtime->makeHandle(2.5_hd));
+  EXPECT_EQ(ElementsKind::PackedDouble, array->getElementsKind());
+  JSArray::setElementAt(
+      array, runtime, 0, runtime->makeHandle(HermesValue::encodeNullValue()));
+  EXPECT_EQ(ElementsKind::PackedAny, array->getElementsKind());
+  // Kinds never become more specific while there are elements.
+  JSArray::setElementAt(array, runtime, 0, runtime->makeHandle(1.0_hd));
+  EXPECT_EQ(ElementsKind::PackedAny, array->getElementsKind());
+
+  // Skipping indices leaves holes, filling them packs the array again.
+  JSArray::setElementAt(array, runtime, 5, runtime->makeHandle(5.0_hd));
+  ASSERT_TRUE(*JSArray::setLengthProperty(array, runtime, 6));
+  EXPECT_EQ(ElementsKind::Holey, array->getElementsKind());
+  EXPECT_FALSE(JSArray::isPacked(array.get()));
+  for (uint32_t i = 2; i < 5; ++i) {
+    JSArray::setElementAt(array, runtime, i, runtime->makeHandle(1.0_hd));
+  }
+  EXPECT_EQ(ElementsKind::PackedAny, array->getElementsKind());
+  EXPECT_TRUE(JSArray::isPacked(array.get()));
+
+  // Deleting creates a hole, truncating the array past it removes it.
+  JSArray::deleteElementAt(array, runtime, 4);
+  EXPECT_EQ(ElementsKind::Holey, array->getElementsKind());
+  ASSERT_TRUE(*JSArray::setLengthProperty(array, runtime, 4));
+  EXPECT_EQ(ElementsKind::PackedAny, array->getElementsKind());
+
+  // Growing the length beyond the storage is not packed, but the storage is.
+  ASSERT_TRUE(*JSArray::setLengthProperty(array, runtime, 10));
+  EXPECT_EQ(ElementsKind::PackedAny, array->getElementsKind());
+  EXPECT_FALSE(JSArray::isPacked(array.get()));
+
+  // Emptying the array resets the kind.
+  ASSERT_TRUE(*JSArray::setLengthProperty(array, runtime, 0));
+  EXPECT_EQ(ElementsKind::PackedInt, array->getElementsKind());
+  EXPECT_TRUE(JSArray::isPacked(array.get()));
+
+  // -0 is not an int.
+  JSArray::setElementAt(
+      array,
+      runtime,
+      0,
+      runtime->makeHandle(HermesValue::encodeDoubleValue(-0.0)));
+  EXPECT_EQ(ElementsKind::PackedDouble, array->getElementsKind());
+
+  // Storage grown by setStorageEndIndex is filled with holes.
+  ASSERT_EQ(
+      ExecutionStatus::RETURNED,
+      JSArray::setStorageEndIndex(array, runtime, 3));
+  EXPECT_EQ(ElementsKind::Holey, array->getElementsKind());
+  JSArray::unsafeSetExistingElementAt(*array, runtime, 1, 1.0_hd);
+  JSArray::unsafeSetExistingElementAt(*array, runtime, 2, 2.0_hd);
+  EXPECT_EQ(ElementsKind::PackedDouble, array->getElementsKind());
+}
 } // namespace
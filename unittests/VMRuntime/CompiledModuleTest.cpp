@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/CompiledModule.h"
+
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/VM/Runtime.h"
+
+#include "TestHelpers.h"
+
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+
+using namespace hermes;
+using namespace hermes::vm;
+using namespace hermes::hbc;
+
+namespace {
+
+/// Compile \p source to a module which can be shared by runtimes.
+std::shared_ptr<CompiledModule> compile(const std::string &source, bool lazy) {
+  CompileFlags flags;
+  flags.lazy = lazy;
+  auto res = BCProviderFromSrc::createBCProviderFromSrc(
+      llvm::make_unique<OwnedMemoryBuffer>(
+          llvm::MemoryBuffer::getMemBufferCopy(source)),
+      "test.js",
+      flags);
+  EXPECT_TRUE(res.first) << res.second;
+  return CompiledModule::create(std::move(res.first));
+}
+
+/// Run \p module in \p runtime and \return its numeric result.
+double run(Runtime *runtime, const std::shared_ptr<CompiledModule> &module) {
+  GCScope scope{runtime};
+  RuntimeModuleFlags flags;
+  flags.persistent = true;
+  auto res = runtime->runBytecode(
+      module, flags, "test.js", Runtime::makeNullHandle<Environment>());
+  EXPECT_EQ(ExecutionStatus::RETURNED, res.getStatus());
+  return res == ExecutionStatus::EXCEPTION ? 0 : res->getNumber();
+}
+
+/// \return the compiled modules used by the runtime modules of \p runtime.
+std::set<CompiledModule *> getCompiledModules(Runtime *runtime) {
+  std::set<CompiledModule *> modules;
+  for (auto &runtimeModule : runtime->getRuntimeModules())
+    modules.insert(runtimeModule.getCompiledModule().get());
+  return modules;
+}
+
+TEST(CompiledModuleTest, SharedBetweenRuntimes) {
+  auto module = compile(
+      "var o = {a: 1, b: 2}; function f(x) { return x.b; } f(o);", false);
+  auto rt1 = Runtime::create(kTestRTConfig);
+  auto rt2 = Runtime::create(kTestRTConfig);
+
+  EXPECT_EQ(2, run(rt1.get(), module));
+  EXPECT_EQ(2, run(rt2.get(), module));
+  // The first runtime loaded it.
+  EXPECT_FALSE(module->markLoaded());
+
+  EXPECT_EQ(1u, getCompiledModules(rt1.get()).count(module.get()));
+  EXPECT_EQ(1u, getCompiledModules(rt2.get()).count(module.get()));
+}
+
+TEST(CompiledModuleTest, LazyFunctionsCompiledOnce) {
+  // The functions are padded so that they won't be eagerly compiled for
+  // being too short.
+  auto module = compile(
+      R"(
+function f(x) {
+  function g() {
+    /* Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do
+     * eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim
+     * ad minim veniam, quis nostrud exercitation ullamco laboris nisi.
+     */
+    return x * 2;
+  }
+  /* Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do
+   * eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim
+   * ad minim veniam, quis nostrud exercitation ullamco laboris nisi.
+   */
+  return g();
+}
+f(21);
+)",
+      true);
+  auto rt1 = Runtime::create(kTestRTConfig);
+  auto rt2 = Runtime::create(kTestRTConfig);
+  EXPECT_EQ(42, run(rt1.get(), module));
+  EXPECT_EQ(42, run(rt2.get(), module));
+
+  // Apart from modules specific to each runtime, like the internal bytecode,
+  // both runtimes use the same modules: the global function, and the modules
+  // compiled from f and g.
+  auto modules1 = getCompiledModules(rt1.get());
+  std::vector<CompiledModule *> sharedLazy;
+  for (auto *compiled : getCompiledModules(rt2.get())) {
+    if (compiled != module.get() && modules1.count(compiled))
+      sharedLazy.push_back(compiled);
+  }
+  ASSERT_EQ(2u, sharedLazy.size());
+  for (auto *compiled : sharedLazy)
+    EXPECT_FALSE(compiled->getBytecode()->isLazy());
+}
+
+} // anonymous namespace
@@ -28,6 +28,8 @@ MetadataTableForTests getMetadataTable() {
       Metadata(), // FillerCell
       Metadata(), // DynamicUTF16StringPrimitive
       Metadata(), // DynamicASCIIStringPrimitive
+      Metadata(), // SlicedUTF16StringPrimitive
+      Metadata(), // SlicedASCIIStringPrimitive
       Metadata(), // DynamicUniquedUTF16StringPrimitive
       Metadata(), // DynamicUniquedASCIIStringPrimitive
       Metadata(), // ExternalUTF16StringPrimitive
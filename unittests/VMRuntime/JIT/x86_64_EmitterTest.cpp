@@ -291,6 +291,20 @@ TEST(x86_64_EmitterTest, Test) {
   emitter.cmpImmToRM<S::SLQ, ScaleRegAccess>(300, Reg::rax, Reg::NoIndex, 0);
   CHECK("48 3d 2c 01 00 00             cmpq $300, %rax");
 
+  emitter.cmpRegToReg<S::Q>(Reg::rdx, Reg::rdi);
+  CHECK("48 39 d7                      cmpq %rdx, %rdi");
+  emitter.cmpRegToReg<S::L>(Reg::r9, Reg::r8);
+  CHECK("45 39 c8                      cmpl %r9d, %r8d");
+  emitter.subRegFromReg<S::Q>(Reg::rax, Reg::r11);
+  CHECK("49 29 c3                      subq %rax, %r11");
+
+  emitter.movzxRMToReg<S::B>(Reg::rdi, Reg::NoIndex, 0, Reg::eax);
+  CHECK("0f b6 07                      movzbl (%rdi), %eax");
+  emitter.movzxRMToReg<S::W>(Reg::rdi, Reg::NoIndex, -2, Reg::eax);
+  CHECK("0f b7 47 fe                   movzwl -2(%rdi), %eax");
+  emitter.movzxRMToReg<S::B, 1>(Reg::r8, Reg::r9, 300, Reg::r10d);
+  CHECK("47 0f b6 94 08 2c 01 00 00    movzbl 300(%r8,%r9), %r10d");
+
   emitter.testImmToRM<S::B, ScaleRegAccess>(-1, Reg::al, Reg::NoIndex, 0);
   CHECK("a8 ff                         testb $-1, %al");
   emitter.testImmToRM<S::W, ScaleRegAccess>(300, Reg::ax, Reg::NoIndex, 0);
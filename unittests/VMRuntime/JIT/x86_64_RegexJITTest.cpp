@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Regex/Compiler.h"
+#include "hermes/Regex/Executor.h"
+#include "hermes/Regex/RegexTraits.h"
+#include "hermes/VM/JIT/x86-64/JIT.h"
+
+#include <string>
+#include "gtest/gtest.h"
+
+using namespace hermes::regex;
+using namespace hermes::vm;
+using namespace hermes::vm::x86_64;
+
+namespace {
+
+using cregex = Regex<UTF16RegexTraits>;
+
+// Flatten a list of captured ranges into a string representation like:
+// "(0-5) (1-3)", or "no match".
+std::string flatten(
+    MatchRuntimeResult res,
+    const std::vector<CapturedRange> &m) {
+  if (res != MatchRuntimeResult::Match)
+    return "no match";
+  std::string result;
+  for (const auto &range : m) {
+    if (!result.empty())
+      result += " ";
+    if (!range.matched()) {
+      result += "nm";
+    } else {
+      result += '(' + std::to_string(range.start) + '-' +
+          std::to_string(range.end) + ')';
+    }
+  }
+  return result;
+}
+
+class RegexJITTest : public ::testing::Test {
+ protected:
+  JITContext jit_{true, 1 << 16, 1 << 20};
+
+  std::vector<uint8_t> compile(
+      const char16_t *pattern,
+      constants::SyntaxFlags flags = {}) {
+    cregex re(pattern, flags);
+    EXPECT_TRUE(re.valid());
+    return re.compile();
+  }
+
+  /// Search \p text with both the native code and the interpreter, from
+  /// every start offset and as ASCII if possible, and check that the results
+  /// agree.
+  /// \return the result of the search from offset 0.
+  std::string search(
+      const char16_t *pattern,
+      const std::u16string &text,
+      constants::SyntaxFlags flags = {},
+      constants::MatchFlagType matchFlags = constants::matchDefault) {
+    auto bytecode = compile(pattern, flags);
+    const NativeMatcher *matcher = jit_.compileRegex(bytecode);
+    EXPECT_NE(nullptr, matcher);
+    if (!matcher)
+      return "not compiled";
+
+    bool ascii = true;
+    std::string text8;
+    for (char16_t c : text) {
+      ascii &= c < 128;
+      text8 += (char)c;
+    }
+    std::string first;
+    for (uint32_t start = 0; start <= text.size(); ++start) {
+      std::vector<CapturedRange> expected, actual;
+      auto expectedRes = searchWithBytecode(
+          bytecode, text.data(), start, text.size(), &expected, matchFlags);
+      auto actualRes = searchWithNativeMatcher(
+          bytecode,
+          *matcher,
+          text.data(),
+          start,
+          text.size(),
+          &actual,
+          matchFlags);
+      std::string result = flatten(actualRes, actual);
+      EXPECT_EQ(flatten(expectedRes, expected), result) << "start " << start;
+      if (start == 0)
+        first = result;
+      if (!ascii)
+        continue;
+      actualRes = searchWithNativeMatcher(
+          bytecode,
+          *matcher,
+          text8.data(),
+          start,
+          text8.size(),
+          &actual,
+          matchFlags);
+      EXPECT_EQ(flatten(expectedRes, expected), flatten(actualRes, actual))
+          << "ASCII, start " << start;
+    }
+    return first;
+  }
+};
+
+TEST_F(RegexJITTest, Characters) {
+  EXPECT_EQ("(2-5)", search(u"abc", u"xxabcxx"));
+  EXPECT_EQ("no match", search(u"abc", u"xxabxx"));
+  EXPECT_EQ("(1-4)", search(u"AbC", u"xaBcx", constants::icase));
+  EXPECT_EQ("(1-2)", search(u"é", u"xé"));
+  EXPECT_EQ("(0-3)", search(u"a.c", u"abc"));
+  EXPECT_EQ("no match", search(u"a.c", u"a c"));
+  EXPECT_EQ("(1-4)", search(u"[a-c][^a-c]\\d", u"xbx1"));
+  EXPECT_EQ("(0-3)", search(u"\\s\\S\\w", u"\u3000x_"));
+  EXPECT_EQ("(0-2)", search(u"[\\W\\d][^\\D]", u"-5"));
+}
+
+TEST_F(RegexJITTest, Anchors) {
+  EXPECT_EQ("(0-1)", search(u"^a", u"aa"));
+  EXPECT_EQ("no match", search(u"^b", u"ab"));
+  EXPECT_EQ("(2-3)", search(u"^b", u"a\nb", constants::multiline));
+  EXPECT_EQ("(1-2)", search(u"a$", u"aa"));
+  EXPECT_EQ("(0-1)", search(u"a$", u"a\nb", constants::multiline));
+  EXPECT_EQ("(3-6)", search(u"\\bfoo\\b", u"xx foo"));
+  EXPECT_EQ("(1-2)", search(u"\\Bo", u"foo"));
+}
+
+TEST_F(RegexJITTest, Alternations) {
+  EXPECT_EQ("(0-2) (0-2) nm", search(u"(ab)|(cd)", u"abcd"));
+  EXPECT_EQ("(0-4) (0-1) (1-4)", search(u"(a|ab)(c|bcd)", u"abcd"));
+  EXPECT_EQ("(0-1) (0-1)", search(u"(a|ab)", u"ab"));
+  EXPECT_EQ("(1-2) nm (1-2)", search(u"(a)x|(b)", u"ab"));
+}
+
+TEST_F(RegexJITTest, Loops) {
+  EXPECT_EQ("(0-5)", search(u"a*ab", u"aaaab"));
+  EXPECT_EQ("(0-2)", search(u"a*?b", u"ab"));
+  EXPECT_EQ("(1-4) (1-2)", search(u"(a+?)b+", u"xabb"));
+  EXPECT_EQ("(0-3)", search(u"\\d{2,3}", u"12345"));
+  EXPECT_EQ("(0-2)", search(u"\\d{2,3}?", u"12345"));
+  EXPECT_EQ("no match", search(u"a{3,}", u"aa"));
+  EXPECT_EQ("(0-6) (0-3)", search(u"([^b]*)b.*", u"xxxbyy"));
+  EXPECT_EQ("(0-4)", search(u".*$", u"abéc"));
+}
+
+TEST_F(RegexJITTest, MatchFlags) {
+  EXPECT_EQ("no match", search(u"b", u"ab", {}, constants::matchOnlyAtStart));
+  EXPECT_EQ("no match", search(u"a$", u"a", {}, constants::matchNotEndOfLine));
+}
+
+TEST_F(RegexJITTest, Budget) {
+  // The native code gives up on catastrophic backtracking and the search is
+  // redone by the interpreter.
+  std::u16string text(30, u'a');
+  EXPECT_EQ("no match", search(u"a*a*a*a*a*b", text));
+  EXPECT_EQ("(0-30)", search(u"a*a*a*a*a*", text));
+}
+
+TEST_F(RegexJITTest, Unsupported) {
+  EXPECT_EQ(nullptr, jit_.compileRegex(compile(u"(a)\\1")));
+  EXPECT_EQ(nullptr, jit_.compileRegex(compile(u"a(?=b)")));
+  EXPECT_EQ(nullptr, jit_.compileRegex(compile(u"(ab)*")));
+  EXPECT_EQ(nullptr, jit_.compileRegex(compile(u"a", constants::unicode)));
+}
+
+TEST_F(RegexJITTest, Cache) {
+  auto bytecode = compile(u"a[bc]+");
+  const NativeMatcher *matcher = jit_.compileRegex(bytecode);
+  ASSERT_NE(nullptr, matcher);
+  EXPECT_EQ(matcher, jit_.compileRegex(compile(u"a[bc]+")));
+  EXPECT_NE(matcher, jit_.compileRegex(compile(u"a[bd]+")));
+}
+
+} // namespace
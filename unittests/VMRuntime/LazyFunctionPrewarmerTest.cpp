@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMESVM_LEAN
+
+#include "hermes/VM/LazyFunctionPrewarmer.h"
+
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/VM/CodeBlock.h"
+
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+using namespace hermes;
+using namespace hermes::vm;
+using namespace hermes::hbc;
+
+namespace {
+
+/// Three functions long enough to be compiled lazily.
+const char *const kSource = R"(
+function f1() {
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  return 1;
+}
+function f2() {
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  return 2;
+}
+function f3() {
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+  return 3;
+}
+)";
+
+class LazyFunctionPrewarmerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    CompileFlags flags;
+    flags.lazy = true;
+    auto res = BCProviderFromSrc::createBCProviderFromSrc(
+        llvm::make_unique<OwnedMemoryBuffer>(
+            llvm::MemoryBuffer::getMemBufferCopy(kSource)),
+        "test.js",
+        flags);
+    ASSERT_TRUE(res.first) << res.second;
+    auto *bcModule = res.first->getBytecodeModule();
+    for (uint32_t i = 0, e = res.first->getFunctionCount(); i < e; ++i) {
+      if (res.first->isFunctionLazy(i))
+        ids_.push_back(i);
+    }
+    // Sort the functions in source order, like the prewarmer.
+    auto start = [bcModule](uint32_t id) {
+      return bcModule->getFunction(id)
+          .getLazyCompilationData()
+          ->span.Start.getPointer();
+    };
+    std::sort(ids_.begin(), ids_.end(), [start](uint32_t a, uint32_t b) {
+      return start(a) < start(b);
+    });
+    ASSERT_EQ(3u, ids_.size());
+    for (uint32_t id : ids_)
+      funcs_.push_back(&bcModule->getFunction(id));
+    module_ = CompiledModule::create(std::move(res.first));
+  }
+
+  std::shared_ptr<CompiledModule> module_;
+  /// The IDs of the lazy functions f1, f2 and f3.
+  std::vector<uint32_t> ids_;
+  /// The lazy functions f1, f2 and f3.
+  std::vector<BytecodeFunction *> funcs_;
+};
+
+TEST_F(LazyFunctionPrewarmerTest, CompilesQueuedFunctions) {
+  LazyFunctionPrewarmer prewarmer;
+  prewarmer.enqueue(module_);
+  prewarmer.waitUntilIdle();
+
+  for (auto *func : funcs_)
+    EXPECT_TRUE(prewarmer.compile(func));
+  EXPECT_EQ(3u, prewarmer.getNumPrewarmed());
+}
+
+TEST_F(LazyFunctionPrewarmerTest, StopsAtMaxUntaken) {
+  LazyFunctionPrewarmer prewarmer{1};
+  prewarmer.enqueue(module_);
+  // Only f1 is compiled, since it isn't taken.
+  prewarmer.waitUntilIdle();
+
+  EXPECT_TRUE(prewarmer.compile(funcs_[2]));
+  EXPECT_EQ(0u, prewarmer.getNumPrewarmed());
+  EXPECT_TRUE(prewarmer.compile(funcs_[0]));
+  EXPECT_EQ(1u, prewarmer.getNumPrewarmed());
+
+  // Taking f1 made room for f2. f3 is skipped, since its first call
+  // compiled it.
+  prewarmer.waitUntilIdle();
+  EXPECT_TRUE(prewarmer.compile(funcs_[1]));
+  EXPECT_EQ(2u, prewarmer.getNumPrewarmed());
+}
+
+TEST_F(LazyFunctionPrewarmerTest, SkipsFunctionsCompiledElsewhere) {
+  // Another runtime sharing the module compiled f1.
+  CompiledModule::createLazy(module_, ids_[0])
+      ->compileLazy([](BytecodeFunction *func) {
+        return compileLazyFunction(func->getLazyCompilationData());
+      });
+  LazyFunctionPrewarmer prewarmer{1};
+  prewarmer.enqueue(module_);
+  prewarmer.waitUntilIdle();
+
+  // f1 was not compiled again, and didn't take the room of f2.
+  EXPECT_TRUE(prewarmer.compile(funcs_[1]));
+  EXPECT_EQ(1u, prewarmer.getNumPrewarmed());
+}
+
+TEST_F(LazyFunctionPrewarmerTest, DiscardMakesRoom) {
+  LazyFunctionPrewarmer prewarmer{1};
+  prewarmer.enqueue(module_);
+  prewarmer.waitUntilIdle();
+
+  // f1 was compiled by another runtime after it was prewarmed.
+  prewarmer.discard(funcs_[0]);
+  prewarmer.waitUntilIdle();
+  EXPECT_TRUE(prewarmer.compile(funcs_[0]));
+  EXPECT_EQ(0u, prewarmer.getNumPrewarmed());
+  EXPECT_TRUE(prewarmer.compile(funcs_[1]));
+  EXPECT_EQ(1u, prewarmer.getNumPrewarmed());
+}
+
+} // anonymous namespace
+
+#endif // HERMESVM_LEAN
@@ -883,6 +883,89 @@ TEST_F(ObjectModelTest, UpdatePropertyFlagsWithoutTransitionsTest) {
   EXPECT_PROPERTY_FLAG(FALSE, obj, *cHnd, configurable);
 }
 
+/// Put \p count numeric properties named "p0", "p1", ... into \p obj.
+static void
+putNumberedProps(Runtime *runtime, Handle<JSObject> obj, unsigned count) {
+  for (unsigned i = 0; i != count; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    std::string name = "p" + std::to_string(i);
+    auto id = *runtime->getIdentifierTable().getSymbolHandle(
+        runtime, ASCIIRef(name.data(), name.size()));
+    ASSERT_TRUE(*JSObject::putNamed_RJS(
+        obj,
+        runtime,
+        *id,
+        runtime->makeHandle(HermesValue::encodeNumberValue(i))));
+  }
+}
+
+/// Check that \p obj has the properties set by putNumberedProps().
+static void
+checkNumberedProps(Runtime *runtime, Handle<JSObject> obj, unsigned count) {
+  for (unsigned i = 0; i != count; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    std::string name = "p" + std::to_string(i);
+    auto id = *runtime->getIdentifierTable().getSymbolHandle(
+        runtime, ASCIIRef(name.data(), name.size()));
+    EXPECT_CALLRESULT_DOUBLE(i, JSObject::getNamed_RJS(obj, runtime, *id));
+  }
+}
+
+TEST_F(ObjectModelTest, DirectSlotSizeClassesTest) {
+  GCScope gcScope{runtime, "ObjectModelTest.DirectSlotSizeClassesTest", 256};
+
+  // Objects with a known number of properties use the smallest size class
+  // which fits them.
+  auto small = toHandle(runtime, JSObject::create(runtime, 3u));
+  EXPECT_EQ(CellKind::ObjectKind, small->getKind());
+  EXPECT_TRUE(small->getNumDirectSlots() == JSObject::DIRECT_PROPERTY_SLOTS);
+  auto medium = toHandle(runtime, JSObject::create(runtime, 12u));
+  EXPECT_EQ(CellKind::ObjectWith16SlotsKind, medium->getKind());
+  EXPECT_EQ(16u, medium->getNumDirectSlots());
+  auto large = toHandle(runtime, JSObject::create(runtime, 30u));
+  EXPECT_TRUE(
+      large->getNumDirectSlots() == JSObject::MAX_DIRECT_PROPERTY_SLOTS);
+  EXPECT_TRUE(vmisa<JSObject>(*large));
+
+  putNumberedProps(runtime, medium, 12);
+  putNumberedProps(runtime, large, 30);
+  runtime->collect();
+  checkNumberedProps(runtime, medium, 12);
+  checkNumberedProps(runtime, large, 30);
+}
+
+TEST_F(ObjectModelTest, InstanceSlotsHintTest) {
+  GCScope gcScope{runtime, "ObjectModelTest.InstanceSlotsHintTest", 256};
+
+  auto proto = toHandle(runtime, JSObject::create(runtime));
+  EXPECT_EQ(0u, proto->getInstanceSlotsHint());
+
+  // An instance fitting in the default slots doesn't change the hint.
+  auto obj1 = toHandle(runtime, JSObject::create(runtime, proto, 0));
+  putNumberedProps(runtime, obj1, JSObject::DIRECT_PROPERTY_SLOTS);
+  EXPECT_EQ(0u, proto->getInstanceSlotsHint());
+
+  // One that outgrows them records how many slots it needed.
+  auto obj2 = toHandle(runtime, JSObject::create(runtime, proto, 0));
+  putNumberedProps(runtime, obj2, 9);
+  EXPECT_EQ(9u, proto->getInstanceSlotsHint());
+
+  // The next instance is large enough to hold all of them.
+  auto obj3 = toHandle(
+      runtime, JSObject::create(runtime, proto, proto->getInstanceSlotsHint()));
+  EXPECT_EQ(CellKind::ObjectWith10SlotsKind, obj3->getKind());
+  putNumberedProps(runtime, obj3, 9);
+  EXPECT_EQ(9u, proto->getInstanceSlotsHint());
+  checkNumberedProps(runtime, obj3, 9);
+
+  // The hint never exceeds the largest size class.
+  auto obj4 = toHandle(runtime, JSObject::create(runtime, proto, 0));
+  putNumberedProps(runtime, obj4, 40);
+  EXPECT_TRUE(
+      proto->getInstanceSlotsHint() == JSObject::MAX_DIRECT_PROPERTY_SLOTS);
+  checkNumberedProps(runtime, obj4, 40);
+}
+
 #ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
 struct ObjectModelLargeHeapTest : public RuntimeTestFixtureBase {
   ObjectModelLargeHeapTest()
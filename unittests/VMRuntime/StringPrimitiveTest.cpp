@@ -6,6 +6,7 @@
  */
 
 #include "hermes/VM/StringPrimitive.h"
+#include "hermes/Support/HashString.h"
 #include "hermes/VM/StringView.h"
 
 #include "llvm/Support/AlignOf.h"
@@ -96,6 +97,33 @@ TEST_F(StringPrimTest, CreateEfficientTest) {
   }
 }
 
+TEST_F(StringPrimTest, HashTest) {
+  auto s1 = StringPrimitive::createNoThrow(runtime, "hello");
+  auto s2 = StringPrimitive::createNoThrow(runtime, createUTF16Ref(u"hello"));
+  auto s3 = StringPrimitive::createNoThrow(runtime, createUTF16Ref(u"h\u00e9"));
+  std::u16string wideLong(StringPrimitive::EXTERNAL_STRING_THRESHOLD, u'!');
+  auto e1 = Handle<StringPrimitive>::vmcast(
+      runtime,
+      *StringPrimitive::createEfficient(runtime, std::u16string(wideLong)));
+  ASSERT_TRUE(e1->isExternal());
+
+  // The hash matches hermes::hashString regardless of the representation,
+  // and stays the same once it is cached.
+  const uint32_t helloHash = hermes::hashString(createASCIIRef("hello"));
+  EXPECT_EQ(helloHash, s1->getOrComputeHash());
+  EXPECT_EQ(helloHash, s1->getOrComputeHash());
+  EXPECT_EQ(helloHash, s2->getOrComputeHash());
+  EXPECT_EQ(
+      hermes::hashString(createUTF16Ref(u"h\u00e9")), s3->getOrComputeHash());
+  EXPECT_EQ(
+      hermes::hashString(createUTF16Ref(wideLong.c_str())),
+      e1->getOrComputeHash());
+
+  // Strings with different cached hashes are different.
+  EXPECT_TRUE(s1->equals(s2.get()));
+  EXPECT_FALSE(s1->equals(s3.get()));
+}
+
 TEST_F(StringPrimTest, CompareTest) {
 #define TEST_CMP(v, a, b)                                 \
   {                                                       \
@@ -143,6 +171,104 @@ TEST_F(StringPrimTest, ConcatTest) {
   }
 }
 
+TEST_F(StringPrimTest, SliceTest) {
+  std::string ascii;
+  std::u16string wide;
+  for (int i = 0; i < 100; ++i) {
+    ascii += 'a' + i % 26;
+    wide += i % 2 ? u'\u00e9' : u'a' + i % 26;
+  }
+  auto asciiStr = StringPrimitive::createNoThrow(runtime, ascii);
+  auto wideStr = StringPrimitive::createNoThrow(
+      runtime, UTF16Ref(wide.data(), wide.size()));
+  auto slice = [this](Handle<StringPrimitive> str, size_t start, size_t len) {
+    auto res = StringPrimitive::slice(runtime, str, start, len);
+    EXPECT_NE(ExecutionStatus::EXCEPTION, res.getStatus());
+    return runtime->makeHandle<StringPrimitive>(*res);
+  };
+  const uint32_t minLen = StringPrimitive::SLICED_STRING_MIN_LENGTH;
+
+  // Short slices are copied.
+  auto shortSlice = slice(asciiStr, 10, minLen - 1);
+  EXPECT_FALSE(shortSlice->isSliced());
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, shortSlice)
+                  .equals(ASCIIRef(ascii.data() + 10, minLen - 1)));
+
+  // Long slices share the storage of the parent, and slices of slices share
+  // the storage of the original string.
+  auto asciiSlice = slice(asciiStr, 10, 60);
+  auto nestedSlice = slice(asciiSlice, 5, minLen);
+  auto wideSlice = slice(wideStr, 3, 90);
+  runtime->collect();
+  EXPECT_TRUE(asciiSlice->isSliced());
+  EXPECT_TRUE(asciiSlice->isASCII());
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, asciiSlice)
+                  .equals(ASCIIRef(ascii.data() + 10, 60)));
+  EXPECT_TRUE(nestedSlice->isSliced());
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, nestedSlice)
+                  .equals(ASCIIRef(ascii.data() + 15, minLen)));
+  EXPECT_TRUE(wideSlice->isSliced());
+  EXPECT_FALSE(wideSlice->isASCII());
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, wideSlice)
+                  .equals(UTF16Ref(wide.data() + 3, 90)));
+  EXPECT_EQ(
+      hermes::hashString(UTF16Ref(wide.data() + 3, 90)),
+      wideSlice->getOrComputeHash());
+
+  // Slices compare equal to copies of the same characters.
+  auto copy = StringPrimitive::createNoThrow(
+      runtime, llvm::StringRef(ascii.data() + 10, 60));
+  EXPECT_TRUE(asciiSlice->equals(copy.get()));
+  EXPECT_EQ(0, copy->compare(asciiSlice.get()));
+
+  // Slicing a whole string returns it.
+  EXPECT_EQ(*asciiStr, *slice(asciiStr, 0, ascii.size()));
+
+  // Slices of a much longer string are copied, so that they don't keep all
+  // of it alive. This applies to the string shared by a slice too.
+  const uint32_t maxRatio = StringPrimitive::SLICED_STRING_MAX_PARENT_RATIO;
+  std::string large = ascii;
+  while (large.size() <= minLen * maxRatio)
+    large += ascii;
+  auto largeStr = StringPrimitive::createNoThrow(runtime, large);
+  auto copiedSlice = slice(largeStr, 7, minLen);
+  EXPECT_FALSE(copiedSlice->isSliced());
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, copiedSlice)
+                  .equals(ASCIIRef(large.data() + 7, minLen)));
+  auto largeSlice = slice(largeStr, 7, large.size() - 10);
+  EXPECT_TRUE(largeSlice->isSliced());
+  auto copiedNestedSlice = slice(largeSlice, 3, minLen);
+  EXPECT_FALSE(copiedNestedSlice->isSliced());
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, copiedNestedSlice)
+                  .equals(ASCIIRef(large.data() + 10, minLen)));
+}
+
+TEST_F(StringPrimTest, ShortSliceTest) {
+  auto str = StringPrimitive::createNoThrow(runtime, "abcabcxyz");
+  auto wide =
+      StringPrimitive::createNoThrow(runtime, createUTF16Ref(u"x\u00e9y"));
+  auto slice = [this](Handle<StringPrimitive> s, size_t start, size_t len) {
+    auto res = StringPrimitive::slice(runtime, s, start, len);
+    EXPECT_NE(ExecutionStatus::EXCEPTION, res.getStatus());
+    return res->getString();
+  };
+
+  // Empty and single character slices use the preallocated strings.
+  EXPECT_EQ(
+      runtime->getPredefinedString(Predefined::emptyString), slice(str, 3, 0));
+  EXPECT_EQ(runtime->getCharacterString(u'b').get(), slice(str, 4, 1));
+  EXPECT_EQ(runtime->getCharacterString(u'\u00e9').get(), slice(wide, 1, 1));
+
+  // Short ASCII slices with the same contents are shared, even across
+  // collections.
+  auto first = runtime->makeHandle(slice(str, 0, 3));
+  runtime->collect();
+  EXPECT_EQ(first.get(), slice(str, 3, 3));
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, first)
+                  .equals(createASCIIRef("abc")));
+  EXPECT_NE(first.get(), slice(str, 1, 3));
+}
+
 // This attempts to test that strings above a sufficient length may be freely
 // memcpy'd around. This would not be true if the small-string optimization used
 // an interior pointer, or if someone else maintained a pointer to the string.
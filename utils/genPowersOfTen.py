@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+# Generates the table of 128-bit approximations of powers of ten used by the
+# fast number conversions in lib/Support/Conversions.cpp.
+# Usage: genPowersOfTen.py > lib/Support/PowersOfTen.inc
+
+# The range of decimal exponents in the table. It covers every double, with
+# enough margin for the scaling done when converting a double to a string.
+MIN_EXP10 = -348
+MAX_EXP10 = 347
+
+
+def floor_log2_pow10(e):
+    """ Return floor(log2(10 ** e)), computed exactly. """
+    if e >= 0:
+        return (10 ** e).bit_length() - 1
+    return -((10 ** -e - 1).bit_length())
+
+
+def mantissa128(e):
+    """ Return the 128 most significant bits of 10 ** e, rounded down. """
+    shift = 127 - floor_log2_pow10(e)
+    if e >= 0:
+        v = 10 ** e
+        m = v << shift if shift >= 0 else v >> -shift
+    else:
+        m = (1 << shift) // 10 ** -e
+    assert m.bit_length() == 128
+    return m
+
+
+def main():
+    print("//")
+    print("// File generated by genPowersOfTen.py")
+    print("// *** DO NOT EDIT BY HAND ***")
+    print("")
+    print("/// The smallest and largest decimal exponents in kPowersOfTen.")
+    print("static constexpr int kPowersOfTenMinExp10 = %d;" % MIN_EXP10)
+    print("static constexpr int kPowersOfTenMaxExp10 = %d;" % MAX_EXP10)
+    print("")
+    print("/// The 128 most significant bits of 10^e, rounded down, for each e in")
+    print("/// [kPowersOfTenMinExp10, kPowersOfTenMaxExp10], as {high, low} halves.")
+    print("/// The most significant bit is always set, and the value of the entry")
+    print("/// for e is approximately {high, low} * 2^(floor(log2(10^e)) - 127).")
+    print("static const uint64_t kPowersOfTen[][2] = {")
+    for e in range(MIN_EXP10, MAX_EXP10 + 1):
+        m = mantissa128(e)
+        # The rounded 64-bit approximation must not overflow.
+        assert (m >> 64) != (1 << 64) - 1 or not (m >> 63) & 1
+        print(
+            "    {0x%016X, 0x%016X}, // 1e%d"
+            % (m >> 64, m & ((1 << 64) - 1), e)
+        )
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,125 @@
+#!/usr/bin/python
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+# -*- coding: utf-8 -*-
+
+""" Measure the effect of fused instructions on a corpus.
+
+Every JavaScript file of the corpus is compiled with -O, with and without
+-fuse-instructions, and the size of the bytecode files is compared.
+
+If --profiler is given, it must be a hermes binary built with
+HERMESVM_PROFILER_OPCODE. It runs both bytecode files, and the number of
+instructions dispatched by the interpreter is compared as well. Its output
+also lists the most frequent pairs of opcodes, which are candidates for new
+fused instructions.
+"""
+
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+
+DISPATCHES_RE = re.compile(r"^Total dispatches: (\d+)$", re.M)
+
+
+def find_sources(paths):
+    """ Return the JavaScript files in the given files and directories. """
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                for name in sorted(files):
+                    if name.endswith(".js"):
+                        yield os.path.join(root, name)
+        else:
+            yield path
+
+
+def compile_source(hermes, source, out, fuse):
+    """ Compile source to the bytecode file out, return whether it worked. """
+    args = [hermes, "-O", "-target=HBC", "-emit-binary", "-out", out, source]
+    if fuse:
+        args.insert(1, "-fuse-instructions")
+    return subprocess.call(args) == 0
+
+
+def count_dispatches(profiler, bytecode):
+    """ Run bytecode with an opcode profiling build, return the number of
+        dispatched instructions, or None. """
+    proc = subprocess.Popen(
+        [profiler, bytecode], stdout=subprocess.PIPE, stderr=subprocess.PIPE
+    )
+    out, _ = proc.communicate()
+    match = DISPATCHES_RE.search(out.decode("utf-8", "replace"))
+    return int(match.group(1)) if match else None
+
+
+def describe_delta(before, after):
+    percent = 100.0 * (after - before) / before if before else 0.0
+    return "%d -> %d (%+.2f%%)" % (before, after, percent)
+
+
+def measure(args, source, tmpdir, totals):
+    """ Compile and optionally run source with and without fusion, add the
+        results to totals, and return a line describing them. """
+    plain = os.path.join(tmpdir, "plain.hbc")
+    fused = os.path.join(tmpdir, "fused.hbc")
+    if not compile_source(args.hermes, source, plain, False) or not (
+        compile_source(args.hermes, source, fused, True)
+    ):
+        print("%s: failed to compile" % source, file=sys.stderr)
+        return None
+
+    sizes = [os.path.getsize(plain), os.path.getsize(fused)]
+    line = "%s: size %s" % (source, describe_delta(*sizes))
+    for i in range(2):
+        totals["size"][i] += sizes[i]
+
+    if args.profiler:
+        counts = [
+            count_dispatches(args.profiler, plain),
+            count_dispatches(args.profiler, fused),
+        ]
+        if None in counts:
+            return line + ", no dispatch count"
+        line += ", dispatches " + describe_delta(*counts)
+        for i in range(2):
+            totals["dispatches"][i] += counts[i]
+    return line
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--hermes", default="hermes", help="hermes compiler")
+    parser.add_argument(
+        "--profiler", help="hermes built with HERMESVM_PROFILER_OPCODE"
+    )
+    parser.add_argument("CORPUS", nargs="+", help="JavaScript files or dirs")
+    args = parser.parse_args()
+
+    totals = {"size": [0, 0], "dispatches": [0, 0]}
+    tmpdir = tempfile.mkdtemp()
+    try:
+        for source in find_sources(args.CORPUS):
+            line = measure(args, source, tmpdir, totals)
+            if line:
+                print(line)
+    finally:
+        shutil.rmtree(tmpdir)
+
+    print("Total size: " + describe_delta(*totals["size"]))
+    if args.profiler:
+        print("Total dispatches: " + describe_delta(*totals["dispatches"]))
+
+
+if __name__ == "__main__":
+    main()